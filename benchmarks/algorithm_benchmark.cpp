@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The cost of building, connecting and running sender algorithms that
+// complete inline, so that only the algorithms themselves are measured.
+// Each benchmark also reports the size of its operation state.
+
+#include <unifex/just.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/when_all.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <exception>
+
+using namespace unifex;
+
+namespace {
+
+struct sink_receiver {
+  template <typename... Values>
+  void set_value(Values&&... values) noexcept {
+    (benchmark::DoNotOptimize(values), ...);
+  }
+  void set_error(std::exception_ptr) noexcept { std::terminate(); }
+  void set_done() noexcept {}
+};
+
+template <typename Sender>
+void run(Sender&& sender) {
+  auto op = connect((Sender &&) sender, sink_receiver{});
+  start(op);
+}
+
+template <typename Sender>
+void report_size(benchmark::State& state, const Sender&) {
+  state.counters["op_state_bytes"] =
+      static_cast<double>(sizeof(connect_result_t<Sender, sink_receiver>));
+}
+
+void just_baseline(benchmark::State& state) {
+  int i = 0;
+  for (auto _ : state) {
+    run(just(++i));
+  }
+  report_size(state, just(i));
+}
+
+void when_all_2(benchmark::State& state) {
+  int i = 0;
+  auto make = [&] {
+    ++i;
+    return when_all(just(i), just(i));
+  };
+  for (auto _ : state) {
+    run(make());
+  }
+  report_size(state, make());
+}
+
+void when_all_8(benchmark::State& state) {
+  int i = 0;
+  auto make = [&] {
+    ++i;
+    return when_all(
+        just(i), just(i), just(i), just(i), just(i), just(i), just(i), just(i));
+  };
+  for (auto _ : state) {
+    run(make());
+  }
+  report_size(state, make());
+}
+
+void let_value_chain(benchmark::State& state) {
+  int i = 0;
+  auto make = [&] {
+    return let_value(just(++i), [](int& a) {
+      return let_value(just(a + 1), [](int& b) {
+        return let_value(just(b + 1), [](int& c) { return just(c + 1); });
+      });
+    });
+  };
+  for (auto _ : state) {
+    run(make());
+  }
+  report_size(state, make());
+}
+
+void then_chain(benchmark::State& state) {
+  int i = 0;
+  auto make = [&] {
+    auto inc = [](int x) { return x + 1; };
+    return then(then(then(just(++i), inc), inc), inc);
+  };
+  for (auto _ : state) {
+    run(make());
+  }
+  report_size(state, make());
+}
+
+}  // namespace
+
+BENCHMARK(just_baseline);
+BENCHMARK(when_all_2);
+BENCHMARK(when_all_8);
+BENCHMARK(let_value_chain);
+BENCHMARK(then_chain);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// async_mutex throughput with an increasing number of threads contending
+// for it.
+
+#include <unifex/async_mutex.hpp>
+#include <unifex/defer.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sequence.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/when_all_range.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+
+struct return_byte {
+  std::uint8_t operator()() const noexcept { return 0; }
+};
+
+constexpr int locks_per_thread = 10'000;
+
+// Locks and unlocks `mutex` locks_per_thread times on `sched`.
+template <typename Scheduler>
+auto lock_loop(Scheduler sched, async_mutex& mutex, int& sharedState) {
+  return let_value(schedule(sched), [sched, &mutex, &sharedState] {
+    return then(
+        repeat_effect_until(
+            defer([sched, &mutex, &sharedState] {
+              return let_value(
+                  mutex.async_lock(), [sched, &mutex, &sharedState] {
+                    // Resume on our own thread while holding the lock.
+                    return then(schedule(sched), [&mutex, &sharedState] {
+                      ++sharedState;
+                      mutex.unlock();
+                    });
+                  });
+            }),
+            [count = 0]() mutable { return ++count == locks_per_thread; }),
+        return_byte{});
+  });
+}
+
+void async_mutex_uncontended(benchmark::State& state) {
+  async_mutex mutex;
+  for (auto _ : state) {
+    sync_wait(mutex.async_lock());
+    mutex.unlock();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void async_mutex_contended(benchmark::State& state) {
+  const auto threads = static_cast<std::size_t>(state.range(0));
+  std::vector<std::unique_ptr<single_thread_context>> contexts;
+  for (std::size_t i = 0; i < threads; ++i) {
+    contexts.push_back(std::make_unique<single_thread_context>());
+  }
+  async_mutex mutex;
+  int sharedState = 0;
+  using sender_t = decltype(lock_loop(
+      contexts.front()->get_scheduler(), mutex, sharedState));
+  for (auto _ : state) {
+    std::vector<sender_t> senders;
+    for (auto& context : contexts) {
+      senders.push_back(
+          lock_loop(context->get_scheduler(), mutex, sharedState));
+    }
+    sync_wait(when_all_range(std::move(senders)));
+  }
+  benchmark::DoNotOptimize(sharedState);
+  state.SetItemsProcessed(
+      state.iterations() * state.range(0) * locks_per_thread);
+}
+
+}  // namespace
+
+BENCHMARK(async_mutex_uncontended);
+BENCHMARK(async_mutex_contended)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+BENCHMARK_MAIN();
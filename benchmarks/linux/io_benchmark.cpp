@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// schedule() latency, timer insert/cancel cost and I/O throughput for the
+// Linux I/O contexts. Benchmarks for a context are only built when it is
+// available.
+
+#include <unifex/config.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/just.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/span.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/when_all.hpp>
+
+#if !UNIFEX_NO_EPOLL
+#include <unifex/linux/io_epoll_context.hpp>
+#endif
+#if !UNIFEX_NO_LIBURING
+#include <unifex/linux/io_uring_context.hpp>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linuxos;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Runs an I/O context on its own thread for the lifetime of the fixture.
+template <typename Context>
+struct context_fixture {
+  Context context_;
+  inplace_stop_source stopSource_;
+  std::thread thread_{[this] { context_.run(stopSource_.get_token()); }};
+
+  ~context_fixture() {
+    stopSource_.request_stop();
+    thread_.join();
+  }
+
+  auto get_scheduler() { return context_.get_scheduler(); }
+};
+
+template <typename Context>
+void io_schedule_latency(benchmark::State& state) {
+  context_fixture<Context> fixture;
+  auto sched = fixture.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(schedule(sched));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Context>
+void io_timer_insert_cancel(benchmark::State& state) {
+  context_fixture<Context> fixture;
+  auto sched = fixture.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(stop_when(schedule_at(sched, now(sched) + 1h), just()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+#if !UNIFEX_NO_EPOLL
+
+// Writes and reads back state.range(0) bytes through a pipe. Writes of up
+// to PIPE_BUF bytes are atomic, so each read sees the whole write.
+void epoll_pipe_throughput(benchmark::State& state) {
+  context_fixture<io_epoll_context> fixture;
+  auto [reader, writer] = open_pipe(fixture.get_scheduler());
+  std::vector<char> out(static_cast<std::size_t>(state.range(0)), 'x');
+  std::vector<char> in(out.size());
+  std::int64_t bytes = 0;
+  for (auto _ : state) {
+    auto result = sync_wait(when_all(
+        async_write_some(writer, as_bytes(span{out.data(), out.size()})),
+        async_read_some(
+            reader, as_writable_bytes(span{in.data(), in.size()}))));
+    bytes += static_cast<std::int64_t>(
+        std::get<0>(std::get<0>(std::get<1>(*result))));
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+#endif  // !UNIFEX_NO_EPOLL
+
+#if !UNIFEX_NO_LIBURING
+
+// Reads a state.range(0) byte file in blocks of state.range(1) bytes.
+void uring_file_read_throughput(benchmark::State& state) {
+  const auto fileSize = static_cast<std::size_t>(state.range(0));
+  const auto blockSize = static_cast<std::size_t>(state.range(1));
+
+  std::string path = "/tmp/unifex_io_benchmark_XXXXXX";
+  const int fd = ::mkstemp(path.data());
+  if (fd < 0) {
+    state.SkipWithError("mkstemp failed");
+    return;
+  }
+  scope_guard removeFile = [&]() noexcept {
+    ::close(fd);
+    ::unlink(path.c_str());
+  };
+  const std::vector<char> contents(fileSize, 'x');
+  if (::write(fd, contents.data(), contents.size()) !=
+      static_cast<ssize_t>(contents.size())) {
+    state.SkipWithError("failed to write the test file");
+    return;
+  }
+
+  context_fixture<io_uring_context> fixture;
+  auto file = open_file_read_only(fixture.get_scheduler(), path);
+  std::vector<char> buffer(blockSize);
+  std::int64_t bytes = 0;
+  for (auto _ : state) {
+    for (std::size_t offset = 0; offset < fileSize; offset += blockSize) {
+      auto bytesRead = sync_wait(async_read_some_at(
+          file,
+          static_cast<off_t>(offset),
+          as_writable_bytes(span{buffer.data(), buffer.size()})));
+      bytes += static_cast<std::int64_t>(*bytesRead);
+    }
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+#endif  // !UNIFEX_NO_LIBURING
+
+}  // namespace
+
+#if !UNIFEX_NO_EPOLL
+BENCHMARK_TEMPLATE(io_schedule_latency, io_epoll_context)->UseRealTime();
+BENCHMARK_TEMPLATE(io_timer_insert_cancel, io_epoll_context)->UseRealTime();
+BENCHMARK(epoll_pipe_throughput)->Arg(64)->Arg(4096)->UseRealTime();
+#endif
+
+#if !UNIFEX_NO_LIBURING
+BENCHMARK_TEMPLATE(io_schedule_latency, io_uring_context)->UseRealTime();
+BENCHMARK_TEMPLATE(io_timer_insert_cancel, io_uring_context)->UseRealTime();
+BENCHMARK(uring_file_read_throughput)
+    ->Args({1 << 20, 4096})
+    ->Args({1 << 20, 64 << 10})
+    ->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
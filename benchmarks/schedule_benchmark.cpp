@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Latency and throughput of schedule() on the general purpose execution
+// contexts, and of hopping between two of them.
+
+#include <unifex/let_value.hpp>
+#include <unifex/manual_event_loop.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/when_all_range.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+
+struct return_byte {
+  std::uint8_t operator()() const noexcept { return 0; }
+};
+
+struct thread_pool_fixture {
+  static_thread_pool context_;
+  auto get_scheduler() { return context_.get_scheduler(); }
+};
+
+struct single_thread_fixture {
+  single_thread_context context_;
+  auto get_scheduler() { return context_.get_scheduler(); }
+};
+
+struct timed_single_thread_fixture {
+  timed_single_thread_context context_;
+  auto get_scheduler() { return context_.get_scheduler(); }
+};
+
+struct manual_event_loop_fixture {
+  manual_event_loop context_;
+  std::thread thread_{[this] { context_.run(); }};
+
+  ~manual_event_loop_fixture() {
+    context_.stop();
+    thread_.join();
+  }
+
+  auto get_scheduler() { return context_.get_scheduler(); }
+};
+
+// One schedule() at a time: the cost of a round trip through the context's
+// queue, including waking its thread.
+template <typename Fixture>
+void schedule_latency(benchmark::State& state) {
+  Fixture fixture;
+  auto sched = fixture.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(schedule(sched));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// state.range(0) schedule() operations in flight at once.
+template <typename Fixture>
+void schedule_throughput(benchmark::State& state) {
+  Fixture fixture;
+  auto sched = fixture.get_scheduler();
+  const auto count = static_cast<std::size_t>(state.range(0));
+  using sender_t =
+      decltype(then(schedule(sched), return_byte{}));
+  std::vector<sender_t> senders;
+  for (auto _ : state) {
+    senders.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+      senders.push_back(then(schedule(sched), return_byte{}));
+    }
+    benchmark::DoNotOptimize(sync_wait(when_all_range(std::move(senders))));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Moves from one thread to another and back again.
+template <typename Fixture>
+void hop_latency(benchmark::State& state) {
+  Fixture first;
+  Fixture second;
+  auto firstSched = first.get_scheduler();
+  auto secondSched = second.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(let_value(
+        schedule(firstSched), [&] { return schedule(secondSched); }));
+  }
+  state.SetItemsProcessed(2 * state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(schedule_latency, thread_pool_fixture)->UseRealTime();
+BENCHMARK_TEMPLATE(schedule_latency, single_thread_fixture)->UseRealTime();
+BENCHMARK_TEMPLATE(schedule_latency, timed_single_thread_fixture)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(schedule_latency, manual_event_loop_fixture)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(schedule_throughput, thread_pool_fixture)
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(schedule_throughput, single_thread_fixture)
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(schedule_throughput, manual_event_loop_fixture)
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(hop_latency, single_thread_fixture)->UseRealTime();
+BENCHMARK_TEMPLATE(hop_latency, manual_event_loop_fixture)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The cost of registering and deregistering inplace_stop_callbacks, which
+// every cancellable operation does even though it is almost never
+// cancelled, and of requesting stop.
+
+#include <unifex/inplace_stop_token.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+
+// Holds a pointer, like the callbacks that algorithms register with a
+// pointer to their operation state.
+struct noop_callback {
+  void* op_ = nullptr;
+  void operator()() const noexcept {}
+};
+
+using callback_t = inplace_stop_callback<noop_callback>;
+
+void report_sizes(benchmark::State& state) {
+  state.counters["callback_bytes"] = sizeof(callback_t);
+  state.counters["source_bytes"] = sizeof(inplace_stop_source);
+}
+
+// The common case: the only callback on a source.
+void stop_callback_single(benchmark::State& state) {
+  inplace_stop_source source;
+  for (auto _ : state) {
+    callback_t callback{source.get_token(), noop_callback{}};
+    benchmark::DoNotOptimize(callback);
+  }
+  state.SetItemsProcessed(state.iterations());
+  report_sizes(state);
+}
+
+// Registering and deregistering one more callback on a source that
+// already has state.range(0) callbacks.
+void stop_callback_nested(benchmark::State& state) {
+  inplace_stop_source source;
+  std::vector<std::optional<callback_t>> others(
+      static_cast<std::size_t>(state.range(0)));
+  for (auto& other : others) {
+    other.emplace(source.get_token(), noop_callback{});
+  }
+  for (auto _ : state) {
+    callback_t callback{source.get_token(), noop_callback{}};
+    benchmark::DoNotOptimize(callback);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Registering state.range(0) callbacks and deregistering them in the order
+// they were registered, as the children of when_all() do.
+void stop_callback_fifo(benchmark::State& state) {
+  inplace_stop_source source;
+  const auto count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::optional<callback_t>> callbacks(count);
+  for (auto _ : state) {
+    for (auto& callback : callbacks) {
+      callback.emplace(source.get_token(), noop_callback{});
+    }
+    for (auto& callback : callbacks) {
+      callback.reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every thread registering and deregistering callbacks on one source.
+void stop_callback_contended(benchmark::State& state) {
+  static inplace_stop_source source;
+  for (auto _ : state) {
+    callback_t callback{source.get_token(), noop_callback{}};
+    benchmark::DoNotOptimize(callback);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void request_stop(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::optional<callback_t>> callbacks(count);
+  for (auto _ : state) {
+    auto source = std::make_unique<inplace_stop_source>();
+    for (auto& callback : callbacks) {
+      callback.emplace(source->get_token(), noop_callback{});
+    }
+    source->request_stop();
+    for (auto& callback : callbacks) {
+      callback.reset();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(stop_callback_single);
+BENCHMARK(stop_callback_nested)->Arg(1)->Arg(8);
+BENCHMARK(stop_callback_fifo)->Arg(2)->Arg(16)->Arg(256);
+BENCHMARK(stop_callback_contended)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(request_stop)->Arg(1)->Arg(16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The overhead of calling and awaiting a task<> compared with a plain
+// function call, and of awaiting a sender from a task<>.
+
+#include <unifex/coroutine.hpp>
+
+#include <benchmark/benchmark.h>
+
+#if !UNIFEX_NO_COROUTINES
+
+#include <unifex/just.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/task.hpp>
+
+using namespace unifex;
+
+namespace {
+
+task<int> leaf(int x) {
+  co_return x + 1;
+}
+
+task<int> call_leaf(int count) {
+  int sum = 0;
+  for (int i = 0; i < count; ++i) {
+    sum += co_await leaf(i);
+  }
+  co_return sum;
+}
+
+task<int> await_just(int count) {
+  int sum = 0;
+  for (int i = 0; i < count; ++i) {
+    sum += co_await just(i);
+  }
+  co_return sum;
+}
+
+constexpr int calls_per_iteration = 1000;
+
+void task_call(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sync_wait(call_leaf(calls_per_iteration)));
+  }
+  state.SetItemsProcessed(state.iterations() * calls_per_iteration);
+}
+
+void task_await_sender(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sync_wait(await_just(calls_per_iteration)));
+  }
+  state.SetItemsProcessed(state.iterations() * calls_per_iteration);
+}
+
+void task_sync_wait(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sync_wait(leaf(0)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(task_call);
+BENCHMARK(task_await_sender);
+BENCHMARK(task_sync_wait);
+
+#endif  // !UNIFEX_NO_COROUTINES
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The cost of inserting timers and of cancelling them before they fire.
+
+#include <unifex/just.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/when_all_range.hpp>
+#include <unifex/then.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct return_byte {
+  std::uint8_t operator()() const noexcept { return 0; }
+};
+
+// Inserts a timer that has already expired and waits for it to fire.
+void timer_fire(benchmark::State& state) {
+  timed_single_thread_context context;
+  auto sched = context.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(schedule_after(sched, 0ms));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Inserts a timer far in the future and cancels it straight away.
+void timer_insert_cancel(benchmark::State& state) {
+  timed_single_thread_context context;
+  auto sched = context.get_scheduler();
+  for (auto _ : state) {
+    sync_wait(stop_when(schedule_after(sched, 1h), just()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Cancels state.range(0) pending timers at once, so the cost includes
+// removing timers from the middle of a populated queue.
+void timer_insert_cancel_many(benchmark::State& state) {
+  timed_single_thread_context context;
+  auto sched = context.get_scheduler();
+  const auto count = static_cast<std::size_t>(state.range(0));
+  using sender_t = decltype(then(
+      schedule_after(sched, std::chrono::milliseconds{}), return_byte{}));
+  std::vector<sender_t> senders;
+  for (auto _ : state) {
+    senders.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+      senders.push_back(then(
+          schedule_after(sched, 1h + std::chrono::milliseconds(i)),
+          return_byte{}));
+    }
+    sync_wait(stop_when(when_all_range(std::move(senders)), just()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(timer_fire)->UseRealTime();
+BENCHMARK(timer_insert_cancel)->UseRealTime();
+BENCHMARK(timer_insert_cancel_many)->Arg(64)->Arg(1024)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -6,3 +6,7 @@
 include(CMakeDependentOption)
 
 option(UNIFEX_BUILD_EXAMPLES "Builds the libunifex examples." ON)
+option(UNIFEX_BUILD_BENCHMARKS
+  "Builds the libunifex benchmarks. Requires Google Benchmark." OFF)
+option(UNIFEX_ENABLE_TRACING
+  "Records trace events in the built-in execution contexts." OFF)
@@ -113,12 +113,12 @@ task<void> handle(io_uring_context::async_read_write_file readWriteFile) {
   if (req.method != Method::GET) {
     auto rsp = not_allowed;
     std::printf("writing=%s\n", rsp.data());
-    co_await async_write_some_at(
+    co_await async_write_all_at(
         readWriteFile, 0, as_bytes(span{rsp.data(), rsp.size()}));
   } else if (req.body.empty()) {
     auto rsp = index;
     std::printf("writing=%s\n", rsp.data());
-    co_await async_write_some_at(
+    co_await async_write_all_at(
         readWriteFile, 0, as_bytes(span{rsp.data(), rsp.size()}));
   } else {
     std::printf("unhandled request\n");
@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/any_scheduler.hpp>
+#include <unifex/await_transform.hpp>
+#include <unifex/blocking.hpp>
+#include <unifex/coroutine.hpp>
+#include <unifex/coroutine_concepts.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/just_done.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/with_scheduler_affinity.hpp>
+
+#if UNIFEX_NO_COROUTINES
+#  error "Coroutine support is required to use this header"
+#endif
+
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _gen {
+
+template <typename T>
+struct _generator final {
+  /**
+   * The "public facing" async_generator<> type.
+   */
+  struct type;
+};
+
+template <typename T>
+struct _promise final {
+  struct type;
+};
+
+/**
+ * Whoever is currently waiting on the generator's next element; either a
+ * next() operation connected to a receiver or a coroutine co_awaiting next().
+ *
+ * The generator calls complete_ once it has yielded, returned, thrown, or been
+ * cancelled; the result is the coroutine to resume by symmetric transfer.
+ */
+struct _consumer_base {
+  coro::coroutine_handle<> (*complete_)(_consumer_base*) noexcept;
+};
+
+/**
+ * The parts of an async_generator<T>'s promise that don't depend on T.
+ */
+struct _promise_base {
+  /**
+   * Generators are lazy; nothing runs until the first next() is started.
+   */
+  coro::suspend_always initial_suspend() noexcept { return {}; }
+
+  void return_void() noexcept {}
+
+  void unhandled_exception() noexcept {
+    exception_ = std::current_exception();
+  }
+
+  // invoked when an awaited sender completes with done; the generator stops
+  // producing and its current consumer observes the end of the stream
+  coro::coroutine_handle<> unhandled_done() noexcept {
+    finished_ = true;
+    return consumer_->complete_(consumer_);
+  }
+
+  friend any_scheduler
+  tag_invoke(tag_t<get_scheduler>, const _promise_base& p) noexcept {
+    return p.sched_;
+  }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const _promise_base& p) noexcept {
+    return p.stoken_;
+  }
+
+  // has the generator run to completion (or been cancelled)?
+  bool finished() const noexcept { return finished_; }
+
+  // returns the exception thrown by the generator body, if any, and clears it
+  std::exception_ptr take_exception() noexcept {
+    return std::exchange(exception_, nullptr);
+  }
+
+  inline static constexpr inline_scheduler _default_scheduler{};
+
+  // the consumer waiting on the generator's next element
+  _consumer_base* consumer_ = nullptr;
+  // the scheduler the current consumer expects the generator to run on
+  any_scheduler sched_{_default_scheduler};
+  // the current consumer's stop token
+  inplace_stop_token stoken_;
+  // an exception that escaped the generator body
+  std::exception_ptr exception_;
+  bool finished_ = false;
+};
+
+template <typename T>
+struct _promise<T>::type final : _promise_base {
+  using value_type = remove_cvref_t<T>;
+  using reference = std::conditional_t<std::is_reference_v<T>, T, T&&>;
+  using pointer = std::add_pointer_t<reference>;
+
+  typename _generator<T>::type get_return_object() noexcept {
+    return typename _generator<T>::type{
+        coro::coroutine_handle<type>::from_promise(*this)};
+  }
+
+  auto final_suspend() noexcept {
+    struct awaiter final {
+      bool await_ready() noexcept { return false; }
+
+      coro::coroutine_handle<>
+      await_suspend(coro::coroutine_handle<type> h) noexcept {
+        auto& p = h.promise();
+        p.value_ = nullptr;
+        p.finished_ = true;
+        return p.consumer_->complete_(p.consumer_);
+      }
+
+      void await_resume() noexcept {}
+    };
+    return awaiter{};
+  }
+
+  static coro::coroutine_handle<> _yield(type& p, pointer value) noexcept {
+    // NOTE: the consumer may synchronously resume or even destroy this
+    //       coroutine from within complete_ so don't touch the promise or the
+    //       awaiter after calling it
+    p.value_ = value;
+    return p.consumer_->complete_(p.consumer_);
+  }
+
+  struct yield_awaiter {
+    bool await_ready() noexcept { return false; }
+
+    coro::coroutine_handle<>
+    await_suspend(coro::coroutine_handle<type> h) noexcept {
+      return _yield(h.promise(), value_);
+    }
+
+    void await_resume() noexcept {}
+
+    pointer value_;
+  };
+
+  // yielded rvalues (and everything yielded from an async_generator<T&>) are
+  // handed to the consumer by reference; they live in the coroutine frame until
+  // the generator is resumed
+  yield_awaiter yield_value(reference value) noexcept {
+    return yield_awaiter{std::addressof(value)};
+  }
+
+  struct copy_yield_awaiter {
+    bool await_ready() noexcept { return false; }
+
+    coro::coroutine_handle<>
+    await_suspend(coro::coroutine_handle<type> h) noexcept {
+      return _yield(h.promise(), std::addressof(copy_));
+    }
+
+    void await_resume() noexcept {}
+
+    value_type copy_;
+  };
+
+  // yielding an lvalue from an async_generator<T> copies it into the awaiter,
+  // which lives in the frame, so the consumer can take ownership without
+  // disturbing the original
+  template(typename Value = value_type)                                //
+      (requires(!std::is_reference_v<T>) AND copy_constructible<Value>)  //
+      copy_yield_awaiter yield_value(const value_type& value) noexcept(
+          std::is_nothrow_copy_constructible_v<value_type>) {
+    return copy_yield_awaiter{value};
+  }
+
+  template <typename Value>
+  decltype(auto) await_transform(Value&& value) {
+    if constexpr (unifex::sender<Value>) {
+      return unifex::await_transform(
+          *this,
+          with_scheduler_affinity(static_cast<Value&&>(value), this->sched_));
+    } else if constexpr (
+        tag_invocable<tag_t<unifex::await_transform>, type&, Value> ||
+        detail::_awaitable<Value>) {
+      return with_scheduler_affinity(
+          *this,
+          unifex::await_transform(*this, static_cast<Value&&>(value)),
+          this->sched_);
+    } else {
+      return (Value &&) value;
+    }
+  }
+
+  // the most recently yielded value; cleared once the consumer has taken it
+  pointer value_ = nullptr;
+};
+
+template <typename T, typename Receiver>
+struct _next_op final {
+  struct type;
+};
+
+/**
+ * The operation state for next(generator) connected to a receiver.
+ */
+template <typename T, typename Receiver>
+struct _next_op<T, Receiver>::type final : _consumer_base {
+  using promise_type = typename _promise<T>::type;
+  using reference = typename promise_type::reference;
+
+  template <typename Receiver2>
+  explicit type(
+      coro::coroutine_handle<promise_type> coro,
+      any_scheduler sched,
+      Receiver2&& receiver) noexcept(std::
+                                         is_nothrow_constructible_v<
+                                             Receiver,
+                                             Receiver2>)
+    : _consumer_base{&complete}
+    , coro_(coro)
+    , sched_(std::move(sched))
+    , receiver_(static_cast<Receiver2&&>(receiver)) {}
+
+  type(type&&) = delete;
+
+  friend void tag_invoke(tag_t<start>, type& op) noexcept {
+    auto& p = op.coro_.promise();
+    if (p.finished()) {
+      unifex::set_done(std::move(op.receiver_));
+      return;
+    }
+
+    p.consumer_ = &op;
+    p.sched_ = op.sched_;
+    p.stoken_ = op.stopTokenAdapter_.subscribe(get_stop_token(op.receiver_));
+
+    op.coro_.resume();
+  }
+
+private:
+  static coro::coroutine_handle<> complete(_consumer_base* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    auto& p = op.coro_.promise();
+
+    op.stopTokenAdapter_.unsubscribe();
+    p.stoken_ = inplace_stop_token{};
+
+    if (p.value_ != nullptr) {
+      auto* value = std::exchange(p.value_, nullptr);
+      UNIFEX_TRY {
+        unifex::set_value(
+            std::move(op.receiver_), static_cast<reference>(*value));
+      }
+      UNIFEX_CATCH(...) {
+        unifex::set_error(std::move(op.receiver_), std::current_exception());
+      }
+    } else if (auto ex = p.take_exception()) {
+      unifex::set_error(std::move(op.receiver_), std::move(ex));
+    } else {
+      unifex::set_done(std::move(op.receiver_));
+    }
+
+    return coro::noop_coroutine();
+  }
+
+  coro::coroutine_handle<promise_type> coro_;
+  any_scheduler sched_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  UNIFEX_NO_UNIQUE_ADDRESS
+  detail::inplace_stop_token_adapter_subscription<stop_token_type_t<Receiver>>
+      stopTokenAdapter_;
+};
+
+template <typename T, typename OtherPromise>
+struct _next_awaiter final {
+  struct type;
+};
+
+/**
+ * The awaitable for co_await next(generator) from a scheduler-affine coroutine
+ * (e.g. a task<>).  Control passes between the two coroutines by symmetric
+ * transfer so there's no stack growth and no per-element operation state.
+ */
+template <typename T, typename OtherPromise>
+struct _next_awaiter<T, OtherPromise>::type final : _consumer_base {
+  using promise_type = typename _promise<T>::type;
+  using reference = typename promise_type::reference;
+
+  explicit type(
+      coro::coroutine_handle<promise_type> coro, any_scheduler sched) noexcept
+    : _consumer_base{&complete}
+    , coro_(coro)
+    , sched_(std::move(sched)) {}
+
+  bool await_ready() noexcept { return false; }
+
+  coro::coroutine_handle<>
+  await_suspend(coro::coroutine_handle<OtherPromise> h) noexcept {
+    auto& p = coro_.promise();
+    continuation_ = h;
+
+    if (p.finished()) {
+      return h.promise().unhandled_done();
+    }
+
+    p.consumer_ = this;
+    p.sched_ = sched_;
+    p.stoken_ = stopTokenAdapter_.subscribe(get_stop_token(h.promise()));
+
+    return coro_;
+  }
+
+  reference await_resume() {
+    auto& p = coro_.promise();
+    if (auto ex = p.take_exception()) {
+      std::rethrow_exception(std::move(ex));
+    }
+    return static_cast<reference>(*std::exchange(p.value_, nullptr));
+  }
+
+private:
+  static coro::coroutine_handle<> complete(_consumer_base* base) noexcept {
+    auto& self = *static_cast<type*>(base);
+    auto& p = self.coro_.promise();
+
+    self.stopTokenAdapter_.unsubscribe();
+    p.stoken_ = inplace_stop_token{};
+
+    if (p.value_ == nullptr && !p.exception_) {
+      // the generator finished without producing a value
+      return self.continuation_.promise().unhandled_done();
+    }
+
+    return self.continuation_;
+  }
+
+  coro::coroutine_handle<promise_type> coro_;
+  coro::coroutine_handle<OtherPromise> continuation_;
+  any_scheduler sched_;
+  UNIFEX_NO_UNIQUE_ADDRESS detail::inplace_stop_token_adapter_subscription<
+      remove_cvref_t<stop_token_type_t<OtherPromise>>>
+      stopTokenAdapter_;
+};
+
+template <typename T, bool SchedulerAffine>
+struct _next_sender final {
+  struct type;
+};
+
+/**
+ * The sender returned from next(generator).
+ *
+ * The non-affine flavour resumes the generator on whatever context its consumer
+ * starts it on; with_scheduler_affinity() produces the affine flavour, which
+ * additionally records the consumer's scheduler so the generator body returns
+ * to it after every co_await, and which a coroutine consumer awaits directly.
+ */
+template <typename T, bool SchedulerAffine>
+struct _next_sender<T, SchedulerAffine>::type final {
+  using promise_type = typename _promise<T>::type;
+
+  template <
+      template <typename...>
+      class Variant,
+      template <typename...>
+      class Tuple>
+  using value_types = Variant<Tuple<
+      std::conditional_t<std::is_reference_v<T>, T, remove_cvref_t<T>>>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  static constexpr blocking_kind blocking = blocking_kind::maybe;
+
+  static constexpr bool is_always_scheduler_affine = SchedulerAffine;
+
+  explicit type(coro::coroutine_handle<promise_type> coro) noexcept
+    : coro_(coro) {}
+
+  explicit type(
+      coro::coroutine_handle<promise_type> coro, any_scheduler sched) noexcept
+    : coro_(coro)
+    , sched_(std::move(sched)) {}
+
+  template(typename Receiver)  //
+      (requires receiver<Receiver>)
+  friend auto tag_invoke(tag_t<connect>, type&& s, Receiver&& r) noexcept(
+      std::is_nothrow_constructible_v<remove_cvref_t<Receiver>, Receiver>) {
+    using op_t = typename _next_op<T, remove_cvref_t<Receiver>>::type;
+    return op_t{s.coro_, std::move(s.sched_), static_cast<Receiver&&>(r)};
+  }
+
+  template(typename Scheduler)  //
+      (requires scheduler<Scheduler>)
+  friend auto
+  tag_invoke(tag_t<with_scheduler_affinity>, type&& s, Scheduler&& sched) {
+    return typename _next_sender<T, true>::type{
+        s.coro_, any_scheduler{static_cast<Scheduler&&>(sched)}};
+  }
+
+  template(typename Promise, bool Affine = SchedulerAffine)  //
+      (requires Affine)
+  friend auto tag_invoke(tag_t<unifex::await_transform>, Promise&, type&& s) {
+    return typename _next_awaiter<T, Promise>::type{
+        s.coro_, std::move(s.sched_)};
+  }
+
+private:
+  coro::coroutine_handle<promise_type> coro_;
+  any_scheduler sched_{promise_type::_default_scheduler};
+};
+
+/**
+ * A coroutine that asynchronously produces a sequence of values and models the
+ * unifex stream concept: next() returns a sender of the next yielded value (or
+ * done once the coroutine returns) and cleanup() returns a sender that
+ * completes with done.
+ *
+ * Yielded values are passed to the consumer by reference to the object named
+ * in the co_yield expression; they are valid until the consumer requests the
+ * next value.
+ */
+template <typename T>
+struct _generator<T>::type final {
+  using promise_type = typename _promise<T>::type;
+
+  type(type&& other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+
+  type& operator=(type other) noexcept {
+    std::swap(coro_, other.coro_);
+    return *this;
+  }
+
+  ~type() {
+    if (coro_) {
+      coro_.destroy();
+    }
+  }
+
+  friend typename _next_sender<T, false>::type
+  tag_invoke(tag_t<next>, type& g) noexcept {
+    return typename _next_sender<T, false>::type{g.coro_};
+  }
+
+  friend auto tag_invoke(tag_t<cleanup>, type&) noexcept { return just_done(); }
+
+private:
+  friend promise_type;
+
+  explicit type(coro::coroutine_handle<promise_type> coro) noexcept
+    : coro_(coro) {}
+
+  coro::coroutine_handle<promise_type> coro_;
+};
+
+}  // namespace _gen
+
+template <typename T>
+using async_generator = typename _gen::_generator<T>::type;
+
+}  // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
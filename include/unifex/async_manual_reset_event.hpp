@@ -22,6 +22,7 @@
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/scheduler_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
+#include <unifex/then.hpp>
 #include <unifex/type_traits.hpp>
 #include <unifex/unstoppable_token.hpp>
 #include <unifex/with_query_value.hpp>
@@ -82,8 +83,27 @@ struct async_manual_reset_event {
   explicit async_manual_reset_event(bool startSignalled) noexcept
     : state_(startSignalled ? this : nullptr) {}
 
+  // Signals the event, resuming every waiting operation.
+  //
+  // The list of waiters is claimed with a single atomic exchange.  Waiters
+  // whose resumption is an enqueue onto a never-blocking scheduler are resumed
+  // first, inside a submission_batch, so that contexts that batch submissions
+  // (such as static_thread_pool) get their enqueues as one batch; the
+  // remaining waiters are then resumed inline.
   void set() noexcept;
 
+  // Returns a sender that, when started, transitions to sched and then
+  // set()s the event, so that the waiters' resumption runs on sched rather
+  // than on the signalling thread.
+  template(typename Scheduler)  //
+      (requires scheduler<Scheduler>)
+  [[nodiscard]] auto async_set(Scheduler&& sched) noexcept(
+      noexcept(schedule(static_cast<Scheduler&&>(sched)))) {
+    return then(
+        schedule(static_cast<Scheduler&&>(sched)),
+        [this]() noexcept { set(); });
+  }
+
   bool ready() const noexcept {
     return state_.load(std::memory_order_acquire) ==
         static_cast<const void*>(this);
@@ -129,9 +149,15 @@ struct _op_base {
   _op_base* next_;
   void (*setValue_)(_op_base*) noexcept;
   async_manual_reset_event* evt_;
+  // true if set_value() only enqueues the waiter's continuation onto a
+  // never-blocking scheduler and so never runs the continuation inline
+  bool resumesAsync_;
 
-  explicit _op_base(async_manual_reset_event& evt, void (*setValue)(_op_base*) noexcept) noexcept
-    : setValue_(setValue), evt_(&evt) {}
+  explicit _op_base(
+      async_manual_reset_event& evt,
+      void (*setValue)(_op_base*) noexcept,
+      bool resumesAsync) noexcept
+    : setValue_(setValue), evt_(&evt), resumesAsync_(resumesAsync) {}
 
   ~_op_base() = default;
 
@@ -161,7 +187,7 @@ template <typename Receiver>
 struct _operation<Receiver>::type : private _op_base {
   explicit type(async_manual_reset_event& evt, Receiver r)
       noexcept(noexcept(connect_as_unstoppable(std::move(r))))
-    : _op_base(evt, &set_value_impl),
+    : _op_base(evt, &set_value_impl, resumes_async),
       op_(connect_as_unstoppable(std::move(r))) {}
 
   ~type() = default;
@@ -172,6 +198,9 @@ struct _operation<Receiver>::type : private _op_base {
   using _op_base::start;
 
  private:
+  static constexpr bool resumes_async = blocking_kind::never ==
+      sender_traits<schedule_result_t<get_scheduler_result_t<const Receiver&>>>::blocking;
+
   UNIFEX_NO_UNIQUE_ADDRESS decltype(connect_as_unstoppable(std::declval<Receiver>())) op_;
 
   static void set_value_impl(_op_base* base) noexcept {
@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bind_back.hpp>
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _batch_stream {
+
+// batch_stream(stream, n) groups the values of `stream` into std::vectors
+// of n values, so that downstream stages pay for one next() per batch
+// rather than one per value.  The last batch may be shorter.
+//
+// batch_stream(stream, n, scheduler, maxDelay) additionally sends a partial
+// batch once its oldest value has waited `maxDelay`, measured on
+// `scheduler` (deadlines are tracked on std::chrono::steady_clock and
+// waited for with schedule_after()).  The source's next() that was in flight at the time keeps
+// running and its value starts the following batch.
+
+// Without a timer everything a batch_stream does happens in response to the
+// consumer's next() so no locking is needed.
+struct _untimed {};
+
+struct _no_mutex {
+  void lock() noexcept {}
+  void unlock() noexcept {}
+};
+
+template <typename Scheduler, typename Duration>
+struct _timed {
+  using clock_t = std::chrono::steady_clock;
+
+  UNIFEX_NO_UNIQUE_ADDRESS Scheduler sched_;
+  Duration maxDelay_;
+};
+
+template <typename Source, typename Timer>
+struct _stream {
+  struct type;
+};
+template <typename Source, typename Timer>
+using stream = typename _stream<Source, Timer>::type;
+
+template <typename Source, typename Timer>
+struct _source_receiver {
+  struct type;
+};
+template <typename Source, typename Timer>
+struct _source_receiver<Source, Timer>::type {
+  stream<Source, Timer>* stream_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    stream_->on_source_value((Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    stream_->on_source_finished(_as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept { stream_->on_source_finished(nullptr); }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const type& r) noexcept {
+    return r.stream_->stopSource_.get_token();
+  }
+};
+
+template <typename Source, typename Timer>
+struct _timer_receiver {
+  struct type;
+};
+template <typename Source, typename Timer>
+struct _timer_receiver<Source, Timer>::type {
+  stream<Source, Timer>* stream_;
+
+  void set_value() && noexcept { stream_->on_timer(); }
+
+  template <typename Error>
+  void set_error(Error&&) && noexcept {
+    stream_->on_timer();
+  }
+
+  void set_done() && noexcept { stream_->on_timer(); }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const type& r) noexcept {
+    return r.stream_->stopSource_.get_token();
+  }
+};
+
+template <typename Source, typename Timer>
+struct _timer_state {};
+
+template <typename Source, typename Scheduler, typename Duration>
+struct _timer_state<Source, _timed<Scheduler, Duration>> {
+  using clock_t = typename _timed<Scheduler, Duration>::clock_t;
+  using time_point = typename clock_t::time_point;
+  using op_t = connect_result_t<
+      decltype(schedule_after(
+          std::declval<Scheduler&>(), std::declval<typename clock_t::duration>())),
+      typename _timer_receiver<Source, _timed<Scheduler, Duration>>::type>;
+
+  bool active_ = false;
+  // When the oldest value of the current batch must be sent.
+  time_point deadline_{};
+  // The deadline the in-flight timer was armed with.
+  time_point armedDeadline_{};
+  manual_lifetime<op_t> op_;
+};
+
+template <typename Source, typename Timer, typename Receiver>
+struct _next_op {
+  struct type;
+};
+template <typename Source, typename Timer, typename Receiver>
+using next_op =
+    typename _next_op<Source, Timer, remove_cvref_t<Receiver>>::type;
+
+template <typename Source, typename Timer>
+struct _next_sender {
+  struct type;
+};
+
+template <typename Source, typename Timer, typename Receiver>
+struct _cleanup_op {
+  struct type;
+};
+template <typename Source, typename Timer, typename Receiver>
+using cleanup_op =
+    typename _cleanup_op<Source, Timer, remove_cvref_t<Receiver>>::type;
+
+template <typename Source, typename Timer>
+struct _cleanup_sender {
+  struct type;
+};
+
+template <typename Source, typename Timer>
+struct _stream<Source, Timer>::type {
+  static constexpr bool timed = !std::is_same_v<Timer, _untimed>;
+
+  using value_t = remove_cvref_t<
+      sender_single_value_return_type_t<next_sender_t<Source>>>;
+  using batch_t = std::vector<value_t>;
+  using consumer_t = _consumer_base<batch_t>;
+  using source_receiver_t = typename _source_receiver<Source, Timer>::type;
+  using source_op_t = next_operation_t<Source, source_receiver_t>;
+  using mutex_t = std::conditional_t<timed, std::mutex, _no_mutex>;
+
+  template <typename Source2, typename Timer2>
+  explicit type(Source2&& source, std::size_t n, Timer2&& timer)
+    : source_((Source2 &&) source)
+    , n_(n != 0 ? n : 1)
+    , timer_((Timer2 &&) timer) {}
+
+  // Only valid before the first call to next() or cleanup().
+  type(type&& other)
+    : source_(std::move(other.source_))
+    , n_(other.n_)
+    , timer_(std::move(other.timer_)) {}
+
+  friend typename _next_sender<Source, Timer>::type
+  tag_invoke(tag_t<next>, type& s) noexcept {
+    return typename _next_sender<Source, Timer>::type{&s};
+  }
+
+  friend typename _cleanup_sender<Source, Timer>::type
+  tag_invoke(tag_t<cleanup>, type& s) noexcept {
+    return typename _cleanup_sender<Source, Timer>::type{&s};
+  }
+
+  // Consumer side.
+
+  void start_next(consumer_t* consumer) noexcept {
+    bool ready = false;
+    bool pull = false;
+    bool arm = false;
+    {
+      std::lock_guard<mutex_t> lock{mutex_};
+      if (batch_.size() >= n_ || finished_) {
+        take_locked(*consumer);
+        ready = true;
+      } else {
+        waiter_ = consumer;
+        pull = !std::exchange(sourceActive_, true);
+        arm = !batch_.empty() && arm_timer_locked();
+      }
+    }
+    if (ready) {
+      consumer->complete_(consumer);
+      return;
+    }
+    if (arm) {
+      start_timer();
+    }
+    if (pull) {
+      pull_source();
+    }
+  }
+
+  void start_cleanup(_cleanup_base* cleanupOp) noexcept {
+    bool ready = false;
+    {
+      std::lock_guard<mutex_t> lock{mutex_};
+      cleanup_ = cleanupOp;
+      ready = cleanup_ready_locked();
+    }
+    stopSource_.request_stop();
+    if (ready) {
+      cleanup_->start_(cleanup_);
+    }
+  }
+
+  // Producer side.
+
+  template <typename... Values>
+  void on_source_value(Values&&... values) noexcept {
+    consumer_t* ready = nullptr;
+    bool pull = false;
+    bool arm = false;
+    bool cleanup = false;
+    {
+      std::lock_guard<mutex_t> lock{mutex_};
+      // The values may live in the source's operation state so they are
+      // copied into the batch before that operation is destroyed.
+      UNIFEX_TRY {
+        if (batch_.empty()) {
+          batch_.reserve(n_);
+          if constexpr (timed) {
+            timerState_.deadline_ =
+                std::chrono::steady_clock::now() + timer_.maxDelay_;
+          }
+        }
+        batch_.emplace_back((Values &&) values...);
+      }
+      UNIFEX_CATCH(...) {
+        finished_ = true;
+        error_ = std::current_exception();
+      }
+      sourceOp_.destruct();
+      sourceActive_ = false;
+      if (waiter_ != nullptr) {
+        if (batch_.size() >= n_ || finished_) {
+          ready = std::exchange(waiter_, nullptr);
+          take_locked(*ready);
+        } else {
+          sourceActive_ = pull = true;
+          arm = arm_timer_locked();
+        }
+      }
+      cleanup = cleanup_ready_locked();
+    }
+    finish(ready, pull, arm, cleanup);
+  }
+
+  void on_source_finished(
+      std::exception_ptr error, bool connected = true) noexcept {
+    consumer_t* ready = nullptr;
+    bool cleanup = false;
+    {
+      std::lock_guard<mutex_t> lock{mutex_};
+      if (connected) {
+        sourceOp_.destruct();
+      }
+      sourceActive_ = false;
+      finished_ = true;
+      error_ = std::move(error);
+      if (waiter_ != nullptr) {
+        ready = std::exchange(waiter_, nullptr);
+        take_locked(*ready);
+      }
+      cleanup = cleanup_ready_locked();
+    }
+    finish(ready, false, false, cleanup);
+  }
+
+  void on_timer() noexcept {
+    consumer_t* ready = nullptr;
+    bool arm = false;
+    bool cleanup = false;
+    {
+      std::lock_guard<mutex_t> lock{mutex_};
+      timerState_.op_.destruct();
+      timerState_.active_ = false;
+      if (waiter_ != nullptr && !batch_.empty()) {
+        // The timer may have been armed for an earlier batch; only flush
+        // once the current batch's deadline has passed.
+        if (std::chrono::steady_clock::now() >= timerState_.deadline_) {
+          ready = std::exchange(waiter_, nullptr);
+          take_locked(*ready);
+        } else {
+          arm = arm_timer_locked();
+        }
+      }
+      cleanup = cleanup_ready_locked();
+    }
+    finish(ready, false, arm, cleanup);
+  }
+
+  void finish(consumer_t* ready, bool pull, bool arm, bool cleanup) noexcept {
+    if (arm) {
+      start_timer();
+    }
+    if (pull) {
+      pull_source();
+    }
+    if (cleanup) {
+      cleanup_->start_(cleanup_);
+    }
+    if (ready != nullptr) {
+      ready->complete_(ready);
+    }
+  }
+
+  void take_locked(consumer_t& consumer) noexcept {
+    if (!batch_.empty()) {
+      consumer.value_.construct(std::move(batch_));
+      batch_.clear();
+      consumer.outcome_ = _outcome::value;
+    } else if (error_) {
+      consumer.error_ = std::exchange(error_, nullptr);
+      consumer.outcome_ = _outcome::error;
+    } else {
+      consumer.outcome_ = _outcome::done;
+    }
+  }
+
+  bool cleanup_ready_locked() noexcept {
+    bool timerActive = false;
+    if constexpr (timed) {
+      timerActive = timerState_.active_;
+    }
+    if (cleanup_ != nullptr && !cleanupStarted_ && !sourceActive_ &&
+        !timerActive) {
+      cleanupStarted_ = true;
+      return true;
+    }
+    return false;
+  }
+
+  bool arm_timer_locked() noexcept {
+    if constexpr (timed) {
+      if (!timerState_.active_ && !stopSource_.stop_requested()) {
+        timerState_.active_ = true;
+        timerState_.armedDeadline_ = timerState_.deadline_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void start_timer() noexcept {
+    if constexpr (timed) {
+      UNIFEX_TRY {
+        timerState_.op_.construct_with([&] {
+          return unifex::connect(
+              schedule_after(
+                  timer_.sched_,
+                  timerState_.armedDeadline_ - std::chrono::steady_clock::now()),
+              typename _timer_receiver<Source, Timer>::type{this});
+        });
+      }
+      UNIFEX_CATCH(...) {
+        // Without a timer the batch is still sent once it is full.
+        bool cleanup = false;
+        {
+          std::lock_guard<mutex_t> lock{mutex_};
+          timerState_.active_ = false;
+          cleanup = cleanup_ready_locked();
+        }
+        if (cleanup) {
+          cleanup_->start_(cleanup_);
+        }
+        return;
+      }
+      unifex::start(timerState_.op_.get());
+    }
+  }
+
+  // Starts the source's next(); a source that completes inline doesn't
+  // recurse, the outermost call loops instead.
+  void pull_source() noexcept {
+    if (pulls_.fetch_add(1, std::memory_order_acq_rel) != 0) {
+      return;
+    }
+    do {
+      bool connected = false;
+      UNIFEX_TRY {
+        sourceOp_.construct_with([&] {
+          return unifex::connect(next(source_), source_receiver_t{this});
+        });
+        connected = true;
+      }
+      UNIFEX_CATCH(...) {
+        on_source_finished(std::current_exception(), false);
+      }
+      if (connected) {
+        unifex::start(sourceOp_.get());
+      }
+    } while (pulls_.fetch_sub(1, std::memory_order_acq_rel) != 1);
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Source source_;
+  std::size_t n_;
+  UNIFEX_NO_UNIQUE_ADDRESS Timer timer_;
+  UNIFEX_NO_UNIQUE_ADDRESS mutex_t mutex_;
+  batch_t batch_;
+  bool sourceActive_ = false;
+  bool finished_ = false;
+  bool cleanupStarted_ = false;
+  consumer_t* waiter_ = nullptr;
+  _cleanup_base* cleanup_ = nullptr;
+  std::exception_ptr error_;
+  std::atomic<int> pulls_{0};
+  inplace_stop_source stopSource_;
+  manual_lifetime<source_op_t> sourceOp_;
+  UNIFEX_NO_UNIQUE_ADDRESS _timer_state<Source, Timer> timerState_;
+};
+
+template <typename Source, typename Timer, typename Receiver>
+struct _next_op<Source, Timer, Receiver>::type
+  : _consumer_base<typename stream<Source, Timer>::batch_t> {
+  using stream_t = stream<Source, Timer>;
+  using base_t = _consumer_base<typename stream_t::batch_t>;
+
+  struct cancel_callback {
+    stream_t* stream_;
+    void operator()() noexcept { stream_->stopSource_.request_stop(); }
+  };
+
+  using stop_token_t = stop_token_type_t<Receiver>;
+  using stop_callback_t =
+      typename stop_token_t::template callback_type<cancel_callback>;
+
+  template <typename Receiver2>
+  explicit type(stream_t* s, Receiver2&& r)
+    : base_t{&complete_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    // Cancelling next() cancels the whole stream: the in-flight next() on
+    // the source completes and this operation completes with it.
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{stream_});
+    }
+    stream_->start_next(this);
+  }
+
+private:
+  static void complete_impl(base_t* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      op.stopCallback_.destruct();
+    }
+    switch (op.outcome_) {
+      case _outcome::value: {
+        auto batch = std::move(op.value_.get());
+        op.value_.destruct();
+        unifex::set_value(std::move(op.receiver_), std::move(batch));
+        break;
+      }
+      case _outcome::error:
+        unifex::set_error(std::move(op.receiver_), std::move(op.error_));
+        break;
+      case _outcome::done:
+        unifex::set_done(std::move(op.receiver_));
+        break;
+    }
+  }
+
+  stream_t* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<stop_callback_t> stopCallback_;
+};
+
+template <typename Source, typename Timer>
+struct _next_sender<Source, Timer>::type {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<typename stream<Source, Timer>::batch_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend next_op<Source, Timer, Receiver>
+  tag_invoke(tag_t<connect>, type&& s, Receiver&& r) {
+    return next_op<Source, Timer, Receiver>{s.stream_, (Receiver &&) r};
+  }
+
+  stream<Source, Timer>* stream_;
+};
+
+template <typename Source, typename Timer, typename Receiver>
+struct _cleanup_op<Source, Timer, Receiver>::type : _cleanup_base {
+  using stream_t = stream<Source, Timer>;
+
+  struct source_receiver {
+    type* op_;
+
+    void set_value() && noexcept {
+      op_->complete(nullptr);
+    }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->complete(_as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept { op_->complete(nullptr); }
+  };
+
+  using source_op_t = cleanup_operation_t<Source, source_receiver>;
+
+  template <typename Receiver2>
+  explicit type(stream_t* s, Receiver2&& r)
+    : _cleanup_base{&start_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept { stream_->start_cleanup(this); }
+
+  // Called once the source has no next() or timer in flight.
+  static void start_impl(_cleanup_base* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    UNIFEX_TRY {
+      op.sourceOp_.construct_with([&] {
+        return unifex::connect(
+            cleanup(op.stream_->source_), source_receiver{&op});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      op.complete_with(std::current_exception());
+      return;
+    }
+    unifex::start(op.sourceOp_.get());
+  }
+
+  void complete(std::exception_ptr error) noexcept {
+    sourceOp_.destruct();
+    complete_with(std::move(error));
+  }
+
+  void complete_with(std::exception_ptr error) noexcept {
+    stream_->batch_.clear();
+    if (error) {
+      unifex::set_error(std::move(receiver_), std::move(error));
+    } else {
+      unifex::set_done(std::move(receiver_));
+    }
+  }
+
+  stream_t* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  manual_lifetime<source_op_t> sourceOp_;
+};
+
+template <typename Source, typename Timer>
+struct _cleanup_sender<Source, Timer>::type {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend cleanup_op<Source, Timer, Receiver>
+  tag_invoke(tag_t<connect>, type&& s, Receiver&& r) {
+    return cleanup_op<Source, Timer, Receiver>{s.stream_, (Receiver &&) r};
+  }
+
+  stream<Source, Timer>* stream_;
+};
+
+struct _fn {
+  template <typename Source>
+  auto operator()(Source&& source, std::size_t n) const
+      -> stream<remove_cvref_t<Source>, _untimed> {
+    return stream<remove_cvref_t<Source>, _untimed>{
+        (Source &&) source, n, _untimed{}};
+  }
+
+  template(typename Source, typename Scheduler, typename Duration)
+      (requires scheduler<Scheduler>)
+  auto operator()(
+      Source&& source,
+      std::size_t n,
+      Scheduler&& sched,
+      Duration&& maxDelay) const
+      -> stream<
+          remove_cvref_t<Source>,
+          _timed<remove_cvref_t<Scheduler>, remove_cvref_t<Duration>>> {
+    using timer_t =
+        _timed<remove_cvref_t<Scheduler>, remove_cvref_t<Duration>>;
+    return stream<remove_cvref_t<Source>, timer_t>{
+        (Source &&) source,
+        n,
+        timer_t{(Scheduler &&) sched, (Duration &&) maxDelay}};
+  }
+
+  constexpr auto operator()(std::size_t n) const
+      noexcept(is_nothrow_callable_v<tag_t<bind_back>, _fn, std::size_t>)
+      -> bind_back_result_t<_fn, std::size_t> {
+    return bind_back(*this, n);
+  }
+
+  template(typename Scheduler, typename Duration)
+      (requires scheduler<Scheduler>)
+  constexpr auto operator()(
+      std::size_t n, Scheduler&& sched, Duration&& maxDelay) const
+      noexcept(is_nothrow_callable_v<
+        tag_t<bind_back>, _fn, std::size_t, Scheduler, Duration>)
+      -> bind_back_result_t<_fn, std::size_t, Scheduler, Duration> {
+    return bind_back(
+        *this, n, (Scheduler &&) sched, (Duration &&) maxDelay);
+  }
+};
+} // namespace _batch_stream
+
+inline constexpr _batch_stream::_fn batch_stream {};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
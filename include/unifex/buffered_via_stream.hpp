@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bind_back.hpp>
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _buffered_via_stream {
+
+// buffered_via_stream(stream, scheduler, capacity) eagerly pulls up to
+// `capacity` values from `stream` into a single-producer/single-consumer
+// ring and delivers each of them to the consumer on `scheduler`.
+//
+// The producer is the chain of next() operations on the source stream; it
+// runs on whatever context the source completes on and parks itself when
+// the ring is full.  The consumer is the sequence of next() operations on
+// this stream.  Neither side takes a lock: ownership of the two hand-offs
+// (the parked producer, the waiting consumer) is transferred with a single
+// atomic exchange/compare-exchange after a store/load pair on both sides.
+
+// A consumer waiting on an empty ring.
+struct _waiter_base {
+  void (*wake_)(_waiter_base*) noexcept;
+};
+
+enum class _producer_state : unsigned char {
+  // A next() on the source stream is in flight.
+  running,
+  // Idle, either not started yet or waiting for the consumer to free a slot.
+  parked,
+  // The source stream completed with done or error.
+  finished,
+  // The source stream's cleanup() has been claimed.
+  stopped
+};
+
+template <typename Stream, typename Scheduler>
+struct _stream {
+  struct type;
+};
+template <typename Stream, typename Scheduler>
+using stream = typename _stream<Stream, Scheduler>::type;
+
+template <typename Stream, typename Scheduler>
+struct _producer_receiver {
+  struct type;
+};
+template <typename Stream, typename Scheduler>
+using producer_receiver =
+    typename _producer_receiver<Stream, Scheduler>::type;
+
+template <typename Stream, typename Scheduler>
+struct _producer_receiver<Stream, Scheduler>::type {
+  stream<Stream, Scheduler>* stream_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    stream_->on_value((Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    stream_->on_finished(_as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept { stream_->on_finished(nullptr); }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const type& r) noexcept {
+    return r.stream_->producerStop_.get_token();
+  }
+};
+
+template <typename Stream, typename Scheduler, typename Receiver>
+struct _next_op {
+  struct type;
+};
+template <typename Stream, typename Scheduler, typename Receiver>
+using next_op =
+    typename _next_op<Stream, Scheduler, remove_cvref_t<Receiver>>::type;
+
+template <typename Stream, typename Scheduler>
+struct _next_sender {
+  struct type;
+};
+template <typename Stream, typename Scheduler>
+using next_sender = typename _next_sender<Stream, Scheduler>::type;
+
+template <typename Stream, typename Scheduler, typename Receiver>
+struct _cleanup_op {
+  struct type;
+};
+template <typename Stream, typename Scheduler, typename Receiver>
+using cleanup_op =
+    typename _cleanup_op<Stream, Scheduler, remove_cvref_t<Receiver>>::type;
+
+template <typename Stream, typename Scheduler>
+struct _cleanup_sender {
+  struct type;
+};
+template <typename Stream, typename Scheduler>
+using cleanup_sender = typename _cleanup_sender<Stream, Scheduler>::type;
+
+template <typename Stream, typename Scheduler>
+struct _stream<Stream, Scheduler>::type {
+  // The ring stores each value as a decayed std::tuple so the source stream
+  // must send a single overload of values (or none at all).
+  using value_tuple = _value_tuple_t<next_sender_t<Stream>>;
+
+  template <typename Stream2, typename Scheduler2>
+  explicit type(Stream2&& stream, Scheduler2&& sched, std::size_t capacity)
+    : stream_((Stream2 &&) stream)
+    , sched_((Scheduler2 &&) sched)
+    , capacity_(capacity != 0 ? capacity : 1)
+    , ring_(new manual_lifetime<value_tuple>[capacity_]) {}
+
+  // Only valid before the first call to next() or cleanup().
+  type(type&& other)
+    : stream_(std::move(other.stream_))
+    , sched_(std::move(other.sched_))
+    , capacity_(other.capacity_)
+    , ring_(std::move(other.ring_)) {
+    UNIFEX_ASSERT(
+        other.producerState_.load(std::memory_order_relaxed) ==
+        _producer_state::parked);
+  }
+
+  ~type() { destroy_buffered_values(); }
+
+  friend next_sender<Stream, Scheduler>
+  tag_invoke(tag_t<next>, type& s) noexcept {
+    return next_sender<Stream, Scheduler>{&s};
+  }
+
+  friend cleanup_sender<Stream, Scheduler>
+  tag_invoke(tag_t<cleanup>, type& s) noexcept {
+    return cleanup_sender<Stream, Scheduler>{&s};
+  }
+
+  using producer_op_t =
+      next_operation_t<Stream, producer_receiver<Stream, Scheduler>>;
+
+  // Producer side.
+
+  void produce_next() noexcept {
+    UNIFEX_TRY {
+      producerOp_.construct_with([&] {
+        return unifex::connect(
+            next(stream_), producer_receiver<Stream, Scheduler>{this});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      on_finished(std::current_exception());
+      return;
+    }
+    unifex::start(producerOp_.get());
+  }
+
+  template <typename... Values>
+  void on_value(Values&&... values) noexcept {
+    // The values may live in the producer's operation state so they are
+    // copied into the ring before that operation is destroyed.
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    UNIFEX_TRY {
+      ring_[tail % capacity_].construct((Values &&) values...);
+    }
+    UNIFEX_CATCH(...) {
+      producerOp_.destruct();
+      on_finished(std::current_exception());
+      return;
+    }
+    producerOp_.destruct();
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    wake_consumer();
+
+    if (!cleanupRequested_.load(std::memory_order_seq_cst) &&
+        tail + 1 - head_.load(std::memory_order_seq_cst) < capacity_) {
+      produce_next();
+    } else {
+      park();
+    }
+  }
+
+  void on_finished(std::exception_ptr error) noexcept {
+    error_ = std::move(error);
+    producerState_.store(_producer_state::finished, std::memory_order_seq_cst);
+    wake_consumer();
+    if (cleanupRequested_.load(std::memory_order_seq_cst)) {
+      try_start_cleanup();
+    }
+  }
+
+  void park() noexcept {
+    producerState_.store(_producer_state::parked, std::memory_order_seq_cst);
+    if (cleanupRequested_.load(std::memory_order_seq_cst)) {
+      try_start_cleanup();
+    } else if (has_free_slot()) {
+      // The consumer freed a slot before it could see us parked; whoever
+      // wins the compare-exchange resumes production.
+      resume_producer();
+    }
+  }
+
+  void wake_consumer() noexcept {
+    if (waiter_.load(std::memory_order_seq_cst) != nullptr) {
+      if (auto* waiter = waiter_.exchange(nullptr, std::memory_order_acq_rel)) {
+        waiter->wake_(waiter);
+      }
+    }
+  }
+
+  // Consumer side.
+
+  bool has_free_slot() const noexcept {
+    return tail_.load(std::memory_order_seq_cst) -
+        head_.load(std::memory_order_seq_cst) <
+        capacity_;
+  }
+
+  void resume_producer() noexcept {
+    auto expected = _producer_state::parked;
+    if (producerState_.compare_exchange_strong(
+            expected, _producer_state::running, std::memory_order_acq_rel)) {
+      produce_next();
+    }
+  }
+
+  void unpark_producer() noexcept {
+    if (producerState_.load(std::memory_order_seq_cst) ==
+            _producer_state::parked &&
+        has_free_slot()) {
+      resume_producer();
+    }
+  }
+
+  bool ready() const noexcept {
+    return producerState_.load(std::memory_order_seq_cst) ==
+        _producer_state::finished ||
+        head_.load(std::memory_order_relaxed) !=
+        tail_.load(std::memory_order_seq_cst);
+  }
+
+  // Cleanup side.
+
+  void try_start_cleanup() noexcept {
+    auto state = producerState_.load(std::memory_order_seq_cst);
+    while (state == _producer_state::parked ||
+           state == _producer_state::finished) {
+      if (producerState_.compare_exchange_weak(
+              state, _producer_state::stopped, std::memory_order_acq_rel)) {
+        cleanup_->start_(cleanup_);
+        return;
+      }
+    }
+  }
+
+  void destroy_buffered_values() noexcept {
+    if (!ring_) {
+      return;
+    }
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    for (std::size_t head = head_.load(std::memory_order_relaxed);
+         head != tail;
+         ++head) {
+      ring_[head % capacity_].destruct();
+    }
+    head_.store(tail, std::memory_order_relaxed);
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Stream stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Scheduler sched_;
+  std::size_t capacity_;
+  std::unique_ptr<manual_lifetime<value_tuple>[]> ring_;
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+  std::atomic<_producer_state> producerState_{_producer_state::parked};
+  std::atomic<_waiter_base*> waiter_{nullptr};
+  std::atomic<bool> cleanupRequested_{false};
+  _cleanup_base* cleanup_ = nullptr;
+  std::exception_ptr error_;
+  inplace_stop_source producerStop_;
+  manual_lifetime<producer_op_t> producerOp_;
+};
+
+template <typename Stream, typename Scheduler, typename Receiver>
+struct _next_op<Stream, Scheduler, Receiver>::type
+  : _waiter_base
+  , _stored_completion<typename stream<Stream, Scheduler>::value_tuple> {
+  using stream_t = stream<Stream, Scheduler>;
+  using value_tuple = typename stream_t::value_tuple;
+
+  struct cancel_callback {
+    type* op_;
+    void operator()() noexcept { op_->cancel(); }
+  };
+
+  struct deliver_receiver {
+    type* op_;
+
+    void set_value() && noexcept { op_->deliver(); }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->deliver_error(_as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept { op_->deliver_done(); }
+  };
+
+  using stop_token_t = stop_token_type_t<Receiver>;
+  using stop_callback_t =
+      typename stop_token_t::template callback_type<cancel_callback>;
+  using schedule_op_t =
+      connect_result_t<schedule_result_t<Scheduler&>, deliver_receiver>;
+
+  template <typename Receiver2>
+  explicit type(stream_t* s, Receiver2&& r)
+    : _waiter_base{&wake_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    stream_->unpark_producer();
+    if (try_take()) {
+      schedule_delivery();
+      return;
+    }
+
+    stream_->waiter_.store(this, std::memory_order_seq_cst);
+    if (stream_->ready()) {
+      _waiter_base* self = this;
+      if (stream_->waiter_.compare_exchange_strong(
+              self, nullptr, std::memory_order_acq_rel)) {
+        finish_waiting();
+        finish_waiting();
+        return;
+      }
+    }
+
+    // Register for cancellation only after publishing ourselves as the
+    // waiter so that a stop request can always find us; the last of
+    // "registered" and "woken" goes on to complete.
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{this});
+      hasCallback_ = true;
+    }
+    finish_waiting();
+  }
+
+private:
+  static void wake_impl(_waiter_base* base) noexcept {
+    static_cast<type*>(base)->finish_waiting();
+  }
+
+  void cancel() noexcept {
+    _waiter_base* self = this;
+    if (stream_->waiter_.compare_exchange_strong(
+            self, nullptr, std::memory_order_acq_rel)) {
+      // Cancelling next() cancels the whole stream.
+      cancelled_ = true;
+      stream_->producerStop_.request_stop();
+      finish_waiting();
+    }
+  }
+
+  void finish_waiting() noexcept {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (cancelled_) {
+        this->outcome_ = _outcome::done;
+      } else {
+        [[maybe_unused]] const bool taken = try_take();
+        UNIFEX_ASSERT(taken);
+      }
+      schedule_delivery();
+    }
+  }
+
+  bool try_take() noexcept {
+    // Read the producer state before the tail: a finished producer has
+    // published all of its values.
+    const bool finished = stream_->producerState_.load(
+                              std::memory_order_seq_cst) ==
+        _producer_state::finished;
+    const std::size_t head = stream_->head_.load(std::memory_order_relaxed);
+    if (head != stream_->tail_.load(std::memory_order_seq_cst)) {
+      auto& slot = stream_->ring_[head % stream_->capacity_];
+      UNIFEX_TRY {
+        this->value_.construct(std::move(slot.get()));
+        this->outcome_ = _outcome::value;
+      }
+      UNIFEX_CATCH(...) {
+        this->error_ = std::current_exception();
+        this->outcome_ = _outcome::error;
+      }
+      slot.destruct();
+      stream_->head_.store(head + 1, std::memory_order_seq_cst);
+      stream_->unpark_producer();
+      return true;
+    }
+    if (finished) {
+      if (stream_->error_) {
+        this->error_ = stream_->error_;
+        this->outcome_ = _outcome::error;
+      } else {
+        this->outcome_ = _outcome::done;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  void schedule_delivery() noexcept {
+    UNIFEX_TRY {
+      scheduleOp_.construct_with([&] {
+        return unifex::connect(
+            schedule(stream_->sched_), deliver_receiver{this});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      deliver_error(std::current_exception());
+      return;
+    }
+    scheduled_ = true;
+    unifex::start(scheduleOp_.get());
+  }
+
+  void reset() noexcept {
+    if (scheduled_) {
+      scheduleOp_.destruct();
+    }
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      if (hasCallback_) {
+        stopCallback_.destruct();
+      }
+    }
+  }
+
+  void deliver() noexcept {
+    reset();
+    _deliver(std::move(receiver_), *this);
+  }
+
+  void deliver_error(std::exception_ptr error) noexcept {
+    reset();
+    if (this->outcome_ == _outcome::value) {
+      this->value_.destruct();
+    }
+    unifex::set_error(std::move(receiver_), std::move(error));
+  }
+
+  void deliver_done() noexcept {
+    reset();
+    if (this->outcome_ == _outcome::value) {
+      this->value_.destruct();
+    }
+    unifex::set_done(std::move(receiver_));
+  }
+
+  stream_t* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  std::atomic<unsigned char> pending_{2};
+  bool cancelled_ = false;
+  bool hasCallback_ = false;
+  bool scheduled_ = false;
+  manual_lifetime<stop_callback_t> stopCallback_;
+  manual_lifetime<schedule_op_t> scheduleOp_;
+};
+
+template <typename Stream, typename Scheduler>
+struct _next_sender<Stream, Scheduler>::type {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = sender_value_types_t<
+      next_sender_t<Stream>,
+      Variant,
+      decayed_tuple<Tuple>::template apply>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend next_op<Stream, Scheduler, Receiver>
+  tag_invoke(tag_t<connect>, type&& s, Receiver&& r) {
+    return next_op<Stream, Scheduler, Receiver>{s.stream_, (Receiver &&) r};
+  }
+
+  stream<Stream, Scheduler>* stream_;
+};
+
+template <typename Stream, typename Scheduler, typename Receiver>
+struct _cleanup_op<Stream, Scheduler, Receiver>::type : _cleanup_base {
+  using stream_t = stream<Stream, Scheduler>;
+
+  struct source_receiver {
+    type* op_;
+
+    void set_value() && noexcept { op_->source_cleaned_up(nullptr); }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->source_cleaned_up(_as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept { op_->source_cleaned_up(nullptr); }
+  };
+
+  struct deliver_receiver {
+    type* op_;
+
+    void set_value() && noexcept { op_->deliver(std::move(op_->error_)); }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->deliver(_as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept { op_->deliver(std::move(op_->error_)); }
+  };
+
+  using source_op_t = cleanup_operation_t<Stream, source_receiver>;
+  using schedule_op_t =
+      connect_result_t<schedule_result_t<Scheduler&>, deliver_receiver>;
+
+  template <typename Receiver2>
+  explicit type(stream_t* s, Receiver2&& r)
+    : _cleanup_base{&start_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    stream_->cleanup_ = this;
+    stream_->producerStop_.request_stop();
+    stream_->cleanupRequested_.store(true, std::memory_order_seq_cst);
+    stream_->try_start_cleanup();
+  }
+
+private:
+  static void start_impl(_cleanup_base* base) noexcept {
+    auto* op = static_cast<type*>(base);
+    UNIFEX_TRY {
+      op->sourceOp_.construct_with([&] {
+        return unifex::connect(
+            cleanup(op->stream_->stream_), source_receiver{op});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      op->source_cleaned_up(std::current_exception());
+      return;
+    }
+    op->started_ = true;
+    unifex::start(op->sourceOp_.get());
+  }
+
+  void source_cleaned_up(std::exception_ptr error) noexcept {
+    if (started_) {
+      sourceOp_.destruct();
+      started_ = false;
+    }
+    stream_->destroy_buffered_values();
+    error_ = std::move(error);
+    UNIFEX_TRY {
+      scheduleOp_.construct_with([&] {
+        return unifex::connect(
+            schedule(stream_->sched_), deliver_receiver{this});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      deliver(std::current_exception());
+      return;
+    }
+    started_ = true;
+    unifex::start(scheduleOp_.get());
+  }
+
+  void deliver(std::exception_ptr error) noexcept {
+    if (started_) {
+      scheduleOp_.destruct();
+    }
+    if (error) {
+      unifex::set_error(std::move(receiver_), std::move(error));
+    } else {
+      unifex::set_done(std::move(receiver_));
+    }
+  }
+
+  stream_t* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  std::exception_ptr error_;
+  // Whether sourceOp_, and later scheduleOp_, is constructed.
+  bool started_ = false;
+  manual_lifetime<source_op_t> sourceOp_;
+  manual_lifetime<schedule_op_t> scheduleOp_;
+};
+
+template <typename Stream, typename Scheduler>
+struct _cleanup_sender<Stream, Scheduler>::type {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend cleanup_op<Stream, Scheduler, Receiver>
+  tag_invoke(tag_t<connect>, type&& s, Receiver&& r) {
+    return cleanup_op<Stream, Scheduler, Receiver>{
+        s.stream_, (Receiver &&) r};
+  }
+
+  stream<Stream, Scheduler>* stream_;
+};
+
+struct _fn {
+  template(typename Stream, typename Scheduler)
+      (requires scheduler<Scheduler>)
+  auto operator()(Stream&& s, Scheduler&& sched, std::size_t capacity) const
+      -> stream<remove_cvref_t<Stream>, remove_cvref_t<Scheduler>> {
+    return stream<remove_cvref_t<Stream>, remove_cvref_t<Scheduler>>{
+        (Stream &&) s, (Scheduler &&) sched, capacity};
+  }
+  template(typename Scheduler)
+      (requires scheduler<Scheduler>)
+  constexpr auto operator()(Scheduler&& sched, std::size_t capacity) const
+      noexcept(is_nothrow_callable_v<
+        tag_t<bind_back>, _fn, Scheduler, std::size_t>)
+      -> bind_back_result_t<_fn, Scheduler, std::size_t> {
+    return bind_back(*this, (Scheduler &&) sched, capacity);
+  }
+};
+} // namespace _buffered_via_stream
+
+inline constexpr _buffered_via_stream::_fn buffered_via_stream {};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
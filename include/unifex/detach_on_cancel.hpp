@@ -19,11 +19,13 @@
 #include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
 #include <unifex/type_list.hpp>
 
 #include <algorithm>
 #include <atomic>
 #include <exception>
+#include <utility>
 
 #include <unifex/detail/prologue.hpp>
 
@@ -180,6 +182,45 @@ private:
   }
 };
 
+// Connects the upstream sender to a receiver that can never be asked to
+// stop. There is nothing to detach from, so this only keeps the guarantee
+// that a throwing set_value() is reported as an error.
+template <typename Receiver>
+struct _direct_receiver {
+  struct type;
+};
+
+template <typename Receiver>
+struct _direct_receiver<Receiver>::type final {
+  template <typename... Values>
+  void set_value(Values&&... values) noexcept {
+    UNIFEX_TRY {
+      unifex::set_value(std::move(receiver_), (Values &&) values...);
+    }
+    UNIFEX_CATCH(...) {
+      unifex::set_error(std::move(receiver_), std::current_exception());
+    }
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) noexcept {
+    unifex::set_error(std::move(receiver_), (Error &&) error);
+  }
+
+  void set_done() noexcept { unifex::set_done(std::move(receiver_)); }
+
+  template(typename CPO, typename R)  //
+      (requires is_receiver_query_cpo_v<CPO> AND same_as<R, type> AND
+           is_callable_v<CPO, const Receiver&>)  //
+  friend auto tag_invoke(CPO cpo, const R& r) noexcept(
+      is_nothrow_callable_v<CPO, const Receiver&>)
+      -> callable_result_t<CPO, const Receiver&> {
+    return std::move(cpo)(std::as_const(r.receiver_));
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+};
+
 template <typename Sender>
 struct _sender {
   struct type;
@@ -228,6 +269,7 @@ struct _sender<Sender>::type {
   template(typename This, typename Receiver)  //
       (requires same_as<remove_cvref_t<This>, type> AND
            receiver<Receiver> AND  //
+               (!is_stop_never_possible_v<stop_token_type_t<Receiver&>>) AND
                sender_to<member_t<This, Sender>, //
                    typename operation_state_t<This, Receiver>::_receiver>)  //
   friend typename operation_state_t<This, Receiver>::type tag_invoke(
@@ -235,6 +277,29 @@ struct _sender<Sender>::type {
     return typename operation_state_t<This, Receiver>::type{
         static_cast<This&&>(s).upstreamSender_, static_cast<Receiver&&>(r)};
   }
+
+  template <typename Receiver>
+  using direct_receiver_t =
+      typename _direct_receiver<remove_cvref_t<Receiver>>::type;
+
+  // A receiver that can never be asked to stop has nothing to detach from,
+  // so there is no detached state to allocate and no callback to register.
+  template(typename This, typename Receiver)  //
+      (requires same_as<remove_cvref_t<This>, type> AND
+           receiver<Receiver> AND  //
+               is_stop_never_possible_v<stop_token_type_t<Receiver&>> AND
+               sender_to<member_t<This, Sender>, direct_receiver_t<Receiver>>)
+  friend auto tag_invoke(tag_t<unifex::connect>, This&& s, Receiver&& r)  //
+      noexcept(is_nothrow_connectable_v<
+               member_t<This, Sender>,
+               direct_receiver_t<Receiver>>)
+          -> connect_result_t<
+              member_t<This, Sender>,
+              direct_receiver_t<Receiver>> {
+    return unifex::connect(
+        static_cast<This&&>(s).upstreamSender_,
+        direct_receiver_t<Receiver>{static_cast<Receiver&&>(r)});
+  }
 };
 }  // namespace _detach_on_cancel
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/type_list.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace unifex {
+namespace _batch {
+
+// Helpers that let per-element callables be applied to a batch of values
+// (e.g. the std::vector produced by batch_stream()) in a single loop.
+
+template <typename Batch>
+using _iterator_t = decltype(std::begin(std::declval<Batch&>()));
+
+// Elements of an rvalue batch are moved out of it.
+template <typename Batch>
+using element_t = std::conditional_t<
+    std::is_lvalue_reference_v<Batch>,
+    decltype(*std::declval<_iterator_t<Batch>>()),
+    decltype(std::move(*std::declval<_iterator_t<Batch>>()))>;
+
+template <typename Func, typename Prefix, typename Batch, typename = void>
+struct _elementwise : std::false_type {};
+
+template <typename Func, typename... Prefix, typename Batch>
+struct _elementwise<
+    Func,
+    type_list<Prefix...>,
+    Batch,
+    std::void_t<element_t<Batch>>>
+  : std::bool_constant<
+        !std::is_invocable_v<Func, Prefix..., Batch> &&
+        std::is_invocable_v<Func, Prefix..., element_t<Batch>>> {};
+
+template <typename Func, typename Prefix, typename... Values>
+struct _is_elementwise_invocable : std::false_type {};
+
+template <typename Func, typename Prefix, typename Batch>
+struct _is_elementwise_invocable<Func, Prefix, Batch>
+  : _elementwise<Func, Prefix, Batch> {};
+
+// True when `Func` cannot be invoked with `Prefix..., Values...` as-is but
+// `Values...` is a single batch and `Func` can be invoked with
+// `Prefix..., element` for each of its elements.
+template <typename Func, typename Prefix, typename... Values>
+inline constexpr bool is_elementwise_invocable_v =
+    _is_elementwise_invocable<Func, Prefix, Values...>::value;
+
+template <typename Batch, typename Func>
+void for_each_element(Batch&& batch, Func&& func) {
+  for (auto&& value : batch) {
+    func(static_cast<element_t<Batch>>(value));
+  }
+}
+
+} // namespace _batch
+} // namespace unifex
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/exception.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <exception>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+// Building blocks shared by the adaptors that store a child's completion
+// and deliver it later, possibly from another thread.
+
+namespace unifex {
+
+// Converts an error to the std::exception_ptr the adaptors store.
+inline std::exception_ptr _as_exception_ptr(std::exception_ptr e) noexcept {
+  return e;
+}
+
+inline std::exception_ptr _as_exception_ptr(std::error_code ec) noexcept {
+  return make_exception_ptr(std::system_error{ec});
+}
+
+template <typename Error>
+std::exception_ptr _as_exception_ptr(Error&& e) noexcept {
+  return make_exception_ptr((Error &&) e);
+}
+
+template <typename... Tuples>
+struct _single_tuple;
+template <>
+struct _single_tuple<> {
+  using type = std::tuple<>;
+};
+template <typename Tuple>
+struct _single_tuple<Tuple> {
+  using type = Tuple;
+};
+
+// The decayed values of a sender that sends a single overload of values
+// (or none at all).
+template <typename Sender>
+using _value_tuple_t = typename sender_value_types_t<
+    Sender,
+    _single_tuple,
+    decayed_tuple<std::tuple>::template apply>::type;
+
+// Which of a child's completion signals was stored.
+enum class _outcome : unsigned char { value, done, error };
+
+// A child's completion, stored until the adaptor can deliver it. value_ is
+// only constructed for _outcome::value. A child's values may live in its
+// operation state, so they are moved in before it is destroyed.
+template <typename Result>
+struct _stored_completion {
+  _outcome outcome_ = _outcome::done;
+  std::exception_ptr error_;
+  manual_lifetime<Result> value_;
+};
+
+// A consumer waiting for the adaptor's next result, which is stored in it
+// before complete_ is called.
+template <typename Result>
+struct _consumer_base : _stored_completion<Result> {
+  explicit _consumer_base(void (*complete)(_consumer_base*) noexcept) noexcept
+    : complete_(complete) {}
+
+  void (*complete_)(_consumer_base*) noexcept;
+};
+
+// Sends a stored completion to `receiver`, with `leading` before any stored
+// values, and destroys the stored value. If moving the value out throws,
+// the exception is sent as an error instead.
+template <typename Receiver, typename Result, typename... Leading>
+void _deliver(
+    Receiver&& receiver,
+    _stored_completion<Result>& completion,
+    Leading&&... leading) noexcept {
+  switch (completion.outcome_) {
+    case _outcome::value: {
+      bool moved = false;
+      UNIFEX_TRY {
+        Result values = std::move(completion.value_.get());
+        completion.value_.destruct();
+        moved = true;
+        std::apply(
+            [&](auto&&... vs) {
+              unifex::set_value(
+                  (Receiver &&) receiver,
+                  (Leading &&) leading...,
+                  static_cast<decltype(vs)>(vs)...);
+            },
+            std::move(values));
+      }
+      UNIFEX_CATCH(...) {
+        if (!moved) {
+          completion.value_.destruct();
+        }
+        unifex::set_error((Receiver &&) receiver, std::current_exception());
+      }
+      break;
+    }
+    case _outcome::error:
+      unifex::set_error((Receiver &&) receiver, std::move(completion.error_));
+      break;
+    case _outcome::done:
+      unifex::set_done((Receiver &&) receiver);
+      break;
+  }
+}
+
+// A cleanup operation waiting for the adaptor's outstanding work to finish.
+struct _cleanup_base {
+  void (*start_)(_cleanup_base*) noexcept;
+};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/config.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace unifex {
+namespace _parallel {
+
+// Helpers shared by the data-parallel algorithms built on bulk_schedule().
+
+template <typename Policy>
+inline constexpr bool is_execution_policy_v = is_one_of_v<
+    remove_cvref_t<Policy>,
+    sequenced_policy,
+    unsequenced_policy,
+    parallel_policy,
+    parallel_unsequenced_policy>;
+
+template <typename Policy>
+inline constexpr bool is_parallel_policy_v = is_one_of_v<
+    remove_cvref_t<Policy>,
+    parallel_policy,
+    parallel_unsequenced_policy>;
+
+template <typename Iterator>
+inline constexpr bool is_random_access_iterator_v = std::is_base_of_v<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<Iterator>::iterator_category>;
+
+// The number of chunks per thread of the scheduler, so that threads that
+// finish early can pick up more work.
+inline constexpr std::size_t chunks_per_thread = 4;
+
+// [0, size) split into `count` chunks of `size` elements, the last of which
+// may be shorter.
+struct chunking {
+  std::size_t total = 0;
+  std::size_t count = 0;
+  std::size_t size = 0;
+
+  std::size_t begin(std::size_t index) const noexcept {
+    return std::min(index * size, total);
+  }
+
+  std::size_t end(std::size_t index) const noexcept {
+    return std::min(begin(index) + size, total);
+  }
+};
+
+// Chunks of at least `minChunkSize` elements, up to chunks_per_thread for
+// each of `concurrency` threads.
+inline chunking split(
+    std::size_t total,
+    std::size_t concurrency,
+    std::size_t minChunkSize) noexcept {
+  if (total == 0) {
+    return {};
+  }
+  const std::size_t maxChunks =
+      std::max<std::size_t>(concurrency * chunks_per_thread, 1);
+  const std::size_t count =
+      std::clamp<std::size_t>(total / minChunkSize, 1, maxChunks);
+  return {total, count, (total + count - 1) / count};
+}
+
+// A policy that isn't parallel gets the whole range as a single chunk, so
+// only one call is ever in flight.
+template <typename Policy>
+chunking split(
+    const Policy&,
+    std::size_t total,
+    std::size_t concurrency,
+    std::size_t minChunkSize) noexcept {
+  if constexpr (is_parallel_policy_v<Policy>) {
+    return split(total, concurrency, minChunkSize);
+  } else {
+    if (total == 0) {
+      return {};
+    }
+    return {total, 1, total};
+  }
+}
+
+// Captures the first exception thrown by the chunks of a bulk operation so
+// that set_next() doesn't throw; the remaining chunks are skipped.
+class first_error {
+ public:
+  bool failed() const noexcept {
+    return failed_.load(std::memory_order_relaxed);
+  }
+
+  template <typename Func>
+  void run(Func&& func) noexcept {
+    if (failed()) {
+      return;
+    }
+    UNIFEX_TRY {
+      ((Func &&) func)();
+    }
+    UNIFEX_CATCH(...) {
+      if (!failed_.exchange(true, std::memory_order_relaxed)) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+
+  // Called once the bulk operation has completed.
+  void rethrow() {
+    if (error_) {
+      std::rethrow_exception(std::move(error_));
+    }
+  }
+
+ private:
+  std::atomic<bool> failed_{false};
+  std::exception_ptr error_;
+};
+
+} // namespace _parallel
+} // namespace unifex
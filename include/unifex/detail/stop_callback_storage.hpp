@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/stop_token_concepts.hpp>
+
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+
+// A base class for operation states that forward their receiver's stop
+// requests with a Callback registered on its StopToken while they run.
+// If StopToken can never ask to stop there is nothing to register, and the
+// base is empty so it takes no space in the operation state.
+template <
+    typename StopToken,
+    typename Callback,
+    bool = is_stop_never_possible_v<StopToken>>
+class _stop_callback_storage {
+public:
+  void construct_stop_callback(StopToken token, Callback&& callback) noexcept {
+    stopCallback_.construct(std::move(token), std::move(callback));
+  }
+
+  void destruct_stop_callback() noexcept { stopCallback_.destruct(); }
+
+private:
+  manual_lifetime<typename StopToken::template callback_type<Callback>>
+      stopCallback_;
+};
+
+template <typename StopToken, typename Callback>
+class _stop_callback_storage<StopToken, Callback, true> {
+public:
+  void construct_stop_callback(StopToken, Callback&&) noexcept {}
+
+  void destruct_stop_callback() noexcept {}
+};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bulk_join.hpp>
+#include <unifex/bulk_schedule.hpp>
+#include <unifex/bulk_transform.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/then.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace unifex {
+namespace _tree_reduce {
+
+// A parallel reduction of the index space [0, size): the indices are split
+// into chunks that are folded on the workers of a scheduler by
+// bulk_schedule(), then the per-chunk partial results are joined pairwise,
+// in a tree whose shape depends only on the number of chunks.
+
+inline constexpr std::size_t min_chunk_size = 1024;
+
+// Each partial result gets its own cache line so that workers folding
+// neighbouring chunks don't contend for it.
+template <typename State>
+struct alignas(64) _partial {
+  std::optional<State> value_;
+};
+
+template <typename Fold, typename Combine>
+struct _shared {
+  using state_t =
+      remove_cvref_t<std::invoke_result_t<Fold&, std::size_t, std::size_t>>;
+
+  _shared(Fold&& fold, Combine&& combine, _parallel::chunking chunks)
+    : fold_(std::move(fold))
+    , combine_(std::move(combine))
+    , chunks_(chunks)
+    , partials_(chunks_.count) {}
+
+  void fold_chunk(std::size_t index) noexcept {
+    errors_.run([&] {
+      partials_[index].value_.emplace(
+          fold_(chunks_.begin(index), chunks_.end(index)));
+    });
+  }
+
+  std::optional<state_t> join() {
+    errors_.rethrow();
+    const std::size_t count = chunks_.count;
+    for (std::size_t stride = 1; stride < count; stride *= 2) {
+      for (std::size_t i = 0; i + stride < count; i += 2 * stride) {
+        auto& left = partials_[i].value_;
+        auto& right = partials_[i + stride].value_;
+        if (!right) {
+          continue;
+        }
+        if (left) {
+          left.emplace(combine_(std::move(*left), std::move(*right)));
+        } else {
+          left.swap(right);
+        }
+      }
+    }
+    if (count == 0) {
+      return std::nullopt;
+    }
+    return std::move(partials_[0].value_);
+  }
+
+  Fold fold_;
+  Combine combine_;
+  _parallel::chunking chunks_;
+  std::vector<_partial<state_t>> partials_;
+  _parallel::first_error errors_;
+};
+
+// Returns a sender of std::optional<State> that is empty when `size` is 0
+// and otherwise holds the combination of fold(begin, end) over the chunks
+// of [0, size). With a parallel policy there are a few chunks for each of
+// `concurrency` threads and `fold` is called concurrently; otherwise the
+// whole range is a single chunk. `combine` must be associative.
+template <
+    typename Scheduler,
+    typename Policy,
+    typename Fold,
+    typename Combine>
+auto reduce(
+    Scheduler&& sched,
+    const Policy& policy,
+    std::size_t size,
+    std::size_t concurrency,
+    Fold&& fold,
+    Combine&& combine) {
+  using shared_t = _shared<remove_cvref_t<Fold>, remove_cvref_t<Combine>>;
+  const auto chunks =
+      _parallel::split(policy, size, concurrency, min_chunk_size);
+  return let_value_with(
+      [fold = (Fold &&) fold,
+       combine = (Combine &&) combine,
+       chunks]() mutable {
+        return shared_t{std::move(fold), std::move(combine), chunks};
+      },
+      [sched = (Scheduler &&) sched, policy](shared_t& shared) mutable {
+        return then(
+            bulk_join(bulk_transform(
+                bulk_schedule(std::move(sched), shared.chunks_.count),
+                [&shared](std::size_t index) noexcept {
+                  shared.fold_chunk(index);
+                },
+                policy)),
+            [&shared] { return shared.join(); });
+      });
+}
+
+} // namespace _tree_reduce
+} // namespace unifex
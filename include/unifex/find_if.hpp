@@ -35,18 +35,67 @@
 #include <unifex/bulk_transform.hpp>
 #include <unifex/bulk_schedule.hpp>
 #include <unifex/bind_back.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <exception>
 #include <functional>
 #include <type_traits>
 #include <utility>
 #include <memory>
+#include <iterator>
+#include <tuple>
 
 #include <unifex/detail/prologue.hpp>
 
 namespace unifex {
 namespace _find_if {
 
+// Chunks are split into sub-chunks of this many elements, between which
+// a chunk checks whether a lower-indexed match has already been found.
+inline constexpr std::size_t sub_chunk_size = 64;
+inline constexpr std::size_t min_chunk_size = 1024;
+
+// Whether a sub-chunk can be searched by evaluating the predicate for
+// every element, without a branch per element, so the loop can be
+// vectorised.
+template <typename Func, typename Iterator, typename... Values>
+inline constexpr bool _is_vectorisable_v =
+    _parallel::is_random_access_iterator_v<Iterator> &&
+    std::is_trivially_copyable_v<
+        typename std::iterator_traits<Iterator>::value_type> &&
+    std::is_nothrow_invocable_v<
+        Func&,
+        typename std::iterator_traits<Iterator>::reference,
+        Values&...>;
+
+// Returns the offset of the first element of [first, first + count) that
+// matches, or count if none does.
+template <typename Func, typename Iterator, typename Diff, typename... Values>
+Diff find_first(Func& func, Iterator first, Diff count, Values&... values) {
+  if constexpr (_is_vectorisable_v<Func, Iterator, Values...>) {
+    bool matches[sub_chunk_size];
+    for (Diff i = 0; i < count; ++i) {
+      matches[i] = std::invoke(func, first[i], values...);
+    }
+    for (Diff i = 0; i < count; ++i) {
+      if (matches[i]) {
+        return i;
+      }
+    }
+  } else {
+    for (Diff i = 0; i < count; ++i, ++first) {
+      if (std::invoke(func, *first, values...)) {
+        return i;
+      }
+    }
+  }
+  return count;
+}
+
 template <typename Predecessor, typename Receiver, typename Func, typename FuncPolicy>
 struct _receiver {
   struct type;
@@ -136,13 +185,14 @@ struct _receiver<Predecessor, Receiver, Func, FuncPolicy>::type {
     }
 
     // Cancellable parallel algorithm.
-    // This version is two phase to avoid a non-trivial atomic in the middle.
-    // With more built-in algorithms it can be simplified:
-    //  * let_value_with to allocate non-movable state in the operation state.
-    //  * unpack to deal with tuple to pack conversion
-    // It could also be simplified by making more of the code custom, but I wanted
-    // to demonstrate reuse of internal algorithms to build something more compelex
-    // and cancellable.
+    //
+    // The range is split into chunks, a few for each thread of the scheduler,
+    // that are searched by bulk_schedule(). Each chunk is searched in
+    // sub-chunks, and the index of the first match found so far is shared by
+    // all of them: a chunk gives up as soon as a lower index has matched.
+    // Work after a match is abandoned quickly, while chunks below it still
+    // run to the end, so the find-first rule holds whatever order the chunks
+    // run in and without cancelling the bulk operation.
     template<typename Scheduler, typename Iterator, typename... Values>
     auto operator()(
         Scheduler&& sched,
@@ -155,93 +205,75 @@ struct _receiver<Predecessor, Receiver, Func, FuncPolicy>::type {
       // NOTE: Assumes random access iterator for now, on the assumption that the policy was accurate
       auto distance = std::distance(begin_it, end_it);
       using diff_t = decltype(distance);
-      constexpr diff_t max_num_chunks = 32;
-      constexpr diff_t min_chunk_size = 4;
-      diff_t num_chunks = (distance/max_num_chunks) > min_chunk_size ?
-        max_num_chunks : ((distance+min_chunk_size)/min_chunk_size);
-      diff_t chunk_size = (distance+num_chunks)/num_chunks;
+      const _parallel::chunking chunks = _parallel::split(
+          distance > 0 ? static_cast<std::size_t>(distance) : std::size_t(0),
+          get_concurrency(sched),
+          min_chunk_size);
 
-      // Found flag and vector that will be constructed in-place in the operation state
+      // The index of the first match, or distance if there is none yet.
+      // Constructed in-place in the operation state.
       struct State {
-        std::atomic<bool> found_flag;
-        std::vector<Iterator> perChunkState;
+        std::atomic<diff_t> first_match;
       };
 
-      // The outer let_value keeps the vector of found results and the found flag
-      // alive for the duration.
-      // let_value_with constructs the vector and found_flag directly in the operation
-      // state.
-      // Use a two phase process largely to demonstrate a simple multi-phase algorithm
-      // and to avoid using a cmpexch loop on an intermediate iterator.
       return
       unifex::let_value(
         unifex::just(std::forward<Values>(values)...),
         [func = std::move(func_), sched = std::forward<Scheduler>(sched), begin_it,
-        chunk_size, end_it, num_chunks](Values&... values) mutable {
-          return unifex::let_value_with([&](){return State{false, std::vector<Iterator>(num_chunks, end_it)};},[&](State& state) {
-            // Inject a stop source and make it available for inner operations.
-            // This stop source propagates into the algorithm through the receiver,
-            // such that it will cancel the bulk_schedule operation.
-            // It is also triggered if the downstream stop source is triggered.
-            return unifex::let_value_with_stop_source([&](unifex::inplace_stop_source& stopSource) mutable {
-              auto bulk_phase = unifex::bulk_join(
-                  unifex::bulk_transform(
-                    unifex::bulk_schedule(std::move(sched), num_chunks),
-                    [&](diff_t index){
-                      auto chunk_begin_it = begin_it + (chunk_size*index);
-                      auto chunk_end_it = chunk_begin_it;
-                      if(index < (num_chunks-1)) {
-                        std::advance(chunk_end_it, chunk_size);
-                      } else {
-                        chunk_end_it = end_it;
+        chunks, end_it, distance](Values&... values) mutable {
+          return unifex::let_value_with([&](){return State{distance};},[&](State& state) {
+            auto bulk_phase = unifex::bulk_join(
+                unifex::bulk_transform(
+                  unifex::bulk_schedule(std::move(sched), chunks.count),
+                  [&](std::size_t index){
+                    const auto chunk_begin =
+                        static_cast<diff_t>(chunks.begin(index));
+                    const auto chunk_end =
+                        static_cast<diff_t>(chunks.end(index));
+
+                    for (diff_t sub_begin = chunk_begin; sub_begin < chunk_end;
+                         sub_begin += sub_chunk_size) {
+                      if (state.first_match.load(std::memory_order_relaxed) < sub_begin) {
+                        // Everything left in this chunk is after a match.
+                        return;
                       }
-
-                      for(auto it = chunk_begin_it; it != chunk_end_it; ++it) {
-                        if(std::invoke(func, *it, values...)) {
-                          // On success, store the value in the output array
-                          // and cancel future work.
-                          // This works on the assumption that bulk_schedule will launch
-                          // tasks (or at least, test for cancellation) in
-                          // iteration-space order, and hence only cancel future work,
-                          // to maintain the find-first property.
-                          state.perChunkState[index] = it;
-                          state.found_flag = true;
-                          stopSource.request_stop();
-                          return;
+                      const diff_t count = std::min(
+                          static_cast<diff_t>(sub_chunk_size), chunk_end - sub_begin);
+                      const diff_t found = find_first(
+                          func, begin_it + sub_begin, count, values...);
+                      if (found != count) {
+                        const diff_t match = sub_begin + found;
+                        diff_t current = state.first_match.load(std::memory_order_relaxed);
+                        while (match < current &&
+                               !state.first_match.compare_exchange_weak(
+                                   current, match, std::memory_order_relaxed)) {
                         }
-                      }
-                    },
-                    unifex::par
-                  )
-                );
-              return
-                unifex::then(
-                  unifex::let_done(
-                    std::move(bulk_phase),
-                    [&state](){
-                      if(state.found_flag == true) {
-                        // If the item was found, then continue as if not cancelled
-                        return just();
-                      } else {
-                        // If there was cancellation and we did not find the item
-                        // then propagate the cancellation and assume failure
-                        // TODO: We are temporarily always recovering from cancellation
-                        // until a variant sender is implemented to unify the two
-                        // algorithms
-                        return just();
+                        return;
                       }
                     }
-                  ),
-                  [&state, end_it, &values...]() mutable -> std::tuple<Iterator, Values...> {
-                    for(auto it : state.perChunkState) {
-                      if(it != end_it) {
-                        return std::tuple<Iterator, Values...>(it, std::move(values)...);
-                      }
-                    }
-                    return std::tuple<Iterator, Values...>(end_it, std::move(values)...);
+                  },
+                  unifex::par
+                )
+              );
+            return
+              unifex::then(
+                unifex::let_done(
+                  std::move(bulk_phase),
+                  [](){
+                    // TODO: We are temporarily always recovering from cancellation
+                    // until a variant sender is implemented to unify the two
+                    // algorithms
+                    return just();
+                  }
+                ),
+                [&state, begin_it, end_it, distance, &values...]() mutable -> std::tuple<Iterator, Values...> {
+                  const diff_t match = state.first_match.load(std::memory_order_relaxed);
+                  if (match < distance) {
+                    return std::tuple<Iterator, Values...>(begin_it + match, std::move(values)...);
                   }
-                );
-              });
+                  return std::tuple<Iterator, Values...>(end_it, std::move(values)...);
+                }
+              );
             });
           });
     }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bulk_join.hpp>
+#include <unifex/bulk_schedule.hpp>
+#include <unifex/bulk_transform.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _for_each_n {
+
+inline constexpr std::size_t min_chunk_size = 1024;
+
+template <typename Iterator, typename Func>
+struct _shared {
+  _shared(Iterator first, _parallel::chunking chunks, Func&& func)
+    : first_(first), func_(std::move(func)), chunks_(chunks) {}
+
+  void apply_chunk(std::size_t index) noexcept {
+    errors_.run([&] {
+      const std::size_t end = chunks_.end(index);
+      for (std::size_t i = chunks_.begin(index); i < end; ++i) {
+        std::invoke(func_, first_[i]);
+      }
+    });
+  }
+
+  Iterator finish() {
+    errors_.rethrow();
+    return first_ + static_cast<std::ptrdiff_t>(chunks_.total);
+  }
+
+  Iterator first_;
+  Func func_;
+  _parallel::chunking chunks_;
+  _parallel::first_error errors_;
+};
+
+struct _fn {
+  // Calls func(x) for each of the `n` elements starting at `first` on
+  // `sched`, then sends first + n. With a parallel policy the elements are
+  // visited in a few chunks for each thread of the scheduler, so `func`
+  // must be safe to call concurrently; otherwise they are visited in order
+  // by a single task.
+  template(
+      typename Scheduler,
+      typename Policy,
+      typename Iterator,
+      typename Size,
+      typename Func)
+    (requires scheduler<Scheduler> AND
+        _parallel::is_execution_policy_v<Policy> AND
+        _parallel::is_random_access_iterator_v<Iterator> AND
+        std::is_integral_v<Size>)
+  auto operator()(
+      Scheduler&& sched,
+      const Policy& policy,
+      Iterator first,
+      Size n,
+      Func func) const {
+    using shared_t = _shared<Iterator, Func>;
+    const auto size = n > 0 ? static_cast<std::size_t>(n) : std::size_t(0);
+    const auto chunks = _parallel::split(
+        policy, size, get_concurrency(sched), min_chunk_size);
+    return let_value_with(
+        [first, chunks, func = std::move(func)]() mutable {
+          return shared_t{first, chunks, std::move(func)};
+        },
+        [sched = (Scheduler &&) sched, policy](shared_t& shared) mutable {
+          return then(
+              bulk_join(bulk_transform(
+                  bulk_schedule(std::move(sched), shared.chunks_.count),
+                  [&shared](std::size_t index) noexcept {
+                    shared.apply_chunk(index);
+                  },
+                  policy)),
+              [&shared] { return shared.finish(); });
+        });
+  }
+};
+
+} // namespace _for_each_n
+
+inline constexpr _for_each_n::_fn for_each_n{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
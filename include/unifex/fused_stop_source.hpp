@@ -18,6 +18,7 @@
 #include <optional>
 
 #include <unifex/inplace_stop_token.hpp>
+#include <unifex/stop_token_concepts.hpp>
 
 #include <unifex/detail/prologue.hpp>
 
@@ -62,19 +63,48 @@ struct fused_stop_callback<First, Rest...> {
   UNIFEX_NO_UNIQUE_ADDRESS fused_stop_callback<Rest...> rest_;
 };
 
+// The callbacks that forward stop requests from StopTokens to a
+// fused_stop_source, or nothing at all if none of the tokens can ever ask
+// to stop.
+template <bool StopPossible, typename... StopTokens>
+class _fused_callbacks {
+protected:
+  void construct_callbacks(
+      unifex::inplace_stop_source& source, StopTokens... tokens) {
+    callbacks_.emplace(source, std::move(tokens)...);
+  }
+
+  void destruct_callbacks() noexcept { callbacks_.reset(); }
+
+private:
+  UNIFEX_NO_UNIQUE_ADDRESS std::optional<
+      fused_stop_callback<stop_callback_t<StopTokens>...>>
+      callbacks_;
+};
+
 template <typename... StopTokens>
-struct fused_stop_source : unifex::inplace_stop_source {
+class _fused_callbacks<false, StopTokens...> {
+protected:
+  void construct_callbacks(
+      unifex::inplace_stop_source&, StopTokens...) noexcept {}
+
+  void destruct_callbacks() noexcept {}
+};
+
+template <typename... StopTokens>
+struct fused_stop_source
+  : unifex::inplace_stop_source
+  , private _fused_callbacks<
+        !(is_stop_never_possible_v<StopTokens> && ...),
+        StopTokens...> {
   using fused_callback_type =
       fused_stop_callback<stop_callback_t<StopTokens>...>;
 
   void register_callbacks(StopTokens... tokens) {
-    callbacks_.emplace(*this, std::move(tokens)...);
+    this->construct_callbacks(*this, std::move(tokens)...);
   }
 
-  void deregister_callbacks() noexcept { callbacks_.reset(); }
-
-private:
-  UNIFEX_NO_UNIQUE_ADDRESS std::optional<fused_callback_type> callbacks_;
+  void deregister_callbacks() noexcept { this->destruct_callbacks(); }
 };
 }  // namespace _fss
 
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/tag_invoke.hpp>
+
+#include <cstddef>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex
+{
+    namespace _get_concurrency {
+        // The number of tasks that a scheduler can run at the same time,
+        // used by bulk algorithms to decide how finely to split their work.
+        // Schedulers that don't say run one task at a time.
+        struct _fn {
+            template(typename Scheduler)
+                (requires tag_invocable<_fn, const Scheduler&>)
+            constexpr std::size_t operator()(const Scheduler& sched) const noexcept {
+                return static_cast<std::size_t>(tag_invoke(_fn{}, sched));
+            }
+
+            template(typename Scheduler)
+                (requires (!tag_invocable<_fn, const Scheduler&>))
+            constexpr std::size_t operator()([[maybe_unused]] const Scheduler&) const noexcept {
+                return 1;
+            }
+        };
+    }
+
+    inline constexpr _get_concurrency::_fn get_concurrency{};
+}
+
+#include <unifex/detail/epilogue.hpp>
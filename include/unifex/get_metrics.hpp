@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/tag_invoke.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _metrics {
+
+// A counter that only one thread updates at a time: either the thread that
+// owns it or whichever thread holds the lock guarding it. Updates are a
+// relaxed load and store rather than a read-modify-write, so keeping count
+// costs about as much as incrementing a plain integer. Any thread may read
+// it, but only get_metrics() does.
+class counter {
+public:
+  void add(std::uint64_t n = 1) noexcept {
+    value_.store(value_.load(std::memory_order_relaxed) + n,
+                 std::memory_order_relaxed);
+  }
+
+  // For counters that add up time.
+  void add(std::chrono::nanoseconds duration) noexcept {
+    add(static_cast<std::uint64_t>(duration.count()));
+  }
+
+  std::uint64_t load() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+// Bucket 0 counts durations under 1us and bucket i durations in
+// [2^(i-1)us, 2^i us). The last bucket also counts anything longer.
+inline constexpr std::size_t histogram_bucket_count = 16;
+
+using histogram_snapshot =
+    std::array<std::uint64_t, histogram_bucket_count>;
+
+// A histogram of durations with the same single-writer rules as counter.
+class histogram {
+public:
+  void record(std::chrono::nanoseconds duration) noexcept {
+    auto micros = static_cast<std::uint64_t>(duration.count()) / 1000;
+    std::size_t bucket = 0;
+    while (micros != 0 && bucket + 1 < histogram_bucket_count) {
+      micros >>= 1;
+      ++bucket;
+    }
+    buckets_[bucket].add();
+  }
+
+  histogram_snapshot load() const noexcept {
+    histogram_snapshot result;
+    for (std::size_t i = 0; i < histogram_bucket_count; ++i) {
+      result[i] = buckets_[i].load();
+    }
+    return result;
+  }
+
+private:
+  std::array<counter, histogram_bucket_count> buckets_;
+};
+
+// Returns a snapshot of the counters an execution context keeps about the
+// work it has done. Counters are read one at a time with relaxed loads, so
+// a snapshot taken while the context is busy is only approximately
+// consistent.
+struct _fn {
+  template(typename Context)
+      (requires tag_invocable<_fn, const Context&>)
+  auto operator()(const Context& context) const
+      noexcept(is_nothrow_tag_invocable_v<_fn, const Context&>)
+      -> tag_invoke_result_t<_fn, const Context&> {
+    return tag_invoke(_fn{}, context);
+  }
+};
+
+} // namespace _metrics
+
+inline constexpr _metrics::_fn get_metrics{};
+
+using duration_histogram = _metrics::histogram_snapshot;
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bulk_join.hpp>
+#include <unifex/bulk_schedule.hpp>
+#include <unifex/bulk_transform.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+#include <unifex/detail/tree_reduce.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _inclusive_scan {
+
+inline constexpr std::size_t min_chunk_size = 2048;
+
+// A two-pass blocked scan. The first pass sums every chunk but the last,
+// the sums are turned into the value carried into each chunk, then the
+// second pass scans every chunk starting from its carry. The input is
+// read twice but the output is only written once, and writing the output
+// in place of the input is fine.
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+struct _shared {
+  using value_t = typename std::iterator_traits<InputIt>::value_type;
+
+  _shared(
+      InputIt first,
+      OutputIt dFirst,
+      _parallel::chunking chunks,
+      BinaryOp&& op)
+    : first_(first)
+    , dFirst_(dFirst)
+    , op_(std::move(op))
+    , chunks_(chunks)
+    , carries_(chunks_.count) {}
+
+  // Pass 1: carries_[index + 1] is the sum of chunk `index`.
+  void sum_chunk(std::size_t index) noexcept {
+    errors_.run([&] {
+      const std::size_t end = chunks_.end(index);
+      std::size_t i = chunks_.begin(index);
+      value_t sum = first_[i];
+      for (++i; i < end; ++i) {
+        sum = std::invoke(op_, std::move(sum), first_[i]);
+      }
+      carries_[index + 1].value_.emplace(std::move(sum));
+    });
+  }
+
+  // Between the passes: carries_[index] is the sum of every chunk before
+  // `index`.
+  void prefix() {
+    errors_.rethrow();
+    for (std::size_t i = 2; i < chunks_.count; ++i) {
+      carries_[i].value_.emplace(std::invoke(
+          op_, std::move(*carries_[i - 1].value_),
+          std::move(*carries_[i].value_)));
+    }
+  }
+
+  // Pass 2: scans chunk `index` starting from its carry.
+  void scan_chunk(std::size_t index) noexcept {
+    errors_.run([&] {
+      const std::size_t end = chunks_.end(index);
+      std::size_t i = chunks_.begin(index);
+      auto& carry = carries_[index].value_;
+      value_t sum = carry ? std::invoke(op_, *carry, first_[i])
+                          : value_t(first_[i]);
+      for (;;) {
+        dFirst_[i] = sum;
+        if (++i == end) {
+          break;
+        }
+        sum = std::invoke(op_, std::move(sum), first_[i]);
+      }
+    });
+  }
+
+  OutputIt finish() {
+    errors_.rethrow();
+    return dFirst_ + static_cast<std::ptrdiff_t>(chunks_.total);
+  }
+
+  InputIt first_;
+  OutputIt dFirst_;
+  BinaryOp op_;
+  _parallel::chunking chunks_;
+  std::vector<_tree_reduce::_partial<value_t>> carries_;
+  _parallel::first_error errors_;
+};
+
+struct _fn {
+  // Writes the inclusive prefix sums of [first, last) by `op` to the
+  // range starting at `dFirst` on `sched`, then sends the end of the
+  // output range. `op` must be associative and, with a parallel policy,
+  // safe to call concurrently.
+  template(
+      typename Scheduler,
+      typename Policy,
+      typename InputIt,
+      typename OutputIt,
+      typename BinaryOp = std::plus<>)
+    (requires scheduler<Scheduler> AND
+        _parallel::is_execution_policy_v<Policy> AND
+        _parallel::is_random_access_iterator_v<InputIt> AND
+        _parallel::is_random_access_iterator_v<OutputIt>)
+  auto operator()(
+      Scheduler&& sched,
+      const Policy& policy,
+      InputIt first,
+      InputIt last,
+      OutputIt dFirst,
+      BinaryOp op = {}) const {
+    using shared_t = _shared<InputIt, OutputIt, remove_cvref_t<BinaryOp>>;
+    const auto size = static_cast<std::size_t>(last - first);
+    const auto chunks = _parallel::split(
+        policy, size, get_concurrency(sched), min_chunk_size);
+    return let_value_with(
+        [first, dFirst, chunks, op = std::move(op)]() mutable {
+          return shared_t{first, dFirst, chunks, std::move(op)};
+        },
+        [sched = (Scheduler &&) sched, policy](shared_t& shared) mutable {
+          const std::size_t count = shared.chunks_.count;
+          return let_value(
+              then(
+                  bulk_join(bulk_transform(
+                      bulk_schedule(sched, count != 0 ? count - 1 : 0),
+                      [&shared](std::size_t index) noexcept {
+                        shared.sum_chunk(index);
+                      },
+                      policy)),
+                  [&shared] { shared.prefix(); }),
+              [&shared, sched = std::move(sched), policy, count]() mutable {
+                return then(
+                    bulk_join(bulk_transform(
+                        bulk_schedule(std::move(sched), count),
+                        [&shared](std::size_t index) noexcept {
+                          shared.scan_chunk(index);
+                        },
+                        policy)),
+                    [&shared] { return shared.finish(); });
+              });
+        });
+  }
+};
+
+} // namespace _inclusive_scan
+
+inline constexpr _inclusive_scan::_fn inclusive_scan{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -63,12 +63,23 @@ class inplace_stop_callback_base {
 
   friend inplace_stop_source;
 
+  // Whether request_stop() has taken this callback off the list to run it.
+  bool is_dequeued() const noexcept {
+    return prev_ == this;
+  }
+
   inplace_stop_source* source_;
   execute_fn* execute_;
-  inplace_stop_callback_base* next_ = nullptr;
-  inplace_stop_callback_base** prevPtr_ = nullptr;
-  bool* removedDuringCallback_ = nullptr;
-  std::atomic<bool> callbackCompleted_{false};
+  // Only read without the source's lock to check whether this is the last
+  // callback, which it stays once it is.
+  std::atomic<inplace_stop_callback_base*> next_{nullptr};
+  // nullptr for the first callback, this once dequeued.
+  inplace_stop_callback_base* prev_ = nullptr;
+  // While request_stop() runs the callback, points at a flag to set if the
+  // callback is deregistered during its own execution. Reset to nullptr
+  // once it has run, so that deregistering on another thread can wait for
+  // that.
+  std::atomic<bool*> removedDuringCallback_{nullptr};
 #ifndef NDEBUG
   char const* type_name_ = nullptr;
 #endif
@@ -99,20 +110,56 @@ class inplace_stop_source {
   template <typename F>
   friend class inplace_stop_callback;
 
-  std::uint8_t lock() noexcept;
-  void unlock(std::uint8_t oldState) noexcept;
+  std::uintptr_t lock() noexcept;
+  void unlock(
+      std::uintptr_t oldState, inplace_stop_callback_base* head) noexcept;
+
+  bool try_add_callback(inplace_stop_callback_base* callback) noexcept {
+    // Fast path: no other callbacks, so just publish this one.
+    auto oldState = state_.load(std::memory_order_relaxed);
+    return (oldState == 0 &&
+            state_.compare_exchange_strong(
+                oldState,
+                reinterpret_cast<std::uintptr_t>(callback),
+                std::memory_order_release,
+                std::memory_order_relaxed)) ||
+        try_add_callback_slow(callback, oldState);
+  }
+
+  void remove_callback(inplace_stop_callback_base* callback) noexcept {
+    // Fast path: this is the only callback. It can't gain a successor, so
+    // once next_ is null it stays null.
+    auto oldState = reinterpret_cast<std::uintptr_t>(callback);
+    if (state_.load(std::memory_order_relaxed) != oldState ||
+        callback->next_.load(std::memory_order_relaxed) != nullptr ||
+        !state_.compare_exchange_strong(
+            oldState,
+            0,
+            std::memory_order_acquire,
+            std::memory_order_relaxed)) {
+      remove_callback_slow(callback);
+    }
+  }
 
-  bool try_lock_unless_stop_requested(bool setStopRequested) noexcept;
+  bool try_add_callback_slow(
+      inplace_stop_callback_base* callback, std::uintptr_t oldState) noexcept;
 
-  bool try_add_callback(inplace_stop_callback_base* callback) noexcept;
+  void remove_callback_slow(inplace_stop_callback_base* callback) noexcept;
+
+  static inplace_stop_callback_base* head(std::uintptr_t state) noexcept {
+    return reinterpret_cast<inplace_stop_callback_base*>(state & ~flags_mask);
+  }
 
-  void remove_callback(inplace_stop_callback_base* callback) noexcept;
+  static constexpr std::uintptr_t stop_requested_flag = 1;
+  static constexpr std::uintptr_t locked_flag = 2;
+  static constexpr std::uintptr_t flags_mask = 3;
 
-  static constexpr std::uint8_t stop_requested_flag = 1;
-  static constexpr std::uint8_t locked_flag = 2;
+  static_assert(alignof(inplace_stop_callback_base) > flags_mask);
 
-  std::atomic<std::uint8_t> state_{0};
-  inplace_stop_callback_base* callbacks_ = nullptr;
+  // The first registered callback, or'd with the flags. Adding a callback
+  // to an empty list and removing the only one are a single
+  // compare-exchange; anything else takes the lock.
+  std::atomic<std::uintptr_t> state_{0};
   std::thread::id notifyingThreadId_;
 };
 
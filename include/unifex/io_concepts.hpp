@@ -15,7 +15,14 @@
  */
 #pragma once
 
+#include <unifex/defer.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/span.hpp>
 #include <unifex/tag_invoke.hpp>
+#include <unifex/then.hpp>
+
+#include <cstddef>
 
 // The senders would be loosened eventually to support sequences.
 //
@@ -193,12 +200,384 @@ inline const struct async_write_some_at_cpo {
         *this, file);
   }
 } async_write_some_at{};
+
+// The first buffer of a vectored read or write that isn't empty, for an
+// object that only reads or writes a single buffer. Sending fewer bytes
+// than asked for is fine because the result may be short anyway.
+template <typename T>
+span<T> _first_non_empty(span<const span<T>> buffers) noexcept {
+  for (const span<T>& buffer : buffers) {
+    if (!buffer.empty()) {
+      return buffer;
+    }
+  }
+  return {};
+}
+
+//
+// async_read_some_v / async_write_some_v
+//
+// Like async_read_some and async_write_some, but scatter into or gather
+// from several buffers with a single readv() or writev(). Objects that
+// don't customise them read or write the first buffer that isn't empty.
+//
+inline const struct async_read_some_v_cpo {
+  template(typename ForwardReader)
+      (requires tag_invocable<
+          async_read_some_v_cpo,
+          ForwardReader&,
+          span<const span<std::byte>>>)
+  auto operator()(
+      ForwardReader& socket,
+      span<const span<std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_some_v_cpo,
+               ForwardReader&,
+               span<const span<std::byte>>>)
+          -> tag_invoke_result_t<
+              async_read_some_v_cpo,
+              ForwardReader&,
+              span<const span<std::byte>>> {
+    return unifex::tag_invoke(*this, socket, buffers);
+  }
+
+  template(typename ForwardReader)
+      (requires (!tag_invocable<
+          async_read_some_v_cpo,
+          ForwardReader&,
+          span<const span<std::byte>>>) AND
+          tag_invocable<
+              async_read_some_cpo,
+              ForwardReader&,
+              span<std::byte>>)
+  auto operator()(
+      ForwardReader& socket,
+      span<const span<std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_some_cpo,
+               ForwardReader&,
+               span<std::byte>>)
+          -> tag_invoke_result_t<
+              async_read_some_cpo,
+              ForwardReader&,
+              span<std::byte>> {
+    return async_read_some(socket, _first_non_empty(buffers));
+  }
+} async_read_some_v{};
+
+inline const struct async_write_some_v_cpo {
+  template(typename ForwardWriter)
+      (requires tag_invocable<
+          async_write_some_v_cpo,
+          ForwardWriter&,
+          span<const span<const std::byte>>>)
+  auto operator()(
+      ForwardWriter& socket,
+      span<const span<const std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_some_v_cpo,
+               ForwardWriter&,
+               span<const span<const std::byte>>>)
+          -> tag_invoke_result_t<
+              async_write_some_v_cpo,
+              ForwardWriter&,
+              span<const span<const std::byte>>> {
+    return unifex::tag_invoke(*this, socket, buffers);
+  }
+
+  template(typename ForwardWriter)
+      (requires (!tag_invocable<
+          async_write_some_v_cpo,
+          ForwardWriter&,
+          span<const span<const std::byte>>>) AND
+          tag_invocable<
+              async_write_some_cpo,
+              ForwardWriter&,
+              span<const std::byte>>)
+  auto operator()(
+      ForwardWriter& socket,
+      span<const span<const std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_some_cpo,
+               ForwardWriter&,
+               span<const std::byte>>)
+          -> tag_invoke_result_t<
+              async_write_some_cpo,
+              ForwardWriter&,
+              span<const std::byte>> {
+    return async_write_some(socket, _first_non_empty(buffers));
+  }
+} async_write_some_v{};
+
+//
+// async_read_some_at_v / async_write_some_at_v
+//
+// The vectored forms of async_read_some_at and async_write_some_at. The
+// span of buffers only needs to live until the sender is constructed, but
+// the buffers themselves must live until the operation completes.
+//
+inline const struct async_read_some_at_v_cpo {
+  template(typename RandomReader)
+      (requires tag_invocable<
+          async_read_some_at_v_cpo,
+          RandomReader&,
+          typename RandomReader::offset_t,
+          span<const span<std::byte>>>)
+  auto operator()(
+      RandomReader& file,
+      typename RandomReader::offset_t offset,
+      span<const span<std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_some_at_v_cpo,
+               RandomReader&,
+               typename RandomReader::offset_t,
+               span<const span<std::byte>>>)
+          -> tag_invoke_result_t<
+              async_read_some_at_v_cpo,
+              RandomReader&,
+              typename RandomReader::offset_t,
+              span<const span<std::byte>>> {
+    return unifex::tag_invoke(*this, file, offset, buffers);
+  }
+
+  template(typename RandomReader)
+      (requires (!tag_invocable<
+          async_read_some_at_v_cpo,
+          RandomReader&,
+          typename RandomReader::offset_t,
+          span<const span<std::byte>>>) AND
+          tag_invocable<
+              async_read_some_at_cpo,
+              RandomReader&,
+              typename RandomReader::offset_t,
+              span<std::byte>>)
+  auto operator()(
+      RandomReader& file,
+      typename RandomReader::offset_t offset,
+      span<const span<std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_some_at_cpo,
+               RandomReader&,
+               typename RandomReader::offset_t,
+               span<std::byte>>)
+          -> tag_invoke_result_t<
+              async_read_some_at_cpo,
+              RandomReader&,
+              typename RandomReader::offset_t,
+              span<std::byte>> {
+    return async_read_some_at(file, offset, _first_non_empty(buffers));
+  }
+} async_read_some_at_v{};
+
+inline const struct async_write_some_at_v_cpo {
+  template(typename RandomWriter)
+      (requires tag_invocable<
+          async_write_some_at_v_cpo,
+          RandomWriter&,
+          typename RandomWriter::offset_t,
+          span<const span<const std::byte>>>)
+  auto operator()(
+      RandomWriter& file,
+      typename RandomWriter::offset_t offset,
+      span<const span<const std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_some_at_v_cpo,
+               RandomWriter&,
+               typename RandomWriter::offset_t,
+               span<const span<const std::byte>>>)
+          -> tag_invoke_result_t<
+              async_write_some_at_v_cpo,
+              RandomWriter&,
+              typename RandomWriter::offset_t,
+              span<const span<const std::byte>>> {
+    return unifex::tag_invoke(*this, file, offset, buffers);
+  }
+
+  template(typename RandomWriter)
+      (requires (!tag_invocable<
+          async_write_some_at_v_cpo,
+          RandomWriter&,
+          typename RandomWriter::offset_t,
+          span<const span<const std::byte>>>) AND
+          tag_invocable<
+              async_write_some_at_cpo,
+              RandomWriter&,
+              typename RandomWriter::offset_t,
+              span<const std::byte>>)
+  auto operator()(
+      RandomWriter& file,
+      typename RandomWriter::offset_t offset,
+      span<const span<const std::byte>> buffers) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_some_at_cpo,
+               RandomWriter&,
+               typename RandomWriter::offset_t,
+               span<const std::byte>>)
+          -> tag_invoke_result_t<
+              async_write_some_at_cpo,
+              RandomWriter&,
+              typename RandomWriter::offset_t,
+              span<const std::byte>> {
+    return async_write_some_at(file, offset, _first_non_empty(buffers));
+  }
+} async_write_some_at_v{};
+
+//
+// async_read_exactly_at / async_write_all_at
+//
+// Like async_read_some_at and async_write_some_at, but keep going after a
+// short read or write until the whole buffer is done, and send the total.
+// A read is only short if the file ends first. If the operation is stopped
+// part of the way through, it completes with done; if it fails part of the
+// way through, it completes with the error and the number of bytes already
+// transferred is lost.
+//
+// Files that don't customise them get a loop of async_read_some_at or
+// async_write_some_at calls, which also stops early if a call transfers
+// nothing.
+//
+template <typename Offset>
+struct _transfer_all_state {
+  Offset offset;
+  std::size_t done = 0;
+  bool ended = false;
+};
+
+// An offset of -1, which some files take to mean their current position,
+// isn't advanced.
+template <typename AsyncSomeAt, typename File, typename T>
+auto _transfer_all_at(
+    AsyncSomeAt asyncSomeAt,
+    File& file,
+    typename File::offset_t offset,
+    span<T> buffer) {
+  using state_t = _transfer_all_state<typename File::offset_t>;
+  return let_value_with(
+      [offset]() noexcept { return state_t{offset}; },
+      [asyncSomeAt, &file, buffer](state_t& state) {
+        return then(
+            repeat_effect_until(
+                defer([asyncSomeAt, &file, buffer, &state] {
+                  return then(
+                      asyncSomeAt(
+                          file, state.offset, buffer.after(state.done)),
+                      [&state](auto bytes) noexcept {
+                        if (bytes <= 0) {
+                          state.ended = true;
+                          return;
+                        }
+                        state.done += static_cast<std::size_t>(bytes);
+                        if (state.offset != -1) {
+                          state.offset += bytes;
+                        }
+                      });
+                }),
+                [&state, size = buffer.size()]() noexcept {
+                  return state.ended || state.done == size;
+                }),
+            [&state]() noexcept {
+              return static_cast<std::ptrdiff_t>(state.done);
+            });
+      });
+}
+
+inline const struct async_read_exactly_at_cpo {
+  template(typename RandomReader)
+      (requires tag_invocable<
+          async_read_exactly_at_cpo,
+          RandomReader&,
+          typename RandomReader::offset_t,
+          span<std::byte>>)
+  auto operator()(
+      RandomReader& file,
+      typename RandomReader::offset_t offset,
+      span<std::byte> buffer) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_exactly_at_cpo,
+               RandomReader&,
+               typename RandomReader::offset_t,
+               span<std::byte>>)
+          -> tag_invoke_result_t<
+              async_read_exactly_at_cpo,
+              RandomReader&,
+              typename RandomReader::offset_t,
+              span<std::byte>> {
+    return unifex::tag_invoke(*this, file, offset, buffer);
+  }
+
+  template(typename RandomReader)
+      (requires (!tag_invocable<
+          async_read_exactly_at_cpo,
+          RandomReader&,
+          typename RandomReader::offset_t,
+          span<std::byte>>) AND
+          tag_invocable<
+              async_read_some_at_cpo,
+              RandomReader&,
+              typename RandomReader::offset_t,
+              span<std::byte>>)
+  auto operator()(
+      RandomReader& file,
+      typename RandomReader::offset_t offset,
+      span<std::byte> buffer) const {
+    return _transfer_all_at(async_read_some_at, file, offset, buffer);
+  }
+} async_read_exactly_at{};
+
+inline const struct async_write_all_at_cpo {
+  template(typename RandomWriter)
+      (requires tag_invocable<
+          async_write_all_at_cpo,
+          RandomWriter&,
+          typename RandomWriter::offset_t,
+          span<const std::byte>>)
+  auto operator()(
+      RandomWriter& file,
+      typename RandomWriter::offset_t offset,
+      span<const std::byte> buffer) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_all_at_cpo,
+               RandomWriter&,
+               typename RandomWriter::offset_t,
+               span<const std::byte>>)
+          -> tag_invoke_result_t<
+              async_write_all_at_cpo,
+              RandomWriter&,
+              typename RandomWriter::offset_t,
+              span<const std::byte>> {
+    return unifex::tag_invoke(*this, file, offset, buffer);
+  }
+
+  template(typename RandomWriter)
+      (requires (!tag_invocable<
+          async_write_all_at_cpo,
+          RandomWriter&,
+          typename RandomWriter::offset_t,
+          span<const std::byte>>) AND
+          tag_invocable<
+              async_write_some_at_cpo,
+              RandomWriter&,
+              typename RandomWriter::offset_t,
+              span<const std::byte>>)
+  auto operator()(
+      RandomWriter& file,
+      typename RandomWriter::offset_t offset,
+      span<const std::byte> buffer) const {
+    return _transfer_all_at(async_write_some_at, file, offset, buffer);
+  }
+} async_write_all_at{};
 } // namespace _io_cpo
 
 using _io_cpo::async_read_some;
 using _io_cpo::async_write_some;
 using _io_cpo::async_read_some_at;
 using _io_cpo::async_write_some_at;
+using _io_cpo::async_read_some_v;
+using _io_cpo::async_write_some_v;
+using _io_cpo::async_read_some_at_v;
+using _io_cpo::async_write_some_at_v;
+using _io_cpo::async_read_exactly_at;
+using _io_cpo::async_write_all_at;
 
 } // namespace unifex
 
@@ -54,6 +54,12 @@ struct _op<Receiver, Values...>::type {
       unifex::set_error((Receiver &&) receiver_, std::current_exception());
     }
   }
+
+  // moving from a trivially copyable value leaves it unchanged so the
+  // operation can be started again as-is
+  template(bool Trivial = (std::is_trivially_copyable_v<Values> && ...))
+    (requires Trivial)
+  void restart() noexcept {}
 };
 
 template <typename... Values>
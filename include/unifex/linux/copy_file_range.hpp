@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace linuxos {
+
+// Copies up to `length` bytes from `fdIn` at `offsetIn` to `fdOut` at
+// `offsetOut` with copy_file_range(), and returns the number of bytes
+// copied, which is only less than `length` if the input ends first. An
+// offset of -1 reads or writes at the current position of that file.
+// Throws std::system_error on failure.
+std::size_t copy_file_range_all(
+    int fdIn,
+    std::int64_t offsetIn,
+    int fdOut,
+    std::int64_t offsetOut,
+    std::size_t length);
+
+namespace _copy_file_range {
+struct _fn {
+  // Copies the range on `sched` and sends the number of bytes copied. The
+  // data stays in the kernel, and file systems that support it share the
+  // blocks rather than copying them. It blocks the thread that runs it
+  // until the copy is done, so pass a thread pool's scheduler rather than
+  // an I/O context's.
+  template(typename Scheduler)
+    (requires scheduler<Scheduler>)
+  auto operator()(
+      Scheduler&& sched,
+      int fdIn,
+      std::int64_t offsetIn,
+      int fdOut,
+      std::int64_t offsetOut,
+      std::size_t length) const {
+    return then(
+        schedule((Scheduler &&) sched),
+        [fdIn, offsetIn, fdOut, offsetOut, length]() {
+          return copy_file_range_all(fdIn, offsetIn, fdOut, offsetOut, length);
+        });
+  }
+};
+} // namespace _copy_file_range
+
+inline constexpr _copy_file_range::_fn async_copy_file_range{};
+
+} // namespace linuxos
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
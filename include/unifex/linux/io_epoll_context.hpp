@@ -23,22 +23,29 @@
 #include <unifex/detail/intrusive_queue.hpp>
 #include <unifex/io_concepts.hpp>
 #include <unifex/pipe_concepts.hpp>
+#include <unifex/get_metrics.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/span.hpp>
+#include <unifex/splice_concepts.hpp>
 #include <unifex/stop_token_concepts.hpp>
 
+#include <unifex/linux/iovec_array.hpp>
 #include <unifex/linux/monotonic_clock.hpp>
 #include <unifex/linux/safe_file_descriptor.hpp>
 
 #include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <system_error>
 #include <utility>
 
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/uio.h>
 #include <sys/epoll.h>
 
@@ -55,7 +62,10 @@ class io_epoll_context {
   class schedule_after_sender;
   class scheduler;
   class read_sender;
+  class readv_sender;
   class write_sender;
+  class writev_sender;
+  class splice_sender;
   class async_reader;
   class async_writer;
 
@@ -68,6 +78,28 @@ class io_epoll_context {
 
   scheduler get_scheduler() noexcept;
 
+  struct metrics {
+    // How long each iteration of the run loop spent running tasks and
+    // reaping completions, excluding time spent in epoll_wait().
+    duration_histogram loopIterationTime;
+    std::uint64_t tasksExecuted;
+    // Operations scheduled from the I/O thread and from other threads.
+    // Remote ones are counted once the I/O thread has dequeued them.
+    std::uint64_t localEnqueues;
+    std::uint64_t remoteEnqueues;
+    // Writes to the eventfd that wakes the I/O thread for remote work.
+    std::uint64_t remoteQueueSignals;
+    // I/O completions received from the kernel.
+    std::uint64_t completions;
+    std::uint64_t timersPending;
+    // Times the I/O thread blocked waiting for I/O or remote work.
+    std::uint64_t parks;
+    std::chrono::nanoseconds idleTime;
+  };
+
+  friend metrics
+  tag_invoke(tag_t<get_metrics>, const io_epoll_context& context) noexcept;
+
  private:
   struct operation_base {
     ~operation_base() {
@@ -130,6 +162,8 @@ class io_epoll_context {
   void schedule_local(operation_base* op) noexcept;
   void schedule_local(operation_queue ops) noexcept;
   void schedule_remote(operation_base* op) noexcept;
+  // Moves items taken off the remote queue onto the local queue.
+  void schedule_dequeued_remote(operation_queue ops) noexcept;
 
   // Insert the timer operation into the queue of timers.
   // Must be called from the I/O thread.
@@ -191,11 +225,27 @@ class io_epoll_context {
   bool remoteQueueReadSubmitted_ = false;
   bool timersAreDirty_ = false;
 
+  // Metrics, read by get_metrics().
+  _metrics::histogram loopIterationTime_;
+  _metrics::counter tasksExecuted_;
+  _metrics::counter localEnqueues_;
+  // Counted as the I/O thread takes items off the remote queue, so that
+  // producers don't all update one shared atomic.
+  _metrics::counter remoteEnqueues_;
+  _metrics::counter completions_;
+  _metrics::counter timersInserted_;
+  _metrics::counter timersRemoved_;
+  _metrics::counter parks_;
+  _metrics::counter idleNanoseconds_;
+
   //////////////////
   // Data that is modified by remote threads
 
   // Queue of operations enqueued by remote threads.
   atomic_intrusive_queue<operation_base, &operation_base::next_> remoteQueue_;
+
+  // Metrics, read by get_metrics().
+  std::atomic<std::uint64_t> remoteQueueSignals_{0};
 };
 
 template <typename StopToken>
@@ -495,6 +545,25 @@ class io_epoll_context::scheduler {
       tag_t<open_pipe>,
       scheduler s);
 
+  friend splice_sender tag_invoke(
+      tag_t<async_splice>,
+      scheduler s,
+      int fdIn,
+      int fdOut,
+      std::size_t length) noexcept;
+  friend splice_sender tag_invoke(
+      tag_t<async_splice_all>,
+      scheduler s,
+      int fdIn,
+      int fdOut,
+      std::size_t length) noexcept;
+  friend splice_sender tag_invoke(
+      tag_t<async_tee>,
+      scheduler s,
+      int pipeIn,
+      int pipeOut,
+      std::size_t length) noexcept;
+
   friend bool operator==(scheduler a, scheduler b) noexcept {
     return a.context_ == b.context_;
   }
@@ -517,7 +586,10 @@ class io_epoll_context::read_sender {
   struct done_op : operation_base {
   };
 
-  template <typename Receiver>
+  friend readv_sender;
+
+  // Buffers is single_iovec, or iovec_array for a readv_sender.
+  template <typename Receiver, typename Buffers = single_iovec>
   class operation : private completion_base, private done_op {
     friend io_epoll_context;
 
@@ -526,13 +598,12 @@ class io_epoll_context::read_sender {
 
    public:
     template <typename Receiver2>
-    explicit operation(const read_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
-          fd_(sender.fd_),
-          receiver_((Receiver2 &&) r) {
-      buffer_[0].iov_base = sender.buffer_.data();
-      buffer_[0].iov_len = sender.buffer_.size();
-    }
+    explicit operation(
+        io_epoll_context& context, int fd, Buffers buffers, Receiver2&& r)
+        : context_(context),
+          fd_(fd),
+          buffers_(std::move(buffers)),
+          receiver_((Receiver2 &&) r) {}
 
     void start() noexcept {
       if (!context_.is_running_on_io_thread()) {
@@ -552,7 +623,7 @@ class io_epoll_context::read_sender {
     void start_io() noexcept {
       UNIFEX_ASSERT(context_.is_running_on_io_thread());
 
-      auto result = readv(fd_, buffer_, 1);
+      auto result = readv(fd_, buffers_.data(), buffers_.size());
 
       if (result == -EAGAIN || result == -EWOULDBLOCK || result == -EPERM) {
         if constexpr (is_stop_ever_possible) {
@@ -569,9 +640,9 @@ class io_epoll_context::read_sender {
       }
 
       auto oldState = state_.fetch_add(
-          io_epoll_context::read_sender::operation<Receiver>::io_flag,
+          operation::io_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::read_sender::operation<Receiver>::cancel_pending_mask) != 0) {
+      if ((oldState & operation::cancel_pending_mask) != 0) {
         // io has been cancelled by a remote thread.
         // The other thread is responsible for enqueueing the operation completion
         return;
@@ -604,9 +675,9 @@ class io_epoll_context::read_sender {
       self.stopCallback_.destruct();
 
       auto oldState = self.state_.fetch_add(
-          io_epoll_context::read_sender::operation<Receiver>::io_flag,
+          operation::io_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::read_sender::operation<Receiver>::cancel_pending_mask) != 0) {
+      if ((oldState & operation::cancel_pending_mask) != 0) {
         // io has been cancelled by a remote thread.
         // The other thread is responsible for enqueueing the operation completion
         return;
@@ -615,7 +686,8 @@ class io_epoll_context::read_sender {
       epoll_event event = {};
       (void)epoll_ctl(self.context_.epollFd_.get(), EPOLL_CTL_DEL, self.fd_, &event);
 
-      auto result = readv(self.fd_, self.buffer_, 1);
+      auto result =
+          readv(self.fd_, self.buffers_.data(), self.buffers_.size());
       UNIFEX_ASSERT(result != -EAGAIN);
       UNIFEX_ASSERT(result != -EWOULDBLOCK);
       if (result == -ECANCELED) {
@@ -659,9 +731,9 @@ class io_epoll_context::read_sender {
 
     void request_stop() noexcept {
       auto oldState = this->state_.fetch_add(
-          io_epoll_context::read_sender::operation<Receiver>::cancel_pending_flag,
+          operation::cancel_pending_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::read_sender::operation<Receiver>::io_mask) == 0) {
+      if ((oldState & operation::io_mask) == 0) {
         // IO not yet completed.
         epoll_event event = {};
         (void)epoll_ctl(this->context_.epollFd_.get(), EPOLL_CTL_DEL, this->fd_, &event);
@@ -683,7 +755,7 @@ class io_epoll_context::read_sender {
 
     io_epoll_context& context_;
     int fd_;
-    iovec buffer_[1];
+    Buffers buffers_;
     Receiver receiver_;
     manual_lifetime<typename stop_token_type_t<
       Receiver>::template callback_type<cancel_callback>>
@@ -715,7 +787,8 @@ class io_epoll_context::read_sender {
 
   template <typename Receiver>
   operation<std::decay_t<Receiver>> connect(Receiver&& r) && {
-    return operation<std::decay_t<Receiver>>{*this, (Receiver &&) r};
+    return operation<std::decay_t<Receiver>>{
+        context_, fd_, single_iovec{buffer_}, (Receiver &&) r};
   }
 
  private:
@@ -724,12 +797,51 @@ class io_epoll_context::read_sender {
   span<std::byte> buffer_;
 };
 
+// A vectored read. The iovecs are copied when the sender is constructed, so
+// only the buffers themselves need to outlive the operation.
+class io_epoll_context::readv_sender {
+  template <typename Receiver>
+  using operation = read_sender::operation<Receiver, iovec_array>;
+
+ public:
+  // Produces number of bytes read.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  explicit readv_sender(
+      io_epoll_context& context,
+      int fd,
+      span<const span<std::byte>> buffers)
+      : context_(context), fd_(fd), buffers_(buffers) {}
+
+  template <typename Receiver>
+  operation<std::decay_t<Receiver>> connect(Receiver&& r) && {
+    return operation<std::decay_t<Receiver>>{
+        context_, fd_, std::move(buffers_), (Receiver &&) r};
+  }
+
+ private:
+  io_epoll_context& context_;
+  int fd_;
+  iovec_array buffers_;
+};
+
 class io_epoll_context::write_sender {
 
   struct done_op : operation_base {
   };
 
-  template <typename Receiver>
+  friend writev_sender;
+
+  // Buffers is single_iovec, or iovec_array for a writev_sender.
+  template <typename Receiver, typename Buffers = single_iovec>
   class operation : private completion_base, private done_op {
     friend io_epoll_context;
 
@@ -737,13 +849,12 @@ class io_epoll_context::write_sender {
         !is_stop_never_possible_v<stop_token_type_t<Receiver>>;
    public:
     template <typename Receiver2>
-    explicit operation(const write_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
-          fd_(sender.fd_),
-          receiver_((Receiver2 &&) r) {
-      buffer_[0].iov_base = (void*)sender.buffer_.data();
-      buffer_[0].iov_len = sender.buffer_.size();
-    }
+    explicit operation(
+        io_epoll_context& context, int fd, Buffers buffers, Receiver2&& r)
+        : context_(context),
+          fd_(fd),
+          buffers_(std::move(buffers)),
+          receiver_((Receiver2 &&) r) {}
 
     void start() noexcept {
       if (!context_.is_running_on_io_thread()) {
@@ -764,7 +875,7 @@ class io_epoll_context::write_sender {
     void start_io() noexcept {
       UNIFEX_ASSERT(context_.is_running_on_io_thread());
 
-      auto result = writev(fd_, buffer_, 1);
+      auto result = writev(fd_, buffers_.data(), buffers_.size());
 
       if (result == -EAGAIN || result == -EWOULDBLOCK || result == -EPERM) {
         if constexpr (is_stop_ever_possible) {
@@ -782,9 +893,9 @@ class io_epoll_context::write_sender {
       }
 
       auto oldState = state_.fetch_add(
-          io_epoll_context::write_sender::operation<Receiver>::io_flag,
+          operation::io_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::write_sender::operation<Receiver>::cancel_pending_mask) != 0) {
+      if ((oldState & operation::cancel_pending_mask) != 0) {
         // io has been cancelled by a remote thread.
         // The other thread is responsible for enqueueing the operation completion
         return;
@@ -820,15 +931,16 @@ class io_epoll_context::write_sender {
       (void)epoll_ctl(self.context_.epollFd_.get(), EPOLL_CTL_DEL, self.fd_, &event);
 
       auto oldState = self.state_.fetch_add(
-          io_epoll_context::write_sender::operation<Receiver>::io_flag,
+          operation::io_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::write_sender::operation<Receiver>::cancel_pending_mask) != 0) {
+      if ((oldState & operation::cancel_pending_mask) != 0) {
         // io has been cancelled by a remote thread.
         // The other thread is responsible for enqueueing the operation completion
         return;
       }
 
-      auto result = writev(self.fd_, self.buffer_, 1);
+      auto result =
+          writev(self.fd_, self.buffers_.data(), self.buffers_.size());
       UNIFEX_ASSERT(result != -EAGAIN);
       UNIFEX_ASSERT(result != -EWOULDBLOCK);
       if (result == -ECANCELED) {
@@ -872,9 +984,9 @@ class io_epoll_context::write_sender {
 
     void request_stop() noexcept {
       auto oldState = this->state_.fetch_add(
-          io_epoll_context::write_sender::operation<Receiver>::cancel_pending_flag,
+          operation::cancel_pending_flag,
           std::memory_order_acq_rel);
-      if ((oldState & io_epoll_context::write_sender::operation<Receiver>::io_mask) == 0) {
+      if ((oldState & operation::io_mask) == 0) {
         // IO not yet completed.
         epoll_event event = {};
         (void)epoll_ctl(this->context_.epollFd_.get(), EPOLL_CTL_DEL, this->fd_, &event);
@@ -896,7 +1008,7 @@ class io_epoll_context::write_sender {
 
     io_epoll_context& context_;
     int fd_;
-    iovec buffer_[1];
+    Buffers buffers_;
     Receiver receiver_;
     manual_lifetime<typename stop_token_type_t<
       Receiver>::template callback_type<cancel_callback>>
@@ -928,7 +1040,8 @@ class io_epoll_context::write_sender {
 
   template <typename Receiver>
   operation<std::decay_t<Receiver>> connect(Receiver&& r) && {
-    return operation<std::decay_t<Receiver>>{*this, (Receiver &&) r};
+    return operation<std::decay_t<Receiver>>{
+        context_, fd_, single_iovec{buffer_}, (Receiver &&) r};
   }
 
  private:
@@ -937,6 +1050,353 @@ class io_epoll_context::write_sender {
   span<const std::byte> buffer_;
 };
 
+// A vectored write. The iovecs are copied when the sender is constructed, so
+// only the buffers themselves need to outlive the operation.
+class io_epoll_context::writev_sender {
+  template <typename Receiver>
+  using operation = write_sender::operation<Receiver, iovec_array>;
+
+ public:
+  // Produces number of bytes written.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  explicit writev_sender(
+      io_epoll_context& context,
+      int fd,
+      span<const span<const std::byte>> buffers)
+      : context_(context), fd_(fd), buffers_(buffers) {}
+
+  template <typename Receiver>
+  operation<std::decay_t<Receiver>> connect(Receiver&& r) && {
+    return operation<std::decay_t<Receiver>>{
+        context_, fd_, std::move(buffers_), (Receiver &&) r};
+  }
+
+ private:
+  io_epoll_context& context_;
+  int fd_;
+  iovec_array buffers_;
+};
+
+class io_epoll_context::splice_sender {
+
+  struct done_op : operation_base {
+  };
+
+  template <typename Receiver>
+  class operation : private completion_base, private done_op {
+    friend io_epoll_context;
+
+    static constexpr bool is_stop_ever_possible =
+        !is_stop_never_possible_v<stop_token_type_t<Receiver>>;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const splice_sender& sender, Receiver2&& r)
+        : context_(sender.context_),
+          tee_(sender.tee_),
+          fdIn_(sender.fdIn_),
+          fdOut_(sender.fdOut_),
+          length_(sender.length_),
+          transferAll_(sender.transferAll_),
+          receiver_((Receiver2 &&) r) {}
+
+    void start() noexcept {
+      if (!context_.is_running_on_io_thread()) {
+        static_cast<completion_base*>(this)->execute_ = &operation::on_schedule_complete;
+        context_.schedule_remote(static_cast<completion_base*>(this));
+      } else {
+        start_io();
+      }
+    }
+
+   private:
+    static void on_schedule_complete(operation_base* op) noexcept {
+      auto& self = *static_cast<operation*>(static_cast<completion_base*>(op));
+      self.start_io();
+    }
+
+    void start_io() noexcept {
+      UNIFEX_ASSERT(context_.is_running_on_io_thread());
+
+      if (!transfer()) {
+        if constexpr (is_stop_ever_possible) {
+          stopCallback_.construct(
+              get_stop_token(receiver_), cancel_callback{*this});
+        }
+        wait();
+        return;
+      }
+
+      auto oldState = state_.fetch_add(io_flag, std::memory_order_acq_rel);
+      if ((oldState & cancel_pending_mask) != 0) {
+        // io has been cancelled by a remote thread.
+        // The other thread is responsible for enqueueing the operation completion
+        return;
+      }
+      complete();
+    }
+
+    // Splices as much as it can without blocking. Returns false if it has to
+    // wait for one of the file descriptors before it can go on.
+    bool transfer() noexcept {
+      while (length_ != 0) {
+        const ssize_t result = tee_
+            ? ::tee(fdIn_, fdOut_, length_, SPLICE_F_NONBLOCK)
+            : ::splice(
+                  fdIn_, nullptr, fdOut_, nullptr, length_,
+                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (result < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+          }
+          error_ = errno;
+          return true;
+        }
+        transferred_ += result;
+        length_ -= static_cast<std::size_t>(result);
+        if (result == 0 || !transferAll_) {
+          break;
+        }
+      }
+      return true;
+    }
+
+    // Waits for the input to become readable, or if it already is, for the
+    // output to become writable.
+    void wait() noexcept {
+      pollfd in = {};
+      in.fd = fdIn_;
+      in.events = POLLIN;
+      const bool inputReady = ::poll(&in, 1, 0) == 1;
+      const int fd = inputReady ? fdOut_ : fdIn_;
+      waitFd_.store(fd);
+
+      UNIFEX_ASSERT(static_cast<completion_base*>(this)->enqueued_.load() == 0);
+      static_cast<completion_base*>(this)->execute_ = &operation::on_ready;
+      epoll_event event;
+      event.data.ptr = static_cast<completion_base*>(this);
+      event.events = inputReady ? EPOLLOUT | EPOLLHUP
+                                : EPOLLIN | EPOLLRDHUP | EPOLLHUP;
+      if (epoll_ctl(context_.epollFd_.get(), EPOLL_CTL_ADD, fd, &event) != 0) {
+        error_ = errno;
+        finish();
+        return;
+      }
+      // A stop request may have looked at waitFd_ before it was stored. If
+      // so, it missed this fd and the request is seen here instead.
+      if ((state_.load() & cancel_pending_mask) != 0) {
+        event = {};
+        (void)epoll_ctl(context_.epollFd_.get(), EPOLL_CTL_DEL, fd, &event);
+      }
+    }
+
+    static void on_ready(operation_base* op) noexcept {
+      auto& self = *static_cast<operation*>(static_cast<completion_base*>(op));
+
+      UNIFEX_ASSERT(static_cast<completion_base&>(self).enqueued_.load() == 0);
+
+      epoll_event event = {};
+      (void)epoll_ctl(
+          self.context_.epollFd_.get(),
+          EPOLL_CTL_DEL,
+          self.waitFd_.load(),
+          &event);
+
+      if ((self.state_.load(std::memory_order_acquire) & cancel_pending_mask) != 0) {
+        // The thread that requested stop completes the operation.
+        return;
+      }
+
+      if (!self.transfer()) {
+        self.wait();
+        return;
+      }
+      self.finish();
+    }
+
+    void finish() noexcept {
+      if constexpr (is_stop_ever_possible) {
+        stopCallback_.destruct();
+      }
+
+      auto oldState = state_.fetch_add(io_flag, std::memory_order_acq_rel);
+      if ((oldState & cancel_pending_mask) != 0) {
+        // io has been cancelled by a remote thread.
+        // The other thread is responsible for enqueueing the operation completion
+        return;
+      }
+      complete();
+    }
+
+    void complete() noexcept {
+      if (error_ != 0) {
+        unifex::set_error(
+            std::move(receiver_),
+            std::error_code{error_, std::system_category()});
+      } else if constexpr (is_nothrow_receiver_of_v<Receiver, ssize_t>) {
+        unifex::set_value(std::move(receiver_), transferred_);
+      } else {
+        UNIFEX_TRY {
+          unifex::set_value(std::move(receiver_), transferred_);
+        } UNIFEX_CATCH (...) {
+          unifex::set_error(std::move(receiver_), std::current_exception());
+        }
+      }
+    }
+
+    static void complete_with_done(operation_base* op) noexcept {
+      auto& self = *static_cast<operation*>(static_cast<done_op*>(op));
+
+      UNIFEX_ASSERT(static_cast<done_op&>(self).enqueued_.load() == 0);
+
+      if (static_cast<completion_base&>(self).enqueued_.load() == 0) {
+        // Avoid instantiating set_done() if we're not going to call it.
+        if constexpr (is_stop_ever_possible) {
+          unifex::set_done(std::move(self.receiver_));
+        } else {
+          // This should never be called if stop is not possible.
+          UNIFEX_ASSERT(false);
+        }
+      } else {
+        // reschedule after queued io is cleared
+        static_cast<done_op&>(self).execute_ = &operation::complete_with_done;
+        self.context_.schedule_local(static_cast<done_op*>(&self));
+      }
+    }
+
+    void request_stop() noexcept {
+      // Sequentially consistent, along with waitFd_, so that either this
+      // removes the fd that wait() added or wait() sees this request.
+      auto oldState = this->state_.fetch_add(cancel_pending_flag);
+      if ((oldState & io_mask) == 0) {
+        // IO not yet completed.
+        epoll_event event = {};
+        (void)epoll_ctl(
+            this->context_.epollFd_.get(),
+            EPOLL_CTL_DEL,
+            this->waitFd_.load(),
+            &event);
+
+        // We are responsible for scheduling the completion of this io
+        // operation.
+        static_cast<done_op&>(*this).execute_ = &operation::complete_with_done;
+        this->context_.schedule_remote(static_cast<done_op*>(this));
+      }
+    }
+
+    struct cancel_callback {
+      operation& op_;
+
+      void operator()() noexcept {
+        op_.request_stop();
+      }
+    };
+
+    io_epoll_context& context_;
+    bool tee_;
+    int fdIn_;
+    int fdOut_;
+    std::size_t length_;
+    bool transferAll_;
+    ssize_t transferred_ = 0;
+    int error_ = 0;
+    // The file descriptor that the operation is waiting on, if any.
+    std::atomic<int> waitFd_ = -1;
+    Receiver receiver_;
+    manual_lifetime<typename stop_token_type_t<
+      Receiver>::template callback_type<cancel_callback>>
+      stopCallback_;
+    static constexpr std::uint32_t io_flag = 0x00010000;
+    static constexpr std::uint32_t io_mask = 0xFFFF0000;
+    static constexpr std::uint32_t cancel_pending_flag = 1;
+    static constexpr std::uint32_t cancel_pending_mask = 0xFFFF;
+    std::atomic<std::uint32_t> state_ = 0;
+  };
+
+ public:
+  // Produces number of bytes moved.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  // Calls tee() rather than splice() if `tee` is set. If `transferAll` is
+  // set, it keeps going until `length` bytes have been moved or `fdIn` ends.
+  explicit splice_sender(
+      io_epoll_context& context,
+      bool tee,
+      int fdIn,
+      int fdOut,
+      std::size_t length,
+      bool transferAll = false) noexcept
+      : context_(context),
+        tee_(tee),
+        fdIn_(fdIn),
+        fdOut_(fdOut),
+        length_(length),
+        transferAll_(transferAll) {}
+
+  template <typename Receiver>
+  operation<std::decay_t<Receiver>> connect(Receiver&& r) && {
+    return operation<std::decay_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_epoll_context& context_;
+  bool tee_;
+  int fdIn_;
+  int fdOut_;
+  std::size_t length_;
+  bool transferAll_;
+};
+
+inline io_epoll_context::splice_sender tag_invoke(
+    tag_t<async_splice>,
+    io_epoll_context::scheduler s,
+    int fdIn,
+    int fdOut,
+    std::size_t length) noexcept {
+  return io_epoll_context::splice_sender{
+      *s.context_, false, fdIn, fdOut, length};
+}
+
+inline io_epoll_context::splice_sender tag_invoke(
+    tag_t<async_splice_all>,
+    io_epoll_context::scheduler s,
+    int fdIn,
+    int fdOut,
+    std::size_t length) noexcept {
+  return io_epoll_context::splice_sender{
+      *s.context_, false, fdIn, fdOut, length, true};
+}
+
+inline io_epoll_context::splice_sender tag_invoke(
+    tag_t<async_tee>,
+    io_epoll_context::scheduler s,
+    int pipeIn,
+    int pipeOut,
+    std::size_t length) noexcept {
+  return io_epoll_context::splice_sender{
+      *s.context_, true, pipeIn, pipeOut, length};
+}
+
 class io_epoll_context::async_reader {
  public:
 
@@ -953,6 +1413,13 @@ class io_epoll_context::async_reader {
     return read_sender{reader.context_, reader.fd_.get(), buffer};
   }
 
+  friend readv_sender tag_invoke(
+      tag_t<async_read_some_v>,
+      async_reader& reader,
+      span<const span<std::byte>> buffers) {
+    return readv_sender{reader.context_, reader.fd_.get(), buffers};
+  }
+
   io_epoll_context& context_;
   safe_file_descriptor fd_;
 };
@@ -973,6 +1440,13 @@ class io_epoll_context::async_writer {
     return write_sender{writer.context_, writer.fd_.get(), buffer};
   }
 
+  friend writev_sender tag_invoke(
+      tag_t<async_write_some_v>,
+      async_writer& writer,
+      span<const span<const std::byte>> buffers) {
+    return writev_sender{writer.context_, writer.fd_.get(), buffers};
+  }
+
   io_epoll_context& context_;
   safe_file_descriptor fd_;
 };
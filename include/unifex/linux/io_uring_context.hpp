@@ -23,22 +23,28 @@
 #include <unifex/detail/intrusive_queue.hpp>
 #include <unifex/defer.hpp>
 #include <unifex/file_concepts.hpp>
+#include <unifex/get_metrics.hpp>
 #include <unifex/filesystem.hpp>
 #include <unifex/io_concepts.hpp>
 #include <unifex/just_done.hpp>
 #include <unifex/let_value_with.hpp>
 #include <unifex/socket_concepts.hpp>
+#include <unifex/splice_concepts.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/span.hpp>
 #include <unifex/stop_token_concepts.hpp>
 
+#include <unifex/linux/iovec_array.hpp>
 #include <unifex/linux/mmap_region.hpp>
 #include <unifex/linux/monotonic_clock.hpp>
 #include <unifex/linux/safe_file_descriptor.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -49,6 +55,7 @@
 #include UNIFEX_LIBURING_HEADER
 
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -65,7 +72,12 @@ class io_uring_context {
   template <typename Duration>
   class schedule_after_sender;
   class read_sender;
+  class readv_sender;
   class write_sender;
+  class writev_sender;
+  class splice_sender;
+  template <typename Derived, typename Receiver>
+  class transfer_operation;
   class async_read_only_file;
   class async_read_write_file;
   class async_write_only_file;
@@ -82,6 +94,33 @@ class io_uring_context {
 
   scheduler get_scheduler() noexcept;
 
+  struct metrics {
+    // How long each iteration of the run loop spent running tasks and
+    // reaping completions, excluding time spent in io_uring_enter().
+    duration_histogram loopIterationTime;
+    std::uint64_t tasksExecuted;
+    // Operations scheduled from the I/O thread and from other threads.
+    // Remote ones are counted once the I/O thread has dequeued them.
+    std::uint64_t localEnqueues;
+    std::uint64_t remoteEnqueues;
+    // Writes to the eventfd that wakes the I/O thread for remote work.
+    std::uint64_t remoteQueueSignals;
+    // I/O completions received from the kernel.
+    std::uint64_t completions;
+    // Operations that had to wait for space in the submission or
+    // completion queue.
+    std::uint64_t sqFullEvents;
+    // Completions the kernel dropped because the completion queue was full.
+    std::uint64_t cqOverflows;
+    std::uint64_t timersPending;
+    // Times the I/O thread blocked waiting for I/O or remote work.
+    std::uint64_t parks;
+    std::chrono::nanoseconds idleTime;
+  };
+
+  friend metrics
+  tag_invoke(tag_t<get_metrics>, const io_uring_context& context) noexcept;
+
  private:
   struct operation_base {
     operation_base() noexcept {}
@@ -141,6 +180,8 @@ class io_uring_context {
   void schedule_local(operation_base* op) noexcept;
   void schedule_local(operation_queue ops) noexcept;
   void schedule_remote(operation_base* op) noexcept;
+  // Moves items taken off the remote queue onto the local queue.
+  void schedule_dequeued_remote(operation_queue ops) noexcept;
 
   // Schedule some operation to be run when there is next available I/O slots.
   void schedule_pending_io(operation_base* op) noexcept;
@@ -281,11 +322,28 @@ class io_uring_context {
 
   __kernel_timespec time_;
 
+  // Metrics, read by get_metrics().
+  _metrics::histogram loopIterationTime_;
+  _metrics::counter tasksExecuted_;
+  _metrics::counter localEnqueues_;
+  // Counted as the I/O thread takes items off the remote queue, so that
+  // producers don't all update one shared atomic.
+  _metrics::counter remoteEnqueues_;
+  _metrics::counter completions_;
+  _metrics::counter sqFullEvents_;
+  _metrics::counter timersInserted_;
+  _metrics::counter timersRemoved_;
+  _metrics::counter parks_;
+  _metrics::counter idleNanoseconds_;
+
   //////////////////
   // Data that is modified by remote threads
 
   // Queue of operations enqueued by remote threads.
   atomic_intrusive_queue<operation_base, &operation_base::next_> remoteQueue_;
+
+  // Metrics, read by get_metrics().
+  std::atomic<std::uint64_t> remoteQueueSignals_{0};
 };
 
 template <typename StopToken>
@@ -407,162 +465,266 @@ class io_uring_context::schedule_sender {
   io_uring_context& context_;
 };
 
-class io_uring_context::read_sender {
-  using offset_t = std::int64_t;
+// The parts of a read, write or splice that don't depend on what it moves:
+// starting on the I/O thread, cancelling the request when stop is requested,
+// resubmitting the rest of an operation that transfers everything, and
+// completing with the number of bytes done.
+//
+// Derived provides populate_sqe(), which fills in everything but the
+// user_data, and advance(bytes), which skips the bytes done by a short
+// transfer and returns whether any are left. It may also hide
+// wait_until_ready() to retry a request that failed.
+template <typename Derived, typename Receiver>
+class io_uring_context::transfer_operation : protected completion_base {
+ public:
+  void start() noexcept {
+    if (!context_.is_running_on_io_thread()) {
+      this->execute_ = &transfer_operation::on_schedule_complete;
+      context_.schedule_remote(this);
+    } else {
+      start_io();
+    }
+  }
 
-  template <typename Receiver>
-  class operation : private completion_base {
-    friend io_uring_context;
+ protected:
+  template <typename Receiver2>
+  explicit transfer_operation(
+      io_uring_context& context, bool transferAll, Receiver2&& r)
+      : context_(context),
+        transferAll_(transferAll),
+        receiver_((Receiver2 &&) r) {}
+
+  void submit_io() noexcept {
+    auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
+      derived().populate_sqe(sqe);
+      sqe.user_data = reinterpret_cast<std::uintptr_t>(
+          static_cast<completion_base*>(this));
+
+      this->execute_ = &transfer_operation::on_complete;
+    };
 
-   public:
-    template <typename Receiver2>
-    explicit operation(const read_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
-          fd_(sender.fd_),
-          offset_(sender.offset_),
-          receiver_((Receiver2 &&) r) {
-      buffer_[0].iov_base = sender.buffer_.data();
-      buffer_[0].iov_len = sender.buffer_.size();
+    if (!context_.try_submit_io(populateSqe)) {
+      this->execute_ = &transfer_operation::on_submit_ready;
+      context_.schedule_pending_io(this);
     }
+  }
 
-    void start() noexcept {
-      if (!context_.is_running_on_io_thread()) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_remote(this);
+  static void on_submit_ready(operation_base* op) noexcept {
+    from(op).submit_io();
+  }
+
+  // Returns false, so a failed request completes the operation.
+  bool wait_until_ready() noexcept { return false; }
+
+  static void on_complete(operation_base* op) noexcept {
+    auto& self = from(op);
+    if (self.resubmit_rest() || self.derived().wait_until_ready()) {
+      return;
+    }
+    if (self.refCount_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      // stop callback is running, must complete the op
+      return;
+    }
+    self.stopCallback_.destruct();
+    if (get_stop_token(self.receiver_).stop_requested()) {
+      unifex::set_done(std::move(self.receiver_));
+    } else if (self.result_ >= 0) {
+      if constexpr (noexcept(unifex::set_value(std::move(self.receiver_), self.transferred_ + self.result_))) {
+        unifex::set_value(std::move(self.receiver_), self.transferred_ + self.result_);
       } else {
-        start_io();
+        UNIFEX_TRY {
+          unifex::set_value(std::move(self.receiver_), self.transferred_ + self.result_);
+        } UNIFEX_CATCH (...) {
+          unifex::set_error(std::move(self.receiver_), std::current_exception());
+        }
       }
+    } else if (self.result_ == -ECANCELED) {
+      unifex::set_done(std::move(self.receiver_));
+    } else {
+      unifex::set_error(
+          std::move(self.receiver_),
+          std::error_code{-self.result_, std::system_category()});
     }
+  }
 
-   private:
-    static void on_schedule_complete(operation_base* op) noexcept {
-      static_cast<operation*>(op)->start_io();
-    }
+  io_uring_context& context_;
+  bool transferAll_;
+  // Bytes done by earlier submissions of an operation that transfers
+  // everything.
+  ssize_t transferred_ = 0;
+  Receiver receiver_;
+  std::atomic_char refCount_{1};
 
-    void start_io() noexcept {
-      UNIFEX_ASSERT(context_.is_running_on_io_thread());
-      stopCallback_.construct(
-            get_stop_token(receiver_), cancel_callback{*this});
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
-        sqe.opcode = IORING_OP_READV;
-        sqe.fd = fd_;
-        sqe.off = offset_;
-        sqe.addr = reinterpret_cast<std::uintptr_t>(&buffer_[0]);
-        sqe.len = 1;
-        sqe.user_data = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
+ private:
+  static transfer_operation& from(operation_base* op) noexcept {
+    return *static_cast<transfer_operation*>(static_cast<completion_base*>(op));
+  }
 
-        this->execute_ = &operation::on_read_complete;
-      };
+  Derived& derived() noexcept { return static_cast<Derived&>(*this); }
 
-      if (!context_.try_submit_io(populateSqe)) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_pending_io(this);
-      }
+  static void on_schedule_complete(operation_base* op) noexcept {
+    from(op).start_io();
+  }
+
+  void start_io() noexcept {
+    UNIFEX_ASSERT(context_.is_running_on_io_thread());
+    stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{*this});
+    submit_io();
+  }
+
+  // After a short transfer by an operation that should transfer everything,
+  // submits the rest straight from the completion. Returns false if there
+  // is nothing left to transfer, or if the operation is being cancelled.
+  bool resubmit_rest() noexcept {
+    if (!transferAll_ || this->result_ <= 0 ||
+        refCount_.load(std::memory_order_relaxed) != 1) {
+      return false;
+    }
+    transferred_ += this->result_;
+    const bool more =
+        derived().advance(static_cast<std::size_t>(this->result_));
+    this->result_ = 0;
+    if (!more || get_stop_token(receiver_).stop_requested()) {
+      return false;
     }
+    submit_io();
+    return true;
+  }
 
-    void request_stop() noexcept {
-      if (char expected = 1; !refCount_.compare_exchange_strong(expected, 2, std::memory_order_relaxed)) {
-        // lost race with on_read_complete
-        UNIFEX_ASSERT(expected == 0);
-        return;
-      }
-      if (context_.is_running_on_io_thread()) {
-        request_stop_local();
-      } else {
-        request_stop_remote();
-      }
+  void request_stop() noexcept {
+    if (char expected = 1; !refCount_.compare_exchange_strong(expected, 2, std::memory_order_relaxed)) {
+      // lost race with on_complete
+      UNIFEX_ASSERT(expected == 0);
+      return;
     }
+    if (context_.is_running_on_io_thread()) {
+      request_stop_local();
+    } else {
+      request_stop_remote();
+    }
+  }
 
-    void request_stop_local() noexcept {
-      UNIFEX_ASSERT(context_.is_running_on_io_thread());
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
-        sqe.opcode = IORING_OP_ASYNC_CANCEL;
-        sqe.fd = -1;
-        sqe.off = 0;
-        auto op = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
-        // sqe.addr is the user_data to look for and cancel
-        sqe.addr = op;
-        sqe.len = 0;
-        auto cop = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(&cop_));
-        sqe.user_data = cop;
-        cop_.execute_ = &cancel_operation::on_stop_complete;
-      };
+  void request_stop_local() noexcept {
+    UNIFEX_ASSERT(context_.is_running_on_io_thread());
+    auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
+      sqe.opcode = IORING_OP_ASYNC_CANCEL;
+      sqe.fd = -1;
+      sqe.off = 0;
+      auto op = reinterpret_cast<std::uintptr_t>(
+          static_cast<completion_base*>(this));
+      // sqe.addr is the user_data to look for and cancel
+      sqe.addr = op;
+      sqe.len = 0;
+      auto cop = reinterpret_cast<std::uintptr_t>(
+          static_cast<completion_base*>(&cop_));
+      sqe.user_data = cop;
+      cop_.execute_ = &cancel_operation::on_stop_complete;
+    };
 
-      if (!context_.try_submit_io(populateSqe)) {
-        cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
-        context_.schedule_pending_io(&cop_);
-      }
+    if (!context_.try_submit_io(populateSqe)) {
+      cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
+      context_.schedule_pending_io(&cop_);
     }
+  }
 
-    void request_stop_remote() noexcept {
-      cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
-      context_.schedule_remote(&cop_);
+  void request_stop_remote() noexcept {
+    cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
+    context_.schedule_remote(&cop_);
+  }
+
+  struct cancel_operation final : completion_base {
+    transfer_operation& op_;
+
+    explicit cancel_operation(transfer_operation& op) noexcept : op_(op) {}
+    // intrusive list breaks if the same operation is submitted twice
+    // break the cycle: `on_stop_complete` delegates to the parent operation
+    static void on_stop_complete(operation_base* op) noexcept {
+      transfer_operation::on_complete(static_cast<completion_base*>(
+          &static_cast<cancel_operation*>(op)->op_));
     }
 
-    static void on_read_complete(operation_base* op) noexcept {
-      auto& self = *static_cast<operation*>(op);
-      if (self.refCount_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
-        // stop callback is running, must complete the op
-        return;
-      }
-      self.stopCallback_.destruct();
-      if (get_stop_token(self.receiver_).stop_requested()) {
-        unifex::set_done(std::move(self.receiver_));
-      } else if (self.result_ >= 0) {
-        if constexpr (noexcept(unifex::set_value(std::move(self.receiver_), ssize_t(self.result_)))) {
-          unifex::set_value(std::move(self.receiver_), ssize_t(self.result_));
-        } else {
-          UNIFEX_TRY {
-            unifex::set_value(std::move(self.receiver_), ssize_t(self.result_));
-          } UNIFEX_CATCH (...) {
-            unifex::set_error(std::move(self.receiver_), std::current_exception());
-          }
-        }
-      } else if (self.result_ == -ECANCELED) {
-        unifex::set_done(std::move(self.receiver_));
-      } else {
-        unifex::set_error(
-            std::move(self.receiver_),
-            std::error_code{-self.result_, std::system_category()});
-      }
+    static void on_schedule_stop_complete(operation_base* op) noexcept {
+      static_cast<cancel_operation*>(op)->op_.request_stop_local();
     }
+  };
 
-    struct cancel_operation final : completion_base {
-      operation& op_;
+  struct cancel_callback final {
+    transfer_operation& op_;
 
-      explicit cancel_operation(operation& op) noexcept : op_(op) {}
-      // intrusive list breaks if the same operation is submitted twice
-      // break the cycle: `on_stop_complete` delegates to the parent operation
-      static void on_stop_complete(operation_base* op) noexcept {
-        operation::on_read_complete(&static_cast<cancel_operation*>(op)->op_);
-      }
+    void operator()() noexcept {
+      op_.request_stop();
+    }
+  };
 
-      static void on_schedule_stop_complete(operation_base* op) noexcept {
-        static_cast<cancel_operation*>(op)->op_.request_stop_local();
+  manual_lifetime<typename stop_token_type_t<
+      Receiver>::template callback_type<cancel_callback>>
+      stopCallback_;
+  cancel_operation cop_{*this};
+};
+
+class io_uring_context::read_sender {
+  using offset_t = std::int64_t;
+
+  friend readv_sender;
+
+  // Buffers is single_iovec, or iovec_array for a readv_sender.
+  template <typename Receiver, typename Buffers = single_iovec>
+  class operation
+    : public transfer_operation<operation<Receiver, Buffers>, Receiver> {
+    using base = transfer_operation<operation, Receiver>;
+    friend base;
+    friend io_uring_context;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(
+        io_uring_context& context,
+        int fd,
+        offset_t offset,
+        bool transferAll,
+        Buffers buffers,
+        Receiver2&& r)
+        : base(context, transferAll, (Receiver2 &&) r),
+          fd_(fd),
+          offset_(offset),
+          buffers_(std::move(buffers)) {}
+
+    // Re-arms a completed operation so that it can be started again, reusing
+    // the same file, offset and buffers.
+    void restart() noexcept {
+      UNIFEX_ASSERT(this->refCount_.load(std::memory_order_relaxed) == 0);
+      // Undo the progress of an operation that transfers everything.
+      if (offset_ != -1) {
+        offset_ -= this->transferred_;
       }
-    };
+      buffers_.reset(static_cast<std::size_t>(this->transferred_));
+      this->transferred_ = 0;
+      this->refCount_.store(1, std::memory_order_relaxed);
+    }
 
-    struct cancel_callback final {
-      operation& op_;
+   private:
+    void populate_sqe(io_uring_sqe & sqe) noexcept {
+      sqe.opcode = IORING_OP_READV;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(buffers_.data());
+      sqe.len = buffers_.size();
+    }
 
-      void operator()() noexcept {
-        op_.request_stop();
+    // Skips the bytes done by a short transfer. Returns whether there are
+    // any left.
+    bool advance(std::size_t bytes) noexcept {
+      if (offset_ != -1) {
+        offset_ += static_cast<offset_t>(bytes);
       }
-    };
+      buffers_.consume(bytes);
+      return !buffers_.empty();
+    }
 
-    io_uring_context& context_;
     int fd_;
     offset_t offset_;
-    iovec buffer_[1];
-    Receiver receiver_;
-    manual_lifetime<typename stop_token_type_t<
-        Receiver>::template callback_type<cancel_callback>>
-        stopCallback_;
-    std::atomic_char refCount_{1};
-    cancel_operation cop_{*this};
+    Buffers buffers_;
   };
 
  public:
@@ -579,16 +741,29 @@ class io_uring_context::read_sender {
 
   static constexpr bool sends_done = true;
 
+  // If `transferAll` is set, a short read is continued from the I/O
+  // thread until the buffer is full or the file ends.
   explicit read_sender(
       io_uring_context& context,
       int fd,
       offset_t offset,
-      span<std::byte> buffer) noexcept
-      : context_(context), fd_(fd), offset_(offset), buffer_(buffer) {}
+      span<std::byte> buffer,
+      bool transferAll = false) noexcept
+      : context_(context),
+        fd_(fd),
+        offset_(offset),
+        buffer_(buffer),
+        transferAll_(transferAll) {}
 
   template <typename Receiver>
-  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) && {
-    return operation<remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) {
+    return operation<remove_cvref_t<Receiver>>{
+        context_,
+        fd_,
+        offset_,
+        transferAll_,
+        single_iovec{buffer_},
+        (Receiver &&) r};
   }
 
  private:
@@ -596,168 +771,310 @@ class io_uring_context::read_sender {
   int fd_;
   offset_t offset_;
   span<std::byte> buffer_;
+  bool transferAll_ = false;
 };
 
-class io_uring_context::write_sender {
+// A vectored read. The iovecs are copied when the sender is constructed, so
+// only the buffers themselves need to outlive the operation.
+class io_uring_context::readv_sender {
   using offset_t = std::int64_t;
 
   template <typename Receiver>
-  class operation : private completion_base {
+  using operation = read_sender::operation<Receiver, iovec_array>;
+
+ public:
+  // Produces number of bytes read.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  // Note: Only case it might complete with exception_ptr is if the
+  // receiver's set_value() exits with an exception.
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  explicit readv_sender(
+      io_uring_context& context,
+      int fd,
+      offset_t offset,
+      span<const span<std::byte>> buffers)
+      : context_(context), fd_(fd), offset_(offset), buffers_(buffers) {}
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) && {
+    return operation<remove_cvref_t<Receiver>>{
+        context_, fd_, offset_, false, std::move(buffers_), (Receiver &&) r};
+  }
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) const& {
+    return operation<remove_cvref_t<Receiver>>{
+        context_, fd_, offset_, false, buffers_, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  offset_t offset_;
+  iovec_array buffers_;
+};
+
+class io_uring_context::write_sender {
+  using offset_t = std::int64_t;
+
+  friend writev_sender;
+
+  // Buffers is single_iovec, or iovec_array for a writev_sender.
+  template <typename Receiver, typename Buffers = single_iovec>
+  class operation
+    : public transfer_operation<operation<Receiver, Buffers>, Receiver> {
+    using base = transfer_operation<operation, Receiver>;
+    friend base;
     friend io_uring_context;
 
    public:
     template <typename Receiver2>
-    explicit operation(const write_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
-          fd_(sender.fd_),
-          offset_(sender.offset_),
-          receiver_((Receiver2 &&) r) {
-      buffer_[0].iov_base = (void*)sender.buffer_.data();
-      buffer_[0].iov_len = sender.buffer_.size();
-    }
-
-    void start() noexcept {
-      if (!context_.is_running_on_io_thread()) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_remote(this);
-      } else {
-        start_io();
+    explicit operation(
+        io_uring_context& context,
+        int fd,
+        offset_t offset,
+        bool transferAll,
+        Buffers buffers,
+        Receiver2&& r)
+        : base(context, transferAll, (Receiver2 &&) r),
+          fd_(fd),
+          offset_(offset),
+          buffers_(std::move(buffers)) {}
+
+    // Re-arms a completed operation so that it can be started again, reusing
+    // the same file, offset and buffers.
+    void restart() noexcept {
+      UNIFEX_ASSERT(this->refCount_.load(std::memory_order_relaxed) == 0);
+      // Undo the progress of an operation that transfers everything.
+      if (offset_ != -1) {
+        offset_ -= this->transferred_;
       }
+      buffers_.reset(static_cast<std::size_t>(this->transferred_));
+      this->transferred_ = 0;
+      this->refCount_.store(1, std::memory_order_relaxed);
     }
 
    private:
-    static void on_schedule_complete(operation_base* op) noexcept {
-      static_cast<operation*>(op)->start_io();
+    void populate_sqe(io_uring_sqe & sqe) noexcept {
+      sqe.opcode = IORING_OP_WRITEV;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(buffers_.data());
+      sqe.len = buffers_.size();
     }
 
-    void start_io() noexcept {
-      UNIFEX_ASSERT(context_.is_running_on_io_thread());
-      stopCallback_.construct(
-            get_stop_token(receiver_), cancel_callback{*this});
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
-        sqe.opcode = IORING_OP_WRITEV;
-        sqe.fd = fd_;
-        sqe.off = offset_;
-        sqe.addr = reinterpret_cast<std::uintptr_t>(&buffer_[0]);
-        sqe.len = 1;
-        sqe.user_data = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
-
-        this->execute_ = &operation::on_write_complete;
-      };
-
-      if (!context_.try_submit_io(populateSqe)) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_pending_io(this);
+    // Skips the bytes done by a short transfer. Returns whether there are
+    // any left.
+    bool advance(std::size_t bytes) noexcept {
+      if (offset_ != -1) {
+        offset_ += static_cast<offset_t>(bytes);
       }
+      buffers_.consume(bytes);
+      return !buffers_.empty();
     }
 
-    void request_stop() noexcept {
-      if (char expected = 1; !refCount_.compare_exchange_strong(expected, 2, std::memory_order_relaxed)) {
-        // lost race with on_write_complete
-        UNIFEX_ASSERT(expected == 0);
-        return;
-      }
-      if (context_.is_running_on_io_thread()) {
-        request_stop_local();
-      } else {
-        request_stop_remote();
-      }
-    }
+    int fd_;
+    offset_t offset_;
+    Buffers buffers_;
+  };
 
-    void request_stop_local() noexcept {
-      UNIFEX_ASSERT(context_.is_running_on_io_thread());
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
-        sqe.opcode = IORING_OP_ASYNC_CANCEL;
-        sqe.fd = -1;
-        sqe.off = 0;
-        auto op = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
-        // sqe.addr is the user_data to look for and cancel
-        sqe.addr = op;
-        sqe.len = 0;
-        auto cop = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(&cop_));
-        sqe.user_data = cop;
-        cop_.execute_ = &cancel_operation::on_stop_complete;
-      };
+ public:
+  // Produces number of bytes read.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
 
-      if (!context_.try_submit_io(populateSqe)) {
-        cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
-        context_.schedule_pending_io(&cop_);
+  // Note: Only case it might complete with exception_ptr is if the
+  // receiver's set_value() exits with an exception.
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  // If `transferAll` is set, a short write is continued from the I/O
+  // thread until the whole buffer has been written.
+  explicit write_sender(
+      io_uring_context& context,
+      int fd,
+      offset_t offset,
+      span<const std::byte> buffer,
+      bool transferAll = false) noexcept
+      : context_(context),
+        fd_(fd),
+        offset_(offset),
+        buffer_(buffer),
+        transferAll_(transferAll) {}
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) {
+    return operation<remove_cvref_t<Receiver>>{
+        context_,
+        fd_,
+        offset_,
+        transferAll_,
+        single_iovec{buffer_},
+        (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  offset_t offset_;
+  span<const std::byte> buffer_;
+  bool transferAll_ = false;
+};
+
+// A vectored write. The iovecs are copied when the sender is constructed, so
+// only the buffers themselves need to outlive the operation.
+class io_uring_context::writev_sender {
+  using offset_t = std::int64_t;
+
+  template <typename Receiver>
+  using operation = write_sender::operation<Receiver, iovec_array>;
+
+ public:
+  // Produces number of bytes written.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  // Note: Only case it might complete with exception_ptr is if the
+  // receiver's set_value() exits with an exception.
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code, std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  explicit writev_sender(
+      io_uring_context& context,
+      int fd,
+      offset_t offset,
+      span<const span<const std::byte>> buffers)
+      : context_(context), fd_(fd), offset_(offset), buffers_(buffers) {}
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) && {
+    return operation<remove_cvref_t<Receiver>>{
+        context_, fd_, offset_, false, std::move(buffers_), (Receiver &&) r};
+  }
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) const& {
+    return operation<remove_cvref_t<Receiver>>{
+        context_, fd_, offset_, false, buffers_, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  offset_t offset_;
+  iovec_array buffers_;
+};
+
+class io_uring_context::splice_sender {
+  template <typename Receiver>
+  class operation
+    : public transfer_operation<operation<Receiver>, Receiver> {
+    using base = transfer_operation<operation, Receiver>;
+    friend base;
+    friend io_uring_context;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const splice_sender& sender, Receiver2&& r)
+        : base(sender.context_, sender.transferAll_, (Receiver2 &&) r),
+          opcode_(sender.opcode_),
+          fdIn_(sender.fdIn_),
+          fdOut_(sender.fdOut_),
+          length_(sender.length_) {}
+
+   private:
+    void populate_sqe(io_uring_sqe & sqe) noexcept {
+      sqe.opcode = opcode_;
+      sqe.fd = fdOut_;
+      sqe.splice_fd_in = fdIn_;
+      if (opcode_ == IORING_OP_SPLICE) {
+        // Use the current position of anything that isn't a pipe.
+        sqe.off = static_cast<std::uint64_t>(-1);
+        sqe.splice_off_in = static_cast<std::uint64_t>(-1);
       }
+      sqe.len = static_cast<std::uint32_t>(
+          std::min<std::size_t>(length_, max_length));
     }
 
-    void request_stop_remote() noexcept {
-      cop_.execute_ = &cancel_operation::on_schedule_stop_complete;
-      context_.schedule_remote(&cop_);
+    // Skips the bytes moved by a short splice. Returns whether there are
+    // any left.
+    bool advance(std::size_t bytes) noexcept {
+      length_ -= bytes;
+      return length_ != 0;
     }
 
-    static void on_write_complete(operation_base* op) noexcept {
-      auto& self = *static_cast<operation*>(op);
-      if (self.refCount_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
-        // stop callback is running, must complete the op
-        return;
-      }
-      self.stopCallback_.destruct();
-      if (get_stop_token(self.receiver_).stop_requested()) {
-        unifex::set_done(std::move(self.receiver_));
-      } else if (self.result_ >= 0) {
-        if constexpr (noexcept(unifex::set_value(std::move(self.receiver_), ssize_t(self.result_)))) {
-          unifex::set_value(std::move(self.receiver_), ssize_t(self.result_));
-        } else {
-          UNIFEX_TRY {
-            unifex::set_value(std::move(self.receiver_), ssize_t(self.result_));
-          } UNIFEX_CATCH (...) {
-            unifex::set_error(std::move(self.receiver_), std::current_exception());
-          }
-        }
-      } else if (self.result_ == -ECANCELED) {
-        unifex::set_done(std::move(self.receiver_));
-      } else {
-        unifex::set_error(
-            std::move(self.receiver_),
-            std::error_code{-self.result_, std::system_category()});
+    // io_uring doesn't wait for a non-blocking fd, so after -EAGAIN this
+    // polls whichever end is blocking and splices again once it's ready.
+    // Returns false if the operation is being cancelled.
+    bool wait_until_ready() noexcept {
+      if (this->result_ != -EAGAIN ||
+          this->refCount_.load(std::memory_order_relaxed) != 1) {
+        return false;
       }
-    }
+      pollfd in{};
+      in.fd = fdIn_;
+      in.events = POLLIN;
+      const bool readable = ::poll(&in, 1, 0) == 1;
+      auto populateSqe = [this, readable](io_uring_sqe & sqe) noexcept {
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = readable ? fdOut_ : fdIn_;
+        sqe.poll_events = readable ? POLLOUT : POLLIN;
+        sqe.user_data = reinterpret_cast<std::uintptr_t>(
+            static_cast<completion_base*>(this));
 
-    struct cancel_operation final : completion_base {
-      operation& op_;
+        this->execute_ = &operation::on_poll_complete;
+      };
 
-      explicit cancel_operation(operation& op) noexcept : op_(op) {}
-      // intrusive list breaks if the same operation is submitted twice
-      // break the cycle: `on_stop_complete` delegates to the parent operation
-      static void on_stop_complete(operation_base* op) noexcept {
-        operation::on_write_complete(&static_cast<cancel_operation*>(op)->op_);
+      this->result_ = 0;
+      if (!this->context_.try_submit_io(populateSqe)) {
+        // Splice again rather than queueing the poll.
+        this->execute_ = &base::on_submit_ready;
+        this->context_.schedule_pending_io(this);
       }
+      return true;
+    }
 
-      static void on_schedule_stop_complete(operation_base* op) noexcept {
-        static_cast<cancel_operation*>(op)->op_.request_stop_local();
+    static void on_poll_complete(operation_base* op) noexcept {
+      auto& self =
+          *static_cast<operation*>(static_cast<completion_base*>(op));
+      if (self.result_ >= 0) {
+        // The poll result is an event mask, not a byte count.
+        self.result_ = 0;
+        if (self.refCount_.load(std::memory_order_relaxed) == 1) {
+          self.submit_io();
+          return;
+        }
       }
-    };
-
-    struct cancel_callback final {
-      operation& op_;
+      base::on_complete(op);
+    }
 
-      void operator()() noexcept {
-        op_.request_stop();
-      }
-    };
+    // The most that a single splice can move.
+    static constexpr std::size_t max_length = 0x7ffff000;
 
-    io_uring_context& context_;
-    int fd_;
-    offset_t offset_;
-    iovec buffer_[1];
-    Receiver receiver_;
-    manual_lifetime<typename stop_token_type_t<
-        Receiver>::template callback_type<cancel_callback>>
-        stopCallback_;
-    std::atomic_char refCount_{1};
-    cancel_operation cop_{*this};
+    std::uint8_t opcode_;
+    int fdIn_;
+    int fdOut_;
+    std::size_t length_;
   };
 
  public:
-  // Produces number of bytes read.
+  // Produces number of bytes moved.
   template <
       template <typename...> class Variant,
       template <typename...> class Tuple>
@@ -770,12 +1087,22 @@ class io_uring_context::write_sender {
 
   static constexpr bool sends_done = true;
 
-  explicit write_sender(
+  // `opcode` is IORING_OP_SPLICE or IORING_OP_TEE. If `transferAll` is set,
+  // a short splice is continued from the I/O thread until `length` bytes
+  // have been moved or `fdIn` ends.
+  explicit splice_sender(
       io_uring_context& context,
-      int fd,
-      offset_t offset,
-      span<const std::byte> buffer) noexcept
-      : context_(context), fd_(fd), offset_(offset), buffer_(buffer) {}
+      std::uint8_t opcode,
+      int fdIn,
+      int fdOut,
+      std::size_t length,
+      bool transferAll = false) noexcept
+      : context_(context),
+        opcode_(opcode),
+        fdIn_(fdIn),
+        fdOut_(fdOut),
+        length_(length),
+        transferAll_(transferAll) {}
 
   template <typename Receiver>
   operation<remove_cvref_t<Receiver>> connect(Receiver&& r) {
@@ -784,9 +1111,11 @@ class io_uring_context::write_sender {
 
  private:
   io_uring_context& context_;
-  int fd_;
-  offset_t offset_;
-  span<const std::byte> buffer_;
+  std::uint8_t opcode_;
+  int fdIn_;
+  int fdOut_;
+  std::size_t length_;
+  bool transferAll_;
 };
 
 class io_uring_context::async_read_only_file {
@@ -807,6 +1136,22 @@ class io_uring_context::async_read_only_file {
     return read_sender{file.context_, file.fd_.get(), offset, buffer};
   }
 
+  friend readv_sender tag_invoke(
+      tag_t<async_read_some_at_v>,
+      async_read_only_file& file,
+      offset_t offset,
+      span<const span<std::byte>> buffers) {
+    return readv_sender{file.context_, file.fd_.get(), offset, buffers};
+  }
+
+  friend read_sender tag_invoke(
+      tag_t<async_read_exactly_at>,
+      async_read_only_file& file,
+      offset_t offset,
+      span<std::byte> buffer) noexcept {
+    return read_sender{file.context_, file.fd_.get(), offset, buffer, true};
+  }
+
   io_uring_context& context_;
   safe_file_descriptor fd_;
 };
@@ -829,6 +1174,22 @@ class io_uring_context::async_write_only_file {
     return write_sender{file.context_, file.fd_.get(), offset, buffer};
   }
 
+  friend writev_sender tag_invoke(
+      tag_t<async_write_some_at_v>,
+      async_write_only_file& file,
+      offset_t offset,
+      span<const span<const std::byte>> buffers) {
+    return writev_sender{file.context_, file.fd_.get(), offset, buffers};
+  }
+
+  friend write_sender tag_invoke(
+      tag_t<async_write_all_at>,
+      async_write_only_file& file,
+      offset_t offset,
+      span<const std::byte> buffer) noexcept {
+    return write_sender{file.context_, file.fd_.get(), offset, buffer, true};
+  }
+
   io_uring_context& context_;
   safe_file_descriptor fd_;
 };
@@ -851,6 +1212,22 @@ class io_uring_context::async_read_write_file {
     return write_sender{file.context_, file.fd_.get(), offset, buffer};
   }
 
+  friend writev_sender tag_invoke(
+      tag_t<async_write_some_at_v>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<const span<const std::byte>> buffers) {
+    return writev_sender{file.context_, file.fd_.get(), offset, buffers};
+  }
+
+  friend write_sender tag_invoke(
+      tag_t<async_write_all_at>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<const std::byte> buffer) noexcept {
+    return write_sender{file.context_, file.fd_.get(), offset, buffer, true};
+  }
+
   friend read_sender tag_invoke(
       tag_t<async_read_some_at>,
       async_read_write_file& file,
@@ -859,6 +1236,22 @@ class io_uring_context::async_read_write_file {
     return read_sender{file.context_, file.fd_.get(), offset, buffer};
   }
 
+  friend readv_sender tag_invoke(
+      tag_t<async_read_some_at_v>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<const span<std::byte>> buffers) {
+    return readv_sender{file.context_, file.fd_.get(), offset, buffers};
+  }
+
+  friend read_sender tag_invoke(
+      tag_t<async_read_exactly_at>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<std::byte> buffer) noexcept {
+    return read_sender{file.context_, file.fd_.get(), offset, buffer, true};
+  }
+
   io_uring_context& context_;
   safe_file_descriptor fd_;
 };
@@ -1094,6 +1487,34 @@ class io_uring_context::scheduler {
       scheduler s,
       port_t port);
 
+  friend splice_sender tag_invoke(
+      tag_t<async_splice>,
+      scheduler s,
+      int fdIn,
+      int fdOut,
+      std::size_t length) noexcept {
+    return splice_sender{*s.context_, IORING_OP_SPLICE, fdIn, fdOut, length};
+  }
+
+  friend splice_sender tag_invoke(
+      tag_t<async_splice_all>,
+      scheduler s,
+      int fdIn,
+      int fdOut,
+      std::size_t length) noexcept {
+    return splice_sender{
+        *s.context_, IORING_OP_SPLICE, fdIn, fdOut, length, true};
+  }
+
+  friend splice_sender tag_invoke(
+      tag_t<async_tee>,
+      scheduler s,
+      int pipeIn,
+      int pipeOut,
+      std::size_t length) noexcept {
+    return splice_sender{*s.context_, IORING_OP_TEE, pipeIn, pipeOut, length};
+  }
+
   friend bool operator==(scheduler a, scheduler b) noexcept {
     return a.context_ == b.context_;
   }
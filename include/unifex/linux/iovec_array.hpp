@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/span.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include <limits.h>
+#include <sys/uio.h>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace linuxos {
+
+// The iovec for a single buffer, which is all that most reads and writes
+// need. It has the same interface as iovec_array.
+class single_iovec {
+ public:
+  template <typename T>
+  explicit single_iovec(span<T> buffer) noexcept
+    : iovec_{(void*)buffer.data(), buffer.size()} {}
+
+  iovec* data() noexcept { return &iovec_; }
+
+  int size() const noexcept { return 1; }
+
+  bool empty() const noexcept { return iovec_.iov_len == 0; }
+
+  // Drops the first `bytes` bytes after a short read or write.
+  void consume(std::size_t bytes) noexcept {
+    iovec_.iov_base = static_cast<char*>(iovec_.iov_base) + bytes;
+    iovec_.iov_len -= bytes;
+  }
+
+  // Brings back the `consumed` bytes that consume() dropped.
+  void reset(std::size_t consumed) noexcept {
+    iovec_.iov_base = static_cast<char*>(iovec_.iov_base) - consumed;
+    iovec_.iov_len += consumed;
+  }
+
+ private:
+  iovec iovec_;
+};
+
+// The iovecs for a readv() or writev() of a span of buffers, copied when a
+// vectored sender is constructed so that the span needn't outlive it. A few
+// are stored inline so that the common header-plus-body case doesn't
+// allocate.
+//
+// At most IOV_MAX buffers are passed to the kernel. Reads and writes that
+// may be short don't need the rest.
+class iovec_array {
+ public:
+  static constexpr std::size_t inline_capacity = 4;
+
+  template <typename T>
+  explicit iovec_array(span<const span<T>> buffers)
+    : size_(std::min<std::size_t>(buffers.size(), IOV_MAX)) {
+    if (size_ > inline_capacity) {
+      heap_.reset(new iovec[size_]);
+    }
+    iovec* iovecs = all();
+    for (std::size_t i = 0; i < size_; ++i) {
+      iovecs[i] = iovec{(void*)buffers[i].data(), buffers[i].size()};
+    }
+  }
+
+  iovec_array(const iovec_array& other)
+    : size_(other.size_), first_(other.first_), trimmed_(other.trimmed_) {
+    if (other.heap_) {
+      heap_.reset(new iovec[size_]);
+    }
+    std::copy(other.all(), other.all() + size_, all());
+  }
+
+  iovec_array(iovec_array&& other) noexcept
+    : heap_(std::move(other.heap_)),
+      size_(other.size_),
+      first_(other.first_),
+      trimmed_(other.trimmed_) {
+    if (!heap_) {
+      std::copy(other.inline_, other.inline_ + size_, inline_);
+    }
+  }
+
+  iovec_array& operator=(const iovec_array&) = delete;
+
+  iovec* data() noexcept { return all() + first_; }
+
+  int size() const noexcept { return static_cast<int>(size_ - first_); }
+
+  bool empty() const noexcept { return first_ == size_; }
+
+  // Drops the first `bytes` bytes after a short read or write, along with
+  // any empty buffers, so that empty() is true once every byte is done.
+  void consume(std::size_t bytes) noexcept {
+    iovec* iovecs = all();
+    for (; first_ != size_; ++first_) {
+      iovec& front = iovecs[first_];
+      if (bytes < front.iov_len) {
+        trim(front, bytes);
+        return;
+      }
+      bytes -= front.iov_len;
+      untrim(front);
+    }
+  }
+
+  // Brings back every buffer that consume() dropped. Unlike single_iovec,
+  // the array keeps track of what it dropped itself.
+  void reset(std::size_t /* consumed */) noexcept {
+    if (first_ != size_) {
+      untrim(all()[first_]);
+    }
+    first_ = 0;
+  }
+
+ private:
+  iovec* all() noexcept { return heap_ ? heap_.get() : inline_; }
+
+  const iovec* all() const noexcept { return heap_ ? heap_.get() : inline_; }
+
+  // Only the front buffer is ever part-consumed; trimmed_ is how much of it.
+  void trim(iovec& front, std::size_t bytes) noexcept {
+    front.iov_base = static_cast<char*>(front.iov_base) + bytes;
+    front.iov_len -= bytes;
+    trimmed_ += bytes;
+  }
+
+  void untrim(iovec& front) noexcept {
+    front.iov_base = static_cast<char*>(front.iov_base) - trimmed_;
+    front.iov_len += trimmed_;
+    trimmed_ = 0;
+  }
+
+  iovec inline_[inline_capacity];
+  std::unique_ptr<iovec[]> heap_;
+  std::size_t size_;
+  std::size_t first_ = 0;
+  std::size_t trimmed_ = 0;
+};
+
+} // namespace linuxos
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
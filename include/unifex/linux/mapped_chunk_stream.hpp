@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/blocking.hpp>
+#include <unifex/just_done.hpp>
+#include <unifex/linux/mapped_file.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/span.hpp>
+#include <unifex/stream_concepts.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace linuxos {
+namespace _mapped_chunk {
+class stream;
+
+template <typename Receiver>
+struct _op {
+  struct type;
+};
+template <typename Receiver>
+using operation = typename _op<remove_cvref_t<Receiver>>::type;
+
+struct next_sender {
+  stream& stream_;
+
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<span<const std::byte>>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<>;
+
+  static constexpr bool sends_done = true;
+
+  static constexpr blocking_kind blocking = blocking_kind::always_inline;
+
+  template <typename Receiver>
+  operation<Receiver> connect(Receiver&& receiver) && {
+    return operation<Receiver>{stream_, (Receiver &&) receiver};
+  }
+  template <typename Receiver>
+  void connect(Receiver&& receiver) const& = delete;
+};
+
+// Sends the bytes of a mapped_file in chunks of `chunkSize` bytes, rounded
+// up to whole pages. Chunks start on a page boundary, except the first
+// one when the mapping starts part way into a page, which is shorter. The
+// last chunk holds whatever is left.
+//
+// Each next() first asks the kernel to read in the `prefetchChunks` chunks
+// after the one it sends, so that scanning the file rarely waits on a
+// page fault. The mapped_file must outlive the stream.
+class stream {
+ public:
+  static constexpr std::size_t default_chunk_size = 1 << 20;
+
+  explicit stream(
+      const mapped_file& file,
+      std::size_t chunkSize = default_chunk_size,
+      std::size_t prefetchChunks = 2) noexcept
+    : file_(file) {
+    const std::size_t page = page_size();
+    chunkSize_ = std::max(page, (chunkSize + page - 1) / page * page);
+    prefetchSize_ = chunkSize_ * prefetchChunks;
+  }
+
+  friend next_sender tag_invoke(tag_t<next>, stream& s) noexcept {
+    return next_sender{s};
+  }
+
+  friend auto tag_invoke(tag_t<cleanup>, stream&) noexcept {
+    return just_done();
+  }
+
+  // The chunk that next() sends, or an empty span once every chunk has
+  // been sent.
+  span<const std::byte> next_chunk() noexcept {
+    const std::size_t size = file_.size();
+    if (offset_ >= size) {
+      return {};
+    }
+    const std::size_t pageOffset = file_.page_offset();
+    const std::size_t end = std::min(
+        size,
+        ((pageOffset + offset_) / chunkSize_ + 1) * chunkSize_ - pageOffset);
+    const std::size_t prefetchEnd = std::min(size, end + prefetchSize_);
+    if (prefetched_ < prefetchEnd) {
+      file_.prefetch(prefetched_, prefetchEnd - prefetched_);
+      prefetched_ = prefetchEnd;
+    }
+    span<const std::byte> chunk{file_.data() + offset_, end - offset_};
+    offset_ = end;
+    return chunk;
+  }
+
+ private:
+  const mapped_file& file_;
+  std::size_t chunkSize_;
+  std::size_t prefetchSize_;
+  // Where the next chunk starts.
+  std::size_t offset_ = 0;
+  // How many bytes from the start have been prefetched.
+  std::size_t prefetched_ = 0;
+};
+
+template <typename Receiver>
+struct _op<Receiver>::type {
+  stream& stream_;
+  Receiver receiver_;
+
+  void start() noexcept {
+    auto chunk = stream_.next_chunk();
+    if (chunk.empty()) {
+      unifex::set_done(std::move(receiver_));
+    } else {
+      unifex::set_value(std::move(receiver_), chunk);
+    }
+  }
+};
+} // namespace _mapped_chunk
+
+using mapped_chunk_stream = _mapped_chunk::stream;
+
+} // namespace linuxos
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/filesystem.hpp>
+#include <unifex/linux/mmap_region.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/span.hpp>
+#include <unifex/then.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace linuxos {
+
+// The size of a virtual memory page.
+std::size_t page_size() noexcept;
+
+// A range of bytes in a file.
+struct file_range {
+  static constexpr std::uint64_t to_end = UINT64_MAX;
+
+  std::uint64_t offset = 0;
+  // The range is cut short at the end of the file.
+  std::uint64_t length = to_end;
+};
+
+// Hints about how a mapping will be used, passed on to madvise().
+struct map_advice {
+  // The pages will be read in order, so the kernel reads further ahead and
+  // may drop pages soon after they have been read.
+  bool sequential = false;
+  // Start reading the pages in from the file now.
+  bool willneed = false;
+  // Use huge pages where the file system supports them for page-cache
+  // pages.
+  bool hugepages = false;
+};
+
+// A read-only mapping of part of a file. The file doesn't need to stay
+// open once it is mapped.
+class mapped_file {
+ public:
+  mapped_file() noexcept = default;
+
+  // Maps `range` of the file at `path`. Throws std::system_error if the
+  // file can't be opened or mapped, or if the range starts past the end
+  // of the file.
+  explicit mapped_file(
+      const filesystem::path& path,
+      file_range range = {},
+      map_advice advice = {});
+
+  const std::byte* data() const noexcept {
+    return static_cast<const std::byte*>(region_.data()) + pageOffset_;
+  }
+
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+  span<const std::byte> bytes() const noexcept {
+    return span<const std::byte>{data(), size_};
+  }
+
+  // How far data() is from the start of its page.
+  std::size_t page_offset() const noexcept {
+    return pageOffset_;
+  }
+
+  // Applies `advice` to the `length` bytes at `offset`. Errors are
+  // ignored, these are only hints.
+  void advise(
+      map_advice advice,
+      std::size_t offset = 0,
+      std::size_t length = SIZE_MAX) const noexcept;
+
+  // Asks the kernel to start reading in the `length` bytes at `offset`
+  // without waiting for them. Errors are ignored, this is only a hint.
+  void prefetch(std::size_t offset, std::size_t length) const noexcept;
+
+ private:
+  // madvise() on the pages that hold the `length` bytes at `offset`.
+  int apply_advice(
+      int flag, std::size_t offset, std::size_t length) const noexcept;
+
+  mmap_region region_;
+  std::size_t pageOffset_ = 0;
+  std::size_t size_ = 0;
+};
+
+namespace _map_file {
+struct _fn {
+  // Opens, sizes and maps the file on `sched` and sends the mapped_file.
+  // Faulting pages in can still block whichever thread touches them, so
+  // pass map_advice::willneed, or prefetch() ahead, to have the kernel
+  // read them in beforehand.
+  template(typename Scheduler)
+    (requires scheduler<Scheduler>)
+  auto operator()(
+      Scheduler&& sched,
+      filesystem::path path,
+      file_range range = {},
+      map_advice advice = {}) const {
+    return then(
+        schedule((Scheduler &&) sched),
+        [path = std::move(path), range, advice]() {
+          return mapped_file{path, range, advice};
+        });
+  }
+};
+} // namespace _map_file
+
+inline constexpr _map_file::_fn async_map_file{};
+
+} // namespace linuxos
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
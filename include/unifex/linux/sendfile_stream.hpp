@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/just.hpp>
+#include <unifex/just_done.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/linux/safe_file_descriptor.hpp>
+#include <unifex/splice_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/variant_sender.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/types.h>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace linuxos {
+namespace _sendfile {
+
+inline constexpr std::uint64_t to_end = UINT64_MAX;
+inline constexpr std::size_t default_chunk_size = 64 * 1024;
+
+// The pipe that a sendfile_stream moves data through. Throws
+// std::system_error if it can't be created.
+class splice_pipe {
+ public:
+  splice_pipe();
+
+  int read_end() const noexcept { return readEnd_.get(); }
+  int write_end() const noexcept { return writeEnd_.get(); }
+
+  // The number of bytes waiting to be read from the pipe.
+  std::size_t size() const;
+
+ private:
+  safe_file_descriptor readEnd_;
+  safe_file_descriptor writeEnd_;
+};
+
+template <typename Scheduler>
+struct _stream {
+  class type;
+};
+template <typename Scheduler>
+using stream = typename _stream<Scheduler>::type;
+
+// A stream that moves the bytes of `fdIn`, from its current position, to
+// `fdOut` without copying them into user space. Each call to next() splices
+// a chunk from `fdIn` into a pipe and then all of it from the pipe into
+// `fdOut`, and sends the size of the chunk. The stream ends when `length`
+// bytes have been sent or `fdIn` ends.
+//
+// If a chunk fails or is cancelled before all of it reaches `fdOut`, the
+// rest stays in the pipe, and the next call to next() sends just that.
+//
+// It works with any scheduler that customises async_splice and
+// async_splice_all. With io_epoll_context, a socket passed as `fdOut` must
+// be non-blocking.
+template <typename Scheduler>
+class _stream<Scheduler>::type {
+  using fill_sender = callable_result_t<
+      tag_t<async_splice>, Scheduler&, int, int, std::size_t>;
+  using drain_sender = callable_result_t<
+      tag_t<async_splice_all>, Scheduler&, int, int, std::size_t>;
+
+ public:
+  template <typename Scheduler2>
+  explicit type(
+      Scheduler2&& sched,
+      int fdIn,
+      int fdOut,
+      std::uint64_t length = to_end,
+      std::size_t chunkSize = default_chunk_size)
+    : sched_((Scheduler2 &&) sched)
+    , fdIn_(fdIn)
+    , fdOut_(fdOut)
+    , remaining_(length)
+    , chunkSize_(chunkSize) {}
+
+  auto next() {
+    return let_value(
+        just(),
+        [this]() -> variant_sender<decltype(send_chunk()), drain_sender> {
+          if (const std::size_t stale = pipe_.size(); stale != 0) {
+            return async_splice_all(
+                sched_, pipe_.read_end(), fdOut_, stale);
+          }
+          return send_chunk();
+        });
+  }
+
+  auto cleanup() noexcept { return just_done(); }
+
+ private:
+  auto send_chunk() {
+    const auto chunk = static_cast<std::size_t>(
+        std::min<std::uint64_t>(remaining_, chunkSize_));
+    return let_value(
+        async_splice(sched_, fdIn_, pipe_.write_end(), chunk),
+        [this](ssize_t moved)
+            -> variant_sender<drain_sender, decltype(just_done())> {
+          if (moved == 0) {
+            return just_done();
+          }
+          remaining_ -= static_cast<std::uint64_t>(moved);
+          return async_splice_all(
+              sched_,
+              pipe_.read_end(),
+              fdOut_,
+              static_cast<std::size_t>(moved));
+        });
+  }
+
+  Scheduler sched_;
+  int fdIn_;
+  int fdOut_;
+  std::uint64_t remaining_;
+  std::size_t chunkSize_;
+  splice_pipe pipe_;
+};
+
+struct _fn {
+  template <typename Scheduler>
+  stream<remove_cvref_t<Scheduler>> operator()(
+      Scheduler&& sched,
+      int fdIn,
+      int fdOut,
+      std::uint64_t length = to_end,
+      std::size_t chunkSize = default_chunk_size) const {
+    return stream<remove_cvref_t<Scheduler>>{
+        (Scheduler &&) sched, fdIn, fdOut, length, chunkSize};
+  }
+};
+
+} // namespace _sendfile
+
+template <typename Scheduler>
+using sendfile_stream = _sendfile::stream<Scheduler>;
+
+inline constexpr _sendfile::_fn async_sendfile{};
+
+} // namespace linuxos
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -20,6 +20,7 @@
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/stream_concepts.hpp>
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -81,6 +82,17 @@ struct stream {
   friend auto tag_invoke(tag_t<cleanup>, stream&) noexcept {
     return just_done();
   }
+
+  // The number of values left and the i'th of them, which lets a parallel
+  // reduce_stream() split them between a scheduler's workers without
+  // pulling them one at a time. See enable_indexed_stream.
+  std::size_t remaining() const noexcept {
+    return next_ < max_ ? static_cast<std::size_t>(max_ - next_) : 0;
+  }
+
+  int value_at(std::size_t i) const noexcept {
+    return next_ + static_cast<int>(i);
+  }
 };
 
 template <typename Receiver>
@@ -95,6 +107,9 @@ void _op<Receiver>::type::start() noexcept {
 
 using range_stream = _range::stream;
 
+template <>
+inline constexpr bool enable_indexed_stream<range_stream> = true;
+
 } // namespace unifex
 
 #include <unifex/detail/epilogue.hpp>
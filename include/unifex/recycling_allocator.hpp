@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _recycle {
+
+// A recycled block of memory; while a block sits in a free list its first
+// bytes are reused to link it to the next free block.
+struct _block {
+  _block* next_;
+};
+
+// The calling thread's cache of free blocks for a single size class.
+//
+// This type is deliberately trivially destructible so that it remains usable
+// for the entire lifetime of its thread, including during the destruction of
+// other thread_local objects that may still be releasing memory.  Draining the
+// cache when the thread exits is the job of the thread's _thread_cache, with
+// which every _free_list registers the first time a block is recycled into it.
+struct _free_list {
+  _block* head_;
+  std::uint32_t count_;
+  // true once this list has been linked into the thread's _thread_cache
+  bool registered_;
+  // set once the owning thread has started exiting; from then on blocks are
+  // returned straight to the global heap
+  bool closed_;
+  _free_list* nextList_;
+
+  void* pop() noexcept {
+    _block* b = head_;
+    if (b != nullptr) {
+      head_ = b->next_;
+      --count_;
+    }
+    return b;
+  }
+
+  // caches p in this list; returns false if p should be returned to the
+  // global heap instead
+  inline bool push(void* p) noexcept;
+
+  // frees every cached block back to the global heap
+  void drain() noexcept;
+};
+
+// Links list into the calling thread's cache so that it is drained when the
+// thread exits; returns false if the thread is already exiting.
+bool _register(_free_list& list) noexcept;
+
+// The number of free blocks cached per size class per thread; blocks released
+// while the cache is full are returned straight to the global heap, which
+// bounds the memory held by an idle thread.
+inline constexpr std::uint32_t _max_cached_blocks = 64;
+
+inline bool _free_list::push(void* p) noexcept {
+  if (count_ < _max_cached_blocks && (registered_ || _register(*this))) {
+    head_ = ::new (p) _block{head_};
+    ++count_;
+    return true;
+  }
+  return false;
+}
+
+// Size classes are rounded up to multiples of the default operator new
+// alignment so that similarly sized operation states share a free list.
+inline constexpr std::size_t _granularity =
+    __STDCPP_DEFAULT_NEW_ALIGNMENT__ < sizeof(_block)
+    ? sizeof(_block)
+    : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+constexpr std::size_t _size_class(std::size_t size) noexcept {
+  return (size + _granularity - 1) / _granularity * _granularity;
+}
+
+template <std::size_t Size>
+struct _pool {
+  static_assert(Size % _granularity == 0);
+
+  static inline thread_local _free_list list_{};
+
+  static void* allocate() {
+    if (void* p = list_.pop()) {
+      return p;
+    }
+    return ::operator new(Size);
+  }
+
+  static void deallocate(void* p) noexcept {
+    if (!list_.push(p)) {
+      ::operator delete(p);
+    }
+  }
+};
+
+// Runtime-sized counterparts to _pool<Size> for allocations whose size isn't
+// known until runtime, such as coroutine frames.  Sizes are rounded up to a
+// power-of-two bucket; sizes beyond the largest bucket bypass the cache.
+//
+// The size passed to deallocate() must match the size passed to allocate().
+void* allocate(std::size_t size);
+void deallocate(void* p, std::size_t size) noexcept;
+
+template <typename T>
+class recycling_allocator {
+  // blocks of a single T are recycled; anything that can't be served from a
+  // default-aligned size class goes straight to the global heap
+  static constexpr bool is_recyclable =
+      alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  using pool_t = _pool<_size_class(sizeof(T))>;
+
+public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  recycling_allocator() = default;
+
+  template <typename U>
+  constexpr recycling_allocator(const recycling_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if constexpr (is_recyclable) {
+      if (n == 1) {
+        return static_cast<T*>(pool_t::allocate());
+      }
+    }
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if constexpr (is_recyclable) {
+      if (n == 1) {
+        pool_t::deallocate(p);
+        return;
+      }
+    }
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  friend constexpr bool
+  operator==(recycling_allocator, recycling_allocator<U>) noexcept {
+    return true;
+  }
+
+  template <typename U>
+  friend constexpr bool
+  operator!=(recycling_allocator, recycling_allocator<U>) noexcept {
+    return false;
+  }
+};
+
+// Returns all of the calling thread's cached blocks to the global heap.
+void trim_recycled_memory() noexcept;
+
+}  // namespace _recycle
+
+// An allocator that recycles single-object allocations through per-thread,
+// per-size-class free lists.
+//
+// Spawning many short-lived operations of the same type (e.g. with
+// spawn_detached() or spawn_future()) repeatedly allocates and frees operation
+// states of identical size; passing a recycling_allocator as the spawn
+// algorithm's allocator (or injecting one with with_allocator()) lets those
+// operation states reuse each other's memory without touching the global heap
+// and without any cross-thread synchronisation.
+//
+// Memory is recycled into the free list of whichever thread deallocates it, so
+// allocation and deallocation may happen on different threads.  Each thread
+// caches a bounded number of blocks per size class and returns its whole cache
+// to the global heap on thread exit or on a call to trim_recycled_memory().
+using _recycle::recycling_allocator;
+using _recycle::trim_recycled_memory;
+
+}  // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -20,6 +20,7 @@
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
 #include <unifex/stream_concepts.hpp>
+#include <unifex/then.hpp>
 #include <unifex/type_traits.hpp>
 #include <unifex/type_list.hpp>
 #include <unifex/unstoppable_token.hpp>
@@ -28,9 +29,18 @@
 #include <unifex/std_concepts.hpp>
 #include <unifex/bind_back.hpp>
 #include <unifex/exception.hpp>
-
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/detail/batch.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+#include <unifex/detail/tree_reduce.hpp>
+
+#include <cstddef>
 #include <exception>
 #include <functional>
+#include <iterator>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -196,10 +206,21 @@ struct _next_receiver<StreamSender, State, ReducerFunc, Receiver>::type {
     auto& op = op_;
     unifex::deactivate_union_member(op.next_);
     UNIFEX_TRY {
-      op.state_ = std::invoke(
-          op.reducer_,
-          std::move(op.state_),
-          (Values &&) values...);
+      if constexpr (_batch::is_elementwise_invocable_v<
+                        ReducerFunc&, type_list<State>, Values...>) {
+        // A batch of values reduced by a per-element reducer.
+        _batch::for_each_element((Values &&) values..., [&](auto&& value) {
+          op.state_ = std::invoke(
+              op.reducer_,
+              std::move(op.state_),
+              static_cast<decltype(value)>(value));
+        });
+      } else {
+        op.state_ = std::invoke(
+            op.reducer_,
+            std::move(op.state_),
+            (Values &&) values...);
+      }
       unifex::activate_union_member_with(op.next_, [&] {
         return unifex::connect(next(op.stream_), next_receiver_t{op});
       });
@@ -343,6 +364,512 @@ struct _sender<StreamSender, State, ReducerFunc>::type {
 };
 } // namespace _reduce
 
+namespace _par_reduce {
+// reduce_stream(stream, initialState, reducer, par, scheduler) folds each
+// batch of values produced by `stream` in parallel on `scheduler`, with the
+// semantics of std::reduce(): every batch is split into chunks, each chunk
+// is folded starting from its first element converted to State, and the
+// partial results are combined with reducer(State, State) before being
+// folded into the state.  Streams whose values aren't batches, or whose
+// elements can't be reduced this way, are folded sequentially.
+
+template <typename T, typename = void>
+inline constexpr bool _is_random_access_range_v = false;
+
+template <typename T>
+inline constexpr bool _is_random_access_range_v<
+    T,
+    std::void_t<
+        decltype(std::size(std::declval<T&>())),
+        _batch::_iterator_t<T>>> =
+    std::is_base_of_v<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<
+            _batch::_iterator_t<T>>::iterator_category>;
+
+template <typename ValueTypes>
+struct _batch_of {
+  using type = void;
+};
+template <typename Batch>
+struct _batch_of<type_list<type_list<Batch>>> {
+  using type = remove_cvref_t<Batch>;
+};
+
+template <typename StreamSender>
+using batch_t = typename _batch_of<
+    sender_value_types_t<next_sender_t<StreamSender>, type_list, type_list>>::
+    type;
+
+template <typename State, typename ReducerFunc, typename Element>
+inline constexpr bool is_tree_reducible_v =
+    std::is_constructible_v<State, Element> &&
+    std::is_invocable_r_v<State, ReducerFunc&, State, Element> &&
+    std::is_invocable_r_v<State, ReducerFunc&, State, State>;
+
+template <typename StreamSender, typename State, typename ReducerFunc>
+inline constexpr bool _folds_batches_in_parallel() noexcept {
+  using batch = batch_t<StreamSender>;
+  if constexpr (_is_random_access_range_v<batch>) {
+    return is_tree_reducible_v<
+        State,
+        ReducerFunc,
+        _batch::element_t<batch>>;
+  } else {
+    return false;
+  }
+}
+
+// Streams that opt in with enable_indexed_stream, such as range_stream, are
+// reduced by splitting their remaining values between the scheduler's
+// workers rather than by pulling them one at a time.
+template <typename Stream>
+inline constexpr bool _is_indexed_stream_v = enable_indexed_stream<Stream>;
+
+template <typename Stream>
+using _indexed_value_t =
+    decltype(std::declval<const Stream&>().value_at(std::size_t{}));
+
+template <typename Stream, typename State, typename ReducerFunc>
+inline constexpr bool _reduces_by_index() noexcept {
+  if constexpr (_is_indexed_stream_v<Stream>) {
+    return is_tree_reducible_v<State, ReducerFunc, _indexed_value_t<Stream>>;
+  } else {
+    return false;
+  }
+}
+
+template <
+    typename Stream,
+    typename State,
+    typename ReducerFunc,
+    typename Policy,
+    typename Scheduler>
+auto _reduce_by_index(
+    Stream stream,
+    State&& initialState,
+    ReducerFunc&& reducer,
+    const Policy& policy,
+    Scheduler&& sched) {
+  using state_t = remove_cvref_t<State>;
+  const std::size_t size = stream.remaining();
+  const std::size_t concurrency = get_concurrency(sched);
+  return then(
+      _tree_reduce::reduce(
+          (Scheduler &&) sched,
+          policy,
+          size,
+          concurrency,
+          [stream, reducer](std::size_t begin, std::size_t end) mutable {
+            state_t state(stream.value_at(begin));
+            for (std::size_t i = begin + 1; i < end; ++i) {
+              state =
+                  std::invoke(reducer, std::move(state), stream.value_at(i));
+            }
+            return state;
+          },
+          [reducer](state_t a, state_t b) mutable -> state_t {
+            return std::invoke(reducer, std::move(a), std::move(b));
+          }),
+      [state = state_t((State &&) initialState),
+       reducer = (ReducerFunc &&) reducer](
+          std::optional<state_t> partial) mutable -> state_t {
+        if (!partial) {
+          return std::move(state);
+        }
+        return std::invoke(reducer, std::move(state), std::move(*partial));
+      });
+}
+
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler,
+    typename Receiver>
+struct _op {
+  struct type;
+};
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler,
+    typename Receiver>
+using operation = typename _op<
+    StreamSender,
+    State,
+    ReducerFunc,
+    Scheduler,
+    remove_cvref_t<Receiver>>::type;
+
+template <typename Op, typename Receiver>
+struct _receiver_base {
+  Op* op_;
+
+  template(typename CPO)
+      (requires is_receiver_query_cpo_v<CPO>)
+  friend auto tag_invoke(CPO cpo, const _receiver_base& r)
+      noexcept(is_nothrow_callable_v<CPO, const Receiver&>)
+      -> callable_result_t<CPO, const Receiver&> {
+    return std::move(cpo)(std::as_const(r.op_->receiver_));
+  }
+};
+
+template <typename Op, typename Receiver>
+struct _next_receiver : _receiver_base<Op, Receiver> {
+  template <typename... Values>
+  void set_value(Values... values) && noexcept {
+    this->op_->on_next((Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& e) && noexcept {
+    this->op_->next_.destruct();
+    this->op_->finish(_outcome::error, _as_exception_ptr((Error &&) e));
+  }
+
+  void set_done() && noexcept {
+    this->op_->next_.destruct();
+    this->op_->finish(_outcome::value, nullptr);
+  }
+};
+
+template <typename Op, typename Receiver>
+struct _fold_receiver : _receiver_base<Op, Receiver> {
+  template <typename Partial>
+  void set_value(Partial&& partial) && noexcept {
+    this->op_->on_partial((Partial &&) partial);
+  }
+
+  template <typename Error>
+  void set_error(Error&& e) && noexcept {
+    this->op_->fold_.destruct();
+    this->op_->batch_.destruct();
+    this->op_->finish(_outcome::error, _as_exception_ptr((Error &&) e));
+  }
+
+  void set_done() && noexcept {
+    this->op_->fold_.destruct();
+    this->op_->batch_.destruct();
+    this->op_->finish(_outcome::done, nullptr);
+  }
+};
+
+template <typename Op, typename Receiver>
+struct _cleanup_receiver : _receiver_base<Op, Receiver> {
+  void set_value() && noexcept { this->op_->complete(); }
+
+  template <typename Error>
+  void set_error(Error&& e) && noexcept {
+    this->op_->outcome_ = _outcome::error;
+    this->op_->error_ = _as_exception_ptr((Error &&) e);
+    this->op_->complete();
+  }
+
+  void set_done() && noexcept { this->op_->complete(); }
+
+  friend unstoppable_token
+  tag_invoke(tag_t<get_stop_token>, const _cleanup_receiver&) noexcept {
+    return {};
+  }
+};
+
+template <typename State, typename Batch, typename ReducerFunc>
+struct _fold_fn {
+  Batch* batch_;
+  ReducerFunc* reducer_;
+
+  State operator()(std::size_t begin, std::size_t end) const {
+    auto it = std::begin(*batch_);
+    State state(std::move(it[begin]));
+    for (std::size_t i = begin + 1; i < end; ++i) {
+      state = std::invoke(*reducer_, std::move(state), std::move(it[i]));
+    }
+    return state;
+  }
+};
+
+template <typename State, typename ReducerFunc>
+struct _combine_fn {
+  ReducerFunc* reducer_;
+
+  State operator()(State a, State b) const {
+    return std::invoke(*reducer_, std::move(a), std::move(b));
+  }
+};
+
+template <
+    bool Parallel,
+    typename Batch,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler,
+    typename Receiver>
+struct _fold {
+  using batch_type = unit;
+  using operation_type = unit;
+};
+
+template <
+    typename Batch,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler,
+    typename Receiver>
+struct _fold<true, Batch, State, ReducerFunc, Scheduler, Receiver> {
+  using batch_type = Batch;
+  using fold_fn = _fold_fn<State, Batch, ReducerFunc>;
+  using combine_fn = _combine_fn<State, ReducerFunc>;
+  using sender_type = decltype(_tree_reduce::reduce(
+      std::declval<Scheduler&>(),
+      par,
+      std::size_t{},
+      std::size_t{},
+      std::declval<fold_fn>(),
+      std::declval<combine_fn>()));
+  using operation_type = connect_result_t<sender_type, Receiver>;
+};
+
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler,
+    typename Receiver>
+struct _op<StreamSender, State, ReducerFunc, Scheduler, Receiver>::type {
+  using next_receiver_t = _next_receiver<type, Receiver>;
+  using fold_receiver_t = _fold_receiver<type, Receiver>;
+  using cleanup_receiver_t = _cleanup_receiver<type, Receiver>;
+  using fold_t = _fold<
+      _folds_batches_in_parallel<StreamSender, State, ReducerFunc>(),
+      batch_t<StreamSender>,
+      State,
+      ReducerFunc,
+      Scheduler,
+      fold_receiver_t>;
+
+  template <
+      typename StreamSender2,
+      typename State2,
+      typename ReducerFunc2,
+      typename Scheduler2,
+      typename Receiver2>
+  explicit type(
+      StreamSender2&& stream,
+      State2&& state,
+      ReducerFunc2&& reducer,
+      Scheduler2&& sched,
+      Receiver2&& receiver)
+    : stream_((StreamSender2 &&) stream)
+    , state_((State2 &&) state)
+    , reducer_((ReducerFunc2 &&) reducer)
+    , sched_((Scheduler2 &&) sched)
+    , receiver_((Receiver2 &&) receiver) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept { pull(); }
+
+  void pull() noexcept {
+    UNIFEX_TRY {
+      next_.construct_with([&] {
+        return unifex::connect(next(stream_), next_receiver_t{{this}});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      finish(_outcome::error, std::current_exception());
+      return;
+    }
+    unifex::start(next_.get());
+  }
+
+  template <typename... Values>
+  void on_next(Values... values) noexcept {
+    if constexpr (_folds_batches_in_parallel<
+                      StreamSender,
+                      State,
+                      ReducerFunc>()) {
+      UNIFEX_TRY {
+        batch_.construct((Values &&) values...);
+      }
+      UNIFEX_CATCH(...) {
+        next_.destruct();
+        finish(_outcome::error, std::current_exception());
+        return;
+      }
+      next_.destruct();
+      UNIFEX_TRY {
+        fold_.construct_with([&] {
+          return unifex::connect(
+              _tree_reduce::reduce(
+                  sched_,
+                  par,
+                  static_cast<std::size_t>(std::size(batch_.get())),
+                  get_concurrency(sched_),
+                  typename fold_t::fold_fn{&batch_.get(), &reducer_},
+                  typename fold_t::combine_fn{&reducer_}),
+              fold_receiver_t{{this}});
+        });
+      }
+      UNIFEX_CATCH(...) {
+        batch_.destruct();
+        finish(_outcome::error, std::current_exception());
+        return;
+      }
+      unifex::start(fold_.get());
+    } else {
+      next_.destruct();
+      UNIFEX_TRY {
+        if constexpr (_batch::is_elementwise_invocable_v<
+                          ReducerFunc&, type_list<State>, Values...>) {
+          _batch::for_each_element((Values &&) values..., [&](auto&& value) {
+            state_ = std::invoke(
+                reducer_,
+                std::move(state_),
+                static_cast<decltype(value)>(value));
+          });
+        } else {
+          state_ =
+              std::invoke(reducer_, std::move(state_), (Values &&) values...);
+        }
+      }
+      UNIFEX_CATCH(...) {
+        finish(_outcome::error, std::current_exception());
+        return;
+      }
+      pull();
+    }
+  }
+
+  template <typename Partial>
+  void on_partial(Partial&& partial) noexcept {
+    auto result = (Partial &&) partial;
+    fold_.destruct();
+    batch_.destruct();
+    if (result) {
+      UNIFEX_TRY {
+        state_ = std::invoke(reducer_, std::move(state_), std::move(*result));
+      }
+      UNIFEX_CATCH(...) {
+        finish(_outcome::error, std::current_exception());
+        return;
+      }
+    }
+    pull();
+  }
+
+  // Runs the stream's cleanup before completing with `outcome`.
+  void finish(_outcome outcome, std::exception_ptr error) noexcept {
+    outcome_ = outcome;
+    error_ = std::move(error);
+    UNIFEX_TRY {
+      cleanup_.construct_with([&] {
+        return unifex::connect(cleanup(stream_), cleanup_receiver_t{{this}});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      outcome_ = _outcome::error;
+      error_ = std::current_exception();
+      deliver();
+      return;
+    }
+    unifex::start(cleanup_.get());
+  }
+
+  void complete() noexcept {
+    cleanup_.destruct();
+    deliver();
+  }
+
+  void deliver() noexcept {
+    switch (outcome_) {
+      case _outcome::value:
+        unifex::set_value(std::move(receiver_), std::move(state_));
+        break;
+      case _outcome::error:
+        unifex::set_error(std::move(receiver_), std::move(error_));
+        break;
+      case _outcome::done:
+        unifex::set_done(std::move(receiver_));
+        break;
+    }
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS StreamSender stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS State state_;
+  UNIFEX_NO_UNIQUE_ADDRESS ReducerFunc reducer_;
+  UNIFEX_NO_UNIQUE_ADDRESS Scheduler sched_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  _outcome outcome_ = _outcome::value;
+  std::exception_ptr error_;
+  manual_lifetime<next_operation_t<StreamSender, next_receiver_t>> next_;
+  manual_lifetime<typename fold_t::batch_type> batch_;
+  manual_lifetime<typename fold_t::operation_type> fold_;
+  manual_lifetime<cleanup_operation_t<StreamSender, cleanup_receiver_t>>
+      cleanup_;
+};
+
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler>
+struct _sender {
+  struct type;
+};
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler>
+using sender = typename _sender<
+    remove_cvref_t<StreamSender>,
+    remove_cvref_t<State>,
+    remove_cvref_t<ReducerFunc>,
+    remove_cvref_t<Scheduler>>::type;
+
+template <
+    typename StreamSender,
+    typename State,
+    typename ReducerFunc,
+    typename Scheduler>
+struct _sender<StreamSender, State, ReducerFunc, Scheduler>::type {
+  StreamSender stream_;
+  State initialState_;
+  ReducerFunc reducer_;
+  Scheduler sched_;
+
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<State>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template <typename Receiver>
+  using operation_t =
+      operation<StreamSender, State, ReducerFunc, Scheduler, Receiver>;
+
+  template(typename Self, typename Receiver)
+      (requires same_as<remove_cvref_t<Self>, type> AND receiver<Receiver>)
+  friend operation_t<Receiver>
+  tag_invoke(tag_t<connect>, Self&& self, Receiver&& receiver) {
+    return operation_t<Receiver>{
+        static_cast<Self&&>(self).stream_,
+        static_cast<Self&&>(self).initialState_,
+        static_cast<Self&&>(self).reducer_,
+        static_cast<Self&&>(self).sched_,
+        (Receiver &&) receiver};
+  }
+};
+
+using _parallel::is_parallel_policy_v;
+} // namespace _par_reduce
+
 namespace _reduce_cpo {
   inline const struct _fn {
     template <typename StreamSender, typename State, typename ReducerFunc>
@@ -366,6 +893,88 @@ namespace _reduce_cpo {
         -> bind_back_result_t<_fn, State, ReducerFunc> {
       return bind_back(*this, (State&&)initialState, (ReducerFunc&&)reducer);
     }
+    template(
+        typename StreamSender,
+        typename State,
+        typename ReducerFunc,
+        typename Policy,
+        typename Scheduler)
+      (requires _par_reduce::is_parallel_policy_v<Policy> AND
+          tag_invocable<
+              _fn, StreamSender, State, ReducerFunc, Policy, Scheduler>)
+    auto operator()(
+        StreamSender&& stream,
+        State&& initialState,
+        ReducerFunc&& reducer,
+        Policy&& policy,
+        Scheduler&& sched) const
+        noexcept(is_nothrow_tag_invocable_v<
+            _fn, StreamSender, State, ReducerFunc, Policy, Scheduler>)
+        -> tag_invoke_result_t<
+            _fn, StreamSender, State, ReducerFunc, Policy, Scheduler> {
+      return unifex::tag_invoke(
+          _fn{},
+          (StreamSender &&) stream,
+          (State &&) initialState,
+          (ReducerFunc &&) reducer,
+          (Policy &&) policy,
+          (Scheduler &&) sched);
+    }
+    template(
+        typename StreamSender,
+        typename State,
+        typename ReducerFunc,
+        typename Policy,
+        typename Scheduler)
+      (requires _par_reduce::is_parallel_policy_v<Policy> AND
+          (!tag_invocable<
+              _fn, StreamSender, State, ReducerFunc, Policy, Scheduler>))
+    auto operator()(
+        StreamSender&& stream,
+        State&& initialState,
+        ReducerFunc&& reducer,
+        Policy&& policy,
+        Scheduler&& sched) const {
+      if constexpr (_par_reduce::_reduces_by_index<
+                        remove_cvref_t<StreamSender>,
+                        remove_cvref_t<State>,
+                        remove_cvref_t<ReducerFunc>>()) {
+        return _par_reduce::_reduce_by_index(
+            remove_cvref_t<StreamSender>((StreamSender &&) stream),
+            (State &&) initialState,
+            (ReducerFunc &&) reducer,
+            policy,
+            (Scheduler &&) sched);
+      } else {
+        return _par_reduce::
+            sender<StreamSender, State, ReducerFunc, Scheduler>{
+                (StreamSender &&) stream,
+                (State &&) initialState,
+                (ReducerFunc &&) reducer,
+                (Scheduler &&) sched};
+      }
+    }
+    template(
+        typename State,
+        typename ReducerFunc,
+        typename Policy,
+        typename Scheduler)
+      (requires _par_reduce::is_parallel_policy_v<Policy>)
+    constexpr auto operator()(
+        State&& initialState,
+        ReducerFunc&& reducer,
+        Policy&& policy,
+        Scheduler&& sched) const
+        noexcept(is_nothrow_callable_v<
+          tag_t<bind_back>, _fn, State, ReducerFunc, Policy, Scheduler>)
+        -> bind_back_result_t<_fn, State, ReducerFunc, Policy, Scheduler> {
+      return bind_back(
+          *this,
+          (State&&)initialState,
+          (ReducerFunc&&)reducer,
+          (Policy&&)policy,
+          (Scheduler&&)sched);
+    }
   } reduce_stream{};
 } // namespace _reduce_cpo
 using _reduce_cpo::reduce_stream;
@@ -22,6 +22,7 @@
 #include <unifex/type_traits.hpp>
 #include <unifex/type_list.hpp>
 #include <unifex/manual_lifetime.hpp>
+#include <unifex/restart.hpp>
 #include <unifex/async_trace.hpp>
 #include <unifex/bind_back.hpp>
 
@@ -69,20 +70,33 @@ public:
     auto* op = op_;
 
     UNIFEX_ASSERT(op->isSourceOpConstructed_);
-    op->isSourceOpConstructed_ = false;
-    op->sourceOp_.destruct();
 
-    if constexpr (std::is_nothrow_invocable_v<Predicate&> && is_nothrow_connectable_v<Source&, type> && is_nothrow_tag_invocable_v<tag_t<unifex::set_value>, Receiver>) {
+    // A restartable source operation is kept alive and restarted for the next
+    // iteration rather than being destroyed and re-connected.
+    constexpr bool restartable =
+        is_restartable_v<connect_result_t<Source&, type>>;
+
+    if constexpr (!restartable) {
+      op->isSourceOpConstructed_ = false;
+      op->sourceOp_.destruct();
+    }
+
+    if constexpr (std::is_nothrow_invocable_v<Predicate&> && (restartable || is_nothrow_connectable_v<Source&, type>) && is_nothrow_tag_invocable_v<tag_t<unifex::set_value>, Receiver>) {
       // call predicate and complete with void if it returns true
       if(op->predicate_()) {
         unifex::set_value(std::move(op->receiver_));
         return;
       }
-      auto& sourceOp = op->sourceOp_.construct_with([&]() noexcept {
-          return unifex::connect(op->source_, type{op});
-        });
-      op->isSourceOpConstructed_ = true;
-      unifex::start(sourceOp);
+      if constexpr (restartable) {
+        unifex::restart(op->sourceOp_.get());
+        unifex::start(op->sourceOp_.get());
+      } else {
+        auto& sourceOp = op->sourceOp_.construct_with([&]() noexcept {
+            return unifex::connect(op->source_, type{op});
+          });
+        op->isSourceOpConstructed_ = true;
+        unifex::start(sourceOp);
+      }
     } else {
       UNIFEX_TRY {
         // call predicate and complete with void if it returns true
@@ -90,11 +104,16 @@ public:
           unifex::set_value(std::move(op->receiver_));
           return;
         }
-        auto& sourceOp = op->sourceOp_.construct_with([&] {
-            return unifex::connect(op->source_, type{op});
-          });
-        op->isSourceOpConstructed_ = true;
-        unifex::start(sourceOp);
+        if constexpr (restartable) {
+          unifex::restart(op->sourceOp_.get());
+          unifex::start(op->sourceOp_.get());
+        } else {
+          auto& sourceOp = op->sourceOp_.construct_with([&] {
+              return unifex::connect(op->source_, type{op});
+            });
+          op->isSourceOpConstructed_ = true;
+          unifex::start(sourceOp);
+        }
       } UNIFEX_CATCH (...) {
         unifex::set_error(std::move(op->receiver_), std::current_exception());
       }
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/tag_invoke.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _restart_cpo {
+  // restart(op) returns an operation-state that has completed to the state it
+  // was in just after connect(), so that it can be start()ed again with the
+  // same receiver instead of being destroyed and re-connected.
+  //
+  // Operation-states opt in to this protocol by customising restart(), either
+  // with tag_invoke() or with a noexcept member restart().  Because the
+  // restarted operation completes the same receiver again, restart() may only
+  // be used by a receiver's owner that knows completing the receiver leaves
+  // it usable, e.g. a receiver that only holds a pointer back to its owner.
+  //
+  // restart() and the subsequent start() may be called from within the
+  // operation's own completion signal so, as with destruction, a restartable
+  // operation must not touch its own state after completing its receiver.
+  inline const struct _fn {
+    template(typename Operation)
+      (requires tag_invocable<_fn, Operation&>)
+    auto operator()(Operation& op) const noexcept
+        -> tag_invoke_result_t<_fn, Operation&> {
+      static_assert(
+          is_nothrow_tag_invocable_v<_fn, Operation&>,
+          "restart() customisation must be noexcept");
+      return unifex::tag_invoke(_fn{}, op);
+    }
+    template(typename Operation)
+      (requires (!tag_invocable<_fn, Operation&>))
+    auto operator()(Operation& op) const noexcept -> decltype(op.restart()) {
+      static_assert(
+          noexcept(op.restart()),
+          "restart() customisation must be noexcept");
+      return op.restart();
+    }
+  } restart{};
+} // namespace _restart_cpo
+using _restart_cpo::restart;
+
+template <typename Operation>
+inline constexpr bool is_restartable_v = is_callable_v<tag_t<restart>, Operation&>;
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -23,6 +23,7 @@
 #include <unifex/type_list.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/manual_lifetime_union.hpp>
+#include <unifex/restart.hpp>
 #include <unifex/async_trace.hpp>
 #include <unifex/bind_back.hpp>
 
@@ -77,15 +78,19 @@ public:
 
     using source_receiver_t = source_receiver<Source, Func, Receiver>;
 
-    if constexpr (is_nothrow_connectable_v<Source&, source_receiver_t>) {
-      auto& sourceOp = unifex::activate_union_member_with(op->sourceOp_, [&]() noexcept {
+    if constexpr (operation<Source, Func, Receiver>::restartable) {
+      auto& sourceOp = op->storage_.sourceOp_.get();
+      unifex::restart(sourceOp);
+      unifex::start(sourceOp);
+    } else if constexpr (is_nothrow_connectable_v<Source&, source_receiver_t>) {
+      auto& sourceOp = unifex::activate_union_member_with(op->storage_.sourceOp_, [&]() noexcept {
           return unifex::connect(op->source_, source_receiver_t{op});
         });
       op->isSourceOpConstructed_ = true;
       unifex::start(sourceOp);
     } else {
       UNIFEX_TRY {
-        auto& sourceOp = unifex::activate_union_member_with(op->sourceOp_, [&] {
+        auto& sourceOp = unifex::activate_union_member_with(op->storage_.sourceOp_, [&] {
             return unifex::connect(op->source_, source_receiver_t{op});
           });
         op->isSourceOpConstructed_ = true;
@@ -150,7 +155,7 @@ private:
 
   void destroy_trigger_op() noexcept {
     using trigger_op = connect_result_t<Trigger, trigger_receiver>;
-    unifex::deactivate_union_member<trigger_op>(op_->triggerOps_);
+    unifex::deactivate_union_member<trigger_op>(op_->storage_.triggerOps_);
   }
 
   operation<Source, Func, Receiver>* op_;
@@ -186,8 +191,12 @@ public:
     UNIFEX_ASSERT(op_ != nullptr);
     auto* const op = op_;
 
-    op->isSourceOpConstructed_ = false;
-    unifex::deactivate_union_member(op->sourceOp_);
+    // A restartable source operation is kept alive while the trigger runs so
+    // that it can be restarted rather than re-connected.
+    if constexpr (!operation<Source, Func, Receiver>::restartable) {
+      op->isSourceOpConstructed_ = false;
+      unifex::deactivate_union_member(op->storage_.sourceOp_);
+    }
 
     using trigger_sender_t = std::invoke_result_t<Func&, Error>;
     using trigger_receiver_t = trigger_receiver<Source, Func, Receiver, trigger_sender_t>;
@@ -196,7 +205,7 @@ public:
     if constexpr (std::is_nothrow_invocable_v<Func&, Error> &&
                   is_nothrow_connectable_v<trigger_sender_t, trigger_receiver_t>) {
       auto& triggerOp = unifex::activate_union_member_with<trigger_op_t>(
-        op->triggerOps_,
+        op->storage_.triggerOps_,
         [&]() noexcept {
           return unifex::connect(
             std::invoke(op->func_, (Error&&)error), trigger_receiver_t{op});
@@ -205,7 +214,7 @@ public:
     } else {
       UNIFEX_TRY {
         auto& triggerOp = unifex::activate_union_member_with<trigger_op_t>(
-          op->triggerOps_,
+          op->storage_.triggerOps_,
             [&]() {
               return unifex::connect(
                 std::invoke(op->func_, (Error&&)error), trigger_receiver_t{op});
@@ -247,6 +256,26 @@ private:
   operation<Source, Func, Receiver>* op_;
 };
 
+// The source operation and the trigger operations are never alive at the same
+// time so they share storage, unless the source operation is restartable, in
+// which case it's kept alive while the trigger runs and restarted afterwards.
+template <typename SourceOp, typename TriggerOps, bool Restartable>
+struct _storage {
+  _storage() noexcept {}
+  ~_storage() {}
+
+  union {
+    manual_lifetime<SourceOp> sourceOp_;
+    TriggerOps triggerOps_;
+  };
+};
+
+template <typename SourceOp, typename TriggerOps>
+struct _storage<SourceOp, TriggerOps, true> {
+  manual_lifetime<SourceOp> sourceOp_;
+  TriggerOps triggerOps_;
+};
+
 template <typename Source, typename Func, typename Receiver>
 class _op<Source, Func, Receiver>::type {
   using operation = type;
@@ -261,19 +290,19 @@ public:
   : source_((Source2&&)source)
   , func_((Func2&&)func)
   , receiver_((Receiver&&)receiver) {
-    unifex::activate_union_member_with(sourceOp_, [&] {
+    unifex::activate_union_member_with(storage_.sourceOp_, [&] {
         return unifex::connect(source_, source_receiver_t{this});
       });
   }
 
   ~type() {
     if (isSourceOpConstructed_) {
-      unifex::deactivate_union_member(sourceOp_);
+      unifex::deactivate_union_member(storage_.sourceOp_);
     }
   }
 
   void start() & noexcept {
-    unifex::start(sourceOp_.get());
+    unifex::start(storage_.sourceOp_.get());
   }
 
 private:
@@ -284,6 +313,8 @@ private:
 
   using source_op_t = connect_result_t<Source&, source_receiver_t>;
 
+  static constexpr bool restartable = is_restartable_v<source_op_t>;
+
   template <typename Error>
   using trigger_sender_t = std::invoke_result_t<Func&, remove_cvref_t<Error>>;
 
@@ -302,10 +333,11 @@ private:
   UNIFEX_NO_UNIQUE_ADDRESS Func func_;
   UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
   bool isSourceOpConstructed_ = true;
-  union {
-    manual_lifetime<source_op_t> sourceOp_;
-    typename Source::template error_types<trigger_op_union> triggerOps_;
-  };
+  _storage<
+      source_op_t,
+      typename Source::template error_types<trigger_op_union>,
+      restartable>
+      storage_;
 };
 
 template <typename Source, typename Func>
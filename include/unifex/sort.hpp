@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bulk_join.hpp>
+#include <unifex/bulk_schedule.hpp>
+#include <unifex/bulk_transform.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _sort {
+
+inline constexpr std::size_t min_chunk_size = 2048;
+
+// A parallel merge sort. Each chunk is sorted on its own, then the sorted
+// runs are merged pairwise up a binary tree over the chunks. Every inner
+// node of the tree is merged by whichever of its two children finishes
+// last, so the merges start as soon as their inputs are ready and no
+// worker ever waits for another.
+template <typename Iterator, typename Compare>
+struct _shared {
+  _shared(Iterator first, _parallel::chunking chunks, Compare&& comp)
+    : first_(first)
+    , comp_(std::move(comp))
+    , chunks_(chunks)
+    , arrivals_(new std::atomic<unsigned char>[chunks_.count]{}) {}
+
+  void sort_chunk(std::size_t index) noexcept {
+    errors_.run([&] {
+      std::sort(
+          first_ + chunks_.begin(index), first_ + chunks_.end(index), comp_);
+    });
+
+    // Climb the tree from leaf `index`. At each level `node` is the index
+    // of the subtree we have just finished among the subtrees of
+    // 2^level chunks.
+    const std::size_t count = chunks_.count;
+    std::size_t node = index;
+    for (std::size_t level = 0; (std::size_t(1) << level) < count; ++level) {
+      const std::size_t left = (node & ~std::size_t(1)) << level;
+      const std::size_t mid = left + (std::size_t(1) << level);
+      node >>= 1;
+      if (mid >= count) {
+        // There is no right subtree: the left one is carried up as is.
+        continue;
+      }
+      // The first chunk of a right subtree identifies its parent.
+      if (arrivals_[mid].fetch_add(1, std::memory_order_acq_rel) == 0) {
+        return;
+      }
+      if (errors_.failed()) {
+        return;
+      }
+      const std::size_t last =
+          std::min(mid + (std::size_t(1) << level), count) - 1;
+      errors_.run([&] {
+        std::inplace_merge(
+            first_ + chunks_.begin(left),
+            first_ + chunks_.begin(mid),
+            first_ + chunks_.end(last),
+            comp_);
+      });
+    }
+  }
+
+  Iterator first_;
+  Compare comp_;
+  _parallel::chunking chunks_;
+  std::unique_ptr<std::atomic<unsigned char>[]> arrivals_;
+  _parallel::first_error errors_;
+};
+
+struct _fn {
+  // Sorts [first, last) by `comp` on `sched`, sending no value once it is
+  // sorted. With a parallel policy the range is split into a few chunks
+  // for each thread of the scheduler. If the operation is cancelled
+  // before it completes it sends done and the range is left in an
+  // unspecified order.
+  template(
+      typename Scheduler,
+      typename Policy,
+      typename Iterator,
+      typename Compare = std::less<>)
+    (requires scheduler<Scheduler> AND
+        _parallel::is_execution_policy_v<Policy> AND
+        _parallel::is_random_access_iterator_v<Iterator>)
+  auto operator()(
+      Scheduler&& sched,
+      const Policy& policy,
+      Iterator first,
+      Iterator last,
+      Compare comp = {}) const {
+    using shared_t = _shared<Iterator, remove_cvref_t<Compare>>;
+    const auto size = static_cast<std::size_t>(last - first);
+    const auto chunks = _parallel::split(
+        policy, size, get_concurrency(sched), min_chunk_size);
+    return let_value_with(
+        [first, chunks, comp = std::move(comp)]() mutable {
+          return shared_t{first, chunks, std::move(comp)};
+        },
+        [sched = (Scheduler &&) sched, policy](shared_t& shared) mutable {
+          return then(
+              bulk_join(bulk_transform(
+                  bulk_schedule(std::move(sched), shared.chunks_.count),
+                  [&shared](std::size_t index) noexcept {
+                    shared.sort_chunk(index);
+                  },
+                  policy)),
+              [&shared] { shared.errors_.rethrow(); });
+        });
+  }
+};
+
+} // namespace _sort
+
+inline constexpr _sort::_fn sort{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/tag_invoke.hpp>
+
+#include <cstddef>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _splice_cpo {
+//
+// async_splice(scheduler, fdIn, fdOut, length)
+//
+// Moves up to `length` bytes from `fdIn` to `fdOut` inside the kernel, at
+// the current position of each, and sends the number of bytes moved. One
+// of the two must be a pipe. Like async_read_some, it sends 0 once `fdIn`
+// has ended.
+//
+inline const struct async_splice_cpo {
+  template <typename Scheduler>
+  auto operator()(
+      Scheduler&& sched,
+      int fdIn,
+      int fdOut,
+      std::size_t length) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_splice_cpo,
+               Scheduler,
+               int,
+               int,
+               std::size_t>)
+          -> tag_invoke_result_t<
+              async_splice_cpo,
+              Scheduler,
+              int,
+              int,
+              std::size_t> {
+    return unifex::tag_invoke(*this, (Scheduler &&) sched, fdIn, fdOut, length);
+  }
+} async_splice{};
+
+//
+// async_splice_all(scheduler, fdIn, fdOut, length)
+//
+// Like async_splice, but keeps going until `length` bytes have been moved
+// or `fdIn` has ended.
+//
+inline const struct async_splice_all_cpo {
+  template <typename Scheduler>
+  auto operator()(
+      Scheduler&& sched,
+      int fdIn,
+      int fdOut,
+      std::size_t length) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_splice_all_cpo,
+               Scheduler,
+               int,
+               int,
+               std::size_t>)
+          -> tag_invoke_result_t<
+              async_splice_all_cpo,
+              Scheduler,
+              int,
+              int,
+              std::size_t> {
+    return unifex::tag_invoke(*this, (Scheduler &&) sched, fdIn, fdOut, length);
+  }
+} async_splice_all{};
+
+//
+// async_tee(scheduler, pipeIn, pipeOut, length)
+//
+// Copies up to `length` bytes from one pipe to another without consuming
+// them, and sends the number of bytes copied.
+//
+inline const struct async_tee_cpo {
+  template <typename Scheduler>
+  auto operator()(
+      Scheduler&& sched,
+      int pipeIn,
+      int pipeOut,
+      std::size_t length) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_tee_cpo,
+               Scheduler,
+               int,
+               int,
+               std::size_t>)
+          -> tag_invoke_result_t<
+              async_tee_cpo,
+              Scheduler,
+              int,
+              int,
+              std::size_t> {
+    return unifex::tag_invoke(
+        *this, (Scheduler &&) sched, pipeIn, pipeOut, length);
+  }
+} async_tee{};
+} // namespace _splice_cpo
+
+using _splice_cpo::async_splice;
+using _splice_cpo::async_splice_all;
+using _splice_cpo::async_tee;
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
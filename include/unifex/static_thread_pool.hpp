@@ -15,13 +15,23 @@
  */
 #pragma once
 
+#include <unifex/bulk_schedule.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/get_execution_policy.hpp>
+#include <unifex/get_metrics.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
+#include <unifex/restart.hpp>
 #include <unifex/scheduler_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
 #include <unifex/stop_token_concepts.hpp>
 #include <unifex/detail/intrusive_queue.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -45,9 +55,22 @@ namespace _static_thread_pool {
   template <typename Receiver>
   using operation = typename _op<remove_cvref_t<Receiver>>::type;
 
+  template <typename Integral, typename Receiver>
+  struct _bulk_op {
+    class type;
+  };
+  template <typename Integral, typename Receiver>
+  using bulk_operation =
+      typename _bulk_op<Integral, remove_cvref_t<Receiver>>::type;
+
+  struct _pending_tasks;
+
   class context {
     template <typename Receiver>
     friend struct _op;
+    template <typename Integral, typename Receiver>
+    friend struct _bulk_op;
+    friend struct _pending_tasks;
   public:
     context();
     context(std::uint32_t threadCount);
@@ -93,19 +116,86 @@ namespace _static_thread_pool {
         context& pool_;
       };
 
+      // bulk_schedule() runs set_next() on as many workers as there are
+      // chunks of work to share when the receiver's execution policy allows
+      // it, and on a single worker otherwise.
+      template <typename Integral>
+      class bulk_sender {
+      public:
+        template <
+            template <typename...> class Variant,
+            template <typename...> class Tuple>
+        using value_types = Variant<Tuple<>>;
+
+        template <
+            template <typename...> class Variant,
+            template <typename...> class Tuple>
+        using next_types = Variant<Tuple<Integral>>;
+
+        template <template <typename...> class Variant>
+        using error_types = Variant<std::exception_ptr>;
+
+        static constexpr bool sends_done = true;
+
+        static constexpr blocking_kind blocking = blocking_kind::never;
+
+        static constexpr bool is_always_scheduler_affine = false;
+
+      private:
+        template(typename BulkReceiver)
+          (requires receiver_of<BulkReceiver> AND
+              is_next_receiver_v<BulkReceiver, Integral>)
+        friend bulk_operation<Integral, BulkReceiver>
+        tag_invoke(tag_t<connect>, bulk_sender s, BulkReceiver&& r) {
+          return bulk_operation<Integral, BulkReceiver>{
+              s.pool_, s.count_, (BulkReceiver &&) r};
+        }
+
+        friend class context::scheduler;
+
+        explicit bulk_sender(context& pool, Integral count) noexcept
+          : pool_(pool)
+          , count_(count) {}
+
+        context& pool_;
+        Integral count_;
+      };
+
       schedule_sender make_sender_() const {
         return schedule_sender{pool_};
       }
 
+      template <typename Integral>
+      bulk_sender<Integral> make_bulk_sender_(Integral count) const {
+        return bulk_sender<Integral>{pool_, count};
+      }
+
       friend schedule_sender
       tag_invoke(tag_t<schedule>, const scheduler& s) noexcept {
         return s.make_sender_();
       }
 
+      template(typename Integral)
+        (requires std::is_integral_v<Integral>)
+      friend bulk_sender<Integral>
+      tag_invoke(tag_t<bulk_schedule>, const scheduler& s, Integral count)
+          noexcept {
+        return s.make_bulk_sender_(count);
+      }
+
       friend class context;
       explicit scheduler(context& pool) noexcept
         : pool_(pool) {}
 
+      std::uint32_t concurrency_() const noexcept {
+        return pool_.threadCount_;
+      }
+
+      friend std::uint32_t
+      tag_invoke(tag_t<get_concurrency>, const scheduler& s) noexcept {
+        return s.concurrency_();
+      }
+
       friend bool operator==(scheduler a, scheduler b) noexcept {
         return &a.pool_ == &b.pool_;
       }
@@ -120,16 +210,62 @@ namespace _static_thread_pool {
 
     void request_stop() noexcept;
 
+    struct thread_metrics {
+      // Tasks this worker ran, including stolen ones.
+      std::uint64_t tasksExecuted;
+      // Tasks pushed onto this worker's queue by one of the pool's own
+      // workers and by any other thread.
+      std::uint64_t localEnqueues;
+      std::uint64_t remoteEnqueues;
+      // Tasks this worker took from another worker's queue.
+      std::uint64_t steals;
+      // Times this worker went to sleep waiting for work and times it was
+      // woken because work arrived.
+      std::uint64_t parks;
+      std::uint64_t unparks;
+      std::chrono::nanoseconds idleTime;
+    };
+
+    struct metrics {
+      std::vector<thread_metrics> threads;
+    };
+
+    friend metrics tag_invoke(tag_t<get_metrics>, const context& pool) {
+      return pool.get_metrics_();
+    }
+
   private:
     class thread_state {
     public:
       task_base* try_pop();
       task_base* pop();
-      bool try_push(task_base* task);
-      void push(task_base* task);
+      // `local` says whether the caller is one of the pool's workers.
+      bool try_push(task_base* task, bool local);
+      void push(task_base* task, bool local);
+      void push_all(
+          intrusive_queue<task_base, &task_base::next> tasks,
+          std::uint32_t count,
+          bool local);
       void request_stop();
 
+      thread_metrics get_metrics() const noexcept;
+
+      // Only updated by this state's worker.
+      _metrics::counter tasksExecuted_;
+      _metrics::counter steals_;
+
     private:
+      void count_enqueues(std::uint32_t count, bool local) noexcept;
+
+      // Only updated by this state's worker.
+      _metrics::counter parks_;
+      _metrics::counter unparks_;
+      _metrics::counter idleNanoseconds_;
+
+      // Only updated with mut_ held.
+      _metrics::counter localEnqueues_;
+      _metrics::counter remoteEnqueues_;
+
       std::mutex mut_;
       std::condition_variable cv_;
       intrusive_queue<task_base, &task_base::next> queue_;
@@ -139,8 +275,14 @@ namespace _static_thread_pool {
     void run(std::uint32_t index) noexcept;
     void join() noexcept;
 
+    metrics get_metrics_() const;
+
     void enqueue(task_base* task) noexcept;
 
+    void enqueue_all(
+        intrusive_queue<task_base, &task_base::next> tasks,
+        std::uint32_t count) noexcept;
+
     std::uint32_t threadCount_;
     std::vector<std::thread> threads_;
     std::vector<thread_state> threadStates_;
@@ -177,6 +319,129 @@ namespace _static_thread_pool {
     friend void tag_invoke(tag_t<start>, type& op) noexcept {
       op.enqueue_(&op);
     }
+
+    friend void tag_invoke(tag_t<restart>, type&) noexcept {}
+  };
+
+  template <typename Integral, typename Receiver>
+  class _bulk_op<Integral, Receiver>::type {
+    using policy_t = decltype(get_execution_policy(UNIFEX_DECLVAL(Receiver&)));
+
+    static constexpr bool is_parallel =
+        is_one_of_v<policy_t, parallel_policy, parallel_unsequenced_policy>;
+
+    struct worker : task_base {
+      type* op_;
+    };
+
+  public:
+    template <typename Receiver2>
+    explicit type(context& pool, Integral count, Receiver2&& r)
+      : pool_(pool)
+      , count_(count)
+      , receiver_((Receiver2 &&) r) {
+      Integral workerCount = 1;
+      blockSize_ = static_cast<Integral>(bulk_cancellation_chunk_size);
+      if constexpr (is_parallel) {
+        // Hand indices out in blocks small enough that every worker gets
+        // a share and cancellation is still noticed promptly.
+        const auto threads = static_cast<Integral>(pool.threadCount_);
+        blockSize_ = std::clamp(
+            static_cast<Integral>(count / (threads * 4)),
+            Integral(1),
+            blockSize_);
+        workerCount = std::clamp(
+            static_cast<Integral>((count + blockSize_ - 1) / blockSize_),
+            Integral(1),
+            threads);
+      }
+      workerCount_ = static_cast<std::uint32_t>(workerCount);
+      workers_.reset(new worker[workerCount_]);
+    }
+
+    type(type&&) = delete;
+
+    void start() noexcept {
+      remaining_.store(workerCount_, std::memory_order_relaxed);
+      intrusive_queue<task_base, &task_base::next> tasks;
+      for (std::uint32_t i = 0; i < workerCount_; ++i) {
+        auto& w = workers_[i];
+        w.op_ = this;
+        w.execute = &execute;
+        tasks.push_back(&w);
+      }
+      pool_.enqueue_all(std::move(tasks), workerCount_);
+    }
+
+  private:
+    static void execute(task_base* t) noexcept {
+      auto& op = *static_cast<worker*>(t)->op_;
+      op.run();
+      if (op.remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        op.complete();
+      }
+    }
+
+    // Claims blocks of indices in ascending order until they run out.  A
+    // claimed block is always run to the end, so once an index has been
+    // passed to set_next() every lower index will be too, even if stop is
+    // requested in the meantime.
+    void run() noexcept {
+      auto stopToken = get_stop_token(receiver_);
+      for (;;) {
+        if (failed_.load(std::memory_order_relaxed)) {
+          return;
+        }
+        if constexpr (!is_stop_never_possible_v<decltype(stopToken)>) {
+          if (stopToken.stop_requested()) {
+            stopped_.store(true, std::memory_order_relaxed);
+            return;
+          }
+        }
+        const Integral begin =
+            next_.fetch_add(blockSize_, std::memory_order_relaxed);
+        if (begin >= count_) {
+          return;
+        }
+        const Integral end =
+            count_ - begin > blockSize_ ? begin + blockSize_ : count_;
+        UNIFEX_TRY {
+          for (Integral i = begin; i < end; ++i) {
+            unifex::set_next(receiver_, Integral(i));
+          }
+        }
+        UNIFEX_CATCH(...) {
+          if (!failed_.exchange(true, std::memory_order_relaxed)) {
+            error_ = std::current_exception();
+          }
+          return;
+        }
+      }
+    }
+
+    void complete() noexcept {
+      // The acq_rel decrement of remaining_ orders the other workers' writes
+      // before this.
+      if (failed_.load(std::memory_order_relaxed)) {
+        unifex::set_error(std::move(receiver_), std::move(error_));
+      } else if (stopped_.load(std::memory_order_relaxed)) {
+        unifex::set_done(std::move(receiver_));
+      } else {
+        unifex::set_value(std::move(receiver_));
+      }
+    }
+
+    context& pool_;
+    Integral count_;
+    Integral blockSize_;
+    std::uint32_t workerCount_;
+    Receiver receiver_;
+    std::unique_ptr<worker[]> workers_;
+    std::atomic<Integral> next_{0};
+    std::atomic<std::uint32_t> remaining_{0};
+    std::atomic<bool> stopped_{false};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
   };
 
 } // _static_thread_pool
@@ -27,6 +27,7 @@
 #include <unifex/async_trace.hpp>
 #include <unifex/bind_back.hpp>
 #include <unifex/exception.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <atomic>
 #include <exception>
@@ -217,7 +218,10 @@ struct _stream<SourceStream, Values...>::type {
 
     template <typename Receiver>
     struct _op {
-      struct type {
+      struct type
+        : _stop_callback_storage<
+              stop_token_type_t<Receiver&>,
+              cancel_next_callback> {
         struct concrete_receiver final : next_receiver_base {
           type& op_;
 
@@ -226,17 +230,17 @@ struct _stream<SourceStream, Values...>::type {
           {}
 
           void set_value(Values&&... values) && noexcept final {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             unifex::set_value(std::move(op_.receiver_), (Values&&)values...);
           }
 
           void set_done() && noexcept final {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             unifex::set_done(std::move(op_.receiver_));
           }
 
           void set_error(std::exception_ptr ex) && noexcept final {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             unifex::set_error(std::move(op_.receiver_), std::move(ex));
           }
         };
@@ -246,9 +250,6 @@ struct _stream<SourceStream, Values...>::type {
         stream& stream_;
         concrete_receiver concreteReceiver_;
         UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
-        UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<
-          typename ST::template callback_type<cancel_next_callback>>
-            stopCallback_;
 
         template <typename Receiver2>
         explicit type(stream& strm, Receiver2&& receiver)
@@ -277,7 +278,7 @@ struct _stream<SourceStream, Values...>::type {
             stream_.state_.store(
               state::source_next_active, std::memory_order_relaxed);
             UNIFEX_TRY {
-              stopCallback_.construct(
+              this->construct_stop_callback(
                 std::move(stopToken),
                 cancel_next_callback{stream_});
               unifex::start(stream_.nextOp_.get());
@@ -24,10 +24,10 @@
 #include <unifex/tag_invoke.hpp>
 #include <unifex/type_list.hpp>
 #include <unifex/type_traits.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <atomic>
 #include <functional>
-#include <optional>
 #include <tuple>
 #include <type_traits>
 #include <variant>
@@ -157,10 +157,49 @@ private:
 };
 
 template <typename Source, typename Trigger, typename Receiver>
-class _op<Source, Trigger, Receiver>::type {
+struct _cancel {
+  class type;
+};
+
+template <typename Source, typename Trigger, typename Receiver>
+class _cancel<Source, Trigger, Receiver>::type {
+  using operation_state = stop_when_operation<Source, Trigger, Receiver>;
+
+public:
+  explicit type(operation_state* op) noexcept : op_(op) {}
+
+  void operator()() noexcept {
+    // save this on the stack; it's likely this callback object will be
+    // destroyed as a side effect of requesting stop on the operation's stop
+    // source so we can't use this->op_ after request_stop() returns
+    auto op = op_;
+
+    if (op->activeOpCount_.fetch_add(1, std::memory_order_relaxed) == 0) {
+      // someone's already invoked deliver_result() so we should bail out
+      return;
+    }
+
+    op->stopSource_.request_stop();
+
+    if (op->activeOpCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // we're the last owner of the operation so deliver its result now
+      op->deliver_result();
+    }
+  }
+
+private:
+  operation_state* op_;
+};
+
+template <typename Source, typename Trigger, typename Receiver>
+class _op<Source, Trigger, Receiver>::type
+  : _stop_callback_storage<
+        stop_token_type_t<Receiver>,
+        typename _cancel<Source, Trigger, Receiver>::type> {
   using source_receiver = stop_when_source_receiver<Source, Trigger, Receiver>;
   using trigger_receiver =
       stop_when_trigger_receiver<Source, Trigger, Receiver>;
+  using cancel_callback = typename _cancel<Source, Trigger, Receiver>::type;
 
 public:
   template <typename Receiver2>
@@ -181,7 +220,8 @@ public:
           unifex::connect((Trigger &&) trigger, trigger_receiver{this})) {}
 
   void start() & noexcept {
-    stopCallback_.emplace(get_stop_token(receiver_), cancel_callback{this});
+    this->construct_stop_callback(
+        get_stop_token(receiver_), cancel_callback{this});
 
     unifex::start(sourceOp_);
     unifex::start(triggerOp_);
@@ -190,45 +230,20 @@ public:
 private:
   friend class _srcvr<Source, Trigger, Receiver>::type;
   friend class _trcvr<Source, Trigger, Receiver>::type;
-
-  class cancel_callback {
-  public:
-    explicit cancel_callback(type* op) noexcept : op_(op) {}
-
-    void operator()() noexcept {
-      // save this on the stack; it's likely this callback object will be
-      // destroyed as a side effect of requesting stop on the operation's stop
-      // source so we can't use this->op_ after request_stop() returns
-      auto op = op_;
-
-      if (op->activeOpCount_.fetch_add(1, std::memory_order_relaxed) == 0) {
-        // someone's already invoked deliver_result() so we should bail out
-        return;
-      }
-
-      op->stopSource_.request_stop();
-
-      if (op->activeOpCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-        // we're the last owner of the operation so deliver its result now
-        op->deliver_result();
-      }
-    }
-
-  private:
-    type* op_;
-  };
+  friend cancel_callback;
 
   void notify_source_complete() noexcept { this->notify_trigger_complete(); }
 
   void notify_trigger_complete() noexcept {
     stopSource_.request_stop();
     if (activeOpCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-      stopCallback_.reset();
       deliver_result();
     }
   }
 
   void deliver_result() noexcept {
+    this->destruct_stop_callback();
+
     UNIFEX_TRY {
       std::visit(
           [this](auto&& tuple) {
@@ -274,9 +289,6 @@ private:
   UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
   std::atomic<int> activeOpCount_ = 2;
   inplace_stop_source stopSource_;
-  std::optional<typename stop_token_type_t<Receiver>::template callback_type<
-      cancel_callback>>
-      stopCallback_;
   UNIFEX_NO_UNIQUE_ADDRESS result_variant result_;
   UNIFEX_NO_UNIQUE_ADDRESS connect_result_t<Source, source_receiver> sourceOp_;
   UNIFEX_NO_UNIQUE_ADDRESS
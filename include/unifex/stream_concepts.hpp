@@ -92,6 +92,14 @@ using next_operation_t = connect_result_t<next_sender_t<Stream>, Receiver>;
 template <typename Stream, typename Receiver>
 using cleanup_operation_t = connect_result_t<cleanup_sender_t<Stream>, Receiver>;
 
+// A stream whose remaining values can be addressed by index opts in to
+// being reduced in parallel by index by specialising this to true. It must
+// be copyable and provide s.remaining(), the number of values it has left,
+// and s.value_at(i), the i'th of them, which is called concurrently on
+// copies of the stream.
+template <typename Stream>
+inline constexpr bool enable_indexed_stream = false;
+
 } // namespace unifex
 
 #include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _submission_batch {
+  // Work that an execution context has held back during a submission_batch;
+  // submit_ hands it over when the batch ends.
+  struct deferred_submission {
+    deferred_submission* next_ = nullptr;
+    void (*submit_)(deferred_submission*) noexcept = nullptr;
+  };
+
+  // While a submission_batch is alive, execution contexts that support
+  // batching may hold back the work that the constructing thread enqueues
+  // onto them and submit it all at once when the batch is destroyed.
+  // static_thread_pool does; other contexts enqueue as usual.
+  //
+  // Batches nest; work is held until the outermost live batch is destroyed.
+  // Don't block on work enqueued while a batch is alive; it won't have been
+  // submitted yet.
+  class submission_batch {
+  public:
+    submission_batch() noexcept;
+    ~submission_batch();
+
+    submission_batch(submission_batch&&) = delete;
+
+    // The calling thread's outermost live batch, or nullptr.
+    static submission_batch* current() noexcept;
+
+    // Calls deferred.submit_ when this batch is destroyed. A
+    // deferred_submission may only be added to one batch at a time.
+    void defer(deferred_submission& deferred) noexcept {
+      deferred.next_ = deferred_;
+      deferred_ = &deferred;
+    }
+
+  private:
+    bool outermost_;
+    deferred_submission* deferred_ = nullptr;
+  };
+} // namespace _submission_batch
+
+using _submission_batch::deferred_submission;
+using _submission_batch::submission_batch;
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
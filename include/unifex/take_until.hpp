@@ -26,6 +26,7 @@
 #include <unifex/bind_back.hpp>
 #include <unifex/exception.hpp>
 #include <unifex/continuations.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <exception>
 #include <atomic>
@@ -108,25 +109,28 @@ struct _stream<SourceStream, TriggerStream>::type {
 
     template <typename Receiver>
     struct _op {
-      struct type {
+      struct type
+        : _stop_callback_storage<
+              stop_token_type_t<Receiver&>,
+              cancel_callback> {
         struct receiver_wrapper {
           type& op_;
 
           template <typename... Values>
           void set_value(Values&&... values) && noexcept {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             unifex::set_value(std::move(op_.receiver_), (Values&&)values...);
           }
 
           void set_done() && noexcept {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             op_.stream_.stopSource_.request_stop();
             unifex::set_done(std::move(op_.receiver_));
           }
 
           template <typename Error>
           void set_error(Error&& error) && noexcept {
-            op_.stopCallback_.destruct();
+            op_.destruct_stop_callback();
             op_.stream_.stopSource_.request_stop();
             unifex::set_error(std::move(op_.receiver_), (Error&&)error);
           }
@@ -161,9 +165,6 @@ struct _stream<SourceStream, TriggerStream>::type {
 
         take_until_stream& stream_;
         Receiver receiver_;
-        manual_lifetime<typename stop_token_type_t<Receiver&>::
-                        template callback_type<cancel_callback>>
-          stopCallback_;
         next_operation_t<SourceStream, receiver_wrapper> innerOp_;
 
         template <typename Receiver2>
@@ -191,7 +192,7 @@ struct _stream<SourceStream, TriggerStream>::type {
             }
           }
 
-          stopCallback_.construct(
+          this->construct_stop_callback(
             get_stop_token(receiver_),
             cancel_callback{stream_.stopSource_});
           unifex::start(innerOp_);
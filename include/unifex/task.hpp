@@ -30,6 +30,7 @@
 #include <unifex/invoke.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/on.hpp>
+#include <unifex/recycling_allocator.hpp>
 #include <unifex/scope_guard.hpp>
 #include <unifex/sender_concepts.hpp>
 #include <unifex/std_concepts.hpp>
@@ -43,7 +44,10 @@
 #  error "Coroutine support is required to use this header"
 #endif
 
+#include <cstddef>
 #include <exception>
+#include <memory>
+#include <new>
 
 #include <unifex/detail/prologue.hpp>
 
@@ -105,7 +109,7 @@ protected:
   std::uintptr_t coro_;
 };
 
-template <typename T, bool nothrow>
+template <typename T, bool nothrow, typename Frames>
 struct _task {
   /**
    * The "public facing" task<> type.
@@ -113,7 +117,7 @@ struct _task {
   struct [[nodiscard]] type;
 };
 
-template <typename T, bool nothrow>
+template <typename T, bool nothrow, typename Frames>
 struct _sa_task final {
   /**
    * A "scheduler-affine" task that's used as an implementation detail to mark a
@@ -135,6 +139,158 @@ struct _sr_thunk_task final {
   struct [[nodiscard]] type;
 };
 
+/**
+ * The default frame allocation policy: frames come from the global heap.
+ */
+struct _heap_frames {
+  static void* allocate(std::size_t size) { return ::operator new(size); }
+
+  static void deallocate(void* frame, std::size_t size) noexcept {
+    ::operator delete(frame, size);
+  }
+};
+
+/**
+ * A frame allocation policy that recycles coroutine frames through the calling
+ * thread's size-bucketed free lists; see recycling_allocator.hpp.
+ */
+struct _recycled_frames {
+  static void* allocate(std::size_t size) { return _recycle::allocate(size); }
+
+  static void deallocate(void* frame, std::size_t size) noexcept {
+    _recycle::deallocate(frame, size);
+  }
+};
+
+constexpr std::size_t _align_up(std::size_t n, std::size_t align) noexcept {
+  return (n + align - 1) & ~(align - 1);
+}
+
+/**
+ * Every task<> frame is followed by the function that frees it, so that frames
+ * allocated with a coroutine's own allocator and frames allocated by the
+ * task<>'s frame allocation policy can share one operator delete.
+ */
+using _frame_deleter = void (*)(void* frame, std::size_t size) noexcept;
+
+constexpr std::size_t _deleter_offset(std::size_t frameSize) noexcept {
+  return _align_up(frameSize, alignof(_frame_deleter));
+}
+
+constexpr std::size_t _deleter_end(std::size_t frameSize) noexcept {
+  return _deleter_offset(frameSize) + sizeof(_frame_deleter);
+}
+
+inline void _set_deleter(
+    void* frame, std::size_t size, _frame_deleter deleter) noexcept {
+  ::new (static_cast<char*>(frame) + _deleter_offset(size))
+      _frame_deleter(deleter);
+}
+
+inline _frame_deleter _get_deleter(void* frame, std::size_t size) noexcept {
+  return *std::launder(reinterpret_cast<_frame_deleter*>(
+      static_cast<char*>(frame) + _deleter_offset(size)));
+}
+
+/**
+ * Allocates frames with a copy of Alloc, rebound to blocks of the default new
+ * alignment.  The rebound allocator is stored after the frame's deleter so
+ * that the deleter can free the frame with it.
+ */
+template <typename Alloc>
+struct _allocator_frames {
+  // allocations are made in units of suitably-aligned blocks
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block {
+    unsigned char bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+  };
+
+  using block_alloc_t =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+  using traits_t = std::allocator_traits<block_alloc_t>;
+
+  static_assert(
+      alignof(block_alloc_t) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+      "Over-aligned allocators aren't supported");
+
+  static void* allocate(std::size_t size, const Alloc& alloc) {
+    block_alloc_t blockAlloc{alloc};
+    void* frame = traits_t::allocate(blockAlloc, _block_count(size));
+    ::new (static_cast<char*>(frame) + _alloc_offset(size))
+        block_alloc_t(std::move(blockAlloc));
+    _set_deleter(frame, size, &deallocate);
+    return frame;
+  }
+
+  static void deallocate(void* frame, std::size_t size) noexcept {
+    block_alloc_t& stored = *std::launder(reinterpret_cast<block_alloc_t*>(
+        static_cast<char*>(frame) + _alloc_offset(size)));
+    block_alloc_t blockAlloc{std::move(stored)};
+    stored.~block_alloc_t();
+    traits_t::deallocate(
+        blockAlloc, static_cast<block*>(frame), _block_count(size));
+  }
+
+private:
+  static constexpr std::size_t _alloc_offset(std::size_t frameSize) noexcept {
+    return _align_up(_deleter_end(frameSize), alignof(block_alloc_t));
+  }
+
+  static constexpr std::size_t _block_count(std::size_t frameSize) noexcept {
+    return (_alloc_offset(frameSize) + sizeof(block_alloc_t) + sizeof(block) -
+            1) /
+        sizeof(block);
+  }
+};
+
+/**
+ * The operator new and delete of task<>'s promise_type.  A coroutine whose
+ * first parameter (or, for member functions, first parameter after the object
+ * parameter) is std::allocator_arg_t and whose next parameter is an allocator
+ * allocates its frame with that allocator:
+ *
+ *   task<int> handle(std::allocator_arg_t, MyAlloc alloc, request r);
+ *
+ * Other coroutines allocate their frames with the Frames policy.
+ */
+template <typename Frames>
+struct _frame_allocation {
+  static void* operator new(std::size_t size) {
+    void* frame = Frames::allocate(_deleter_end(size));
+    _set_deleter(frame, size, &_deallocate);
+    return frame;
+  }
+
+  template(typename Alloc, typename... Args)
+    (requires is_allocator_v<Alloc>)
+  static void* operator new(
+      std::size_t size,
+      std::allocator_arg_t,
+      const Alloc& alloc,
+      const Args&...) {
+    return _allocator_frames<Alloc>::allocate(size, alloc);
+  }
+
+  template(typename Self, typename Alloc, typename... Args)
+    (requires is_allocator_v<Alloc>)
+  static void* operator new(
+      std::size_t size,
+      const Self&,
+      std::allocator_arg_t,
+      const Alloc& alloc,
+      const Args&...) {
+    return _allocator_frames<Alloc>::allocate(size, alloc);
+  }
+
+  static void operator delete(void* frame, std::size_t size) noexcept {
+    _get_deleter(frame, size)(frame, size);
+  }
+
+private:
+  static void _deallocate(void* frame, std::size_t size) noexcept {
+    Frames::deallocate(frame, _deleter_end(size));
+  }
+};
+
 /**
  * A base class for both task<> and sr_thunk_task<>'s promises' final-suspend
  * awaitable.
@@ -297,19 +453,21 @@ struct _return_value_or_void<void, nothrow> {
  */
 struct _task_base {};
 
-template <typename T, bool nothrow>
+template <typename T, bool nothrow, typename Frames>
 struct _promise final {
   /**
    * The promise_type for task<>; inherits _task_promise_base for common
-   * functionality, and _return_value_or_void<T> for result handling.
+   * functionality, _return_value_or_void<T> for result handling, and
+   * _frame_allocation<Frames> for frame allocation.
    */
   struct type final
     : _task_promise_base
-    , _return_value_or_void<T, nothrow>::type {
+    , _return_value_or_void<T, nothrow>::type
+    , _frame_allocation<Frames> {
     using result_type = T;
 
-    typename _task<T, nothrow>::type get_return_object() noexcept {
-      return typename _task<T, nothrow>::type{
+    typename _task<T, nothrow, Frames>::type get_return_object() noexcept {
+      return typename _task<T, nothrow, Frames>::type{
           coro::coroutine_handle<type>::from_promise(*this)};
     }
 
@@ -653,18 +811,18 @@ private:
  * Await the given sa_task<> in a context that will deliver stop requests from
  * the receiver on the expected scheduler.
  */
-template <typename T, bool nothrow>
-typename _sr_thunk_task<T>::type
-inject_stop_request_thunk(typename _sa_task<T, nothrow>::type awaitable) {
+template <typename T, bool nothrow, typename Frames>
+typename _sr_thunk_task<T>::type inject_stop_request_thunk(
+    typename _sa_task<T, nothrow, Frames>::type awaitable) {
   // I wonder if we could do better than hopping through this extra coroutine
   co_return co_await std::move(awaitable);
 }
 
-template <typename T, bool nothrow>
-struct _task<T, nothrow>::type
+template <typename T, bool nothrow, typename Frames>
+struct _task<T, nothrow, Frames>::type
   : _task_base
   , coro_holder {
-  using promise_type = typename _promise<T, nothrow>::type;
+  using promise_type = typename _promise<T, nothrow, Frames>::type;
   friend promise_type;
 
   template <
@@ -709,7 +867,7 @@ private:
     // invariants so we need to ensure that stop requests are delivered on the
     // right scheduler
     return unifex::await_transform(
-        p, inject_stop_request_thunk<T, nothrow>(std::move(t)));
+        p, inject_stop_request_thunk<T, nothrow, Frames>(std::move(t)));
   }
 
   template <typename Receiver>
@@ -719,7 +877,7 @@ private:
     if constexpr (is_stop_never_possible_v<stoken_t>) {
       // NOTE: we *don't* need to worry about stop requests if the receiver's
       //       stop token can't make such requests!
-      using sa_task = typename _sa_task<T, nothrow>::type;
+      using sa_task = typename _sa_task<T, nothrow, Frames>::type;
 
       return connect(sa_task{std::move(t)}, static_cast<Receiver&&>(r));
     } else {
@@ -731,7 +889,7 @@ private:
   }
 
   template <typename Scheduler>
-  friend typename _sa_task<T, nothrow>::type tag_invoke(
+  friend typename _sa_task<T, nothrow, Frames>::type tag_invoke(
       tag_t<with_scheduler_affinity>, type&& task, Scheduler&&) noexcept {
     return {std::move(task)};
   }
@@ -745,9 +903,10 @@ private:
  * The main difference is that await_transform doesn't indirect through
  * inject_stop_request_thunk.
  */
-template <typename T, bool nothrow>
-struct _sa_task<T, nothrow>::type final : public _task<T, nothrow>::type {
-  using base = typename _task<T, nothrow>::type;
+template <typename T, bool nothrow, typename Frames>
+struct _sa_task<T, nothrow, Frames>::type final
+  : public _task<T, nothrow, Frames>::type {
+  using base = typename _task<T, nothrow, Frames>::type;
 
   type(base&& t) noexcept : base(std::move(t)) {}
 
@@ -775,10 +934,20 @@ struct _sa_task<T, nothrow>::type final : public _task<T, nothrow>::type {
 }  // namespace _task
 
 template <typename T>
-using task = typename _task::_task<T, false>::type;
+using task = typename _task::_task<T, false, _task::_heap_frames>::type;
 
 template <typename T>
-using nothrow_task = typename _task::_task<T, true>::type;
+using nothrow_task = typename _task::_task<T, true, _task::_heap_frames>::type;
+
+/**
+ * A task<> whose coroutine frames are recycled through per-thread,
+ * size-bucketed free lists rather than being freshly allocated from the global
+ * heap on every call.  Deep call trees of short-lived recycling_task<>s reuse
+ * each other's frames.
+ */
+template <typename T>
+using recycling_task =
+    typename _task::_task<T, false, _task::_recycled_frames>::type;
 
 }  // namespace unifex
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <unifex/config.hpp>
+#include <unifex/get_metrics.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
@@ -283,6 +284,16 @@ class timed_single_thread_context {
   task_base* head_ = nullptr;
   bool stop_ = false;
 
+  // Only updated with mutex_ held.
+  _metrics::counter enqueues_;
+  _metrics::counter dequeues_;
+  _metrics::counter cancellations_;
+  _metrics::counter unparks_;
+  // Only updated by thread_.
+  _metrics::counter tasksExecuted_;
+  _metrics::counter parks_;
+  _metrics::counter idleNanoseconds_;
+
   std::thread thread_;
  public:
   using clock_t = _timed_single_thread_context::clock_t;
@@ -298,6 +309,23 @@ class timed_single_thread_context {
   std::thread::id get_thread_id() const noexcept {
     return thread_.get_id();
   }
+
+  struct metrics {
+    std::uint64_t tasksExecuted;
+    // Includes tasks that are requeued to run early when cancelled.
+    std::uint64_t enqueues;
+    std::uint64_t cancellations;
+    // Tasks that are waiting for their due time.
+    std::uint64_t timersPending;
+    // Times the thread went to sleep and times it was woken early because
+    // a task became the earliest one due.
+    std::uint64_t parks;
+    std::uint64_t unparks;
+    std::chrono::nanoseconds idleTime;
+  };
+
+  friend metrics tag_invoke(
+      tag_t<get_metrics>, const timed_single_thread_context& context) noexcept;
 };
 
 namespace _timed_single_thread_context {
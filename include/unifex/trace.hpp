@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Opt-in tracing of the work that passes through execution contexts.
+//
+// When libunifex is configured with UNIFEX_ENABLE_TRACING the built-in
+// schedulers and I/O contexts record an event when a task is enqueued,
+// dequeued, started and completed, and when it is cancelled. Otherwise
+// UNIFEX_TRACE_EVENT() expands to nothing and tracing costs nothing.
+//
+// Events are appended to a fixed-size ring buffer owned by the recording
+// thread, so recording never takes a lock and each thread keeps its most
+// recent events. When a thread exits, its buffer and the events in it are
+// kept until a new thread takes the buffer over, so there are never more
+// buffers than threads that were recording at the same time.
+// write_chrome_trace() dumps every thread's events in the Chrome trace
+// event format, which chrome://tracing and Perfetto can open.
+// The time a task spent queued shows up as a "queue" span and the time it
+// ran as a "run" span.
+
+namespace unifex {
+namespace _trace {
+
+enum class event_kind : std::uint8_t {
+  enqueue,
+  dequeue,
+  start,
+  complete,
+  cancel,
+};
+
+struct event {
+  // Nanoseconds on std::chrono::steady_clock.
+  std::uint64_t timestamp;
+  // Identifies the task or operation, usually its address.
+  const void* id;
+  // The execution context that recorded the event. Must have static
+  // storage duration.
+  const char* name;
+  event_kind kind;
+};
+
+struct thread_events {
+  // Threads are numbered from 1 in the order they first record an event.
+  // Numbers aren't reused.
+  std::uint32_t threadId;
+  // Oldest first.
+  std::vector<event> events;
+};
+
+} // namespace _trace
+
+using trace_event_kind = _trace::event_kind;
+using trace_event = _trace::event;
+using thread_trace_events = _trace::thread_events;
+
+// The number of events each thread keeps.
+std::size_t trace_buffer_capacity() noexcept;
+
+void record_trace_event(
+    trace_event_kind kind, const char* name, const void* id) noexcept;
+
+// Copies the events of every thread that has recorded any. Events that
+// are being overwritten while this runs are skipped.
+std::vector<thread_trace_events> collect_trace_events();
+
+// Discards every thread's events. Must not run concurrently with
+// record_trace_event().
+void clear_trace_events() noexcept;
+
+void write_chrome_trace(std::ostream& out);
+
+// Returns false if the file couldn't be written.
+bool write_chrome_trace(const std::string& path);
+
+} // namespace unifex
+
+#if UNIFEX_ENABLE_TRACING
+#define UNIFEX_TRACE_EVENT(kind, name, id) \
+  ::unifex::record_trace_event(::unifex::trace_event_kind::kind, name, id)
+#else
+#define UNIFEX_TRACE_EVENT(kind, name, id) ((void)0)
+#endif
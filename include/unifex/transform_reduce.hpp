@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/execution_policy.hpp>
+#include <unifex/get_concurrency.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/parallel_algorithm.hpp>
+#include <unifex/detail/tree_reduce.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _transform_reduce {
+
+struct _fn {
+  // Sends init combined by `reduce` with transform(x) for every x in
+  // [first, last), computed on `sched`. With a parallel policy the range
+  // is folded in a few chunks for each thread of the scheduler and the
+  // chunk results are combined in a tree, so `reduce` must be associative
+  // and commutative, and it and `transform` must be safe to call
+  // concurrently.
+  template(
+      typename Scheduler,
+      typename Policy,
+      typename Iterator,
+      typename T,
+      typename Reduce,
+      typename Transform)
+    (requires scheduler<Scheduler> AND
+        _parallel::is_execution_policy_v<Policy> AND
+        _parallel::is_random_access_iterator_v<Iterator>)
+  auto operator()(
+      Scheduler&& sched,
+      const Policy& policy,
+      Iterator first,
+      Iterator last,
+      T init,
+      Reduce reduce,
+      Transform transform) const {
+    const auto size = static_cast<std::size_t>(last - first);
+    const std::size_t concurrency = get_concurrency(sched);
+    return then(
+        _tree_reduce::reduce(
+            (Scheduler &&) sched,
+            policy,
+            size,
+            concurrency,
+            [first, reduce, transform](
+                std::size_t begin, std::size_t end) mutable -> T {
+              T state(std::invoke(transform, first[begin]));
+              for (std::size_t i = begin + 1; i < end; ++i) {
+                state = std::invoke(
+                    reduce, std::move(state), std::invoke(transform, first[i]));
+              }
+              return state;
+            },
+            [reduce](T a, T b) mutable -> T {
+              return std::invoke(reduce, std::move(a), std::move(b));
+            }),
+        [init = std::move(init), reduce](std::optional<T> partial) mutable -> T {
+          if (!partial) {
+            return std::move(init);
+          }
+          return std::invoke(reduce, std::move(init), std::move(*partial));
+        });
+  }
+};
+
+} // namespace _transform_reduce
+
+inline constexpr _transform_reduce::_fn transform_reduce{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
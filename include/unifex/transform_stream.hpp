@@ -18,19 +18,54 @@
 #include <unifex/next_adapt_stream.hpp>
 #include <unifex/then.hpp>
 #include <unifex/bind_back.hpp>
+#include <unifex/detail/batch.hpp>
 
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
 #include <unifex/detail/prologue.hpp>
 
 namespace unifex {
 namespace _tfx_stream {
+  // Invokes the function with each set of values; when the function only
+  // accepts the elements of a batch of values, maps it over the batch in
+  // a single loop instead and sends a std::vector of the results.
+  template <typename Func>
+  struct _func_ref {
+    Func* func_;
+
+    template(typename... Values)
+        (requires std::is_invocable_v<Func&, Values...>)
+    std::invoke_result_t<Func&, Values...> operator()(Values&&... values) const {
+      return std::invoke(*func_, (Values &&) values...);
+    }
+
+    template(typename Batch)
+        (requires _batch::is_elementwise_invocable_v<Func&, type_list<>, Batch>)
+    auto operator()(Batch&& batch) const -> std::vector<remove_cvref_t<
+        std::invoke_result_t<Func&, _batch::element_t<Batch>>>> {
+      std::vector<remove_cvref_t<
+          std::invoke_result_t<Func&, _batch::element_t<Batch>>>> results;
+      results.reserve(
+          static_cast<std::size_t>(std::distance(std::begin(batch), std::end(batch))));
+      _batch::for_each_element((Batch &&) batch, [&](auto&& value) {
+        results.push_back(
+            std::invoke(*func_, static_cast<decltype(value)>(value)));
+      });
+      return results;
+    }
+  };
+
   struct _fn {
     template <typename StreamSender, typename Func>
     auto operator()(StreamSender&& stream, Func&& func) const {
       return next_adapt_stream(
           (StreamSender &&) stream, [func = (Func &&) func](auto&& sender) mutable {
-            return then((decltype(sender))sender, std::ref(func));
+            return then(
+                (decltype(sender))sender,
+                _func_ref<std::remove_reference_t<decltype(func)>>{&func});
           });
     }
     template <typename Func>
@@ -0,0 +1,692 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bind_back.hpp>
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _tfx_stream_async {
+
+// transform_stream_async(stream, func, maxConcurrency, scheduler) starts
+// the sender returned by func(value) on `scheduler` for each value of
+// `stream`, running up to `maxConcurrency` of them at a time.
+//
+// Each in-flight sender owns one of `maxConcurrency` slots, which also
+// hold its result until it is sent.  The ordered variant sends results in
+// the order of the source values, so the slots form a reorder buffer
+// indexed by sequence number; the unordered variant sends them as they
+// complete.
+
+template <typename Source, typename Func, typename Scheduler, bool Ordered>
+struct _stream {
+  struct type;
+};
+template <typename Source, typename Func, typename Scheduler, bool Ordered>
+using stream = typename _stream<Source, Func, Scheduler, Ordered>::type;
+
+template <typename Stream>
+struct _next_sender;
+
+template <typename Stream>
+struct _cleanup_sender;
+
+template <typename Func, typename Values>
+struct _invoke_fn {
+  Func* func_;
+  Values values_;
+
+  auto operator()() { return std::apply(*func_, std::move(values_)); }
+};
+
+template <typename Stream>
+struct _source_receiver {
+  Stream* stream_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    stream_->on_source_value((Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    stream_->on_source_finished(_as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept { stream_->on_source_finished(nullptr); }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const _source_receiver& r) noexcept {
+    return r.stream_->stopSource_.get_token();
+  }
+};
+
+template <typename Stream>
+struct _slot_receiver {
+  Stream* stream_;
+  std::size_t index_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    stream_->on_slot_value(index_, (Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    stream_->on_slot_complete(
+        index_, _outcome::error, _as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept {
+    stream_->on_slot_complete(index_, _outcome::done, nullptr);
+  }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const _slot_receiver& r) noexcept {
+    return r.stream_->stopSource_.get_token();
+  }
+};
+
+template <typename Source, typename Func, typename Scheduler, bool Ordered>
+struct _stream<Source, Func, Scheduler, Ordered>::type {
+  using source_values_t = _value_tuple_t<next_sender_t<Source>>;
+  using invoke_fn_t = _invoke_fn<Func, source_values_t>;
+  using inner_sender_t = std::invoke_result_t<invoke_fn_t&>;
+  using result_t = _value_tuple_t<inner_sender_t>;
+  using task_t = decltype(let_value(
+      schedule(std::declval<Scheduler&>()), std::declval<invoke_fn_t>()));
+  using consumer_t = _consumer_base<result_t>;
+  using source_op_t = next_operation_t<Source, _source_receiver<type>>;
+  using task_op_t = connect_result_t<task_t, _slot_receiver<type>>;
+
+  enum class _slot_state : unsigned char { free, running, ready };
+
+  struct slot {
+    _slot_state state_ = _slot_state::free;
+    _outcome outcome_ = _outcome::done;
+    std::exception_ptr error_;
+    manual_lifetime<task_op_t> op_;
+    manual_lifetime<result_t> value_;
+  };
+
+  template <typename Source2, typename Func2, typename Scheduler2>
+  explicit type(
+      Source2&& source, Func2&& func, std::size_t n, Scheduler2&& sched)
+    : source_((Source2 &&) source)
+    , func_((Func2 &&) func)
+    , sched_((Scheduler2 &&) sched)
+    , n_(n != 0 ? n : 1)
+    , slots_(new slot[n_]) {
+    if constexpr (!Ordered) {
+      indices_.reset(new std::size_t[2 * n_]);
+      // The first n_ indices are the free slots, the second n_ the queue
+      // of completed slots.
+      for (std::size_t i = 0; i < n_; ++i) {
+        indices_[i] = i;
+      }
+      freeCount_ = n_;
+    }
+  }
+
+  // Must not be called once the source has been pulled.
+  type(type&& other)
+    : source_(std::move(other.source_))
+    , func_(std::move(other.func_))
+    , sched_(std::move(other.sched_))
+    , n_(other.n_)
+    , slots_(std::move(other.slots_))
+    , indices_(std::move(other.indices_))
+    , freeCount_(other.freeCount_) {}
+
+  ~type() { destroy_results(); }
+
+  friend _next_sender<type> tag_invoke(tag_t<next>, type& s) noexcept {
+    return _next_sender<type>{&s};
+  }
+
+  friend _cleanup_sender<type> tag_invoke(tag_t<cleanup>, type& s) noexcept {
+    return _cleanup_sender<type>{&s};
+  }
+
+  // Consumer side.
+
+  void start_next(consumer_t* consumer) noexcept {
+    bool ready = false;
+    bool pull = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      ready = take_locked(*consumer);
+      if (!ready) {
+        waiter_ = consumer;
+      }
+      pull = try_claim_pull_locked();
+    }
+    if (pull) {
+      pull_source();
+    }
+    if (ready) {
+      consumer->complete_(consumer);
+    }
+  }
+
+  void start_cleanup(_cleanup_base* cleanupOp) noexcept {
+    bool ready = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      cleanup_ = cleanupOp;
+      ready = cleanup_ready_locked();
+    }
+    stopSource_.request_stop();
+    if (ready) {
+      cleanup_->start_(cleanup_);
+    }
+  }
+
+  // Source side.
+
+  template <typename... Values>
+  void on_source_value(Values&&... values) noexcept {
+    slot* started = nullptr;
+    consumer_t* ready = nullptr;
+    bool pull = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      const std::size_t index = allocate_slot_locked();
+      auto& s = slots_[index];
+      s.state_ = _slot_state::running;
+      ++running_;
+      UNIFEX_TRY {
+        s.op_.construct_with([&] {
+          return unifex::connect(
+              let_value(
+                  schedule(sched_),
+                  invoke_fn_t{&func_, source_values_t{(Values &&) values...}}),
+              _slot_receiver<type>{this, index});
+        });
+        started = &s;
+      }
+      UNIFEX_CATCH(...) {
+        ready = slot_ready_locked(
+            index, _outcome::error, std::current_exception());
+      }
+      sourceOp_.destruct();
+      sourceActive_ = false;
+      pull = try_claim_pull_locked();
+    }
+    if (started != nullptr) {
+      unifex::start(started->op_.get());
+    }
+    finish(ready, pull, false);
+  }
+
+  void on_source_finished(
+      std::exception_ptr error, bool connected = true) noexcept {
+    consumer_t* ready = nullptr;
+    bool cleanup = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (connected) {
+        sourceOp_.destruct();
+      }
+      sourceActive_ = false;
+      sourceFinished_ = true;
+      sourceError_ = std::move(error);
+      if (waiter_ != nullptr && take_locked(*waiter_)) {
+        ready = std::exchange(waiter_, nullptr);
+      }
+      cleanup = cleanup_ready_locked();
+    }
+    finish(ready, false, cleanup);
+  }
+
+  // Slot side.
+
+  template <typename... Values>
+  void on_slot_value(std::size_t index, Values&&... values) noexcept {
+    auto& s = slots_[index];
+    UNIFEX_TRY {
+      s.value_.construct((Values &&) values...);
+    }
+    UNIFEX_CATCH(...) {
+      on_slot_complete(index, _outcome::error, std::current_exception());
+      return;
+    }
+    on_slot_complete(index, _outcome::value, nullptr);
+  }
+
+  void on_slot_complete(
+      std::size_t index, _outcome outcome, std::exception_ptr error) noexcept {
+    consumer_t* ready = nullptr;
+    bool pull = false;
+    bool cleanup = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      slots_[index].op_.destruct();
+      --running_;
+      ready = slot_ready_locked(index, outcome, std::move(error));
+      if (ready != nullptr) {
+        pull = try_claim_pull_locked();
+      }
+      cleanup = cleanup_ready_locked();
+    }
+    finish(ready, pull, cleanup);
+  }
+
+  void finish(consumer_t* ready, bool pull, bool cleanup) noexcept {
+    if (pull) {
+      pull_source();
+    }
+    if (cleanup) {
+      cleanup_->start_(cleanup_);
+    }
+    if (ready != nullptr) {
+      ready->complete_(ready);
+    }
+  }
+
+  std::size_t allocate_slot_locked() noexcept {
+    ++occupied_;
+    if constexpr (Ordered) {
+      return tail_++ % n_;
+    } else {
+      return indices_[--freeCount_];
+    }
+  }
+
+  // Marks a slot as complete and returns the waiting consumer if it can
+  // now be completed.
+  consumer_t* slot_ready_locked(
+      std::size_t index, _outcome outcome, std::exception_ptr error) noexcept {
+    auto& s = slots_[index];
+    s.state_ = _slot_state::ready;
+    s.outcome_ = outcome;
+    s.error_ = std::move(error);
+    if constexpr (!Ordered) {
+      indices_[n_ + (readyFront_ + readyCount_++) % n_] = index;
+    }
+    if (waiter_ != nullptr && take_locked(*waiter_)) {
+      return std::exchange(waiter_, nullptr);
+    }
+    return nullptr;
+  }
+
+  bool take_locked(consumer_t& consumer) noexcept {
+    std::size_t index;
+    if constexpr (Ordered) {
+      if (head_ == tail_ ||
+          slots_[head_ % n_].state_ != _slot_state::ready) {
+        return take_end_locked(consumer);
+      }
+      index = head_++ % n_;
+    } else {
+      if (readyCount_ == 0) {
+        return take_end_locked(consumer);
+      }
+      index = indices_[n_ + readyFront_];
+      readyFront_ = (readyFront_ + 1) % n_;
+      --readyCount_;
+      indices_[freeCount_++] = index;
+    }
+
+    auto& s = slots_[index];
+    consumer.outcome_ = s.outcome_;
+    consumer.error_ = std::move(s.error_);
+    if (s.outcome_ == _outcome::value) {
+      UNIFEX_TRY {
+        consumer.value_.construct(std::move(s.value_.get()));
+      }
+      UNIFEX_CATCH(...) {
+        consumer.outcome_ = _outcome::error;
+        consumer.error_ = std::current_exception();
+      }
+      s.value_.destruct();
+    }
+    s.state_ = _slot_state::free;
+    --occupied_;
+    return true;
+  }
+
+  // The stream ends once every value of the source has been sent.
+  bool take_end_locked(consumer_t& consumer) noexcept {
+    if (occupied_ != 0 || !sourceFinished_) {
+      return false;
+    }
+    if (sourceError_) {
+      consumer.outcome_ = _outcome::error;
+      consumer.error_ = std::exchange(sourceError_, nullptr);
+    } else {
+      consumer.outcome_ = _outcome::done;
+    }
+    return true;
+  }
+
+  bool try_claim_pull_locked() noexcept {
+    if (!sourceActive_ && !sourceFinished_ && cleanup_ == nullptr &&
+        occupied_ < n_) {
+      sourceActive_ = true;
+      return true;
+    }
+    return false;
+  }
+
+  bool cleanup_ready_locked() noexcept {
+    if (cleanup_ != nullptr && !cleanupStarted_ && !sourceActive_ &&
+        running_ == 0) {
+      cleanupStarted_ = true;
+      return true;
+    }
+    return false;
+  }
+
+  void destroy_results() noexcept {
+    if (!slots_) {
+      return;
+    }
+    for (std::size_t i = 0; i < n_; ++i) {
+      auto& s = slots_[i];
+      if (s.state_ == _slot_state::ready && s.outcome_ == _outcome::value) {
+        s.value_.destruct();
+      }
+      s.state_ = _slot_state::free;
+    }
+  }
+
+  // Starts the source's next(); a source that completes inline doesn't
+  // recurse, the outermost call loops instead.
+  void pull_source() noexcept {
+    if (pulls_.fetch_add(1, std::memory_order_acq_rel) != 0) {
+      return;
+    }
+    do {
+      bool connected = false;
+      UNIFEX_TRY {
+        sourceOp_.construct_with([&] {
+          return unifex::connect(next(source_), _source_receiver<type>{this});
+        });
+        connected = true;
+      }
+      UNIFEX_CATCH(...) {
+        on_source_finished(std::current_exception(), false);
+      }
+      if (connected) {
+        unifex::start(sourceOp_.get());
+      }
+    } while (pulls_.fetch_sub(1, std::memory_order_acq_rel) != 1);
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Source source_;
+  UNIFEX_NO_UNIQUE_ADDRESS Func func_;
+  UNIFEX_NO_UNIQUE_ADDRESS Scheduler sched_;
+  std::size_t n_;
+  std::unique_ptr<slot[]> slots_;
+  std::mutex mutex_;
+  // Ordered: the sequence numbers of the occupied slots are [head_, tail_).
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  // Unordered: a stack of free slots and a queue of completed slots.
+  std::unique_ptr<std::size_t[]> indices_;
+  std::size_t freeCount_ = 0;
+  std::size_t readyFront_ = 0;
+  std::size_t readyCount_ = 0;
+  std::size_t occupied_ = 0;
+  std::size_t running_ = 0;
+  bool sourceActive_ = false;
+  bool sourceFinished_ = false;
+  bool cleanupStarted_ = false;
+  consumer_t* waiter_ = nullptr;
+  _cleanup_base* cleanup_ = nullptr;
+  std::exception_ptr sourceError_;
+  std::atomic<int> pulls_{0};
+  inplace_stop_source stopSource_;
+  manual_lifetime<source_op_t> sourceOp_;
+};
+
+template <typename Stream, typename Receiver>
+struct _next_op {
+  struct type;
+};
+
+template <typename Stream, typename Receiver>
+struct _next_op<Stream, Receiver>::type
+  : _consumer_base<typename Stream::result_t> {
+  using base_t = _consumer_base<typename Stream::result_t>;
+
+  struct cancel_callback {
+    Stream* stream_;
+    void operator()() noexcept { stream_->stopSource_.request_stop(); }
+  };
+
+  using stop_token_t = stop_token_type_t<Receiver>;
+  using stop_callback_t =
+      typename stop_token_t::template callback_type<cancel_callback>;
+
+  template <typename Receiver2>
+  explicit type(Stream* s, Receiver2&& r)
+    : base_t{&complete_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    // Cancelling next() cancels the whole stream: the source and every
+    // in-flight sender are asked to stop and this operation completes once
+    // the result it is waiting for does.
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{stream_});
+    }
+    stream_->start_next(this);
+  }
+
+private:
+  static void complete_impl(base_t* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      op.stopCallback_.destruct();
+    }
+    _deliver(std::move(op.receiver_), op);
+  }
+
+  Stream* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<stop_callback_t> stopCallback_;
+};
+
+template <typename Stream>
+struct _next_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = sender_value_types_t<
+      typename Stream::inner_sender_t,
+      Variant,
+      decayed_tuple<Tuple>::template apply>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend typename _next_op<Stream, remove_cvref_t<Receiver>>::type
+  tag_invoke(tag_t<connect>, _next_sender&& s, Receiver&& r) {
+    return typename _next_op<Stream, remove_cvref_t<Receiver>>::type{
+        s.stream_, (Receiver &&) r};
+  }
+
+  Stream* stream_;
+};
+
+template <typename Stream, typename Receiver>
+struct _cleanup_op {
+  struct type;
+};
+
+template <typename Stream, typename Receiver>
+struct _cleanup_op<Stream, Receiver>::type : _cleanup_base {
+  struct source_receiver {
+    type* op_;
+
+    void set_value() && noexcept { op_->complete(nullptr); }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->complete(_as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept { op_->complete(nullptr); }
+  };
+
+  using source_op_t = cleanup_operation_t<
+      remove_cvref_t<decltype(std::declval<Stream&>().source_)>,
+      source_receiver>;
+
+  template <typename Receiver2>
+  explicit type(Stream* s, Receiver2&& r)
+    : _cleanup_base{&start_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept { stream_->start_cleanup(this); }
+
+  // Called once neither the source nor any slot has an operation in flight.
+  static void start_impl(_cleanup_base* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    op.stream_->destroy_results();
+    UNIFEX_TRY {
+      op.sourceOp_.construct_with([&] {
+        return unifex::connect(
+            cleanup(op.stream_->source_), source_receiver{&op});
+      });
+    }
+    UNIFEX_CATCH(...) {
+      op.complete_with(std::current_exception());
+      return;
+    }
+    unifex::start(op.sourceOp_.get());
+  }
+
+  void complete(std::exception_ptr error) noexcept {
+    sourceOp_.destruct();
+    complete_with(std::move(error));
+  }
+
+  void complete_with(std::exception_ptr error) noexcept {
+    if (error) {
+      unifex::set_error(std::move(receiver_), std::move(error));
+    } else {
+      unifex::set_done(std::move(receiver_));
+    }
+  }
+
+  Stream* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  manual_lifetime<source_op_t> sourceOp_;
+};
+
+template <typename Stream>
+struct _cleanup_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend typename _cleanup_op<Stream, remove_cvref_t<Receiver>>::type
+  tag_invoke(tag_t<connect>, _cleanup_sender&& s, Receiver&& r) {
+    return typename _cleanup_op<Stream, remove_cvref_t<Receiver>>::type{
+        s.stream_, (Receiver &&) r};
+  }
+
+  Stream* stream_;
+};
+
+template <bool Ordered>
+struct _fn {
+  template(typename Source, typename Func, typename Scheduler)
+      (requires scheduler<Scheduler>)
+  auto operator()(
+      Source&& source,
+      Func&& func,
+      std::size_t maxConcurrency,
+      Scheduler&& sched) const
+      -> stream<
+          remove_cvref_t<Source>,
+          remove_cvref_t<Func>,
+          remove_cvref_t<Scheduler>,
+          Ordered> {
+    return stream<
+        remove_cvref_t<Source>,
+        remove_cvref_t<Func>,
+        remove_cvref_t<Scheduler>,
+        Ordered>{
+        (Source &&) source,
+        (Func &&) func,
+        maxConcurrency,
+        (Scheduler &&) sched};
+  }
+
+  template(typename Func, typename Scheduler)
+      (requires scheduler<Scheduler>)
+  constexpr auto operator()(
+      Func&& func, std::size_t maxConcurrency, Scheduler&& sched) const
+      noexcept(is_nothrow_callable_v<
+        tag_t<bind_back>, _fn, Func, std::size_t, Scheduler>)
+      -> bind_back_result_t<_fn, Func, std::size_t, Scheduler> {
+    return bind_back(
+        *this, (Func &&) func, maxConcurrency, (Scheduler &&) sched);
+  }
+};
+} // namespace _tfx_stream_async
+
+inline constexpr _tfx_stream_async::_fn<true> transform_stream_async {};
+inline constexpr _tfx_stream_async::_fn<false>
+    transform_stream_async_unordered {};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -27,6 +27,7 @@
 #include <unifex/get_stop_token.hpp>
 #include <unifex/bind_back.hpp>
 #include <unifex/exception.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <atomic>
 
@@ -337,6 +338,39 @@ struct _stream<Values...>::type final {
   template <typename Stream>
   using stream = typename _stream<remove_cvref_t<Stream>>::type;
 
+  template <typename Op>
+  struct cancel_next_callback final {
+    Op& op_;
+    void operator()() noexcept { op_.request_stop(); }
+  };
+
+  // The stop source through which a next() operation Op forwards its
+  // receiver's stop requests to the erased stream. A receiver that can never
+  // ask to stop needs neither the source nor the callback.
+  template <
+      typename Op,
+      typename StopToken,
+      bool = is_stop_never_possible_v<StopToken>>
+  struct next_stop_source
+    : _stop_callback_storage<StopToken, cancel_next_callback<Op>> {
+    inplace_stop_token next_token(const StopToken& token) noexcept {
+      return token.stop_possible() ? stopSource_.get_token()
+                                   : inplace_stop_token{};
+    }
+
+    void request_next_stop() noexcept { stopSource_.request_stop(); }
+
+    inplace_stop_source stopSource_;
+  };
+
+  template <typename Op, typename StopToken>
+  struct next_stop_source<Op, StopToken, true>
+    : _stop_callback_storage<StopToken, cancel_next_callback<Op>> {
+    inplace_stop_token next_token(const StopToken&) noexcept { return {}; }
+
+    void request_next_stop() noexcept {}
+  };
+
   struct next_sender final {
     stream_base& stream_;
 
@@ -351,37 +385,28 @@ struct _stream<Values...>::type final {
 
     template <typename Receiver>
     struct _op final {
-      struct type final : next_op_base {
-        struct cancel_callback final {
-          type& op_;
-          void operator()() noexcept {
-            op_.request_stop();
-          }
-        };
-
+      struct type final
+        : next_op_base
+        , next_stop_source<type, stop_token_type_t<Receiver&>> {
         stream_base& stream_;
-        inplace_stop_source stopSource_;
         next_receiver<Receiver> receiver_;
-        UNIFEX_NO_UNIQUE_ADDRESS
-            typename stop_token_type_t<Receiver&>::
-            template callback_type<cancel_callback>
-          stopCallback_;
 
         template <typename Receiver2>
         explicit type(stream_base& strm, Receiver2&& receiver)
           : stream_(strm),
-            stopSource_(),
-            receiver_((Receiver2 &&) receiver, this),
-            stopCallback_(
-              get_stop_token(receiver_.receiver_),
-              cancel_callback{*this})
-        {}
+            receiver_((Receiver2 &&) receiver, this)
+        {
+          this->construct_stop_callback(
+            get_stop_token(receiver_.receiver_),
+            cancel_next_callback<type>{*this});
+        }
+
+        ~type() { this->destruct_stop_callback(); }
 
         void start() noexcept {
           stream_.start_next(
             receiver_,
-            get_stop_token(receiver_.receiver_).stop_possible() ?
-            stopSource_.get_token() : inplace_stop_token{});
+            this->next_token(get_stop_token(receiver_.receiver_)));
         }
 
         void request_stop() noexcept {
@@ -390,7 +415,7 @@ struct _stream<Values...>::type final {
             // set_* already called
             return;
           }
-          stopSource_.request_stop();
+          this->request_next_stop();
           // conditionally call set_*
           receiver_.set_done();
         }
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/bind_back.hpp>
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/batch.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _unbatch_stream {
+
+// unbatch_stream(stream) is the inverse of batch_stream(): it sends the
+// elements of each batch (any range) produced by `stream` one at a time.
+// Elements are moved out of the batch, which is owned by the stream until
+// its last element has been sent.
+
+template <typename Source>
+struct _stream {
+  struct type;
+};
+template <typename Source>
+using stream = typename _stream<Source>::type;
+
+template <typename Source, typename Receiver>
+struct _next_op {
+  struct type;
+};
+template <typename Source, typename Receiver>
+using next_op = typename _next_op<Source, remove_cvref_t<Receiver>>::type;
+
+template <typename Source>
+struct _next_sender {
+  struct type;
+};
+
+template <typename Source>
+struct _stream<Source>::type {
+  using batch_t = remove_cvref_t<
+      sender_single_value_return_type_t<next_sender_t<Source>>>;
+  using iterator_t = _batch::_iterator_t<batch_t>;
+  using element_t = remove_cvref_t<_batch::element_t<batch_t>>;
+
+  template <typename Source2>
+  explicit type(Source2&& source) : source_((Source2 &&) source) {}
+
+  type(type&& other) : source_(std::move(other.source_)) {
+    UNIFEX_ASSERT(!other.hasBatch_);
+  }
+
+  ~type() { reset(); }
+
+  friend typename _next_sender<Source>::type
+  tag_invoke(tag_t<next>, type& s) noexcept {
+    return typename _next_sender<Source>::type{&s};
+  }
+
+  friend cleanup_sender_t<Source> tag_invoke(tag_t<cleanup>, type& s) {
+    s.reset();
+    return cleanup(s.source_);
+  }
+
+  bool has_element() const noexcept {
+    return hasBatch_ && current_ != std::end(batch_.get());
+  }
+
+  void reset() noexcept {
+    if (hasBatch_) {
+      batch_.destruct();
+      hasBatch_ = false;
+    }
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Source source_;
+  bool hasBatch_ = false;
+  manual_lifetime<batch_t> batch_;
+  iterator_t current_{};
+};
+
+template <typename Source, typename Receiver>
+struct _next_op<Source, Receiver>::type {
+  using stream_t = stream<Source>;
+
+  struct source_receiver {
+    type* op_;
+
+    template <typename Batch>
+    void set_value(Batch&& batch) && noexcept {
+      op_->on_batch((Batch &&) batch);
+    }
+
+    template <typename Error>
+    void set_error(Error&& error) && noexcept {
+      op_->on_complete(_outcome::error, _as_exception_ptr((Error &&) error));
+    }
+
+    void set_done() && noexcept {
+      op_->on_complete(_outcome::done, nullptr);
+    }
+
+    template(typename CPO)
+        (requires is_receiver_query_cpo_v<CPO>)
+    friend auto tag_invoke(CPO cpo, const source_receiver& r)
+        noexcept(is_nothrow_callable_v<CPO, const Receiver&>)
+        -> callable_result_t<CPO, const Receiver&> {
+      return std::move(cpo)(std::as_const(r.op_->receiver_));
+    }
+  };
+
+  using source_op_t = next_operation_t<Source, source_receiver>;
+
+  template <typename Receiver2>
+  explicit type(stream_t* s, Receiver2&& r)
+    : stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    if (stream_->has_element()) {
+      send_element();
+    } else {
+      pull();
+    }
+  }
+
+private:
+  enum _state : unsigned char { _idle, _starting, _completed };
+
+  // Pulls batches until one has an element.  When the source completes
+  // inside start() the completion is left to this loop so that empty
+  // batches don't recurse and this operation isn't touched after it has
+  // completed.
+  void pull() noexcept {
+    for (;;) {
+      state_.store(_starting, std::memory_order_relaxed);
+      UNIFEX_TRY {
+        sourceOp_.construct_with([&] {
+          return unifex::connect(
+              next(stream_->source_), source_receiver{this});
+        });
+      }
+      UNIFEX_CATCH(...) {
+        unifex::set_error(std::move(receiver_), std::current_exception());
+        return;
+      }
+      unifex::start(sourceOp_.get());
+      if (state_.exchange(_idle, std::memory_order_acq_rel) != _completed) {
+        return;
+      }
+      if (!needs_batch()) {
+        complete();
+        return;
+      }
+    }
+  }
+
+  template <typename Batch>
+  void on_batch(Batch&& batch) noexcept {
+    auto& s = *stream_;
+    s.reset();
+    UNIFEX_TRY {
+      s.batch_.construct((Batch &&) batch);
+      s.hasBatch_ = true;
+      s.current_ = std::begin(s.batch_.get());
+      outcome_ = _outcome::value;
+    }
+    UNIFEX_CATCH(...) {
+      s.reset();
+      outcome_ = _outcome::error;
+      error_ = std::current_exception();
+    }
+    finish_source();
+  }
+
+  void on_complete(_outcome outcome, std::exception_ptr error) noexcept {
+    outcome_ = outcome;
+    error_ = std::move(error);
+    finish_source();
+  }
+
+  void finish_source() noexcept {
+    sourceOp_.destruct();
+    if (state_.exchange(_completed, std::memory_order_acq_rel) == _starting) {
+      // Completed inline; pull() takes it from here.
+      return;
+    }
+    if (needs_batch()) {
+      pull();
+    } else {
+      complete();
+    }
+  }
+
+  bool needs_batch() const noexcept {
+    return outcome_ == _outcome::value && !stream_->has_element();
+  }
+
+  void complete() noexcept {
+    switch (outcome_) {
+      case _outcome::value:
+        send_element();
+        break;
+      case _outcome::error:
+        unifex::set_error(std::move(receiver_), std::move(error_));
+        break;
+      case _outcome::done:
+        unifex::set_done(std::move(receiver_));
+        break;
+    }
+  }
+
+  void send_element() noexcept {
+    auto& s = *stream_;
+    UNIFEX_TRY {
+      auto it = s.current_++;
+      unifex::set_value(std::move(receiver_), std::move(*it));
+    }
+    UNIFEX_CATCH(...) {
+      unifex::set_error(std::move(receiver_), std::current_exception());
+    }
+  }
+
+  stream_t* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  std::atomic<_state> state_{_idle};
+  _outcome outcome_ = _outcome::done;
+  std::exception_ptr error_;
+  manual_lifetime<source_op_t> sourceOp_;
+};
+
+template <typename Source>
+struct _next_sender<Source>::type {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<typename stream<Source>::element_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend next_op<Source, Receiver>
+  tag_invoke(tag_t<connect>, type&& s, Receiver&& r) {
+    return next_op<Source, Receiver>{s.stream_, (Receiver &&) r};
+  }
+
+  stream<Source>* stream_;
+};
+
+struct _fn {
+  template <typename Source>
+  auto operator()(Source&& source) const -> stream<remove_cvref_t<Source>> {
+    return stream<remove_cvref_t<Source>>{(Source &&) source};
+  }
+
+  constexpr auto operator()() const
+      noexcept(is_nothrow_callable_v<tag_t<bind_back>, _fn>)
+      -> bind_back_result_t<_fn> {
+    return bind_back(*this);
+  }
+};
+} // namespace _unbatch_stream
+
+inline constexpr _unbatch_stream::_fn unbatch_stream {};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
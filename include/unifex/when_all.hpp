@@ -25,11 +25,12 @@
 #include <unifex/type_list.hpp>
 #include <unifex/blocking.hpp>
 #include <unifex/std_concepts.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
-#include <optional>
+#include <cstdint>
 #include <tuple>
 #include <type_traits>
 #include <variant>
@@ -126,6 +127,39 @@ using value_variant_for_sender =
   typename sender_value_types_t<Sender, concat_type_lists_unique_t, decayed_value_tuple>
       ::template apply<std::variant>;
 
+// One bit for each child that has stored its values, one that is set by the
+// first child to complete with done or an error and one that says whether
+// that child stored an error. The bits live in the smallest words that fit,
+// which for up to 6 children is a single byte.
+template <std::size_t Count>
+struct _completion_bits {
+  using word_t = std::conditional_t<
+      Count <= 8,
+      std::uint8_t,
+      std::conditional_t<
+          Count <= 16,
+          std::uint16_t,
+          std::conditional_t<Count <= 32, std::uint32_t, std::uint64_t>>>;
+
+  static constexpr std::size_t bits_per_word = 8 * sizeof(word_t);
+
+  // Returns whether the bit was already set.
+  bool set(std::size_t index) noexcept {
+    const auto mask = static_cast<word_t>(word_t{1} << (index % bits_per_word));
+    return (words_[index / bits_per_word].fetch_or(
+                mask, std::memory_order_relaxed) &
+            mask) != 0;
+  }
+
+  bool test(std::size_t index) const noexcept {
+    const auto mask = static_cast<word_t>(word_t{1} << (index % bits_per_word));
+    return (words_[index / bits_per_word].load(std::memory_order_relaxed) &
+            mask) != 0;
+  }
+
+  std::atomic<word_t> words_[(Count + bits_per_word - 1) / bits_per_word] = {};
+};
+
 template <size_t Index, typename Receiver, typename... Senders>
 struct _element_receiver {
   struct type;
@@ -143,9 +177,10 @@ struct _element_receiver<Index, Receiver, Senders...>::type final {
   void set_value(Values&&... values) noexcept {
     UNIFEX_TRY {
       std::get<Index>(op_.values_)
-          .emplace(
+          .construct(
               std::in_place_type<std::tuple<std::decay_t<Values>...>>,
               (Values &&) values...);
+      op_.completed_.set(Index);
       op_.element_complete();
     } UNIFEX_CATCH (...) {
       this->set_error(std::current_exception());
@@ -154,15 +189,16 @@ struct _element_receiver<Index, Receiver, Senders...>::type final {
 
   template <typename Error>
   void set_error(Error&& error) noexcept {
-    if (!op_.doneOrError_.exchange(true, std::memory_order_relaxed)) {
-      op_.error_.emplace(std::in_place_type<std::decay_t<Error>>, (Error &&) error);
+    if (!op_.completed_.set(op_.done_or_error_bit)) {
+      op_.error_.construct(std::in_place_type<std::decay_t<Error>>, (Error &&) error);
+      op_.completed_.set(op_.error_bit);
       op_.stopSource_.request_stop();
     }
     op_.element_complete();
   }
 
   void set_done() noexcept {
-    if (!op_.doneOrError_.exchange(true, std::memory_order_relaxed)) {
+    if (!op_.completed_.set(op_.done_or_error_bit)) {
       op_.stopSource_.request_stop();
     }
     op_.element_complete();
@@ -202,7 +238,10 @@ struct _element_receiver<Index, Receiver, Senders...>::type final {
 };
 
 template <typename Receiver, typename... Senders>
-struct _op<Receiver, Senders...>::type {
+struct _op<Receiver, Senders...>::type
+  : _stop_callback_storage<
+        stop_token_type_t<Receiver&>,
+        cancel_operation<Receiver, Senders...>> {
   using operation = type;
   using receiver_type = Receiver;
   template <std::size_t Index, typename Receiver2, typename... Senders2>
@@ -213,8 +252,15 @@ struct _op<Receiver, Senders...>::type {
     : receiver_((Receiver2 &&) receiver),
       ops_(*this, (Senders2 &&) senders...) {}
 
+  ~type() {
+    destroy_values(std::index_sequence_for<Senders...>{});
+    if (completed_.test(error_bit)) {
+      error_.destruct();
+    }
+  }
+
   void start() noexcept {
-    stopCallback_.construct(
+    this->construct_stop_callback(
         get_stop_token(receiver_),
         cancel_operation<Receiver, Senders...>{*this});
     ops_.start();
@@ -239,17 +285,17 @@ private:
   }
 
   void deliver_result() noexcept {
-    stopCallback_.destruct();
+    this->destruct_stop_callback();
 
     if (get_stop_token(receiver_).stop_requested()) {
       unifex::set_done(std::move(receiver_));
-    } else if (doneOrError_.load(std::memory_order_relaxed)) {
-      if (error_.has_value()) {
+    } else if (completed_.test(done_or_error_bit)) {
+      if (completed_.test(error_bit)) {
         std::visit(
             [this](auto&& error) {
               unifex::set_error(std::move(receiver_), (decltype(error))error);
             },
-            std::move(error_.value()));
+            std::move(error_).get());
       } else {
         unifex::set_done(std::move(receiver_));
       }
@@ -263,23 +309,28 @@ private:
     UNIFEX_TRY {
       unifex::set_value(
           std::move(receiver_),
-          std::get<Indices>(std::move(values_)).value()...);
+          std::get<Indices>(std::move(values_)).get()...);
     } UNIFEX_CATCH (...) {
       unifex::set_error(std::move(receiver_), std::current_exception());
     }
   }
 
-  static constexpr std::size_t callback_running_bit{1};
-  std::tuple<std::optional<value_variant_for_sender<remove_cvref_t<Senders>>>...> values_;
-  std::optional<error_types<std::variant, remove_cvref_t<Senders>...>> error_;
+  template <std::size_t... Indices>
+  void destroy_values(std::index_sequence<Indices...>) noexcept {
+    ((completed_.test(Indices) ? std::get<Indices>(values_).destruct()
+                               : void()),
+     ...);
+  }
+
+  static constexpr std::size_t done_or_error_bit = sizeof...(Senders);
+  static constexpr std::size_t error_bit = sizeof...(Senders) + 1;
+  // values_[i] and error_ are only constructed once their bit is set
+  std::tuple<manual_lifetime<value_variant_for_sender<remove_cvref_t<Senders>>>...> values_;
+  manual_lifetime<error_types<std::variant, remove_cvref_t<Senders>...>> error_;
   // a running cancel_operation increments refCount
   std::atomic<std::size_t> refCount_{sizeof...(Senders)};
-  std::atomic<bool> doneOrError_{false};
+  _completion_bits<sizeof...(Senders) + 2> completed_;
   inplace_stop_source stopSource_;
-  UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<
-      typename stop_token_type_t<Receiver&>::template callback_type<
-          cancel_operation<Receiver, Senders...>>>
-      stopCallback_;
   Receiver receiver_;
   template <std::size_t Index>
   using op_element_receiver = element_receiver<Index, Receiver, Senders...>;
@@ -17,62 +17,206 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <functional>
 #include <iterator>
 #include <numeric>
 #include <optional>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <unifex/blocking.hpp>
 #include <unifex/continuations.hpp>
+#include <unifex/exception.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/inplace_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
+#include <unifex/span.hpp>
 #include <unifex/std_concepts.hpp>
 #include <unifex/type_list.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
 
 #include <unifex/detail/prologue.hpp>
 
 namespace unifex {
 namespace _when_all_range {
 
-template <typename Receiver, typename Sender>
+// Operations for up to this many senders keep their children inline when
+// the senders are given as a span.
+inline constexpr std::size_t inline_capacity = 8;
+
+// Where an operation puts the values of its children once they have all
+// completed, and what it sends.
+template <typename T>
+struct _vector_output {
+  using value_type = std::vector<T>;
+
+  template <typename Receiver, typename Holder>
+  void set_value(Receiver&& receiver, Holder* holders, std::size_t count) {
+    std::vector<T> values;
+    values.reserve(count);
+    std::transform(
+        holders,
+        holders + count,
+        std::back_inserter(values),
+        [](auto&& h) -> decltype(auto) { return std::move(h.value.value()); });
+    unifex::set_value((Receiver &&) receiver, std::move(values));
+  }
+};
+
+template <typename T, std::size_t N>
+struct _array_output {
+  using value_type = std::array<T, N>;
+
+  template <typename Receiver, typename Holder>
+  void set_value(Receiver&& receiver, Holder* holders, std::size_t) {
+    set_value_impl(
+        (Receiver &&) receiver, holders, std::make_index_sequence<N>{});
+  }
+
+private:
+  template <typename Receiver, typename Holder, std::size_t... Is>
+  static void set_value_impl(
+      Receiver&& receiver, Holder* holders, std::index_sequence<Is...>) {
+    unifex::set_value(
+        (Receiver &&) receiver,
+        value_type{{std::move(holders[Is].value.value())...}});
+  }
+};
+
+// Moves the values into storage owned by the caller and sends the part of
+// it that was written.
+template <typename T>
+struct _span_output {
+  using value_type = span<T>;
+
+  template <typename Receiver, typename Holder>
+  void set_value(Receiver&& receiver, Holder* holders, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      results_[i] = std::move(holders[i].value.value());
+    }
+    unifex::set_value((Receiver &&) receiver, results_.first(count));
+  }
+
+  span<T> results_;
+};
+
+// Storage for the children of an operation: inline for up to
+// InlineCapacity of them and on the heap for more.
+template <typename Holder, std::size_t InlineCapacity>
+class _holder_storage {
+public:
+  Holder* allocate(std::size_t count) {
+    if (count <= InlineCapacity) {
+      return reinterpret_cast<Holder*>(buffer_.data());
+    }
+    return std::allocator<Holder>{}.allocate(count);
+  }
+
+  void deallocate(Holder* holders, std::size_t count) noexcept {
+    if (count > InlineCapacity) {
+      std::allocator<Holder>{}.deallocate(holders, count);
+    }
+  }
+
+private:
+  struct alignas(Holder) _slot {
+    unsigned char bytes_[sizeof(Holder)];
+  };
+
+  std::array<_slot, InlineCapacity> buffer_;
+};
+
+template <typename Holder>
+class _holder_storage<Holder, 0> {
+public:
+  Holder* allocate(std::size_t count) {
+    return std::allocator<Holder>{}.allocate(count);
+  }
+
+  void deallocate(Holder* holders, std::size_t count) noexcept {
+    std::allocator<Holder>{}.deallocate(holders, count);
+  }
+};
+
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
 struct _operation final {
   struct type;
 };
 
-template <typename Receiver, typename Sender>
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
 struct _element_receiver final {
   struct type;
 };
 
-template <typename Receiver, typename Sender>
-using element_receiver = typename _element_receiver<Receiver, Sender>::type;
-
-template <typename Receiver, typename Sender>
-using operation =
-    typename _operation<unifex::remove_cvref_t<Receiver>, Sender>::type;
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
+using element_receiver = typename _element_receiver<
+    Receiver,
+    Sender,
+    Output,
+    InlineCapacity>::type;
+
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
+using operation = typename _operation<
+    unifex::remove_cvref_t<Receiver>,
+    Sender,
+    Output,
+    InlineCapacity>::type;
+
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
+struct _cancel_operation final {
+  operation<Receiver, Sender, Output, InlineCapacity>& op_;
+  void operator()() noexcept { op_.request_stop(); }
+};
 
-template <typename Receiver, typename Sender>
-struct _operation<Receiver, Sender>::type final {
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
+struct _operation<Receiver, Sender, Output, InlineCapacity>::type final
+  : unifex::_stop_callback_storage<
+        unifex::stop_token_type_t<Receiver&>,
+        _cancel_operation<Receiver, Sender, Output, InlineCapacity>> {
 private:
   using sender_nonvoid_value_type =
       unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>;
 
-  using element_receiver_t = element_receiver<Receiver, Sender>;
+  using element_receiver_t =
+      element_receiver<Receiver, Sender, Output, InlineCapacity>;
 
-  friend struct _element_receiver<Receiver, Sender>::type;
+  using cancel_operation =
+      _cancel_operation<Receiver, Sender, Output, InlineCapacity>;
 
-  struct cancel_operation final {
-    type& op_;
-    void operator()() noexcept { op_.request_stop(); }
-  };
+  friend struct _element_receiver<Receiver, Sender, Output, InlineCapacity>::
+      type;
 
   struct _operation_holder final {
     std::optional<sender_nonvoid_value_type> value;
@@ -86,22 +230,27 @@ private:
   };
 
 public:
-  type(Receiver&& receiver, std::vector<Sender>&& senders)
-    : receiver_(std::move(receiver))
-    , refCount_(senders.size()) {
-    std::allocator<_operation_holder> allocator;
-    holders_ = allocator.allocate(senders.size());
+  // Moves each of the `count` senders starting at `senders` into the
+  // operation.
+  type(
+      Receiver&& receiver,
+      Sender* senders,
+      std::size_t count,
+      Output output)
+    : output_(std::move(output))
+    , receiver_(std::move(receiver))
+    , refCount_(count) {
+    holders_ = storage_.allocate(count);
     try {
-      for (auto&& sender : senders) {
-        new (holders_ + numHolders_)
-            _operation_holder{std::move(sender), *this, numHolders_};
-        ++numHolders_;
+      for (; numHolders_ < count; ++numHolders_) {
+        new (holders_ + numHolders_) _operation_holder{
+            std::move(senders[numHolders_]), *this, numHolders_};
       }
     } catch (...) {
       std::destroy(
           std::make_reverse_iterator(holders_ + numHolders_),
           std::make_reverse_iterator(holders_));
-      allocator.deallocate(holders_, senders.size());
+      storage_.deallocate(holders_, count);
       holders_ = nullptr;
       throw;
     }
@@ -111,20 +260,18 @@ public:
 
   // does not run when constructor throws, numHolders_ is the correct size
   ~type() {
-    std::allocator<_operation_holder> allocator;
     std::destroy(
         std::make_reverse_iterator(holders_ + numHolders_),
         std::make_reverse_iterator(holders_));
-    allocator.deallocate(holders_, numHolders_);
+    storage_.deallocate(holders_, numHolders_);
   }
 
   void start() noexcept {
     if (numHolders_ == 0) {
       // In case there is 0 sender, immediately complete
-      unifex::set_value(
-          std::move(receiver_), std::vector<sender_nonvoid_value_type>{});
+      deliver_values();
     } else {
-      stopCallback_.construct(
+      this->construct_stop_callback(
           unifex::get_stop_token(receiver_), cancel_operation{*this});
       // last start() might destroy this
       std::for_each(
@@ -146,7 +293,7 @@ public:
 
   void element_complete() noexcept {
     if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-      stopCallback_.destruct();
+      this->destruct_stop_callback();
 
       if (doneOrError_.load(std::memory_order_relaxed)) {
         if (error_.has_value()) {
@@ -160,46 +307,46 @@ public:
           unifex::set_done(std::move(receiver_));
         }
       } else {
-        UNIFEX_TRY {
-          std::vector<sender_nonvoid_value_type> values;
-          values.reserve(numHolders_);
-          std::transform(
-              holders_,
-              holders_ + numHolders_,
-              std::back_inserter(values),
-              [](auto&& h) -> decltype(auto) {
-                return std::move(h.value.value());
-              });
-          unifex::set_value(std::move(receiver_), std::move(values));
-        }
-        UNIFEX_CATCH(...) {
-          unifex::set_error(std::move(receiver_), std::current_exception());
-        }
+        deliver_values();
       }
     }
   }
 
+  void deliver_values() noexcept {
+    UNIFEX_TRY {
+      output_.set_value(std::move(receiver_), holders_, numHolders_);
+    }
+    UNIFEX_CATCH(...) {
+      unifex::set_error(std::move(receiver_), std::current_exception());
+    }
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS
+  _holder_storage<_operation_holder, InlineCapacity> storage_;
   _operation_holder* holders_;
   std::size_t numHolders_{0};
   UNIFEX_NO_UNIQUE_ADDRESS
   std::optional<unifex::sender_error_types_t<Sender, std::variant>>
       error_;
-  UNIFEX_NO_UNIQUE_ADDRESS
-  unifex::manual_lifetime<typename unifex::stop_token_type_t<
-      Receiver&>::template callback_type<cancel_operation>>
-      stopCallback_;
+  UNIFEX_NO_UNIQUE_ADDRESS Output output_;
   UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
   std::atomic<std::size_t> refCount_;
   std::atomic<bool> doneOrError_{false};
   unifex::inplace_stop_source stopSource_;
 };
 
-template <typename Receiver, typename Sender>
-struct _element_receiver<Receiver, Sender>::type final {
-  operation<Receiver, Sender>& op_;
+template <
+    typename Receiver,
+    typename Sender,
+    typename Output,
+    std::size_t InlineCapacity>
+struct _element_receiver<Receiver, Sender, Output, InlineCapacity>::type final {
+  using operation_t = operation<Receiver, Sender, Output, InlineCapacity>;
+
+  operation_t& op_;
   size_t index_;
 
-  type(operation<Receiver, Sender>& op, size_t index) noexcept
+  type(operation_t& op, size_t index) noexcept
     : op_(op)
     , index_(index){};
 
@@ -262,31 +409,49 @@ struct _element_receiver<Receiver, Sender>::type final {
   }
 };
 
-// Sender adapter for vector<Sender>
-template <typename Sender>
+// Sender adapter for a range of senders, owned in a std::vector or
+// std::array or borrowed through a span, that sends their values as an
+// Output::value_type.
+template <
+    typename Sender,
+    typename Senders,
+    typename Output,
+    std::size_t InlineCapacity>
 struct _sender final {
   struct type;
 };
 
-template <typename Sender>
-using sender = typename _sender<Sender>::type;
-
-template <typename Sender>
-struct _sender<Sender>::type final {
+template <
+    typename Sender,
+    typename Senders = std::vector<Sender>,
+    typename Output = _vector_output<
+        unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>>,
+    std::size_t InlineCapacity = 0>
+using sender =
+    typename _sender<Sender, Senders, Output, InlineCapacity>::type;
+
+template <
+    typename Sender,
+    typename Senders,
+    typename Output,
+    std::size_t InlineCapacity>
+struct _sender<Sender, Senders, Output, InlineCapacity>::type final {
 public:
   using sender_value_type =
       unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>;
 
-  explicit type(std::vector<Sender>&& senders) noexcept(
-      std::is_nothrow_move_constructible_v<std::vector<Sender>>)
-    : senders_(std::move(senders)) {}
+  explicit type(Senders&& senders, Output output = {}) noexcept(
+      std::is_nothrow_move_constructible_v<Senders>&&
+          std::is_nothrow_move_constructible_v<Output>)
+    : senders_(std::move(senders))
+    , output_(std::move(output)) {}
 
   template <
       template <typename...>
       class Variant,
       template <typename...>
       class Tuple>
-  using value_types = Variant<Tuple<std::vector<sender_value_type>>>;
+  using value_types = Variant<Tuple<typename Output::value_type>>;
 
   template <template <typename...> class Variant>
   using error_types = Variant<std::exception_ptr>;
@@ -309,9 +474,15 @@ private:
           Sender2&& sender,
           Receiver&& receiver) {
     // return an operation that wraps all connections
-    return operation<unifex::remove_cvref_t<Receiver>, Sender>{
+    return operation<
+        unifex::remove_cvref_t<Receiver>,
+        Sender,
+        Output,
+        InlineCapacity>{
         static_cast<Receiver&&>(receiver),
-        std::move((static_cast<Sender2&&>(sender)).senders_)};
+        std::data(sender.senders_),
+        std::size(sender.senders_),
+        static_cast<Sender2&&>(sender).output_};
   }
 
   // Combine the blocking-nature of each of the child operations.
@@ -335,7 +506,8 @@ private:
     }
 }
 
-  std::vector<Sender> senders_;
+  Senders senders_;
+  UNIFEX_NO_UNIQUE_ADDRESS Output output_;
 };
 
 namespace _cpo {
@@ -346,6 +518,61 @@ struct _fn final {
       operator()(std::vector<Sender> senders) const {
     return _when_all_range::sender<Sender>(std::move(senders));
   }
+
+  // A fixed number of senders, owned by the returned sender or borrowed
+  // from the caller, whose values are sent as a std::array. The operation
+  // doesn't allocate.
+  template(typename Sender, std::size_t N)  //
+      (requires(unifex::sender<Sender>))    //
+      auto
+      operator()(std::array<Sender, N> senders) const {
+    using value_t =
+        unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>;
+    return _when_all_range::
+        sender<Sender, std::array<Sender, N>, _array_output<value_t, N>, N>(
+            std::move(senders));
+  }
+
+  template(typename Sender, std::size_t N)  //
+      (requires(unifex::sender<Sender>) AND(N != dynamic_extent))  //
+      auto
+      operator()(span<Sender, N> senders) const {
+    using value_t =
+        unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>;
+    return _when_all_range::
+        sender<Sender, span<Sender, N>, _array_output<value_t, N>, N>(
+            std::move(senders));
+  }
+
+  // Senders borrowed from the caller, whose values are sent as a
+  // std::vector. The operation keeps up to inline_capacity children inline.
+  template(typename Sender)               //
+      (requires(unifex::sender<Sender>))  //
+      auto
+      operator()(span<Sender> senders) const {
+    using value_t =
+        unifex::sender_single_value_result_t<unifex::remove_cvref_t<Sender>>;
+    return _when_all_range::
+        sender<Sender, span<Sender>, _vector_output<value_t>, inline_capacity>(
+            std::move(senders));
+  }
+
+  // Senders borrowed from the caller, whose values are moved into
+  // `results`, which must be at least as long (otherwise std::length_error
+  // is thrown). Sends the written part of `results`. The operation keeps up
+  // to inline_capacity children inline.
+  template(typename Sender, typename T)   //
+      (requires(unifex::sender<Sender>))  //
+      auto
+      operator()(span<Sender> senders, span<T> results) const {
+    if (results.size() < senders.size()) {
+      throw_(std::length_error{
+          "when_all_range: results is shorter than senders"});
+    }
+    return _when_all_range::
+        sender<Sender, span<Sender>, _span_output<T>, inline_capacity>(
+            std::move(senders), _span_output<T>{results});
+  }
   template <typename Iterator>
   auto operator()(Iterator first, Iterator last) const -> decltype(operator()(
       std::vector<typename std::iterator_traits<Iterator>::value_type>{
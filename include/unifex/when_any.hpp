@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/blocking.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/std_concepts.hpp>
+#include <unifex/type_list.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _when_any {
+
+// when_any(senders...) starts every sender and sends the values of the
+// first one to complete with a value, asking the others to stop and
+// waiting for them to complete. The values are sent as a single
+// std::variant with one alternative for each sender, so index() is the
+// index of the winner.
+//
+// Senders that complete with an error or done only matter if none
+// completes with a value, in which case the first error, or done if there
+// was none, is sent.
+//
+// Every child operation lives in the operation state and a single
+// inplace_stop_source cancels the losers, so nothing is allocated.
+
+template <typename... Senders>
+using result_t = std::variant<_value_tuple_t<Senders>...>;
+
+template <typename... Errors>
+using unique_decayed_error_types =
+    concat_type_lists_unique_t<type_list<std::decay_t<Errors>>...>;
+
+template <template <typename...> class Variant, typename... Senders>
+using error_types = typename concat_type_lists_unique_t<
+    sender_error_types_t<Senders, unique_decayed_error_types>...,
+    type_list<std::exception_ptr>>::template apply<Variant>;
+
+template <typename Receiver, typename... Senders>
+struct _op {
+  struct type;
+};
+template <typename Receiver, typename... Senders>
+using operation = typename _op<remove_cvref_t<Receiver>, Senders...>::type;
+
+template <std::size_t Index, typename Receiver, typename... Senders>
+struct _element_receiver {
+  struct type;
+};
+template <std::size_t Index, typename Receiver, typename... Senders>
+using element_receiver =
+    typename _element_receiver<Index, Receiver, Senders...>::type;
+
+template <std::size_t Index, typename Receiver, typename... Senders>
+struct _element_receiver<Index, Receiver, Senders...>::type final {
+  using element_receiver = type;
+
+  operation<Receiver, Senders...>& op_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) noexcept {
+    if (!op_.won_.exchange(true, std::memory_order_acq_rel)) {
+      UNIFEX_TRY {
+        op_.result_.emplace(std::in_place_index<Index>, (Values &&) values...);
+      }
+      UNIFEX_CATCH(...) {
+        // The win stands: the others may already have dropped their values,
+        // so the exception is sent in place of this one's.
+        op_.resultError_ = std::current_exception();
+      }
+      op_.stopSource_.request_stop();
+    }
+    op_.element_complete();
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) noexcept {
+    if (!op_.errored_.exchange(true, std::memory_order_relaxed)) {
+      op_.error_.emplace(
+          std::in_place_type<std::decay_t<Error>>, (Error &&) error);
+    }
+    op_.element_complete();
+  }
+
+  void set_done() noexcept { op_.element_complete(); }
+
+  Receiver& get_receiver() const { return op_.receiver_; }
+
+  template(typename CPO, typename R)
+      (requires is_receiver_query_cpo_v<CPO> AND
+          same_as<R, element_receiver> AND
+          is_callable_v<CPO, const Receiver&>)
+  friend auto tag_invoke(CPO cpo, const R& r) noexcept(
+      is_nothrow_callable_v<CPO, const Receiver&>)
+      -> callable_result_t<CPO, const Receiver&> {
+    return std::move(cpo)(std::as_const(r.get_receiver()));
+  }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const element_receiver& r) noexcept {
+    return r.op_.stopSource_.get_token();
+  }
+};
+
+template <typename Receiver, typename... Senders>
+struct cancel_operation {
+  operation<Receiver, Senders...>& op_;
+  void operator()() noexcept { op_.request_stop(); }
+};
+
+template <
+    std::size_t Index,
+    template <std::size_t> class Receiver,
+    typename... Senders>
+struct _operation_tuple {
+  struct type;
+};
+template <
+    std::size_t Index,
+    template <std::size_t> class Receiver,
+    typename... Senders>
+using operation_tuple =
+    typename _operation_tuple<Index, Receiver, Senders...>::type;
+
+template <
+    std::size_t Index,
+    template <std::size_t> class Receiver,
+    typename First,
+    typename... Rest>
+struct _operation_tuple<Index, Receiver, First, Rest...> {
+  struct type;
+};
+template <
+    std::size_t Index,
+    template <std::size_t> class Receiver,
+    typename First,
+    typename... Rest>
+struct _operation_tuple<Index, Receiver, First, Rest...>::type
+  : operation_tuple<Index + 1, Receiver, Rest...> {
+  template <typename Parent, typename First2, typename... Rest2>
+  explicit type(Parent& parent, First2&& first, Rest2&&... rest)
+    : operation_tuple<Index + 1, Receiver, Rest...>{parent, (Rest2 &&) rest...}
+    , op_(connect((First2 &&) first, Receiver<Index>{parent})) {}
+
+  void start() noexcept {
+    unifex::start(op_);
+    operation_tuple<Index + 1, Receiver, Rest...>::start();
+  }
+
+private:
+  connect_result_t<First, Receiver<Index>> op_;
+};
+
+template <std::size_t Index, template <std::size_t> class Receiver>
+struct _operation_tuple<Index, Receiver> {
+  struct type;
+};
+template <std::size_t Index, template <std::size_t> class Receiver>
+struct _operation_tuple<Index, Receiver>::type {
+  template <typename Parent>
+  explicit type(Parent&) noexcept {}
+
+  void start() noexcept {}
+};
+
+template <typename Receiver, typename... Senders>
+struct _op<Receiver, Senders...>::type
+  : _stop_callback_storage<
+        stop_token_type_t<Receiver&>,
+        cancel_operation<Receiver, Senders...>> {
+  template <typename Receiver2, typename... Senders2>
+  explicit type(Receiver2&& receiver, Senders2&&... senders)
+    : receiver_((Receiver2 &&) receiver)
+    , ops_(*this, (Senders2 &&) senders...) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    this->construct_stop_callback(
+        get_stop_token(receiver_),
+        cancel_operation<Receiver, Senders...>{*this});
+    ops_.start();
+  }
+
+  void request_stop() noexcept {
+    if (refCount_.fetch_add(1, std::memory_order_relaxed) == 0) {
+      // deliver_result already called
+      return;
+    }
+    stopSource_.request_stop();
+    element_complete();
+  }
+
+  void element_complete() noexcept {
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      deliver_result();
+    }
+  }
+
+  void deliver_result() noexcept {
+    this->destruct_stop_callback();
+
+    // The winner writes result_ (or resultError_) before its release in
+    // element_complete(), which the last acq_rel decrement of refCount_
+    // synchronises with.
+    if (won_.load(std::memory_order_acquire)) {
+      if (resultError_) {
+        unifex::set_error(std::move(receiver_), std::move(resultError_));
+        return;
+      }
+      UNIFEX_TRY {
+        unifex::set_value(std::move(receiver_), std::move(*result_));
+      }
+      UNIFEX_CATCH(...) {
+        unifex::set_error(std::move(receiver_), std::current_exception());
+      }
+    } else if (error_.has_value()) {
+      std::visit(
+          [this](auto&& error) {
+            unifex::set_error(std::move(receiver_), (decltype(error))error);
+          },
+          std::move(*error_));
+    } else {
+      unifex::set_done(std::move(receiver_));
+    }
+  }
+
+  std::optional<result_t<remove_cvref_t<Senders>...>> result_;
+  // Set instead of result_ if constructing the winner's values threw.
+  std::exception_ptr resultError_;
+  std::optional<error_types<std::variant, remove_cvref_t<Senders>...>> error_;
+  // a running cancel_operation increments refCount
+  std::atomic<std::size_t> refCount_{sizeof...(Senders)};
+  std::atomic<bool> won_{false};
+  std::atomic<bool> errored_{false};
+  inplace_stop_source stopSource_;
+  Receiver receiver_;
+  template <std::size_t Index>
+  using op_element_receiver = element_receiver<Index, Receiver, Senders...>;
+  operation_tuple<0, op_element_receiver, Senders...> ops_;
+};
+
+template <typename... Senders>
+struct _sender {
+  class type;
+};
+template <typename... Senders>
+using sender = typename _sender<remove_cvref_t<Senders>...>::type;
+
+template <typename... Senders>
+class _sender<Senders...>::type {
+  static constexpr blocking_kind compute_blocking() noexcept {
+    const _block::_enum enums[]{sender_traits<Senders>::blocking...};
+
+    return *std::max_element(std::begin(enums), std::end(enums));
+  }
+
+public:
+  static_assert(sizeof...(Senders) > 0);
+
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<result_t<Senders...>>>;
+
+  template <template <typename...> class Variant>
+  using error_types = error_types<Variant, Senders...>;
+
+  static constexpr bool sends_done = true;
+
+  static constexpr blocking_kind blocking = compute_blocking();
+
+  static constexpr bool is_always_scheduler_affine =
+      (sender_traits<Senders>::is_always_scheduler_affine && ...);
+
+  template <typename... Senders2>
+  explicit type(Senders2&&... senders) : senders_((Senders2 &&) senders...) {}
+
+  template(typename CPO, typename Sender, typename Receiver)
+      (requires same_as<CPO, tag_t<unifex::connect>> AND
+          same_as<remove_cvref_t<Sender>, type> AND
+          receiver<Receiver>)
+  friend auto tag_invoke([[maybe_unused]] CPO cpo, Sender&& sender, Receiver&& receiver)
+      -> operation<Receiver, member_t<Sender, Senders>...> {
+    return std::apply(
+        [&](auto&&... senders) {
+          return operation<Receiver, member_t<Sender, Senders>...>{
+              (Receiver &&) receiver, static_cast<decltype(senders)>(senders)...};
+        },
+        static_cast<Sender&&>(sender).senders_);
+  }
+
+  // Customise the 'blocking' CPO to combine the blocking-nature
+  // of each of the child operations.
+  friend constexpr blocking_kind
+  tag_invoke(tag_t<unifex::blocking>, const type& s) noexcept {
+    return std::apply(
+        [](const auto&... senders) noexcept {
+          const _block::_enum enums[]{unifex::blocking(senders)...};
+
+          return *std::max_element(std::begin(enums), std::end(enums));
+        },
+        s.senders_);
+  }
+
+private:
+  std::tuple<Senders...> senders_;
+};
+
+namespace _cpo {
+struct _fn {
+  template(typename... Senders)
+      (requires (sizeof...(Senders) > 0) AND (unifex::sender<Senders> && ...))
+  auto operator()(Senders&&... senders) const
+      -> _when_any::sender<Senders...> {
+    return _when_any::sender<Senders...>{(Senders &&) senders...};
+  }
+};
+} // namespace _cpo
+} // namespace _when_any
+
+inline constexpr _when_any::_cpo::_fn when_any{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _when_each {
+
+// when_each(senders) is a stream that starts every sender on the first
+// call to next() and then sends (index, values...) for each of them in the
+// order in which they complete.
+//
+// The first sender to complete with an error or done ends the stream: the
+// others are asked to stop and the next call to next() sends that error
+// or done. Cancelling next() or calling cleanup() also stops the senders
+// that are still running, and cleanup() completes once all of them have.
+
+template <template <typename...> class Tuple, typename Values>
+struct _indexed;
+template <template <typename...> class Tuple, typename... Values>
+struct _indexed<Tuple, std::tuple<Values...>> {
+  using type = Tuple<std::size_t, Values...>;
+};
+
+// A consumer that is also sent the index of the sender whose values it gets.
+template <typename Result>
+struct _indexed_consumer : _consumer_base<Result> {
+  using _consumer_base<Result>::_consumer_base;
+
+  std::size_t index_ = 0;
+};
+
+template <typename Sender>
+struct _stream {
+  struct type;
+};
+template <typename Sender>
+using stream = typename _stream<Sender>::type;
+
+template <typename Stream>
+struct _next_sender;
+
+template <typename Stream>
+struct _cleanup_sender;
+
+template <typename Stream>
+struct _child_receiver {
+  Stream* stream_;
+  std::size_t index_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    stream_->on_child_value(index_, (Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    stream_->on_child_complete(
+        index_, _outcome::error, _as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept {
+    stream_->on_child_complete(index_, _outcome::done, nullptr);
+  }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const _child_receiver& r) noexcept {
+    return r.stream_->stopSource_.get_token();
+  }
+};
+
+template <typename Sender>
+struct _stream<Sender>::type {
+  using result_t = _value_tuple_t<Sender>;
+  using consumer_t = _indexed_consumer<result_t>;
+  using child_op_t = connect_result_t<Sender, _child_receiver<type>>;
+
+  struct child {
+    manual_lifetime<child_op_t> op_;
+    manual_lifetime<result_t> value_;
+  };
+
+  explicit type(std::vector<Sender>&& senders)
+    : senders_(std::move(senders)) {}
+
+  // Moves the senders, so the stream must not have started them yet.
+  type(type&& other) : senders_(std::move(other.senders_)) {}
+
+  ~type() { destroy_results(); }
+
+  friend _next_sender<type> tag_invoke(tag_t<next>, type& s) noexcept {
+    return _next_sender<type>{&s};
+  }
+
+  friend _cleanup_sender<type> tag_invoke(tag_t<cleanup>, type& s) noexcept {
+    return _cleanup_sender<type>{&s};
+  }
+
+  // Consumer side.
+
+  void start_next(consumer_t* consumer) noexcept {
+    bool ready = false;
+    bool start = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (!started_) {
+        started_ = true;
+        start = true;
+      }
+      ready = take_locked(*consumer);
+      if (!ready) {
+        waiter_ = consumer;
+      }
+    }
+    if (start) {
+      start_children();
+    }
+    if (ready) {
+      consumer->complete_(consumer);
+    }
+  }
+
+  void start_cleanup(_cleanup_base* cleanupOp) noexcept {
+    bool ready = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      cleanup_ = cleanupOp;
+      // Senders that were never started never will be.
+      started_ = true;
+      ready = running_ == 0;
+    }
+    stopSource_.request_stop();
+    if (ready) {
+      cleanup_->start_(cleanup_);
+    }
+  }
+
+  // Child side.
+
+  template <typename... Values>
+  void on_child_value(std::size_t index, Values&&... values) noexcept {
+    UNIFEX_TRY {
+      children_[index].value_.construct((Values &&) values...);
+    }
+    UNIFEX_CATCH(...) {
+      on_child_complete(index, _outcome::error, std::current_exception());
+      return;
+    }
+    on_child_complete(index, _outcome::value, nullptr);
+  }
+
+  void on_child_complete(
+      std::size_t index, _outcome outcome, std::exception_ptr error) noexcept {
+    consumer_t* ready = nullptr;
+    bool cleanup = false;
+    bool stop = false;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      children_[index].op_.destruct();
+      --running_;
+      if (outcome == _outcome::value) {
+        order_[readyCount_++] = index;
+      } else if (!ended_) {
+        ended_ = true;
+        endOutcome_ = outcome;
+        endError_ = std::move(error);
+        stop = true;
+      }
+      if (waiter_ != nullptr && take_locked(*waiter_)) {
+        ready = std::exchange(waiter_, nullptr);
+      }
+      cleanup = cleanup_ != nullptr && running_ == 0;
+    }
+    if (stop) {
+      stopSource_.request_stop();
+    }
+    if (cleanup) {
+      cleanup_->start_(cleanup_);
+    }
+    if (ready != nullptr) {
+      ready->complete_(ready);
+    }
+  }
+
+  void start_children() noexcept {
+    const std::size_t count = senders_.size();
+    std::size_t connected = 0;
+    UNIFEX_TRY {
+      children_.reset(new child[count]);
+      order_.reset(new std::size_t[count]);
+      for (; connected < count; ++connected) {
+        children_[connected].op_.construct_with([&] {
+          return unifex::connect(
+              std::move(senders_[connected]),
+              _child_receiver<type>{this, connected});
+        });
+      }
+    }
+    UNIFEX_CATCH(...) {
+      for (std::size_t i = 0; i < connected; ++i) {
+        children_[i].op_.destruct();
+      }
+      consumer_t* ready = nullptr;
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        ended_ = true;
+        endOutcome_ = _outcome::error;
+        endError_ = std::current_exception();
+        if (waiter_ != nullptr && take_locked(*waiter_)) {
+          ready = std::exchange(waiter_, nullptr);
+        }
+      }
+      if (ready != nullptr) {
+        ready->complete_(ready);
+      }
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      running_ = count;
+    }
+    // The last child to start might complete the consumer that owns this
+    // call, but not destroy the stream, which outlives cleanup().
+    for (std::size_t i = 0; i < count; ++i) {
+      unifex::start(children_[i].op_.get());
+    }
+  }
+
+  bool take_locked(consumer_t& consumer) noexcept {
+    if (ended_) {
+      // The end is sent once, then the stream is finished.
+      consumer.outcome_ = std::exchange(endOutcome_, _outcome::done);
+      consumer.error_ = std::exchange(endError_, nullptr);
+      return true;
+    }
+    if (readyFront_ == readyCount_) {
+      if (started_ && running_ == 0 && readyCount_ == senders_.size()) {
+        consumer.outcome_ = _outcome::done;
+        return true;
+      }
+      return false;
+    }
+    const std::size_t index = order_[readyFront_++];
+    auto& c = children_[index];
+    consumer.outcome_ = _outcome::value;
+    consumer.index_ = index;
+    UNIFEX_TRY {
+      consumer.value_.construct(std::move(c.value_.get()));
+    }
+    UNIFEX_CATCH(...) {
+      consumer.outcome_ = _outcome::error;
+      consumer.error_ = std::current_exception();
+    }
+    c.value_.destruct();
+    return true;
+  }
+
+  void destroy_results() noexcept {
+    for (; readyFront_ != readyCount_; ++readyFront_) {
+      children_[order_[readyFront_]].value_.destruct();
+    }
+  }
+
+  std::vector<Sender> senders_;
+  std::unique_ptr<child[]> children_;
+  // The indices of the children that completed with a value, in the order
+  // they did; [readyFront_, readyCount_) haven't been sent yet.
+  std::unique_ptr<std::size_t[]> order_;
+  std::size_t readyFront_ = 0;
+  std::size_t readyCount_ = 0;
+  std::size_t running_ = 0;
+  std::mutex mutex_;
+  bool started_ = false;
+  bool ended_ = false;
+  _outcome endOutcome_ = _outcome::done;
+  std::exception_ptr endError_;
+  consumer_t* waiter_ = nullptr;
+  _cleanup_base* cleanup_ = nullptr;
+  inplace_stop_source stopSource_;
+};
+
+template <typename Stream, typename Receiver>
+struct _next_op {
+  struct type;
+};
+
+template <typename Stream, typename Receiver>
+struct _next_op<Stream, Receiver>::type
+  : Stream::consumer_t {
+  using base_t = typename Stream::consumer_t;
+
+  struct cancel_callback {
+    Stream* stream_;
+    void operator()() noexcept { stream_->stopSource_.request_stop(); }
+  };
+
+  using stop_token_t = stop_token_type_t<Receiver>;
+  using stop_callback_t =
+      typename stop_token_t::template callback_type<cancel_callback>;
+
+  template <typename Receiver2>
+  explicit type(Stream* s, Receiver2&& r)
+    : base_t{&complete_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept {
+    // Cancelling next() stops every sender that is still running, which
+    // ends the stream.
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{stream_});
+    }
+    stream_->start_next(this);
+  }
+
+private:
+  static void
+  complete_impl(_consumer_base<typename Stream::result_t>* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    if constexpr (!is_stop_never_possible_v<stop_token_t>) {
+      op.stopCallback_.destruct();
+    }
+    _deliver(std::move(op.receiver_), op, op.index_);
+  }
+
+  Stream* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<stop_callback_t> stopCallback_;
+};
+
+template <typename Stream>
+struct _next_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types =
+      Variant<typename _indexed<Tuple, typename Stream::result_t>::type>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend typename _next_op<Stream, remove_cvref_t<Receiver>>::type
+  tag_invoke(tag_t<connect>, _next_sender&& s, Receiver&& r) {
+    return typename _next_op<Stream, remove_cvref_t<Receiver>>::type{
+        s.stream_, (Receiver &&) r};
+  }
+
+  Stream* stream_;
+};
+
+template <typename Stream, typename Receiver>
+struct _cleanup_op {
+  struct type;
+};
+
+template <typename Stream, typename Receiver>
+struct _cleanup_op<Stream, Receiver>::type : _cleanup_base {
+  template <typename Receiver2>
+  explicit type(Stream* s, Receiver2&& r)
+    : _cleanup_base{&start_impl}
+    , stream_(s)
+    , receiver_((Receiver2 &&) r) {}
+
+  type(type&&) = delete;
+
+  void start() noexcept { stream_->start_cleanup(this); }
+
+  // Called once none of the senders is running.
+  static void start_impl(_cleanup_base* base) noexcept {
+    auto& op = *static_cast<type*>(base);
+    op.stream_->destroy_results();
+    unifex::set_done(std::move(op.receiver_));
+  }
+
+  Stream* stream_;
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+};
+
+template <typename Stream>
+struct _cleanup_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Receiver)
+      (requires receiver<Receiver>)
+  friend typename _cleanup_op<Stream, remove_cvref_t<Receiver>>::type
+  tag_invoke(tag_t<connect>, _cleanup_sender&& s, Receiver&& r) {
+    return typename _cleanup_op<Stream, remove_cvref_t<Receiver>>::type{
+        s.stream_, (Receiver &&) r};
+  }
+
+  Stream* stream_;
+};
+
+struct _fn {
+  template(typename Sender)
+      (requires sender<Sender>)
+  stream<Sender> operator()(std::vector<Sender> senders) const {
+    return stream<Sender>{std::move(senders)};
+  }
+
+  template <typename Iterator>
+  auto operator()(Iterator first, Iterator last) const -> decltype(operator()(
+      std::vector<typename std::iterator_traits<Iterator>::value_type>{
+          first, last})) {
+    return operator()(
+        std::vector<typename std::iterator_traits<Iterator>::value_type>{
+            first, last});
+  }
+};
+
+} // namespace _when_each
+
+inline constexpr _when_each::_fn when_each{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/exception.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/detail/completion_helpers.hpp>
+#include <unifex/detail/stop_callback_storage.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <unifex/detail/prologue.hpp>
+
+namespace unifex {
+namespace _when_n_of {
+
+// when_n_of(senders, k) starts every sender and completes as soon as k of
+// them have completed with a value, asking the others to stop. It sends
+// the index and value of those k senders in the order in which they
+// completed.
+//
+// Senders that complete with an error or done don't count. Once so many
+// have failed that k values can't be reached, the rest are asked to stop
+// and the operation sends the first error, or done if there was none. If k
+// is more than the number of senders, none are started and it sends done.
+
+template <typename Receiver, typename Sender>
+struct _operation {
+  struct type;
+};
+template <typename Receiver, typename Sender>
+using operation = typename _operation<Receiver, Sender>::type;
+
+template <typename Receiver, typename Sender>
+struct _child_receiver {
+  operation<Receiver, Sender>* op_;
+  std::size_t index_;
+
+  template <typename... Values>
+  void set_value(Values&&... values) && noexcept {
+    op_->on_child_value(index_, (Values &&) values...);
+  }
+
+  template <typename Error>
+  void set_error(Error&& error) && noexcept {
+    op_->on_child_failure(_as_exception_ptr((Error &&) error));
+  }
+
+  void set_done() && noexcept { op_->on_child_failure(nullptr); }
+
+  friend inplace_stop_token
+  tag_invoke(tag_t<get_stop_token>, const _child_receiver& r) noexcept {
+    return r.op_->stopSource_.get_token();
+  }
+
+  template(typename CPO, typename R)
+      (requires is_receiver_query_cpo_v<CPO> AND
+          same_as<R, _child_receiver> AND
+          is_callable_v<CPO, const Receiver&>)
+  friend auto tag_invoke(CPO cpo, const R& r) noexcept(
+      is_nothrow_callable_v<CPO, const Receiver&>)
+      -> callable_result_t<CPO, const Receiver&> {
+    return std::move(cpo)(std::as_const(r.op_->receiver_));
+  }
+};
+
+template <typename Receiver, typename Sender>
+struct _cancel_callback {
+  operation<Receiver, Sender>* op_;
+  void operator()() noexcept { op_->request_stop(); }
+};
+
+template <typename Receiver, typename Sender>
+struct _operation<Receiver, Sender>::type
+  : _stop_callback_storage<
+        stop_token_type_t<Receiver&>,
+        _cancel_callback<Receiver, Sender>> {
+  using value_t = sender_single_value_result_t<remove_cvref_t<Sender>>;
+  using result_t = std::vector<std::pair<std::size_t, value_t>>;
+  using child_receiver_t = _child_receiver<Receiver, Sender>;
+  using child_op_t = connect_result_t<Sender, child_receiver_t>;
+
+  struct child {
+    manual_lifetime<child_op_t> op_;
+    std::optional<value_t> value_;
+  };
+
+  using cancel_callback = _cancel_callback<Receiver, Sender>;
+
+  template <typename Receiver2>
+  type(Receiver2&& receiver, std::vector<Sender>&& senders, std::size_t k)
+    : receiver_((Receiver2 &&) receiver)
+    , count_(senders.size())
+    , k_(k)
+    , children_(new child[count_])
+    , order_(new std::size_t[k_])
+    , refCount_(count_) {
+    std::size_t connected = 0;
+    UNIFEX_TRY {
+      for (; connected < count_; ++connected) {
+        children_[connected].op_.construct_with([&] {
+          return unifex::connect(
+              std::move(senders[connected]),
+              child_receiver_t{this, connected});
+        });
+      }
+    }
+    UNIFEX_CATCH(...) {
+      while (connected != 0) {
+        children_[--connected].op_.destruct();
+      }
+      throw;
+    }
+  }
+
+  type(type&&) = delete;
+
+  ~type() {
+    if (!started_) {
+      for (std::size_t i = 0; i < count_; ++i) {
+        children_[i].op_.destruct();
+      }
+    }
+  }
+
+  void start() noexcept {
+    started_ = true;
+    if (k_ == 0 || k_ > count_) {
+      for (std::size_t i = 0; i < count_; ++i) {
+        children_[i].op_.destruct();
+      }
+      if (k_ == 0) {
+        unifex::set_value(std::move(receiver_), result_t{});
+      } else {
+        unifex::set_done(std::move(receiver_));
+      }
+      return;
+    }
+    this->construct_stop_callback(
+        get_stop_token(receiver_), cancel_callback{this});
+    // The last child to complete might destroy this.
+    const std::size_t count = count_;
+    child* children = children_.get();
+    for (std::size_t i = 0; i < count; ++i) {
+      unifex::start(children[i].op_.get());
+    }
+  }
+
+  template <typename... Values>
+  void on_child_value(std::size_t index, Values&&... values) noexcept {
+    UNIFEX_TRY {
+      children_[index].value_.emplace((Values &&) values...);
+    }
+    UNIFEX_CATCH(...) {
+      on_child_failure(std::current_exception());
+      return;
+    }
+    const std::size_t position =
+        successes_.fetch_add(1, std::memory_order_relaxed);
+    if (position < k_) {
+      order_[position] = index;
+      if (position + 1 == k_) {
+        stopSource_.request_stop();
+      }
+    }
+    child_complete();
+  }
+
+  void on_child_failure(std::exception_ptr error) noexcept {
+    if (error && !errored_.exchange(true, std::memory_order_relaxed)) {
+      error_ = std::move(error);
+    }
+    const std::size_t failures =
+        failures_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (count_ - failures < k_) {
+      stopSource_.request_stop();
+    }
+    child_complete();
+  }
+
+  void request_stop() noexcept {
+    if (refCount_.fetch_add(1, std::memory_order_relaxed) == 0) {
+      // Already completing.
+      return;
+    }
+    stopSource_.request_stop();
+    child_complete();
+  }
+
+  void child_complete() noexcept {
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    this->destruct_stop_callback();
+    for (std::size_t i = 0; i < count_; ++i) {
+      children_[i].op_.destruct();
+    }
+    if (successes_.load(std::memory_order_relaxed) >= k_) {
+      UNIFEX_TRY {
+        result_t values;
+        values.reserve(k_);
+        for (std::size_t i = 0; i < k_; ++i) {
+          const std::size_t index = order_[i];
+          values.emplace_back(index, std::move(*children_[index].value_));
+        }
+        unifex::set_value(std::move(receiver_), std::move(values));
+      }
+      UNIFEX_CATCH(...) {
+        unifex::set_error(std::move(receiver_), std::current_exception());
+      }
+    } else if (error_) {
+      unifex::set_error(std::move(receiver_), std::move(error_));
+    } else {
+      unifex::set_done(std::move(receiver_));
+    }
+  }
+
+  UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+  std::size_t count_;
+  std::size_t k_;
+  std::unique_ptr<child[]> children_;
+  // The indices of the first k children to complete with a value.
+  std::unique_ptr<std::size_t[]> order_;
+  std::atomic<std::size_t> refCount_;
+  std::atomic<std::size_t> successes_{0};
+  std::atomic<std::size_t> failures_{0};
+  std::atomic<bool> errored_{false};
+  std::exception_ptr error_;
+  bool started_ = false;
+  inplace_stop_source stopSource_;
+};
+
+template <typename Sender>
+struct _sender {
+  struct type;
+};
+template <typename Sender>
+using sender = typename _sender<Sender>::type;
+
+template <typename Sender>
+struct _sender<Sender>::type {
+  using value_t = sender_single_value_result_t<remove_cvref_t<Sender>>;
+
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types =
+      Variant<Tuple<std::vector<std::pair<std::size_t, value_t>>>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = true;
+
+  template(typename Sender2, typename Receiver)
+      (requires same_as<remove_cvref_t<Sender2>, type> AND
+          receiver<Receiver>)
+  friend operation<remove_cvref_t<Receiver>, Sender>
+  tag_invoke(tag_t<connect>, Sender2&& s, Receiver&& r) {
+    return operation<remove_cvref_t<Receiver>, Sender>{
+        (Receiver &&) r, std::move(s.senders_), s.k_};
+  }
+
+  std::vector<Sender> senders_;
+  std::size_t k_;
+};
+
+struct _fn {
+  template(typename Sender)
+      (requires unifex::sender<Sender>)
+  sender<Sender> operator()(std::vector<Sender> senders, std::size_t k) const {
+    return sender<Sender>{std::move(senders), k};
+  }
+};
+
+} // namespace _when_n_of
+
+inline constexpr _when_n_of::_fn when_n_of{};
+
+} // namespace unifex
+
+#include <unifex/detail/epilogue.hpp>
@@ -16,6 +16,10 @@
 
 #include <unifex/async_manual_reset_event.hpp>
 
+#include <unifex/submission_batch.hpp>
+
+#include <utility>
+
 namespace unifex::_amre {
 
 void async_manual_reset_event::set() noexcept {
@@ -32,7 +36,38 @@ void async_manual_reset_event::set() noexcept {
 
   // We are the first thread to set the state to signalled; iteratively pop
   // the stack and complete each operation.
+  //
+  // Operations that resume by enqueueing onto a never-blocking scheduler are
+  // completed first, inside a submission_batch, so that a context that
+  // batches submissions receives the whole chain at once rather than one push
+  // per waiter.  The others may run arbitrary code inline (possibly blocking
+  // on work submitted to a context) so they're set aside and completed once
+  // the batch has been submitted.
   auto op = static_cast<_op_base*>(top);
+  _op_base* inlineOps = nullptr;
+  {
+    submission_batch batch;
+    while (op != nullptr) {
+      auto* next = op->next_;
+      if (op->resumesAsync_) {
+        op->set_value();
+      } else {
+        op->next_ = inlineOps;
+        inlineOps = op;
+      }
+      op = next;
+    }
+  }
+
+  // note: setting the inline operations aside reversed their order; restore
+  //       it so they're completed in the same order as before
+  while (inlineOps != nullptr) {
+    auto* next = inlineOps->next_;
+    inlineOps->next_ = op;
+    op = inlineOps;
+    inlineOps = next;
+  }
+
   while (op != nullptr) {
     std::exchange(op, op->next_)->set_value();
   }
@@ -26,53 +26,75 @@ namespace unifex {
 inplace_stop_source::~inplace_stop_source() {
   UNIFEX_ASSERT((state_.load(std::memory_order_relaxed) & locked_flag) == 0);
 #ifndef NDEBUG
-  for (auto* cb = callbacks_; cb != nullptr; cb = cb->next_) {
+  for (auto* cb = head(state_.load(std::memory_order_relaxed));
+       cb != nullptr;
+       cb = cb->next_.load(std::memory_order_relaxed)) {
     printf("dangling inplace_stop_callback: %s\n", cb->type_name());
     fflush(stdout);
   }
 #endif
-  UNIFEX_ASSERT(callbacks_ == nullptr);
+  UNIFEX_ASSERT(head(state_.load(std::memory_order_relaxed)) == nullptr);
 }
 
 bool inplace_stop_source::request_stop() noexcept {
-  if (!try_lock_unless_stop_requested(true)) {
-    return true;
-  }
+  spin_wait spin;
+  auto oldState = state_.load(std::memory_order_relaxed);
+  do {
+    while (true) {
+      if ((oldState & stop_requested_flag) != 0) {
+        // Stop already requested.
+        return true;
+      } else if ((oldState & locked_flag) == 0) {
+        break;
+      } else {
+        spin.wait();
+        oldState = state_.load(std::memory_order_relaxed);
+      }
+    }
+  } while (!state_.compare_exchange_weak(
+      oldState,
+      oldState | locked_flag | stop_requested_flag,
+      std::memory_order_acq_rel,
+      std::memory_order_relaxed));
 
   notifyingThreadId_ = std::this_thread::get_id();
 
-  // We are responsible for executing callbacks.
-  while (callbacks_ != nullptr) {
-    auto* callback = callbacks_;
-    callback->prevPtr_ = nullptr;
-    callbacks_ = callback->next_;
-    if (callbacks_ != nullptr) {
-      callbacks_->prevPtr_ = &callbacks_;
+  // We are responsible for executing callbacks. No more can be added.
+  auto* callback = head(oldState);
+  while (callback != nullptr) {
+    auto* next = callback->next_.load(std::memory_order_relaxed);
+    if (next != nullptr) {
+      next->prev_ = nullptr;
     }
-
-    // unlock()
-    state_.store(stop_requested_flag, std::memory_order_release);
+    callback->prev_ = callback;
 
     bool removedDuringCallback = false;
-    callback->removedDuringCallback_ = &removedDuringCallback;
+    callback->removedDuringCallback_.store(
+        &removedDuringCallback, std::memory_order_relaxed);
+
+    unlock(stop_requested_flag, next);
 
     callback->execute();
 
     if (!removedDuringCallback) {
-      callback->removedDuringCallback_ = nullptr;
-      callback->callbackCompleted_.store(true, std::memory_order_release);
+      callback->removedDuringCallback_.store(
+          nullptr, std::memory_order_release);
     }
 
-    lock();
+    // Callbacks can only be removed now, so if none are left there's no
+    // need to take the lock again.
+    if (head(state_.load(std::memory_order_relaxed)) == nullptr) {
+      return false;
+    }
+    callback = head(lock());
   }
 
-  // unlock()
-  state_.store(stop_requested_flag, std::memory_order_release);
+  unlock(stop_requested_flag, nullptr);
 
   return false;
 }
 
-std::uint8_t inplace_stop_source::lock() noexcept {
+std::uintptr_t inplace_stop_source::lock() noexcept {
   spin_wait spin;
   auto oldState = state_.load(std::memory_order_relaxed);
   do {
@@ -89,81 +111,81 @@ std::uint8_t inplace_stop_source::lock() noexcept {
   return oldState;
 }
 
-void inplace_stop_source::unlock(std::uint8_t oldState) noexcept {
-  (void)state_.store(oldState, std::memory_order_release);
+void inplace_stop_source::unlock(
+    std::uintptr_t oldState, inplace_stop_callback_base* head) noexcept {
+  state_.store(
+      (oldState & stop_requested_flag) |
+          reinterpret_cast<std::uintptr_t>(head),
+      std::memory_order_release);
 }
 
-bool inplace_stop_source::try_lock_unless_stop_requested(
-    bool setStopRequested) noexcept {
+bool inplace_stop_source::try_add_callback_slow(
+    inplace_stop_callback_base* callback, std::uintptr_t oldState) noexcept {
   spin_wait spin;
-  auto oldState = state_.load(std::memory_order_relaxed);
-  do {
-    while (true) {
-      if ((oldState & stop_requested_flag) != 0) {
-        // Stop already requested.
-        return false;
-      } else if (oldState == 0) {
-        break;
-      } else {
-        spin.wait();
-        oldState = state_.load(std::memory_order_relaxed);
+  while (true) {
+    if ((oldState & stop_requested_flag) != 0) {
+      return false;
+    } else if (oldState == 0) {
+      if (state_.compare_exchange_weak(
+              oldState,
+              reinterpret_cast<std::uintptr_t>(callback),
+              std::memory_order_release,
+              std::memory_order_relaxed)) {
+        return true;
       }
+    } else if ((oldState & locked_flag) != 0) {
+      spin.wait();
+      oldState = state_.load(std::memory_order_relaxed);
+    } else if (state_.compare_exchange_weak(
+                   oldState,
+                   oldState | locked_flag,
+                   std::memory_order_acquire,
+                   std::memory_order_relaxed)) {
+      auto* oldHead = head(oldState);
+      callback->next_.store(oldHead, std::memory_order_relaxed);
+      oldHead->prev_ = callback;
+      unlock(oldState, callback);
+      return true;
     }
-  } while (!state_.compare_exchange_weak(
-      oldState,
-      setStopRequested ? (locked_flag | stop_requested_flag) : locked_flag,
-      std::memory_order_acq_rel,
-      std::memory_order_relaxed));
-
-  // Lock acquired successfully
-  return true;
-}
-
-bool inplace_stop_source::try_add_callback(
-    inplace_stop_callback_base* callback) noexcept {
-  if (!try_lock_unless_stop_requested(false)) {
-    return false;
   }
-
-  callback->next_ = callbacks_;
-  callback->prevPtr_ = &callbacks_;
-  if (callbacks_ != nullptr) {
-    callbacks_->prevPtr_ = &callback->next_;
-  }
-  callbacks_ = callback;
-
-  unlock(0);
-
-  return true;
 }
 
-void inplace_stop_source::remove_callback(
+void inplace_stop_source::remove_callback_slow(
     inplace_stop_callback_base* callback) noexcept {
   auto oldState = lock();
 
-  if (callback->prevPtr_ != nullptr) {
+  if (!callback->is_dequeued()) {
     // Callback has not been executed yet.
     // Remove from the list.
-    *callback->prevPtr_ = callback->next_;
-    if (callback->next_ != nullptr) {
-      callback->next_->prevPtr_ = callback->prevPtr_;
+    auto* next = callback->next_.load(std::memory_order_relaxed);
+    auto* prev = callback->prev_;
+    if (next != nullptr) {
+      next->prev_ = prev;
+    }
+    if (prev != nullptr) {
+      prev->next_.store(next, std::memory_order_relaxed);
+      unlock(oldState, head(oldState));
+    } else {
+      unlock(oldState, next);
     }
-    unlock(oldState);
   } else {
     auto notifyingThreadId = notifyingThreadId_;
-    unlock(oldState);
+    auto* removedDuringCallback =
+        callback->removedDuringCallback_.load(std::memory_order_relaxed);
+    unlock(oldState, head(oldState));
 
     // Callback has either already been executed or is
     // currently executing on another thread.
     if (std::this_thread::get_id() == notifyingThreadId) {
-      if (callback->removedDuringCallback_ != nullptr) {
-        *callback->removedDuringCallback_ = true;
+      if (removedDuringCallback != nullptr) {
+        *removedDuringCallback = true;
       }
     } else {
       // Concurrently executing on another thread.
       // Wait until the other thread finishes executing the callback.
       spin_wait spin;
-      while (!callback->callbackCompleted_.load(std::memory_order_acquire)) {
+      while (callback->removedDuringCallback_.load(
+                 std::memory_order_acquire) != nullptr) {
         spin.wait();
       }
     }
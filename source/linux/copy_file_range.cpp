@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/copy_file_range.hpp>
+
+#include <unifex/exception.hpp>
+
+#include <cerrno>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace unifex::linuxos {
+
+std::size_t copy_file_range_all(
+    int fdIn,
+    std::int64_t offsetIn,
+    int fdOut,
+    std::int64_t offsetOut,
+    std::size_t length) {
+  loff_t in = offsetIn;
+  loff_t out = offsetOut;
+  std::size_t copied = 0;
+  while (copied != length) {
+    const ssize_t result = ::copy_file_range(
+        fdIn,
+        offsetIn == -1 ? nullptr : &in,
+        fdOut,
+        offsetOut == -1 ? nullptr : &out,
+        length - copied,
+        0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      int errorCode = errno;
+      throw_(std::system_error{errorCode, std::system_category()});
+    }
+    if (result == 0) {
+      break;
+    }
+    copied += static_cast<std::size_t>(result);
+  }
+  return copied;
+}
+
+} // namespace unifex::linuxos
@@ -21,6 +21,7 @@
 
 #include <unifex/scope_guard.hpp>
 #include <unifex/exception.hpp>
+#include <unifex/trace.hpp>
 
 #include <cstring>
 #include <system_error>
@@ -145,6 +146,8 @@ void io_epoll_context::run_impl(const bool& shouldStop) {
   };
 
   while (true) {
+    const auto iterationStart = std::chrono::steady_clock::now();
+
     // Dequeue and process local queue items (ready to run)
     execute_pending_local();
 
@@ -165,6 +168,9 @@ void io_epoll_context::run_impl(const bool& shouldStop) {
       remoteQueueReadSubmitted_ = try_schedule_local_remote_queue_contents();
     }
 
+    loopIterationTime_.record(
+        std::chrono::steady_clock::now() - iterationStart);
+
     if (remoteQueueReadSubmitted_) {
       // Check for any new completion-queue items.
       acquire_completion_queue_items();
@@ -172,6 +178,22 @@ void io_epoll_context::run_impl(const bool& shouldStop) {
   }
 }
 
+io_epoll_context::metrics
+tag_invoke(tag_t<get_metrics>, const io_epoll_context& context) noexcept {
+  const auto timersInserted = context.timersInserted_.load();
+  const auto timersRemoved = context.timersRemoved_.load();
+  return io_epoll_context::metrics{
+      context.loopIterationTime_.load(),
+      context.tasksExecuted_.load(),
+      context.localEnqueues_.load(),
+      context.remoteEnqueues_.load(),
+      context.remoteQueueSignals_.load(std::memory_order_relaxed),
+      context.completions_.load(),
+      timersInserted > timersRemoved ? timersInserted - timersRemoved : 0,
+      context.parks_.load(),
+      std::chrono::nanoseconds(context.idleNanoseconds_.load())};
+}
+
 bool io_epoll_context::is_running_on_io_thread() const noexcept {
   return this == currentThreadContext;
 }
@@ -188,6 +210,8 @@ void io_epoll_context::schedule_impl(operation_base* op) {
 }
 
 void io_epoll_context::schedule_local(operation_base* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_epoll_context", op);
+  localEnqueues_.add();
   LOG("schedule_local");
   UNIFEX_ASSERT(op->execute_);
   UNIFEX_ASSERT(op->enqueued_.load() == 0);
@@ -199,7 +223,18 @@ void io_epoll_context::schedule_local(operation_queue ops) noexcept {
   localQueue_.append(std::move(ops));
 }
 
+void io_epoll_context::schedule_dequeued_remote(
+    operation_queue ops) noexcept {
+  std::uint64_t count = 0;
+  while (!ops.empty()) {
+    localQueue_.push_back(ops.pop_front());
+    ++count;
+  }
+  remoteEnqueues_.add(count);
+}
+
 void io_epoll_context::schedule_remote(operation_base* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_epoll_context", op);
   LOG("schedule_remote");
   UNIFEX_ASSERT(op->execute_);
   UNIFEX_ASSERT(op->enqueued_.load() == 0);
@@ -214,9 +249,11 @@ void io_epoll_context::schedule_remote(operation_base* op) noexcept {
 }
 
 void io_epoll_context::schedule_at_impl(schedule_at_operation* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_epoll_context", op);
   LOG("schedule_at_impl");
   UNIFEX_ASSERT(is_running_on_io_thread());
   timers_.insert(op);
+  timersInserted_.add();
   if (timers_.top() == op) {
     timersAreDirty_ = true;
   }
@@ -240,7 +277,11 @@ void io_epoll_context::execute_pending_local() noexcept {
     std::exchange(item->next_, nullptr);
     auto execute = std::exchange(item->execute_, nullptr);
 
+    UNIFEX_TRACE_EVENT(dequeue, "io_epoll_context", item);
+    UNIFEX_TRACE_EVENT(start, "io_epoll_context", item);
+    tasksExecuted_.add();
     execute(item);
+    UNIFEX_TRACE_EVENT(complete, "io_epoll_context", item);
     ++count;
   }
 
@@ -252,15 +293,21 @@ void io_epoll_context::acquire_completion_queue_items() {
   LOG("epoll_wait()");
 
   epoll_event completions[io_epoll_max_event_count];
+  const bool park = localQueue_.empty();
+  const auto waitStart = std::chrono::steady_clock::now();
   int result = epoll_wait(
     epollFd_.get(),
     completions,
     io_epoll_max_event_count,
-    localQueue_.empty() ? -1 : 0);
+    park ? -1 : 0);
   if (result < 0) {
     int errorCode = errno;
     throw_(std::system_error{errorCode, std::system_category(), "epoll_wait"});
   }
+  if (park) {
+    parks_.add();
+    idleNanoseconds_.add(std::chrono::steady_clock::now() - waitStart);
+  }
   std::uint32_t count = result;
 
   LOGX("got %u completions\n", count);
@@ -321,6 +368,9 @@ void io_epoll_context::acquire_completion_queue_items() {
     // Save the result in the completion state.
     // completionState.result_ = cqe.res;
 
+    UNIFEX_TRACE_EVENT(enqueue, "io_epoll_context", &completionState);
+    completions_.add();
+
     // Add it to a temporary queue of newly completed items.
     completionQueue.push_back(&completionState);
   }
@@ -333,13 +383,14 @@ bool io_epoll_context::try_schedule_local_remote_queue_contents() noexcept {
   LOG(queuedItems.empty() ? "remote queue is empty"
                           : "registered items from remote queue");
   if (!queuedItems.empty()) {
-    schedule_local(std::move(queuedItems));
+    schedule_dequeued_remote(std::move(queuedItems));
     return false;
   }
   return true;
 }
 
 void io_epoll_context::signal_remote_queue() {
+  remoteQueueSignals_.fetch_add(1, std::memory_order_relaxed);
   LOG("writing bytes to eventfd");
 
   // Notify eventfd() by writing a 64-bit integer to it.
@@ -366,6 +417,9 @@ void io_epoll_context::remove_timer(schedule_at_operation* op) noexcept {
     timersAreDirty_ = true;
   }
   timers_.remove(op);
+  timersRemoved_.add();
+  UNIFEX_TRACE_EVENT(dequeue, "io_epoll_context", op);
+  UNIFEX_TRACE_EVENT(cancel, "io_epoll_context", op);
 }
 
 void io_epoll_context::update_timers() noexcept {
@@ -375,6 +429,8 @@ void io_epoll_context::update_timers() noexcept {
     time_point now = monotonic_clock::now();
     while (!timers_.empty() && timers_.top()->dueTime_ <= now) {
       schedule_at_operation* item = timers_.pop();
+      timersRemoved_.add();
+      UNIFEX_TRACE_EVENT(dequeue, "io_epoll_context", item);
 
       LOGX("dequeued elapsed timer %p\n", (void*)item);
 
@@ -22,6 +22,7 @@
 
 #include <unifex/scope_guard.hpp>
 #include <unifex/exception.hpp>
+#include <unifex/trace.hpp>
 
 #include "io_uring_syscall.hpp"
 
@@ -401,6 +402,8 @@ void io_uring_context::run_impl(const bool& shouldStop) {
   };
 
   while (true) {
+    const auto iterationStart = std::chrono::steady_clock::now();
+
     // Dequeue and process local queue items (ready to run)
     execute_pending_local();
 
@@ -430,6 +433,9 @@ void io_uring_context::run_impl(const bool& shouldStop) {
       item->execute_(item);
     }
 
+    loopIterationTime_.record(
+        std::chrono::steady_clock::now() - iterationStart);
+
     if (localQueue_.empty() || sqUnflushedCount_ > 0) {
       const bool isIdle = sqUnflushedCount_ == 0 && localQueue_.empty();
       if (isIdle) {
@@ -455,6 +461,7 @@ void io_uring_context::run_impl(const bool& shouldStop) {
           minCompletionCount,
           pending_operation_count());
 
+      const auto enterStart = std::chrono::steady_clock::now();
       int result = io_uring_enter(
           iouringFd_.get(),
           sqUnflushedCount_,
@@ -465,6 +472,10 @@ void io_uring_context::run_impl(const bool& shouldStop) {
         int errorCode = errno;
         throw_(std::system_error{errorCode, std::system_category()});
       }
+      if (minCompletionCount != 0) {
+        parks_.add();
+        idleNanoseconds_.add(std::chrono::steady_clock::now() - enterStart);
+      }
 
       LOG("io_uring_enter() returned");
 
@@ -474,6 +485,24 @@ void io_uring_context::run_impl(const bool& shouldStop) {
   }
 }
 
+io_uring_context::metrics
+tag_invoke(tag_t<get_metrics>, const io_uring_context& context) noexcept {
+  const auto timersInserted = context.timersInserted_.load();
+  const auto timersRemoved = context.timersRemoved_.load();
+  return io_uring_context::metrics{
+      context.loopIterationTime_.load(),
+      context.tasksExecuted_.load(),
+      context.localEnqueues_.load(),
+      context.remoteEnqueues_.load(),
+      context.remoteQueueSignals_.load(std::memory_order_relaxed),
+      context.completions_.load(),
+      context.sqFullEvents_.load(),
+      context.cqOverflow_->load(std::memory_order_relaxed),
+      timersInserted > timersRemoved ? timersInserted - timersRemoved : 0,
+      context.parks_.load(),
+      std::chrono::nanoseconds(context.idleNanoseconds_.load())};
+}
+
 bool io_uring_context::is_running_on_io_thread() const noexcept {
   return this == currentThreadContext;
 }
@@ -488,6 +517,8 @@ void io_uring_context::schedule_impl(operation_base* op) {
 }
 
 void io_uring_context::schedule_local(operation_base* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_uring_context", op);
+  localEnqueues_.add();
   localQueue_.push_back(op);
 }
 
@@ -495,7 +526,18 @@ void io_uring_context::schedule_local(operation_queue ops) noexcept {
   localQueue_.append(std::move(ops));
 }
 
+void io_uring_context::schedule_dequeued_remote(
+    operation_queue ops) noexcept {
+  std::uint64_t count = 0;
+  while (!ops.empty()) {
+    localQueue_.push_back(ops.pop_front());
+    ++count;
+  }
+  remoteEnqueues_.add(count);
+}
+
 void io_uring_context::schedule_remote(operation_base* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_uring_context", op);
   bool ioThreadWasInactive = remoteQueue_.enqueue(op);
   if (ioThreadWasInactive) {
     // We were the first to queue an item and the I/O thread is not
@@ -507,6 +549,7 @@ void io_uring_context::schedule_remote(operation_base* op) noexcept {
 
 void io_uring_context::schedule_pending_io(operation_base* op) noexcept {
   UNIFEX_ASSERT(is_running_on_io_thread());
+  sqFullEvents_.add();
   pendingIoQueue_.push_back(op);
 }
 
@@ -516,8 +559,10 @@ void io_uring_context::reschedule_pending_io(operation_base* op) noexcept {
 }
 
 void io_uring_context::schedule_at_impl(schedule_at_operation* op) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "io_uring_context", op);
   UNIFEX_ASSERT(is_running_on_io_thread());
   timers_.insert(op);
+  timersInserted_.add();
   if (timers_.top() == op) {
     timersAreDirty_ = true;
   }
@@ -535,7 +580,11 @@ void io_uring_context::execute_pending_local() noexcept {
   auto pending = std::move(localQueue_);
   while (!pending.empty()) {
     auto* item = pending.pop_front();
+    UNIFEX_TRACE_EVENT(dequeue, "io_uring_context", item);
+    UNIFEX_TRACE_EVENT(start, "io_uring_context", item);
+    tasksExecuted_.add();
     item->execute_(item);
+    UNIFEX_TRACE_EVENT(complete, "io_uring_context", item);
     ++count;
   }
 
@@ -618,6 +667,9 @@ void io_uring_context::acquire_completion_queue_items() noexcept {
       // Save the result in the completion state.
       completionState.result_ = cqe.res;
 
+      UNIFEX_TRACE_EVENT(enqueue, "io_uring_context", &completionState);
+      completions_.add();
+
       // Add it to a temporary queue of newly completed items.
       completionQueue.push_back(&completionState);
     }
@@ -635,7 +687,7 @@ void io_uring_context::acquire_remote_queued_items() noexcept {
   auto items = remoteQueue_.dequeue_all();
   LOG(items.empty() ? "remote queue is empty"
                     : "acquired items from remote queue");
-  schedule_local(std::move(items));
+  schedule_dequeued_remote(std::move(items));
 }
 
 bool io_uring_context::try_register_remote_queue_notification() noexcept {
@@ -644,7 +696,7 @@ bool io_uring_context::try_register_remote_queue_notification() noexcept {
   const auto populateRemoteQueuePollSqe = [this](io_uring_sqe & sqe) noexcept {
     auto queuedItems = remoteQueue_.try_mark_inactive_or_dequeue_all();
     if (!queuedItems.empty()) {
-      schedule_local(std::move(queuedItems));
+      schedule_dequeued_remote(std::move(queuedItems));
       return false;
     }
 
@@ -665,6 +717,7 @@ bool io_uring_context::try_register_remote_queue_notification() noexcept {
 }
 
 void io_uring_context::signal_remote_queue() {
+  remoteQueueSignals_.fetch_add(1, std::memory_order_relaxed);
   LOG("writing bytes to eventfd");
 
   // Notify eventfd() by writing a 64-bit integer to it.
@@ -690,6 +743,9 @@ void io_uring_context::remove_timer(schedule_at_operation* op) noexcept {
     timersAreDirty_ = true;
   }
   timers_.remove(op);
+  timersRemoved_.add();
+  UNIFEX_TRACE_EVENT(dequeue, "io_uring_context", op);
+  UNIFEX_TRACE_EVENT(cancel, "io_uring_context", op);
 }
 
 void io_uring_context::update_timers() noexcept {
@@ -700,6 +756,8 @@ void io_uring_context::update_timers() noexcept {
     time_point now = monotonic_clock::now();
     while (!timers_.empty() && timers_.top()->dueTime_ <= now) {
       schedule_at_operation* item = timers_.pop();
+      timersRemoved_.add();
+      UNIFEX_TRACE_EVENT(dequeue, "io_uring_context", item);
 
       LOGX("dequeued elapsed timer %p\n", (void*)item);
 
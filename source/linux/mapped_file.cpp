@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/mapped_file.hpp>
+
+#include <unifex/exception.hpp>
+#include <unifex/linux/safe_file_descriptor.hpp>
+
+#include <algorithm>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace unifex::linuxos {
+
+namespace {
+[[noreturn]] void throw_errno() {
+  int errorCode = errno;
+  throw_(std::system_error{errorCode, std::system_category()});
+}
+} // namespace
+
+std::size_t page_size() noexcept {
+  static const std::size_t size =
+      static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+mapped_file::mapped_file(
+    const filesystem::path& path, file_range range, map_advice advice) {
+  safe_file_descriptor fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (!fd.valid()) {
+    throw_errno();
+  }
+
+  struct stat info;
+  if (::fstat(fd.get(), &info) < 0) {
+    throw_errno();
+  }
+  const auto fileSize = static_cast<std::uint64_t>(info.st_size);
+  if (range.offset > fileSize) {
+    throw_(std::system_error{
+        std::make_error_code(std::errc::invalid_argument)});
+  }
+  size_ = static_cast<std::size_t>(
+      std::min(range.length, fileSize - range.offset));
+  if (size_ == 0) {
+    // mmap() doesn't accept empty mappings.
+    return;
+  }
+
+  pageOffset_ = static_cast<std::size_t>(range.offset % page_size());
+  const std::size_t mappedSize = pageOffset_ + size_;
+  void* ptr = ::mmap(
+      nullptr,
+      mappedSize,
+      PROT_READ,
+      MAP_SHARED,
+      fd.get(),
+      static_cast<off_t>(range.offset - pageOffset_));
+  if (ptr == MAP_FAILED) {
+    throw_errno();
+  }
+  region_ = mmap_region{ptr, mappedSize};
+
+  advise(advice);
+}
+
+void mapped_file::advise(
+    map_advice advice, std::size_t offset, std::size_t length) const
+    noexcept {
+  // The mapping works the same without any of them, so a hint that the
+  // kernel doesn't support (e.g. MADV_HUGEPAGE without transparent huge
+  // pages) is skipped rather than reported.
+  if (advice.sequential) {
+    (void)apply_advice(MADV_SEQUENTIAL, offset, length);
+  }
+#ifdef MADV_HUGEPAGE
+  if (advice.hugepages) {
+    (void)apply_advice(MADV_HUGEPAGE, offset, length);
+  }
+#endif
+  if (advice.willneed) {
+    (void)apply_advice(MADV_WILLNEED, offset, length);
+  }
+}
+
+void mapped_file::prefetch(std::size_t offset, std::size_t length) const
+    noexcept {
+  (void)apply_advice(MADV_WILLNEED, offset, length);
+}
+
+int mapped_file::apply_advice(
+    int flag, std::size_t offset, std::size_t length) const noexcept {
+  if (offset >= size_) {
+    return 0;
+  }
+  // madvise() wants a page-aligned address.
+  const std::size_t begin = pageOffset_ + offset;
+  const std::size_t alignedBegin = begin - begin % page_size();
+  return ::madvise(
+      static_cast<std::byte*>(region_.data()) + alignedBegin,
+      begin - alignedBegin + std::min(length, size_ - offset),
+      flag);
+}
+
+} // namespace unifex::linuxos
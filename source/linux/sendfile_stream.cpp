@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/sendfile_stream.hpp>
+
+#include <unifex/exception.hpp>
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace unifex::linuxos::_sendfile {
+
+splice_pipe::splice_pipe() {
+  int fds[2];
+  if (::pipe2(fds, O_CLOEXEC) < 0) {
+    int errorCode = errno;
+    throw_(std::system_error{errorCode, std::system_category()});
+  }
+  readEnd_ = safe_file_descriptor{fds[0]};
+  writeEnd_ = safe_file_descriptor{fds[1]};
+}
+
+std::size_t splice_pipe::size() const {
+  int bytes = 0;
+  if (::ioctl(readEnd_.get(), FIONREAD, &bytes) < 0) {
+    int errorCode = errno;
+    throw_(std::system_error{errorCode, std::system_category()});
+  }
+  return static_cast<std::size_t>(bytes);
+}
+
+} // namespace unifex::linuxos::_sendfile
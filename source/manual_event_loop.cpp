@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <unifex/manual_event_loop.hpp>
+#include <unifex/trace.hpp>
 
 namespace unifex {
 namespace _manual_event_loop {
@@ -31,7 +32,10 @@ void context::run() {
       tail_ = nullptr;
     }
     lock.unlock();
+    UNIFEX_TRACE_EVENT(dequeue, "manual_event_loop", task);
+    UNIFEX_TRACE_EVENT(start, "manual_event_loop", task);
     task->execute();
+    UNIFEX_TRACE_EVENT(complete, "manual_event_loop", task);
     lock.lock();
   }
 }
@@ -43,6 +47,7 @@ void context::stop() {
 }
 
 void context::enqueue(task_base* task) {
+  UNIFEX_TRACE_EVENT(enqueue, "manual_event_loop", task);
   std::unique_lock lock{mutex_};
   if (head_ == nullptr) {
     head_ = task;
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unifex/recycling_allocator.hpp>
+
+namespace unifex::_recycle {
+
+namespace {
+
+// The head of the calling thread's list of registered free lists; trivially
+// destructible for the same reason as _free_list.
+struct _registry {
+  _free_list* lists_;
+  bool exiting_;
+};
+
+thread_local _registry registry{};
+
+// Drains and closes every registered free list when the thread exits.  This
+// object is only constructed by the first registration on each thread so
+// threads that never recycle memory pay nothing.
+struct _thread_cache {
+  ~_thread_cache() {
+    registry.exiting_ = true;
+    for (auto* list = registry.lists_; list != nullptr;
+         list = list->nextList_) {
+      list->drain();
+      // unregistering forces later deallocations through _register(), which
+      // sends them to the global heap now that the list is closed
+      list->registered_ = false;
+      list->closed_ = true;
+    }
+    registry.lists_ = nullptr;
+  }
+};
+
+// the runtime-sized buckets hold blocks of 64, 128, ..., 8192 bytes
+constexpr std::size_t _min_bucket_size = 64;
+constexpr std::size_t _num_buckets = 8;
+
+thread_local _free_list buckets[_num_buckets]{};
+
+// returns the index of the smallest bucket that fits size, or _num_buckets if
+// there isn't one
+std::size_t _bucket_index(std::size_t size) noexcept {
+  std::size_t index = 0;
+  for (std::size_t bucketSize = _min_bucket_size; bucketSize < size;
+       bucketSize *= 2) {
+    ++index;
+  }
+  return index;
+}
+
+}  // namespace
+
+void* allocate(std::size_t size) {
+  const auto index = _bucket_index(size);
+  if (index < _num_buckets) {
+    if (void* p = buckets[index].pop()) {
+      return p;
+    }
+    return ::operator new(_min_bucket_size << index);
+  }
+  return ::operator new(size);
+}
+
+void deallocate(void* p, std::size_t size) noexcept {
+  const auto index = _bucket_index(size);
+  if (index < _num_buckets && buckets[index].push(p)) {
+    return;
+  }
+  ::operator delete(p);
+}
+
+void _free_list::drain() noexcept {
+  while (void* p = pop()) {
+    ::operator delete(p);
+  }
+}
+
+bool _register(_free_list& list) noexcept {
+  if (list.closed_ || registry.exiting_) {
+    return false;
+  }
+
+  // construct the thread's cache on first use so that it's destroyed (and
+  // thus drains all free lists) when this thread exits
+  static thread_local _thread_cache cache;
+  (void)cache;
+
+  list.nextList_ = registry.lists_;
+  registry.lists_ = &list;
+  list.registered_ = true;
+  return true;
+}
+
+void trim_recycled_memory() noexcept {
+  for (auto* list = registry.lists_; list != nullptr; list = list->nextList_) {
+    list->drain();
+  }
+}
+
+}  // namespace unifex::_recycle
@@ -14,9 +14,56 @@
  * limitations under the License.
  */
 #include <unifex/static_thread_pool.hpp>
+#include <unifex/submission_batch.hpp>
+#include <unifex/trace.hpp>
+
+#include <utility>
 
 namespace unifex {
 namespace _static_thread_pool {
+  // The tasks that the calling thread has enqueued onto a pool during the
+  // current submission_batch.
+  struct _pending_tasks : deferred_submission {
+    void add(submission_batch& batch, context& pool, task_base* task) noexcept {
+      if (batch_ == nullptr) {
+        batch_ = &batch;
+        submit_ = &submit;
+        batch.defer(*this);
+      }
+      if (pool_ != &pool) {
+        submit_tasks();
+        pool_ = &pool;
+      }
+      tasks_.push_back(task);
+      ++count_;
+    }
+
+    void submit_tasks() noexcept {
+      if (pool_ != nullptr) {
+        std::exchange(pool_, nullptr)->enqueue_all(
+            std::move(tasks_), std::exchange(count_, 0));
+      }
+    }
+
+    static void submit(deferred_submission* self) noexcept {
+      auto& pending = static_cast<_pending_tasks&>(*self);
+      pending.batch_ = nullptr;
+      pending.submit_tasks();
+    }
+
+    submission_batch* batch_ = nullptr;
+    context* pool_ = nullptr;
+    intrusive_queue<task_base, &task_base::next> tasks_;
+    std::uint32_t count_ = 0;
+  };
+
+  namespace {
+    thread_local _pending_tasks pendingTasks;
+
+    // the pool that the calling thread is a worker of, if any
+    thread_local const context* currentPool = nullptr;
+  } // namespace
+
   context::context()
     : context(std::thread::hardware_concurrency()) {}
 
@@ -51,6 +98,8 @@ namespace _static_thread_pool {
   }
 
   void context::run(std::uint32_t index) noexcept {
+    currentPool = this;
+    auto& ownState = threadStates_[index];
     while (true) {
       task_base* task = nullptr;
       for (std::uint32_t i = 0; i < threadCount_; ++i) {
@@ -60,6 +109,9 @@ namespace _static_thread_pool {
         auto& state = threadStates_[queueIndex];
         task = state.try_pop();
         if (task != nullptr) {
+          if (i != 0) {
+            ownState.steals_.add();
+          }
           break;
         }
       }
@@ -72,7 +124,11 @@ namespace _static_thread_pool {
         }
       }
 
+      UNIFEX_TRACE_EVENT(dequeue, "static_thread_pool", task);
+      UNIFEX_TRACE_EVENT(start, "static_thread_pool", task);
+      ownState.tasksExecuted_.add();
       task->execute(task);
+      UNIFEX_TRACE_EVENT(complete, "static_thread_pool", task);
     }
   }
 
@@ -83,23 +139,66 @@ namespace _static_thread_pool {
     threads_.clear();
   }
 
+  context::metrics context::get_metrics_() const {
+    metrics result;
+    result.threads.reserve(threadStates_.size());
+    for (auto& state : threadStates_) {
+      result.threads.push_back(state.get_metrics());
+    }
+    return result;
+  }
+
   void context::enqueue(task_base* task) noexcept {
+    UNIFEX_TRACE_EVENT(enqueue, "static_thread_pool", task);
+    if (auto* batch = submission_batch::current()) {
+      pendingTasks.add(*batch, *this, task);
+      return;
+    }
+
     const std::uint32_t threadCount = static_cast<std::uint32_t>(threads_.size());
     const std::uint32_t startIndex =
         nextThread_.fetch_add(1, std::memory_order_relaxed) % threadCount;
+    const bool local = currentPool == this;
 
     // First try to enqueue to one of the threads without blocking.
     for (std::uint32_t i = 0; i < threadCount; ++i) {
       const auto index = (startIndex + i) < threadCount
           ? (startIndex + i)
           : (startIndex + i - threadCount);
-      if (threadStates_[index].try_push(task)) {
+      if (threadStates_[index].try_push(task, local)) {
         return;
       }
     }
 
     // Otherwise, do a blocking enqueue on the selected thread.
-    threadStates_[startIndex].push(task);
+    threadStates_[startIndex].push(task, local);
+  }
+
+  void context::enqueue_all(
+      intrusive_queue<task_base, &task_base::next> tasks,
+      std::uint32_t count) noexcept {
+    const std::uint32_t threadCount = static_cast<std::uint32_t>(threads_.size());
+    const std::uint32_t startIndex =
+        nextThread_.fetch_add(1, std::memory_order_relaxed) % threadCount;
+
+    // Spread the tasks evenly over the worker queues so that idle workers,
+    // which only wait on their own queue, all get woken.
+    const std::uint32_t perThread = (count + threadCount - 1) / threadCount;
+    const bool local = currentPool == this;
+
+    for (std::uint32_t i = 0; i < threadCount && !tasks.empty(); ++i) {
+      const auto index = (startIndex + i) < threadCount
+          ? (startIndex + i)
+          : (startIndex + i - threadCount);
+
+      intrusive_queue<task_base, &task_base::next> chunk;
+      std::uint32_t chunkSize = 0;
+      for (; chunkSize < perThread && !tasks.empty(); ++chunkSize) {
+        chunk.push_back(tasks.pop_front());
+      }
+
+      threadStates_[index].push_all(std::move(chunk), chunkSize, local);
+    }
   }
 
   task_base* context::thread_state::try_pop() {
@@ -112,20 +211,30 @@ namespace _static_thread_pool {
 
   task_base* context::thread_state::pop() {
     std::unique_lock lk{mut_};
-    while (queue_.empty()) {
-      if (stopRequested_) {
-        return nullptr;
+    if (queue_.empty() && !stopRequested_) {
+      parks_.add();
+      const auto start = std::chrono::steady_clock::now();
+      do {
+        cv_.wait(lk);
+      } while (queue_.empty() && !stopRequested_);
+      idleNanoseconds_.add(std::chrono::steady_clock::now() - start);
+      if (!queue_.empty()) {
+        unparks_.add();
       }
-      cv_.wait(lk);
+    }
+    if (queue_.empty()) {
+      // request_stop() was called.
+      return nullptr;
     }
     return queue_.pop_front();
   }
 
-  bool context::thread_state::try_push(task_base* task) {
+  bool context::thread_state::try_push(task_base* task, bool local) {
     std::unique_lock lk{mut_, std::try_to_lock};
     if (!lk) {
       return false;
     }
+    count_enqueues(1, local);
     const bool wasEmpty = queue_.empty();
     queue_.push_back(task);
     if (wasEmpty) {
@@ -134,8 +243,9 @@ namespace _static_thread_pool {
     return true;
   }
 
-  void context::thread_state::push(task_base* task) {
+  void context::thread_state::push(task_base* task, bool local) {
     std::lock_guard lk{mut_};
+    count_enqueues(1, local);
     const bool wasEmpty = queue_.empty();
     queue_.push_back(task);
     if (wasEmpty) {
@@ -143,11 +253,41 @@ namespace _static_thread_pool {
     }
   }
 
+  void context::thread_state::push_all(
+      intrusive_queue<task_base, &task_base::next> tasks,
+      std::uint32_t count,
+      bool local) {
+    std::lock_guard lk{mut_};
+    count_enqueues(count, local);
+    const bool wasEmpty = queue_.empty();
+    queue_.append(std::move(tasks));
+    if (wasEmpty) {
+      cv_.notify_one();
+    }
+  }
+
   void context::thread_state::request_stop() {
     std::lock_guard lk{mut_};
     stopRequested_ = true;
     cv_.notify_one();
   }
 
+  void context::thread_state::count_enqueues(
+      std::uint32_t count, bool local) noexcept {
+    (local ? localEnqueues_ : remoteEnqueues_).add(count);
+  }
+
+  context::thread_metrics
+  context::thread_state::get_metrics() const noexcept {
+    return thread_metrics{
+        tasksExecuted_.load(),
+        localEnqueues_.load(),
+        remoteEnqueues_.load(),
+        steals_.load(),
+        parks_.load(),
+        unparks_.load(),
+        std::chrono::nanoseconds(idleNanoseconds_.load())};
+  }
+
 } // namespace _static_thread_pool
 } // namespace unifex
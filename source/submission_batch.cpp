@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/submission_batch.hpp>
+
+#include <utility>
+
+namespace unifex::_submission_batch {
+  namespace {
+    // the calling thread's outermost live submission_batch, if any
+    thread_local submission_batch* currentBatch = nullptr;
+  } // namespace
+
+  submission_batch::submission_batch() noexcept
+    : outermost_(currentBatch == nullptr) {
+    if (outermost_) {
+      currentBatch = this;
+    }
+  }
+
+  submission_batch::~submission_batch() {
+    if (!outermost_) {
+      return;
+    }
+
+    // Work enqueued while the deferred work is submitted isn't held back.
+    currentBatch = nullptr;
+    while (deferred_ != nullptr) {
+      auto* deferred = std::exchange(deferred_, deferred_->next_);
+      deferred->submit_(deferred);
+    }
+  }
+
+  submission_batch* submission_batch::current() noexcept {
+    return currentBatch;
+  }
+} // namespace unifex::_submission_batch
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <unifex/timed_single_thread_context.hpp>
+#include <unifex/trace.hpp>
 
 namespace unifex {
 
@@ -33,7 +34,9 @@ timed_single_thread_context::~timed_single_thread_context() {
 }
 
 void timed_single_thread_context::enqueue(task_base* task) noexcept {
+  UNIFEX_TRACE_EVENT(enqueue, "timed_single_thread_context", task);
   std::lock_guard lock{mutex_};
+  enqueues_.add();
 
   if (head_ == nullptr || task->dueTime_ < head_->dueTime_) {
     // Insert at the head of the queue.
@@ -46,6 +49,7 @@ void timed_single_thread_context::enqueue(task_base* task) noexcept {
 
     // New minimum due-time has changed, wake the thread.
     cv_.notify_one();
+    unparks_.add();
   } else {
     auto* queuedTask = head_;
     while (queuedTask->next_ != nullptr &&
@@ -82,22 +86,46 @@ void timed_single_thread_context::run() {
 
         // Flag the task as dequeued.
         task->prevNextPtr_ = nullptr;
+        dequeues_.add();
         lock.unlock();
 
+        UNIFEX_TRACE_EVENT(dequeue, "timed_single_thread_context", task);
+        UNIFEX_TRACE_EVENT(start, "timed_single_thread_context", task);
+        tasksExecuted_.add();
         task->execute();
+        UNIFEX_TRACE_EVENT(complete, "timed_single_thread_context", task);
 
         lock.lock();
       } else {
         // Not yet ready to run. Sleep until it's ready.
+        parks_.add();
         cv_.wait_until(lock, nextDueTime);
+        idleNanoseconds_.add(clock_t::now() - now);
       }
     } else {
       // Queue is empty.
+      parks_.add();
+      const auto start = clock_t::now();
       cv_.wait(lock);
+      idleNanoseconds_.add(clock_t::now() - start);
     }
   }
 }
 
+timed_single_thread_context::metrics tag_invoke(
+    tag_t<get_metrics>, const timed_single_thread_context& context) noexcept {
+  const auto enqueues = context.enqueues_.load();
+  const auto dequeues = context.dequeues_.load();
+  return timed_single_thread_context::metrics{
+      context.tasksExecuted_.load(),
+      enqueues,
+      context.cancellations_.load(),
+      enqueues > dequeues ? enqueues - dequeues : 0,
+      context.parks_.load(),
+      context.unparks_.load(),
+      std::chrono::nanoseconds(context.idleNanoseconds_.load())};
+}
+
 void _timed_single_thread_context::cancel_callback::operator()() noexcept {
   std::unique_lock lock{task_->context_->mutex_};
   auto now = clock_t::now();
@@ -113,8 +141,13 @@ void _timed_single_thread_context::cancel_callback::operator()() noexcept {
         task_->next_->prevNextPtr_ = task_->prevNextPtr_;
       }
       task_->prevNextPtr_ = nullptr;
+      task_->context_->dequeues_.add();
+      task_->context_->cancellations_.add();
       lock.unlock();
 
+      UNIFEX_TRACE_EVENT(dequeue, "timed_single_thread_context", task_);
+      UNIFEX_TRACE_EVENT(cancel, "timed_single_thread_context", task_);
+
       // And requeue with an updated time.
       task_->dueTime_ = now;
       task_->context_->enqueue(task_);
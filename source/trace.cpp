@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/trace.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+#if !defined(UNIFEX_TRACE_BUFFER_SIZE)
+#define UNIFEX_TRACE_BUFFER_SIZE 16384
+#endif
+
+namespace unifex {
+namespace _trace {
+namespace {
+
+constexpr std::size_t buffer_size = UNIFEX_TRACE_BUFFER_SIZE;
+static_assert(
+    buffer_size != 0 && (buffer_size & (buffer_size - 1)) == 0,
+    "UNIFEX_TRACE_BUFFER_SIZE must be a power of two");
+
+// An event that may be read while its owner overwrites it. seq_ is odd
+// while the slot is being written and 2 * (index + 1) once the event with
+// that index is complete, so that readers can skip torn slots.
+struct slot {
+  std::atomic<std::uint64_t> seq_{0};
+  std::atomic<std::uint64_t> timestamp_{0};
+  std::atomic<const void*> id_{nullptr};
+  std::atomic<const char*> name_{nullptr};
+  std::atomic<event_kind> kind_{event_kind::enqueue};
+};
+
+// Only the owning thread writes to a buffer. Once the thread exits the
+// buffer keeps its events until another thread takes it over.
+struct thread_buffer {
+  // Only accessed with the registry's mutex held.
+  std::uint32_t threadId_ = 0;
+  // The number of events ever recorded. The newest is at
+  // events_[(count_ - 1) % buffer_size].
+  std::atomic<std::uint64_t> count_{0};
+  std::unique_ptr<slot[]> events_{new slot[buffer_size]};
+};
+
+struct registry {
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<thread_buffer>> buffers_;
+  // The buffers of threads that have exited.
+  std::vector<thread_buffer*> free_;
+  std::uint32_t nextThreadId_ = 1;
+};
+
+registry& get_registry() {
+  // Never destroyed, so that threads that outlive static destruction can
+  // still record, and so that a thread's events outlive the thread.
+  static registry* r = new registry;
+  return *r;
+}
+
+thread_local thread_buffer* currentBuffer = nullptr;
+thread_local bool threadExited = false;
+
+// Hands the thread's buffer back when the thread exits.
+struct buffer_owner {
+  ~buffer_owner() {
+    threadExited = true;
+    auto& r = get_registry();
+    std::lock_guard lock{r.mutex_};
+    r.free_.push_back(std::exchange(currentBuffer, nullptr));
+  }
+};
+
+thread_buffer* acquire_buffer() {
+  auto& r = get_registry();
+  std::lock_guard lock{r.mutex_};
+  thread_buffer* buffer;
+  if (r.free_.empty()) {
+    r.buffers_.push_back(std::make_unique<thread_buffer>());
+    buffer = r.buffers_.back().get();
+  } else {
+    buffer = r.free_.back();
+    r.free_.pop_back();
+    buffer->count_.store(0, std::memory_order_relaxed);
+  }
+  buffer->threadId_ = r.nextThreadId_++;
+  // So that handing the buffer back when the thread exits can't throw.
+  r.free_.reserve(r.buffers_.size());
+  return buffer;
+}
+
+thread_buffer* current_buffer() noexcept {
+  if (currentBuffer == nullptr && !threadExited) {
+    UNIFEX_TRY {
+      currentBuffer = acquire_buffer();
+      thread_local buffer_owner owner;
+      (void)owner;
+    } UNIFEX_CATCH (...) {
+      // Out of memory: drop the event.
+    }
+  }
+  return currentBuffer;
+}
+
+const char* phase(event_kind kind) noexcept {
+  switch (kind) {
+    case event_kind::enqueue:
+    case event_kind::start:
+      return "b";
+    case event_kind::dequeue:
+    case event_kind::complete:
+      return "e";
+    case event_kind::cancel:
+    default:
+      return "n";
+  }
+}
+
+const char* category(event_kind kind) noexcept {
+  switch (kind) {
+    case event_kind::start:
+    case event_kind::complete:
+      return "run";
+    case event_kind::enqueue:
+    case event_kind::dequeue:
+    case event_kind::cancel:
+    default:
+      return "queue";
+  }
+}
+
+void write_string(std::ostream& out, const char* s) {
+  out << '"';
+  for (; *s != '\0'; ++s) {
+    if (*s == '"' || *s == '\\') {
+      out << '\\';
+    }
+    out << *s;
+  }
+  out << '"';
+}
+
+} // namespace
+} // namespace _trace
+
+std::size_t trace_buffer_capacity() noexcept {
+  return _trace::buffer_size;
+}
+
+void record_trace_event(
+    trace_event_kind kind, const char* name, const void* id) noexcept {
+  auto* buffer = _trace::current_buffer();
+  if (buffer == nullptr) {
+    return;
+  }
+  const auto timestamp = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+  const auto count = buffer->count_.load(std::memory_order_relaxed);
+  auto& slot = buffer->events_[count & (_trace::buffer_size - 1)];
+  const auto seq = 2 * count + 2;
+  slot.seq_.store(seq - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestamp_.store(timestamp, std::memory_order_relaxed);
+  slot.id_.store(id, std::memory_order_relaxed);
+  slot.name_.store(name, std::memory_order_relaxed);
+  slot.kind_.store(kind, std::memory_order_relaxed);
+  slot.seq_.store(seq, std::memory_order_release);
+  buffer->count_.store(count + 1, std::memory_order_release);
+}
+
+std::vector<thread_trace_events> collect_trace_events() {
+  auto& r = _trace::get_registry();
+  std::lock_guard lock{r.mutex_};
+  std::vector<thread_trace_events> result;
+  result.reserve(r.buffers_.size());
+  for (auto& buffer : r.buffers_) {
+    const auto count = buffer->count_.load(std::memory_order_acquire);
+    const auto first = count > _trace::buffer_size
+        ? count - _trace::buffer_size
+        : std::uint64_t{0};
+    auto& thread = result.emplace_back();
+    thread.threadId = buffer->threadId_;
+    thread.events.reserve(static_cast<std::size_t>(count - first));
+    for (auto i = first; i != count; ++i) {
+      // Skip the slots that the owner has started to overwrite.
+      auto& slot = buffer->events_[i & (_trace::buffer_size - 1)];
+      const auto seq = 2 * i + 2;
+      if (slot.seq_.load(std::memory_order_acquire) != seq) {
+        continue;
+      }
+      const trace_event e{
+          slot.timestamp_.load(std::memory_order_relaxed),
+          slot.id_.load(std::memory_order_relaxed),
+          slot.name_.load(std::memory_order_relaxed),
+          slot.kind_.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq_.load(std::memory_order_relaxed) == seq) {
+        thread.events.push_back(e);
+      }
+    }
+  }
+  return result;
+}
+
+void clear_trace_events() noexcept {
+  auto& r = _trace::get_registry();
+  std::lock_guard lock{r.mutex_};
+  for (auto& buffer : r.buffers_) {
+    buffer->count_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void write_chrome_trace(std::ostream& out) {
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (auto& thread : collect_trace_events()) {
+    for (auto& e : thread.events) {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      out << "{\"name\":";
+      _trace::write_string(out, e.name);
+      out << ",\"cat\":\"" << _trace::category(e.kind) << "\""
+          << ",\"ph\":\"" << _trace::phase(e.kind) << "\""
+          << ",\"id\":\"" << e.id << "\""
+          << ",\"pid\":1,\"tid\":" << thread.threadId
+          // Microseconds
+          << ",\"ts\":" << e.timestamp / 1000 << '.';
+      const auto fraction = e.timestamp % 1000;
+      out << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "")
+          << fraction;
+      if (e.kind == trace_event_kind::cancel) {
+        out << ",\"args\":{\"cancelled\":true}";
+      }
+      out << '}';
+    }
+  }
+  out << "\n]}\n";
+}
+
+bool write_chrome_trace(const std::string& path) {
+  std::ofstream out{path};
+  if (!out) {
+    return false;
+  }
+  write_chrome_trace(out);
+  out.flush();
+  return static_cast<bool>(out);
+}
+
+} // namespace unifex
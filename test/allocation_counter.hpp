@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// Replaces the global operator new and delete with versions that count
+// the allocations and deallocations made by each thread, so that a test
+// can check that a pipeline doesn't allocate:
+//
+//   unifex_test::allocation_scope scope;
+//   sync_wait(pipeline);
+//   EXPECT_EQ(0u, scope.allocations());
+//
+// Only include this from one source file of a test executable.
+
+namespace unifex_test {
+
+inline thread_local std::size_t threadAllocationCount = 0;
+inline thread_local std::size_t threadDeallocationCount = 0;
+
+// Counts the allocations and deallocations made by the current thread
+// since construction.
+class allocation_scope {
+public:
+  std::size_t allocations() const noexcept {
+    return threadAllocationCount - start_;
+  }
+
+  std::size_t deallocations() const noexcept {
+    return threadDeallocationCount - startDeallocations_;
+  }
+
+private:
+  std::size_t start_ = threadAllocationCount;
+  std::size_t startDeallocations_ = threadDeallocationCount;
+};
+
+}  // namespace unifex_test
+
+void* operator new(std::size_t size) {
+  ++unifex_test::threadAllocationCount;
+  if (void* p = std::malloc(size != 0 ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  ++unifex_test::threadAllocationCount;
+  const auto alignment = static_cast<std::size_t>(align);
+#ifdef _MSC_VER
+  void* p = ::_aligned_malloc(size != 0 ? size : 1, alignment);
+#else
+  // aligned_alloc needs the size to be a multiple of the alignment
+  const std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+  void* p = std::aligned_alloc(alignment, rounded != 0 ? rounded : alignment);
+#endif
+  if (p == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return p;
+}
+
+// GCC sees the free() when this is inlined after a new-expression and
+// doesn't know that the matching operator new is the one above.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept {
+  if (p != nullptr) {
+    ++unifex_test::threadDeallocationCount;
+  }
+  std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void* p, std::size_t) noexcept {
+  ::operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  if (p != nullptr) {
+    ++unifex_test::threadDeallocationCount;
+  }
+#ifdef _MSC_VER
+  ::_aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept {
+  ::operator delete(p, align);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "allocation_counter.hpp"
+
+#include <unifex/any_sender_of.hpp>
+#include <unifex/coroutine.hpp>
+#include <unifex/defer.hpp>
+#include <unifex/detach_on_cancel.hpp>
+#include <unifex/dematerialize.hpp>
+#include <unifex/finally.hpp>
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/into_variant.hpp>
+#include <unifex/just.hpp>
+#include <unifex/just_done.hpp>
+#include <unifex/just_error.hpp>
+#include <unifex/just_from.hpp>
+#include <unifex/let_done.hpp>
+#include <unifex/let_error.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/materialize.hpp>
+#include <unifex/on.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sequence.hpp>
+#include <unifex/stop_if_requested.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/trampoline_scheduler.hpp>
+#include <unifex/upon_done.hpp>
+#include <unifex/upon_error.hpp>
+#include <unifex/via.hpp>
+#include <unifex/when_all.hpp>
+#include <unifex/when_all_range.hpp>
+#include <unifex/when_any.hpp>
+
+#if !UNIFEX_NO_COROUTINES
+#include <unifex/task.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <exception>
+#include <vector>
+
+using namespace unifex;
+using unifex_test::allocation_scope;
+
+namespace {
+auto plus_one() {
+  return [](int x) { return x + 1; };
+}
+}  // namespace
+
+TEST(Allocation, CounterSeesHeapAllocations) {
+  allocation_scope scope;
+
+  std::vector<int> v(10);
+
+  EXPECT_EQ(1u, scope.allocations());
+}
+
+TEST(Allocation, SyncWaitDoesNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(just(42));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, ValueAdaptorsDoNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(then(just(1), plus_one()));
+  sync_wait(let_value(just(1), [](int& x) { return just(x + 1); }));
+  sync_wait(let_value_with([] { return 42; }, [](int& x) { return just(x); }));
+  sync_wait(into_variant(just(1)));
+  sync_wait(dematerialize(materialize(just(1))));
+  sync_wait(defer([] { return just(1); }));
+  sync_wait(just_from([] { return 1; }));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, ErrorAndDoneAdaptorsDoNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(upon_error(just_error(42), [](int) noexcept {}));
+  sync_wait(let_error(just_error(42), [](int) noexcept { return just(); }));
+  sync_wait(upon_done(just_done(), [] {}));
+  sync_wait(let_done(just_done(), [] { return just(); }));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, CombinatorsDoNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(when_all(just(1), just(2), just(3)));
+  sync_wait(when_any(just(1), just(2)));
+  sync_wait(sequence(just(), just(), just(1)));
+  sync_wait(finally(just(1), just()));
+  sync_wait(stop_when(just(1), just()));
+  sync_wait(
+      repeat_effect_until(just(), [n = 0]() mutable { return ++n == 10; }));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, DetachOnCancelWithoutAStopTokenDoesNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(detach_on_cancel(just(1)));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, StopSourcesDoNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(let_value_with_stop_source([](inplace_stop_source& source) {
+    source.request_stop();
+    return stop_if_requested();
+  }));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, WhenAllRangeWithCallerStorageDoesNotAllocate) {
+  using sender_t = decltype(then(just(1), plus_one()));
+  std::array<sender_t, 4> senders{
+      then(just(1), plus_one()), then(just(2), plus_one()),
+      then(just(3), plus_one()), then(just(4), plus_one())};
+  std::array<int, 4> results{};
+
+  allocation_scope scope;
+
+  sync_wait(when_all_range(span<sender_t>{senders}, span<int>{results}));
+  sync_wait(when_all_range(std::move(senders)));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+TEST(Allocation, SchedulingOnTheCurrentThreadDoesNotAllocate) {
+  allocation_scope scope;
+
+  sync_wait(schedule(inline_scheduler{}));
+  sync_wait(schedule(trampoline_scheduler{}));
+  sync_wait(on(inline_scheduler{}, just(1)));
+  sync_wait(via(just(1), inline_scheduler{}));
+
+  EXPECT_EQ(0u, scope.allocations());
+}
+
+// The following allocate by design. They check that the counter catches
+// an adaptor that allocates, and record which ones do.
+
+TEST(Allocation, WhenAllRangeOfVectorAllocates) {
+  std::vector<decltype(just(1))> senders;
+  senders.push_back(just(1));
+
+  allocation_scope scope;
+
+  sync_wait(when_all_range(std::move(senders)));
+
+  EXPECT_LT(0u, scope.allocations());
+}
+
+TEST(Allocation, TypeErasedSenderAllocates) {
+  allocation_scope scope;
+
+  sync_wait(any_sender_of<int>{just(1)});
+
+  EXPECT_LT(0u, scope.allocations());
+}
+
+#if !UNIFEX_NO_COROUTINES
+TEST(Allocation, TaskAllocatesItsFrame) {
+  auto makeTask = []() -> task<int> { co_return 42; };
+  allocation_scope scope;
+
+  sync_wait(makeTask());
+
+  EXPECT_LT(0u, scope.allocations());
+}
+#endif  // !UNIFEX_NO_COROUTINES
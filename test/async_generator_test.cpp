@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/coroutine.hpp>
+
+#if !UNIFEX_NO_COROUTINES
+
+#include <unifex/async_generator.hpp>
+#include <unifex/done_as_optional.hpp>
+#include <unifex/for_each.hpp>
+#include <unifex/just.hpp>
+#include <unifex/let_done.hpp>
+#include <unifex/on.hpp>
+#include <unifex/reduce_stream.hpp>
+#include <unifex/single.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/task.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/transform_stream.hpp>
+#include <unifex/via_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+
+async_generator<int> iota(int n) {
+  for (int i = 0; i < n; ++i) {
+    co_yield i;
+  }
+}
+
+struct move_only {
+  explicit move_only(int v) : value(std::make_unique<int>(v)) {}
+  std::unique_ptr<int> value;
+};
+
+async_generator<move_only> make_move_only(int n) {
+  for (int i = 0; i < n; ++i) {
+    co_yield move_only{i};
+  }
+}
+
+async_generator<int&> counter(int& value, int n) {
+  for (int i = 0; i < n; ++i) {
+    co_yield value;
+  }
+}
+
+async_generator<int> throws_after(int n) {
+  for (int i = 0; i < n; ++i) {
+    co_yield i;
+  }
+  throw std::runtime_error("boom");
+}
+
+async_generator<int> awaits_senders(int n) {
+  for (int i = 0; i < n; ++i) {
+    co_yield co_await just(i * 2);
+  }
+}
+
+async_generator<int> ticks(timed_single_thread_context& ctx) {
+  for (int i = 0;; ++i) {
+    co_await schedule_after(ctx.get_scheduler(), 10ms);
+    co_yield i;
+  }
+}
+
+template <typename Sender>
+auto done_as_void(Sender&& sender) {
+  return let_done(static_cast<Sender&&>(sender), [] { return just(); });
+}
+
+}  // namespace
+
+TEST(AsyncGenerator, ReduceStream) {
+  auto result = sync_wait(reduce_stream(
+      iota(10), 0, [](int state, int value) { return state + value; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(45, *result);
+}
+
+TEST(AsyncGenerator, ComposesWithTransformStream) {
+  auto result = sync_wait(reduce_stream(
+      transform_stream(iota(10), [](int value) { return value * value; }),
+      0,
+      [](int state, int value) { return state + value; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(285, *result);
+}
+
+TEST(AsyncGenerator, ForEach) {
+  std::vector<int> values;
+  sync_wait(for_each(iota(5), [&](int value) { values.push_back(value); }));
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), values);
+}
+
+TEST(AsyncGenerator, ValuesAreYieldedWithoutCopying) {
+  std::vector<int> values;
+  sync_wait(for_each(make_move_only(3), [&](move_only&& value) {
+    values.push_back(*value.value);
+  }));
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), values);
+}
+
+TEST(AsyncGenerator, ReferenceGeneratorsYieldTheReferent) {
+  int value = 0;
+  auto consume = [&]() -> task<void> {
+    auto gen = counter(value, 3);
+    for (int i = 0; i < 3; ++i) {
+      int& v = co_await next(gen);
+      EXPECT_EQ(&value, &v);
+      ++v;
+    }
+  };
+  sync_wait(consume());
+
+  EXPECT_EQ(3, value);
+}
+
+TEST(AsyncGenerator, GeneratorBodyMayAwaitSenders) {
+  auto result = sync_wait(reduce_stream(
+      awaits_senders(4), 0, [](int state, int value) { return state + value; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(12, *result);
+}
+
+TEST(AsyncGenerator, ExceptionsPropagateToTheConsumer) {
+  int count = 0;
+  EXPECT_THROW(
+      sync_wait(for_each(throws_after(3), [&](int) { ++count; })),
+      std::runtime_error);
+  EXPECT_EQ(3, count);
+}
+
+TEST(AsyncGenerator, ViaStream) {
+  single_thread_context ctx;
+  auto id = std::this_thread::get_id();
+
+  std::vector<int> values;
+  sync_wait(for_each(via_stream(ctx.get_scheduler(), iota(5)), [&](int value) {
+    EXPECT_NE(id, std::this_thread::get_id());
+    values.push_back(value);
+  }));
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), values);
+}
+
+TEST(AsyncGenerator, TakeUntilCancelsAnInfiniteGenerator) {
+  timed_single_thread_context ctx;
+
+  int count = 0;
+  auto result = sync_wait(for_each(
+      take_until(ticks(ctx), single(schedule_after(ctx.get_scheduler(), 100ms))),
+      [&](int) { ++count; }));
+
+  EXPECT_TRUE(result.has_value());
+  EXPECT_GT(count, 0);
+}
+
+TEST(AsyncGenerator, TaskConsumer) {
+  auto consume = []() -> task<int> {
+    auto gen = iota(10);
+    int sum = 0;
+    while (auto value = co_await done_as_optional(next(gen))) {
+      sum += *value;
+    }
+    co_await done_as_void(cleanup(gen));
+    co_return sum;
+  };
+
+  auto result = sync_wait(consume());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(45, *result);
+}
+
+TEST(AsyncGenerator, TaskConsumerAwaitsNextDirectly) {
+  auto consume = []() -> task<int> {
+    auto gen = iota(10);
+    int sum = 0;
+    for (int i = 0; i < 5; ++i) {
+      sum += co_await next(gen);
+    }
+    co_return sum;
+  };
+
+  auto result = sync_wait(consume());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(10, *result);
+}
+
+TEST(AsyncGenerator, ExhaustedGeneratorCancelsAwaitingTask) {
+  bool reachedEnd = false;
+  auto consume = [&]() -> task<int> {
+    auto gen = iota(2);
+    int sum = co_await next(gen);
+    sum += co_await next(gen);
+    sum += co_await next(gen);
+    reachedEnd = true;
+    co_return sum;
+  };
+
+  auto result = sync_wait(consume());
+  EXPECT_FALSE(result.has_value());
+  EXPECT_FALSE(reachedEnd);
+}
+
+TEST(AsyncGenerator, TaskConsumerResumesOnItsScheduler) {
+  single_thread_context consumerCtx;
+  timed_single_thread_context timerCtx;
+
+  auto consume = [&]() -> task<int> {
+    auto gen = ticks(timerCtx);
+    int sum = 0;
+    for (int i = 0; i < 3; ++i) {
+      sum += co_await next(gen);
+      EXPECT_EQ(consumerCtx.get_thread_id(), std::this_thread::get_id());
+    }
+    co_return sum;
+  };
+
+  auto result = sync_wait(on(consumerCtx.get_scheduler(), consume()));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(3, *result);
+}
+
+#endif  // !UNIFEX_NO_COROUTINES
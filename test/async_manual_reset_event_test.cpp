@@ -20,13 +20,17 @@
 #include <unifex/inplace_stop_token.hpp>
 #include <unifex/sender_concepts.hpp>
 #include <unifex/single_thread_context.hpp>
+#include <unifex/spawn_detached.hpp>
+#include <unifex/static_thread_pool.hpp>
 #include <unifex/sync_wait.hpp>
 #include <unifex/then.hpp>
+#include <unifex/v2/async_scope.hpp>
 #include <unifex/with_query_value.hpp>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <atomic>
 #include <exception>
 #include <memory>
 #include <stdexcept>
@@ -44,6 +48,7 @@ using unifex::inplace_stop_token;
 using unifex::schedule;
 using unifex::single_thread_context;
 using unifex::start;
+using unifex::static_thread_pool;
 using unifex::sync_wait;
 using unifex::tag_t;
 using unifex::then;
@@ -250,3 +255,83 @@ TEST_F(
   ASSERT_TRUE(actualThreadId);
   EXPECT_EQ(expectedThreadId, *actualThreadId);
 }
+
+TEST_F(async_manual_reset_event_test, set_resumes_many_thread_pool_waiters) {
+  static_thread_pool pool{4};
+  auto scheduler = pool.get_scheduler();
+  unifex::v2::async_scope scope;
+
+  async_manual_reset_event evt;
+  std::atomic<int> count{0};
+
+  constexpr int waiters = 1000;
+  for (int i = 0; i < waiters; ++i) {
+    unifex::spawn_detached(
+        then(
+            with_query_value(evt.async_wait(), get_scheduler, scheduler),
+            [&]() noexcept { ++count; }),
+        scope);
+  }
+
+  EXPECT_EQ(0, count.load());
+
+  evt.set();
+
+  sync_wait(scope.join());
+
+  EXPECT_EQ(waiters, count.load());
+}
+
+TEST_F(
+    async_manual_reset_event_test,
+    set_resumes_thread_pool_and_inline_waiters_together) {
+  static_thread_pool pool{2};
+  unifex::v2::async_scope scope;
+
+  async_manual_reset_event evt;
+  std::atomic<int> count{0};
+
+  for (int i = 0; i < 10; ++i) {
+    unifex::spawn_detached(
+        then(
+            with_query_value(
+                evt.async_wait(), get_scheduler, pool.get_scheduler()),
+            [&]() noexcept { ++count; }),
+        scope);
+    unifex::spawn_detached(
+        then(
+            with_query_value(evt.async_wait(), get_scheduler, scheduler),
+            [&]() noexcept {
+              // inline waiters run after the thread pool waiters have been
+              // submitted, so blocking on the pool here can't deadlock
+              sync_wait(schedule(pool.get_scheduler()));
+              ++count;
+            }),
+        scope);
+  }
+
+  evt.set();
+
+  sync_wait(scope.join());
+
+  EXPECT_EQ(20, count.load());
+}
+
+TEST_F(async_manual_reset_event_test, async_set_resumes_waiters_on_scheduler) {
+  single_thread_context thread;
+
+  async_manual_reset_event evt;
+  std::thread::id actualThreadId{};
+
+  auto op = connect(evt.async_wait(), std::move(receiver));
+  start(op);
+
+  EXPECT_CALL(receiverImpl, set_value()).WillOnce(Invoke([&] {
+    actualThreadId = std::this_thread::get_id();
+  }));
+
+  sync_wait(evt.async_set(thread.get_scheduler()));
+
+  EXPECT_TRUE(evt.ready());
+  EXPECT_EQ(thread.get_thread_id(), actualThreadId);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/batch_stream.hpp>
+#include <unifex/unbatch_stream.hpp>
+
+#include <unifex/delay.hpp>
+#include <unifex/for_each.hpp>
+#include <unifex/range_stream.hpp>
+#include <unifex/reduce_stream.hpp>
+#include <unifex/single.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/transform_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+TEST(batch_stream, GroupsValuesIntoBatches) {
+  std::vector<std::vector<int>> batches;
+  sync_wait(for_each(
+      batch_stream(range_stream{0, 10}, 4),
+      [&](std::vector<int> batch) { batches.push_back(std::move(batch)); }));
+
+  EXPECT_EQ(
+      (std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9}}),
+      batches);
+}
+
+TEST(batch_stream, UnbatchRestoresTheOriginalStream) {
+  std::vector<int> values;
+  range_stream{0, 10}
+    | batch_stream(3)
+    | unbatch_stream()
+    | for_each([&](int value) { values.push_back(value); })
+    | sync_wait();
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), values);
+}
+
+TEST(batch_stream, ReduceStreamFoldsEachBatchInALoop) {
+  auto result = range_stream{0, 100}
+    | batch_stream(8)
+    | reduce_stream(0, [](int state, int value) { return state + value; })
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(4950, *result);
+}
+
+TEST(batch_stream, TransformStreamMapsEachBatchInALoop) {
+  std::vector<std::vector<long>> batches;
+  range_stream{0, 5}
+    | batch_stream(2)
+    | transform_stream([](int value) { return long(value) * 10; })
+    | for_each([&](std::vector<long> batch) {
+        batches.push_back(std::move(batch));
+      })
+    | sync_wait();
+
+  EXPECT_EQ((std::vector<std::vector<long>>{{0, 10}, {20, 30}, {40}}), batches);
+}
+
+TEST(batch_stream, WholeBatchFunctionsStillApply) {
+  auto result = range_stream{0, 10}
+    | batch_stream(4)
+    | transform_stream([](std::vector<int> batch) { return batch.size(); })
+    | reduce_stream(
+        std::size_t{0},
+        [](std::size_t state, std::size_t size) { return state + size; })
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(10u, *result);
+}
+
+TEST(batch_stream, ErrorsAreSentAfterThePartialBatch) {
+  std::vector<std::vector<int>> batches;
+  EXPECT_THROW(
+      sync_wait(for_each(
+          batch_stream(
+              transform_stream(
+                  range_stream{0, 10},
+                  [](int value) {
+                    if (value == 6) {
+                      throw std::runtime_error("boom");
+                    }
+                    return value;
+                  }),
+              4),
+          [&](std::vector<int> batch) {
+            batches.push_back(std::move(batch));
+          })),
+      std::runtime_error);
+
+  EXPECT_EQ((std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5}}), batches);
+}
+
+TEST(batch_stream, MaxDelayFlushesPartialBatches) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+
+  std::vector<std::vector<int>> batches;
+  sync_wait(for_each(
+      batch_stream(delay(range_stream{0, 3}, sched, 100ms), 100, sched, 10ms),
+      [&](std::vector<int> batch) { batches.push_back(std::move(batch)); }));
+
+  std::vector<int> values;
+  for (auto& batch : batches) {
+    values.insert(values.end(), batch.begin(), batch.end());
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), values);
+  EXPECT_GT(batches.size(), 1u);
+}
+
+TEST(batch_stream, CancellingNextCancelsTheSource) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+
+  // The values collected before the source was cancelled are still sent.
+  std::size_t count = 0;
+  auto result = sync_wait(for_each(
+      take_until(
+          batch_stream(delay(range_stream{0, 1000}, sched, 10ms), 1000),
+          single(schedule_after(sched, 50ms))),
+      [&](std::vector<int> batch) { count += batch.size(); }));
+
+  EXPECT_TRUE(result.has_value());
+  EXPECT_LT(count, 1000u);
+}
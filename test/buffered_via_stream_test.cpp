@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/buffered_via_stream.hpp>
+
+#include <unifex/for_each.hpp>
+#include <unifex/never.hpp>
+#include <unifex/on_stream.hpp>
+#include <unifex/range_stream.hpp>
+#include <unifex/reduce_stream.hpp>
+#include <unifex/single.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/transform_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+TEST(buffered_via_stream, Smoke) {
+  single_thread_context ctx;
+
+  std::vector<int> values;
+  sync_wait(for_each(
+      buffered_via_stream(range_stream{0, 100}, ctx.get_scheduler(), 4),
+      [&](int value) {
+        EXPECT_EQ(ctx.get_thread_id(), std::this_thread::get_id());
+        values.push_back(value);
+      }));
+
+  ASSERT_EQ(100u, values.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, values[i]);
+  }
+}
+
+TEST(buffered_via_stream, Pipeable) {
+  single_thread_context ctx;
+
+  auto result = range_stream{0, 10}
+    | transform_stream([](int value) { return value * value; })
+    | buffered_via_stream(ctx.get_scheduler(), 3)
+    | reduce_stream(0, [](int state, int value) { return state + value; })
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(285, *result);
+}
+
+TEST(buffered_via_stream, ProducerIsBoundedByCapacity) {
+  single_thread_context producer;
+  single_thread_context consumer;
+  constexpr int capacity = 4;
+
+  std::atomic<int> pulled{0};
+  int consumed = 0;
+  int maxAhead = 0;
+  sync_wait(for_each(
+      buffered_via_stream(
+          on_stream(
+              producer.get_scheduler(),
+              transform_stream(
+                  range_stream{0, 200},
+                  [&](int value) {
+                    ++pulled;
+                    return value;
+                  })),
+          consumer.get_scheduler(),
+          capacity),
+      [&](int value) {
+        EXPECT_EQ(consumed, value);
+        // One value may be pulled into the slot freed by this value.
+        maxAhead = std::max(maxAhead, pulled.load() - consumed);
+        ++consumed;
+        std::this_thread::yield();
+      }));
+
+  EXPECT_EQ(200, consumed);
+  EXPECT_LE(maxAhead, capacity + 1);
+}
+
+TEST(buffered_via_stream, ErrorsAreDeliveredAfterBufferedValues) {
+  single_thread_context ctx;
+
+  std::vector<int> values;
+  EXPECT_THROW(
+      sync_wait(for_each(
+          buffered_via_stream(
+              transform_stream(
+                  range_stream{0, 10},
+                  [](int value) {
+                    if (value == 5) {
+                      throw std::runtime_error("boom");
+                    }
+                    return value;
+                  }),
+              ctx.get_scheduler(),
+              8),
+          [&](int value) { values.push_back(value); })),
+      std::runtime_error);
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), values);
+}
+
+TEST(buffered_via_stream, CancellingNextStopsTheSource) {
+  single_thread_context ctx;
+  timed_single_thread_context timer;
+
+  int count = 0;
+  auto result = sync_wait(for_each(
+      take_until(
+          buffered_via_stream(never_stream{}, ctx.get_scheduler(), 2),
+          single(schedule_after(timer.get_scheduler(), 10ms))),
+      [&](auto&&...) { ++count; }));
+
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ(0, count);
+}
+
+TEST(buffered_via_stream, CleanupWithoutNext) {
+  single_thread_context ctx;
+
+  auto s = buffered_via_stream(range_stream{0, 10}, ctx.get_scheduler(), 2);
+  auto result = sync_wait(cleanup(s));
+
+  EXPECT_FALSE(result.has_value());
+}
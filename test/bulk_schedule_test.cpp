@@ -16,6 +16,7 @@
 
 #include <unifex/bulk_schedule.hpp>
 #include <unifex/single_thread_context.hpp>
+#include <unifex/static_thread_pool.hpp>
 #include <unifex/sync_wait.hpp>
 #include <unifex/bulk_transform.hpp>
 #include <unifex/bulk_join.hpp>
@@ -23,6 +24,12 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
 TEST(bulk, bulk_transform) {
     unifex::single_thread_context ctx;
     auto sched = ctx.get_scheduler();
@@ -112,3 +119,69 @@ TEST(bulk, Pipeable) {
         EXPECT_EQ(i, output[i]);
     }
 }
+
+TEST(bulk, static_thread_pool_parallel) {
+    unifex::static_thread_pool pool{4};
+    auto sched = pool.get_scheduler();
+
+    const std::size_t count = 1000;
+
+    std::vector<std::atomic<int>> visits(count);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    unifex::sync_wait(
+        unifex::bulk_join(
+            unifex::bulk_transform(
+                unifex::bulk_schedule(sched, count),
+                [&](std::size_t index) noexcept {
+                    ++visits[index];
+                    if (index % 64 == 0) {
+                        {
+                            std::lock_guard lock{mutex};
+                            threads.insert(std::this_thread::get_id());
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }, unifex::par)));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(1, visits[i].load());
+    }
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(bulk, static_thread_pool_cancellation) {
+    unifex::static_thread_pool pool{4};
+    auto sched = pool.get_scheduler();
+
+    const std::size_t count = 10000;
+
+    std::vector<std::atomic<int>> visits(count);
+    const std::size_t stop_index = 100;
+
+    // Indices are handed out in ascending blocks that always run to the end,
+    // so every index up to the one that requested stop is visited.
+    auto result = unifex::sync_wait(
+        unifex::let_value_with_stop_source([&](unifex::inplace_stop_source& stopSource) {
+            return unifex::bulk_join(
+                unifex::bulk_transform(
+                    unifex::bulk_schedule(sched, count),
+                    [&](std::size_t index) noexcept {
+                        ++visits[index];
+                        if (index == stop_index) {
+                            stopSource.request_stop();
+                        }
+                    }, unifex::par));
+        }));
+
+    EXPECT_FALSE(result.has_value());
+    for (std::size_t i = 0; i <= stop_index; ++i) {
+        EXPECT_EQ(1, visits[i].load());
+    }
+    std::size_t visited = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        visited += visits[i].load();
+    }
+    EXPECT_LT(visited, count);
+}
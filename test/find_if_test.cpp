@@ -26,6 +26,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <vector>
+
 TEST(find_if, find_if_sequential) {
     using namespace unifex;
 
@@ -83,21 +88,14 @@ TEST(find_if, find_if_parallel) {
           })));
 
     EXPECT_EQ(**result, checkValue);
-    // Expect 62 iterations to run to validate cancellation
+    // Expect 64 iterations to run to validate early exit.
     // This is based on some implementation details:
-    //  * bulk_schedule's bulk_cancellation_chunk_size
-    //  * find_if's max_num_chunks and min_chunk_size
-    // find_if tries to launch 32 chunks of 4 elements each.
-    // bulk_schedule then chunks those into 16 element cancellation chunks.
-    // bulk_schedule launches a whole 16 element chunk.
-    // Most of them run to completion without finding the element.
-    // The second finds element 7 half way through and terminates early in
-    // the find_if algorithm.
-    // It ends up running the comparison operator 62 times.
-    // In general cancellation is best effort.
-    // Note though that the current implementation launches tasks in-order, so it
-    // cannot cancel earlier tasks, which makes find_if's find-fist rule safe.
-    EXPECT_EQ(countOfTasksRun, 62);
+    //  * find_if's min_chunk_size and sub_chunk_size
+    // The 126 elements are too few to split, so they form a single chunk.
+    // That chunk is searched 64 elements at a time, evaluating the
+    // predicate for the whole sub-chunk so that the loop can be vectorised.
+    // The first sub-chunk contains element 7, so the search stops there.
+    EXPECT_EQ(countOfTasksRun, 64);
 }
 #endif
 
@@ -130,3 +128,83 @@ TEST(find_if, Pipeable) {
 
     EXPECT_EQ(**result, 3);
 }
+
+TEST(find_if, ParallelFindsTheFirstOfManyMatches) {
+    using namespace unifex;
+
+    std::vector<int> input(1 << 20, 0);
+    input[300000] = 1;
+    input[70000] = 1;
+    input[900000] = 1;
+
+    static_thread_pool ctx{4};
+    std::atomic<int> comparisons = 0;
+    auto result = sync_wait(
+      on(
+        ctx.get_scheduler(),
+        find_if(
+          just(begin(input), end(input)),
+          [&](const int& v) noexcept {
+            comparisons.fetch_add(1, std::memory_order_relaxed);
+            return v == 1;
+          },
+          par)));
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(70000, std::distance(begin(input), *result));
+    // Chunks after the match give up once they see it.
+    EXPECT_LT(comparisons.load(), static_cast<int>(input.size()));
+}
+
+TEST(find_if, ParallelReturnsEndWithoutAMatch) {
+    using namespace unifex;
+
+    std::vector<long> input(100000);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      input[i] = static_cast<long>(i);
+    }
+
+    static_thread_pool ctx{4};
+    auto result = sync_wait(
+      on(
+        ctx.get_scheduler(),
+        find_if(
+          just(begin(input), end(input)),
+          // Not noexcept, so each sub-chunk is searched element by element.
+          [](long v) { return v < 0; },
+          par)));
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(*result == end(input));
+}
+
+TEST(find_if, ParallelSearchesRandomAccessRanges) {
+    using namespace unifex;
+
+    std::deque<int> input(100000, 0);
+    input[54321] = 1;
+    input[76543] = 1;
+    std::vector<bool> flags(100000, false);
+    flags[12345] = true;
+
+    static_thread_pool ctx{4};
+    auto result = sync_wait(
+      on(
+        ctx.get_scheduler(),
+        find_if(
+          just(begin(input), end(input)),
+          [](int v) noexcept { return v == 1; },
+          par)));
+    auto flagResult = sync_wait(
+      on(
+        ctx.get_scheduler(),
+        find_if(
+          just(begin(flags), end(flags)),
+          [](bool v) noexcept { return v; },
+          par)));
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(54321, std::distance(begin(input), *result));
+    ASSERT_TRUE(flagResult.has_value());
+    EXPECT_EQ(12345, std::distance(begin(flags), *flagResult));
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/for_each_n.hpp>
+
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace unifex;
+
+TEST(for_each_n, Parallel) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000, 1);
+
+  auto result = sync_wait(unifex::for_each_n(
+      pool.get_scheduler(), par, values.begin(), 60'000, [](int& value) {
+        value *= 3;
+      }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(*result == values.begin() + 60'000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(i < 60'000 ? 3 : 1, values[i]);
+  }
+}
+
+TEST(for_each_n, Sequenced) {
+  std::vector<int> values{1, 2, 3, 4};
+  std::vector<int> visited;
+
+  auto result = sync_wait(unifex::for_each_n(
+      inline_scheduler{}, seq, values.begin(), 3, [&](int value) {
+        visited.push_back(value);
+      }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), visited);
+}
+
+TEST(for_each_n, SequencedCallsNeverOverlap) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000, 1);
+  std::atomic<int> inFlight{0};
+  std::atomic<bool> overlapped{false};
+  int next = 0;
+  bool inOrder = true;
+
+  auto result = sync_wait(unifex::for_each_n(
+      pool.get_scheduler(), seq, values.begin(), 100'000, [&](int& value) {
+        if (inFlight.fetch_add(1) != 0) {
+          overlapped = true;
+        }
+        inOrder = inOrder && &value == &values[next++];
+        inFlight.fetch_sub(1);
+      }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_FALSE(overlapped.load());
+  EXPECT_TRUE(inOrder);
+}
+
+TEST(for_each_n, ExceptionIsSent) {
+  static_thread_pool pool{4};
+  std::vector<int> values(10'000, 1);
+  values[7'000] = 0;
+
+  EXPECT_THROW(
+      sync_wait(unifex::for_each_n(
+          pool.get_scheduler(), par, values.begin(), 10'000, [](int value) {
+            if (value == 0) {
+              throw std::runtime_error("boom");
+            }
+          })),
+      std::runtime_error);
+}
+
+TEST(for_each_n, Cancellation) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000, 1);
+
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return unifex::for_each_n(
+            pool.get_scheduler(), par, values.begin(), 100'000, [](int& value) {
+              value = 0;
+            });
+      }));
+
+  EXPECT_FALSE(result.has_value());
+  EXPECT_EQ(1, values[0]);
+}
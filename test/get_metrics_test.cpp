@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/get_metrics.hpp>
+
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+
+#if !UNIFEX_NO_EPOLL
+#include <unifex/linux/io_epoll_context.hpp>
+#endif
+
+#if !UNIFEX_NO_LIBURING
+#include <unifex/linux/io_uring_context.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+std::uint64_t total(const duration_histogram& histogram) {
+  return std::accumulate(
+      histogram.begin(), histogram.end(), std::uint64_t{0});
+}
+
+template <typename Scheduler>
+auto schedule_twice(Scheduler s) {
+  return let_value(schedule(s), [s]() { return schedule(s); });
+}
+} // namespace
+
+TEST(get_metrics, HistogramBuckets) {
+  _metrics::histogram h;
+  h.record(500ns);
+  h.record(1us);
+  h.record(3us);
+  h.record(1h);
+  auto buckets = h.load();
+  EXPECT_EQ(1u, buckets[0]);
+  EXPECT_EQ(1u, buckets[1]);
+  EXPECT_EQ(1u, buckets[2]);
+  EXPECT_EQ(1u, buckets.back());
+  EXPECT_EQ(4u, total(buckets));
+}
+
+TEST(get_metrics, StaticThreadPool) {
+  static_thread_pool pool{2};
+  auto s = pool.get_scheduler();
+
+  for (int i = 0; i < 10; ++i) {
+    sync_wait(schedule(s));
+  }
+  sync_wait(schedule_twice(s));
+
+  auto m = get_metrics(pool);
+  ASSERT_EQ(2u, m.threads.size());
+  std::uint64_t executed = 0;
+  std::uint64_t local = 0;
+  std::uint64_t remote = 0;
+  for (auto& thread : m.threads) {
+    executed += thread.tasksExecuted;
+    local += thread.localEnqueues;
+    remote += thread.remoteEnqueues;
+    EXPECT_LE(thread.unparks, thread.parks);
+  }
+  EXPECT_EQ(12u, executed);
+  EXPECT_EQ(1u, local);
+  EXPECT_EQ(11u, remote);
+}
+
+TEST(get_metrics, TimedSingleThreadContext) {
+  timed_single_thread_context context;
+  auto s = context.get_scheduler();
+
+  sync_wait(schedule_after(s, 1ms));
+  sync_wait(stop_when(schedule_after(s, 1h), schedule_after(s, 1ms)));
+
+  auto m = get_metrics(context);
+  // The cancelled timer is requeued to complete with done.
+  EXPECT_EQ(4u, m.enqueues);
+  EXPECT_EQ(3u, m.tasksExecuted);
+  EXPECT_EQ(1u, m.cancellations);
+  EXPECT_EQ(0u, m.timersPending);
+  EXPECT_GE(m.parks, 1u);
+}
+
+#if !UNIFEX_NO_EPOLL
+TEST(get_metrics, IoEpollContext) {
+  linuxos::io_epoll_context context;
+  inplace_stop_source stopSource;
+  std::thread t{[&] { context.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+  auto s = context.get_scheduler();
+
+  sync_wait(schedule_twice(s));
+  sync_wait(schedule_at(s, now(s) + 1ms));
+
+  auto m = get_metrics(context);
+  EXPECT_GE(m.remoteEnqueues, 2u);
+  EXPECT_GE(m.localEnqueues, 2u);
+  EXPECT_GE(m.tasksExecuted, 4u);
+  EXPECT_EQ(0u, m.timersPending);
+  EXPECT_GE(total(m.loopIterationTime), 1u);
+}
+#endif
+
+#if !UNIFEX_NO_LIBURING
+TEST(get_metrics, IoUringContext) {
+  linuxos::io_uring_context context;
+  inplace_stop_source stopSource;
+  std::thread t{[&] { context.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+  auto s = context.get_scheduler();
+
+  sync_wait(schedule_twice(s));
+  sync_wait(schedule_at(s, now(s) + 1ms));
+
+  auto m = get_metrics(context);
+  EXPECT_GE(m.remoteEnqueues, 2u);
+  EXPECT_GE(m.localEnqueues, 2u);
+  EXPECT_GE(m.tasksExecuted, 4u);
+  EXPECT_EQ(0u, m.timersPending);
+  EXPECT_EQ(0u, m.cqOverflows);
+  EXPECT_GE(total(m.loopIterationTime), 1u);
+}
+#endif
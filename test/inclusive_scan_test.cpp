@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inclusive_scan.hpp>
+
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace unifex;
+
+TEST(inclusive_scan, Parallel) {
+  static_thread_pool pool{4};
+  for (std::size_t size : {0, 1, 100, 2048 * 5 + 7, 100'000}) {
+    std::vector<std::int64_t> values(size);
+    std::iota(values.begin(), values.end(), 1);
+    std::vector<std::int64_t> expected(size);
+    std::partial_sum(values.begin(), values.end(), expected.begin());
+
+    std::vector<std::int64_t> output(size);
+    auto result = sync_wait(unifex::inclusive_scan(
+        pool.get_scheduler(),
+        par,
+        values.begin(),
+        values.end(),
+        output.begin()));
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(*result == output.end());
+    EXPECT_EQ(expected, output);
+  }
+}
+
+TEST(inclusive_scan, InPlace) {
+  static_thread_pool pool{4};
+  std::vector<int> values(50'000, 1);
+
+  auto result = sync_wait(unifex::inclusive_scan(
+      pool.get_scheduler(),
+      par,
+      values.begin(),
+      values.end(),
+      values.begin()));
+
+  ASSERT_TRUE(result.has_value());
+  for (int i = 0; i < 50'000; ++i) {
+    ASSERT_EQ(i + 1, values[i]);
+  }
+}
+
+TEST(inclusive_scan, NonCommutativeOperation) {
+  static_thread_pool pool{4};
+  std::vector<int> values(50'000);
+  std::iota(values.begin(), values.end(), 5);
+  std::vector<int> output(values.size());
+
+  // Associative but not commutative: every chunk must apply its carry on
+  // the left.
+  auto result = sync_wait(unifex::inclusive_scan(
+      pool.get_scheduler(),
+      par,
+      values.begin(),
+      values.end(),
+      output.begin(),
+      [](int first, int) { return first; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(std::vector<int>(values.size(), 5), output);
+}
+
+TEST(inclusive_scan, Sequenced) {
+  std::vector<int> values{3, 1, 4, 1, 5};
+  std::vector<int> output(values.size());
+
+  auto result = sync_wait(unifex::inclusive_scan(
+      inline_scheduler{},
+      seq,
+      values.begin(),
+      values.end(),
+      output.begin(),
+      std::multiplies<>{}));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((std::vector<int>{3, 3, 12, 12, 60}), output);
+}
+
+TEST(inclusive_scan, Cancellation) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000, 1);
+  std::vector<int> output(values.size(), 0);
+
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return unifex::inclusive_scan(
+            pool.get_scheduler(),
+            par,
+            values.begin(),
+            values.end(),
+            output.begin());
+      }));
+
+  EXPECT_FALSE(result.has_value());
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+struct count_calls {
+  int& calls;
+  void operator()() const noexcept { ++calls; }
+};
+
+using counting_callback = inplace_stop_callback<count_calls>;
+} // namespace
+
+TEST(inplace_stop_token, DeregisteredCallbacksAreNotCalled) {
+  inplace_stop_source source;
+  int calls = 0;
+  {
+    counting_callback callback{source.get_token(), count_calls{calls}};
+  }
+  EXPECT_FALSE(source.request_stop());
+  EXPECT_EQ(0, calls);
+}
+
+TEST(inplace_stop_token, RequestStopCallsEveryRegisteredCallback) {
+  inplace_stop_source source;
+  int calls = 0;
+  std::vector<std::optional<counting_callback>> callbacks(8);
+  for (auto& callback : callbacks) {
+    callback.emplace(source.get_token(), count_calls{calls});
+  }
+  // Deregister from the middle, the front and the back of the list.
+  callbacks[3].reset();
+  callbacks[0].reset();
+  callbacks[7].reset();
+
+  EXPECT_FALSE(source.request_stop());
+  EXPECT_EQ(5, calls);
+  EXPECT_TRUE(source.request_stop());
+  EXPECT_EQ(5, calls);
+}
+
+TEST(inplace_stop_token, DeregisteringInAnyOrderLeavesTheListEmpty) {
+  inplace_stop_source source;
+  int calls = 0;
+  for (int round = 0; round < 2; ++round) {
+    std::vector<std::optional<counting_callback>> callbacks(4);
+    for (auto& callback : callbacks) {
+      callback.emplace(source.get_token(), count_calls{calls});
+    }
+    if (round == 0) {
+      for (auto& callback : callbacks) {
+        callback.reset();
+      }
+    } else {
+      for (auto it = callbacks.rbegin(); it != callbacks.rend(); ++it) {
+        it->reset();
+      }
+    }
+  }
+  counting_callback callback{source.get_token(), count_calls{calls}};
+  source.request_stop();
+  EXPECT_EQ(1, calls);
+}
+
+TEST(inplace_stop_token, CallbackRegisteredAfterStopRunsInline) {
+  inplace_stop_source source;
+  source.request_stop();
+  int calls = 0;
+  counting_callback callback{source.get_token(), count_calls{calls}};
+  EXPECT_EQ(1, calls);
+}
+
+TEST(inplace_stop_token, CallbackCanDeregisterItself) {
+  struct destroy_self {
+    std::optional<inplace_stop_callback<destroy_self>>* self;
+    int* calls;
+    void operator()() const noexcept {
+      ++*calls;
+      self->reset();
+    }
+  };
+
+  inplace_stop_source source;
+  int calls = 0;
+  std::optional<inplace_stop_callback<destroy_self>> first;
+  std::optional<inplace_stop_callback<destroy_self>> second;
+  first.emplace(source.get_token(), destroy_self{&first, &calls});
+  second.emplace(source.get_token(), destroy_self{&second, &calls});
+  source.request_stop();
+  EXPECT_EQ(2, calls);
+  EXPECT_FALSE(first.has_value());
+  EXPECT_FALSE(second.has_value());
+}
+
+TEST(inplace_stop_token, CallbackCanDeregisterAnother) {
+  struct destroy_other {
+    std::optional<counting_callback>* other;
+    void operator()() const noexcept { other->reset(); }
+  };
+
+  inplace_stop_source source;
+  int calls = 0;
+  std::optional<counting_callback> first;
+  first.emplace(source.get_token(), count_calls{calls});
+  // Registered last, so it runs first.
+  inplace_stop_callback<destroy_other> second{
+      source.get_token(), destroy_other{&first}};
+  source.request_stop();
+  EXPECT_EQ(0, calls);
+}
+
+TEST(inplace_stop_token, DeregisteringWaitsForCallbackOnAnotherThread) {
+  struct slow_callback {
+    std::atomic<bool>* started;
+    std::atomic<bool>* finished;
+    void operator()() const noexcept {
+      started->store(true);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      finished->store(true);
+    }
+  };
+
+  inplace_stop_source source;
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  auto callback = std::make_unique<inplace_stop_callback<slow_callback>>(
+      source.get_token(), slow_callback{&started, &finished});
+  std::thread t{[&] { source.request_stop(); }};
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  callback.reset();
+  EXPECT_TRUE(finished.load());
+  t.join();
+}
+
+TEST(inplace_stop_token, ConcurrentRegistrationAndStop) {
+  for (int round = 0; round < 20; ++round) {
+    inplace_stop_source source;
+    std::atomic<int> calls{0};
+    struct count_atomic {
+      std::atomic<int>* calls;
+      void operator()() const noexcept { ++*calls; }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < 200; ++j) {
+          inplace_stop_callback<count_atomic> callback{
+              source.get_token(), count_atomic{&calls}};
+        }
+      });
+    }
+    source.request_stop();
+    for (auto& t : threads) {
+      t.join();
+    }
+    EXPECT_TRUE(source.stop_requested());
+  }
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/config.hpp>
+
+#if !UNIFEX_NO_LIBURING
+
+#include <unifex/linux/io_uring_context.hpp>
+
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/io_concepts.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/restart.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/span.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace unifex;
+using namespace unifex::linuxos;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct IOUringTransferAllTest : testing::Test {
+  IOUringTransferAllTest() {
+    EXPECT_NE(-1, pipe(pipes_));
+  }
+
+  ~IOUringTransferAllTest() {
+    stopSource_.request_stop();
+    io_.join();
+    close(pipes_[0]);
+    close(pipes_[1]);
+    if (path_[0] != '\0') {
+      unlink(path_);
+    }
+  }
+
+  std::string pipe_path(int fd) const {
+    return "/proc/self/fd/" + std::to_string(fd);
+  }
+
+  // Creates an empty temporary file and returns its path.
+  const char* temp_path() {
+    const int fd = mkstemp(path_);
+    EXPECT_NE(-1, fd);
+    close(fd);
+    return path_;
+  }
+
+  void write_to_pipe(const std::string& text) {
+    ASSERT_EQ(
+        static_cast<ssize_t>(text.size()),
+        ::write(pipes_[1], text.data(), text.size()));
+  }
+
+  int pipes_[2];
+  char path_[32] = "/tmp/unifex_transfer_all_XXXXXX";
+  io_uring_context ctx_;
+  inplace_stop_source stopSource_;
+  std::thread io_{[this] { ctx_.run(stopSource_.get_token()); }};
+};
+
+struct sink {
+  void set_value(...) noexcept {}
+  void set_error(...) noexcept {}
+  void set_done() noexcept {}
+};
+
+// Drops the values of Sender so that it can be repeated, and keeps its
+// operation restartable so that repeat_effect_until() reuses it.
+template <typename Sender>
+struct discard_values {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<>>;
+
+  template <template <typename...> class Variant>
+  using error_types = sender_error_types_t<Sender, Variant>;
+
+  static constexpr bool sends_done = sender_traits<Sender>::sends_done;
+
+  template <typename Receiver>
+  struct operation {
+    struct inner_receiver {
+      template <typename... Values>
+      void set_value(Values&&...) && noexcept {
+        unifex::set_value(std::move(op_->receiver_));
+      }
+
+      template <typename Error>
+      void set_error(Error&& error) && noexcept {
+        unifex::set_error(std::move(op_->receiver_), (Error &&) error);
+      }
+
+      void set_done() && noexcept {
+        unifex::set_done(std::move(op_->receiver_));
+      }
+
+      friend auto tag_invoke(
+          tag_t<get_stop_token>, const inner_receiver& r) noexcept {
+        return get_stop_token(r.op_->receiver_);
+      }
+
+      operation* op_;
+    };
+
+    operation(Sender& sender, Receiver&& receiver)
+      : receiver_(std::move(receiver))
+      , inner_(unifex::connect(sender, inner_receiver{this})) {}
+
+    void start() noexcept { unifex::start(inner_); }
+
+    void restart() noexcept { unifex::restart(inner_); }
+
+    Receiver receiver_;
+    connect_result_t<Sender&, inner_receiver> inner_;
+  };
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) & {
+    return {sender_, (Receiver &&) r};
+  }
+
+  Sender sender_;
+};
+
+template <typename Sender>
+discard_values(Sender) -> discard_values<Sender>;
+
+} // namespace
+
+TEST_F(IOUringTransferAllTest, ReadsExactlyAcrossShortReads) {
+  auto in = open_file_read_only(ctx_.get_scheduler(), pipe_path(pipes_[0]));
+  std::thread writer{[this] {
+    write_to_pipe("hello");
+    std::this_thread::sleep_for(20ms);
+    write_to_pipe(", world");
+  }};
+
+  char buffer[12] = {};
+  auto read = sync_wait(async_read_exactly_at(
+      in, -1, as_writable_bytes(span{buffer, sizeof(buffer)})));
+  writer.join();
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(12, *read);
+  EXPECT_EQ("hello, world", std::string(buffer, sizeof(buffer)));
+}
+
+TEST_F(IOUringTransferAllTest, ReadIsShortOnlyAtTheEndOfTheFile) {
+  const char* path = temp_path();
+  auto file = open_file_read_write(ctx_.get_scheduler(), path);
+  const std::string text(100000, 'x');
+  auto written = sync_wait(
+      async_write_all_at(file, 0, as_bytes(span{text.data(), text.size()})));
+  ASSERT_TRUE(written.has_value());
+  EXPECT_EQ(100000, *written);
+
+  std::string buffer(200000, '\0');
+  auto read = sync_wait(async_read_exactly_at(
+      file, 50000, as_writable_bytes(span{buffer.data(), buffer.size()})));
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(50000, *read);
+  EXPECT_EQ(text.substr(50000), buffer.substr(0, 50000));
+}
+
+TEST_F(IOUringTransferAllTest, RepeatedReadStartsFromTheBeginningEachTime) {
+  const char* path = temp_path();
+  auto file = open_file_read_write(ctx_.get_scheduler(), path);
+  const std::string text = "0123456789";
+  ASSERT_TRUE(
+      sync_wait(async_write_all_at(file, 0, as_bytes(span{text.data(), 10}))));
+
+  // Each read reaches the end of the file part-way through the buffer, so
+  // it is resubmitted once; restarting it must undo that progress.
+  char buffer[16];
+  std::vector<std::string> reads;
+  auto read = async_read_exactly_at(
+      file, 4, as_writable_bytes(span{buffer, sizeof(buffer)}));
+  static_assert(is_restartable_v<connect_result_t<decltype(read)&, sink>>);
+
+  sync_wait(repeat_effect_until(discard_values{read}, [&]() noexcept {
+    reads.emplace_back(buffer, 6);
+    std::fill(std::begin(buffer), std::end(buffer), '\0');
+    return reads.size() == 3;
+  }));
+
+  EXPECT_EQ(std::vector<std::string>(3, "456789"), reads);
+}
+
+TEST_F(IOUringTransferAllTest, StopsPartWayThrough) {
+  auto sched = ctx_.get_scheduler();
+  auto in = open_file_read_only(sched, pipe_path(pipes_[0]));
+  write_to_pipe("part");
+
+  char buffer[8] = {};
+  auto read = sync_wait(stop_when(
+      async_read_exactly_at(
+          in, -1, as_writable_bytes(span{buffer, sizeof(buffer)})),
+      schedule_at(sched, now(sched) + 50ms)));
+
+  EXPECT_FALSE(read.has_value());
+  EXPECT_EQ("part", std::string(buffer, 4));
+}
+
+#endif // !UNIFEX_NO_LIBURING
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/config.hpp>
+
+#if defined(__linux__)
+
+#include <unifex/linux/mapped_chunk_stream.hpp>
+#include <unifex/linux/mapped_file.hpp>
+
+#include <unifex/reduce_stream.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace unifex;
+using namespace unifex::linuxos;
+
+namespace {
+struct MappedFileTest : testing::Test {
+  void SetUp() override {
+    char name[] = "/tmp/unifex_mapped_file_XXXXXX";
+    int fd = ::mkstemp(name);
+    ASSERT_NE(fd, -1);
+    path_ = name;
+    contents_.resize(3 * page_size() + 123);
+    for (std::size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<char>(i * 7 + i / 251);
+    }
+    ASSERT_EQ(
+        ::write(fd, contents_.data(), contents_.size()),
+        static_cast<ssize_t>(contents_.size()));
+    ::close(fd);
+  }
+
+  void TearDown() override { ::unlink(path_.c_str()); }
+
+  void expect_contents(
+      span<const std::byte> bytes, std::size_t offset, std::size_t size) {
+    ASSERT_EQ(size, bytes.size());
+    EXPECT_EQ(
+        0, std::memcmp(bytes.data(), contents_.data() + offset, size));
+  }
+
+  std::string path_;
+  std::vector<char> contents_;
+  single_thread_context thread_;
+};
+} // namespace
+
+TEST_F(MappedFileTest, MapsTheWholeFileOnTheScheduler) {
+  auto file = sync_wait(async_map_file(
+      thread_.get_scheduler(), path_, {}, map_advice{true, true, false}));
+  ASSERT_TRUE(file.has_value());
+  expect_contents(file->bytes(), 0, contents_.size());
+  EXPECT_EQ(0u, file->page_offset());
+}
+
+TEST_F(MappedFileTest, MapsARangeThatStartsPartWayIntoAPage) {
+  mapped_file file{path_, file_range{100, 2 * page_size()}};
+  expect_contents(file.bytes(), 100, 2 * page_size());
+  EXPECT_EQ(100u, file.page_offset());
+  file.advise(map_advice{true, true, false}, 10, 50);
+}
+
+TEST_F(MappedFileTest, IgnoresHintsThatTheKernelRejects) {
+  // Whether or not this kernel has transparent huge pages, the mapping is
+  // made.
+  mapped_file file{path_, {}, map_advice{true, true, true}};
+  expect_contents(file.bytes(), 0, contents_.size());
+}
+
+TEST_F(MappedFileTest, CutsTheRangeShortAtTheEndOfTheFile) {
+  mapped_file file{path_, file_range{contents_.size() - 10, 1000}};
+  expect_contents(file.bytes(), contents_.size() - 10, 10);
+
+  mapped_file empty{path_, file_range{contents_.size()}};
+  EXPECT_EQ(0u, empty.size());
+}
+
+TEST_F(MappedFileTest, ReportsErrors) {
+  EXPECT_THROW(
+      (mapped_file{path_, file_range{contents_.size() + 1}}),
+      std::system_error);
+  EXPECT_THROW(
+      sync_wait(async_map_file(thread_.get_scheduler(), path_ + ".missing")),
+      std::system_error);
+}
+
+TEST_F(MappedFileTest, ChunkStreamSendsPageAlignedChunks) {
+  mapped_file file{path_, file_range{100}};
+  auto chunks = sync_wait(reduce_stream(
+      mapped_chunk_stream{file, page_size() + 1, 1},
+      std::vector<span<const std::byte>>{},
+      [](auto chunks, span<const std::byte> chunk) {
+        chunks.push_back(chunk);
+        return chunks;
+      }));
+  ASSERT_TRUE(chunks.has_value());
+
+  // Chunks round up to two pages and the first one stops at the first
+  // boundary after the start of the mapping.
+  const std::size_t page = page_size();
+  ASSERT_EQ(2u, chunks->size());
+  expect_contents((*chunks)[0], 100, 2 * page - 100);
+  expect_contents((*chunks)[1], 2 * page, page + 123);
+  EXPECT_EQ(
+      0u, reinterpret_cast<std::uintptr_t>((*chunks)[1].data()) % page);
+}
+
+TEST_F(MappedFileTest, ChunkStreamOfAnEmptyMappingIsEmpty) {
+  mapped_file file{path_, file_range{0, 0}};
+  auto count = sync_wait(reduce_stream(
+      mapped_chunk_stream{file},
+      0,
+      [](int count, span<const std::byte>) { return count + 1; }));
+  ASSERT_TRUE(count.has_value());
+  EXPECT_EQ(0, *count);
+}
+
+#endif // defined(__linux__)
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detach_on_cancel.hpp>
+#include <unifex/finally.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/just.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/let_value_with.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/materialize.hpp>
+#include <unifex/range_stream.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/sequence.hpp>
+#include <unifex/stop_immediately.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/type_erased_stream.hpp>
+#include <unifex/when_all.hpp>
+#include <unifex/when_any.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <exception>
+#include <string>
+
+// Reports sizeof(connect_result_t<...>) for representative pipelines and
+// checks it against a budget, so that growth in an operation state shows
+// up as a test failure. Each size is recorded as a test property, so it
+// is also in the --gtest_output=xml/json report.
+//
+// Budgets are in pointer-sized words for a 64-bit GCC or Clang build.
+// Other compilers only report the sizes.
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A receiver the size of a pointer, like most real receivers.
+struct pointer_receiver {
+  void* context_;
+
+  template <typename... Values>
+  void set_value(Values&&...) noexcept {}
+  void set_error(std::exception_ptr) noexcept {}
+  void set_done() noexcept {}
+};
+
+template <typename Sender>
+void check_size(const Sender&, std::size_t budgetWords) {
+  const std::size_t size = sizeof(connect_result_t<Sender, pointer_receiver>);
+  ::testing::Test::RecordProperty("op_state_bytes", std::to_string(size));
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+  if (sizeof(void*) == 8) {
+    EXPECT_LE(size, budgetWords * sizeof(void*));
+  }
+#else
+  (void)size;
+  (void)budgetWords;
+#endif
+}
+
+// A stop token that never asks to stop, but whose type doesn't say so, so
+// adaptors have to make room for its (empty) callback.
+struct opaque_unstoppable_token {
+  template <typename F>
+  struct callback_type {
+    explicit callback_type(opaque_unstoppable_token, F&&) noexcept {}
+  };
+
+  bool stop_requested() const noexcept { return false; }
+  bool stop_possible() const noexcept { return false; }
+};
+
+struct opaque_stop_receiver : pointer_receiver {
+  friend opaque_unstoppable_token
+  tag_invoke(tag_t<get_stop_token>, const opaque_stop_receiver&) noexcept {
+    return {};
+  }
+};
+
+// Checks that an adaptor elides the stop callback, and any state that only
+// serves it, for a receiver that can never be asked to stop.
+template <typename Sender>
+void check_stop_elided(Sender&&) {
+  EXPECT_LT(
+      sizeof(connect_result_t<Sender, pointer_receiver>),
+      sizeof(connect_result_t<Sender, opaque_stop_receiver>));
+}
+
+auto plus_one() {
+  return [](int x) { return x + 1; };
+}
+
+}  // namespace
+
+TEST(OperationStateSize, Just) {
+  check_size(just(1), 2);
+}
+
+TEST(OperationStateSize, Then) {
+  check_size(then(then(just(1), plus_one()), plus_one()), 4);
+}
+
+TEST(OperationStateSize, LetValue) {
+  check_size(let_value(just(1), [](int& x) { return just(x); }), 6);
+}
+
+TEST(OperationStateSize, NestedLetValue) {
+  check_size(
+      let_value(
+          just(1),
+          [](int& a) {
+            return let_value(just(a), [](int& b) {
+              return let_value(just(b), [](int& c) { return just(c); });
+            });
+          }),
+      14);
+}
+
+TEST(OperationStateSize, LetValueWith) {
+  check_size(
+      let_value_with([] { return 42; }, [](int& x) { return just(x); }), 3);
+}
+
+TEST(OperationStateSize, LetValueWithStopSource) {
+  check_size(
+      let_value_with_stop_source([](inplace_stop_source&) { return just(); }),
+      7);
+}
+
+TEST(OperationStateSize, Finally) {
+  check_size(finally(just(1), just()), 6);
+}
+
+TEST(OperationStateSize, StopWhen) {
+  check_size(stop_when(just(1), just()), 10);
+}
+
+TEST(OperationStateSize, Sequence) {
+  check_size(sequence(just(), just(), just(1)), 8);
+}
+
+TEST(OperationStateSize, RepeatEffectUntil) {
+  check_size(repeat_effect_until(just(), [] { return true; }), 5);
+}
+
+TEST(OperationStateSize, Materialize) {
+  check_size(materialize(just(1)), 2);
+}
+
+TEST(OperationStateSize, WhenAll2) {
+  check_size(when_all(just(1), just(2)), 13);
+}
+
+TEST(OperationStateSize, WhenAll8) {
+  check_size(
+      when_all(
+          just(1), just(2), just(3), just(4),
+          just(5), just(6), just(7), just(8)),
+      31);
+}
+
+TEST(OperationStateSize, WhenAny2) {
+  check_size(when_any(just(1), just(2)), 15);
+}
+
+TEST(OperationStateSize, ScheduleAfter) {
+  timed_single_thread_context context;
+  check_size(schedule_after(context.get_scheduler(), 1ms), 8);
+}
+
+TEST(OperationStateSize, StopWhenScheduleAfter) {
+  timed_single_thread_context context;
+  auto sched = context.get_scheduler();
+  check_size(
+      stop_when(
+          then(schedule_after(sched, 1s), [] { return 1; }),
+          schedule_after(sched, 1ms)),
+      35);
+}
+
+TEST(OperationStateSize, UnstoppableReceiversHaveNoStopCallback) {
+  check_stop_elided(stop_when(just(1), just()));
+  check_stop_elided(when_all(just(1), just(2)));
+  check_stop_elided(
+      let_value_with_stop_source([](inplace_stop_source&) { return just(); }));
+  check_stop_elided(detach_on_cancel(just(1)));
+
+  auto untilStream = take_until(range_stream{0, 3}, range_stream{0, 1});
+  check_stop_elided(next(untilStream));
+  auto immediateStream = stop_immediately<int>(range_stream{0, 3});
+  check_stop_elided(next(immediateStream));
+  auto erasedStream = type_erase<int>(range_stream{0, 3});
+  check_stop_elided(next(erasedStream));
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "allocation_counter.hpp"
+
+#include <unifex/recycling_allocator.hpp>
+
+#include <unifex/just.hpp>
+#include <unifex/just_from.hpp>
+#include <unifex/spawn_detached.hpp>
+#include <unifex/spawn_future.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/v2/async_scope.hpp>
+#include <unifex/when_all.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+static_assert(unifex::is_allocator_v<unifex::recycling_allocator<int>>);
+
+struct big {
+  char bytes[200];
+};
+
+TEST(recycling_allocator_test, freed_blocks_are_reused) {
+  unifex::recycling_allocator<big> alloc;
+
+  big* first = alloc.allocate(1);
+  alloc.deallocate(first, 1);
+
+  big* second = alloc.allocate(1);
+  EXPECT_EQ(first, second);
+  alloc.deallocate(second, 1);
+
+  unifex::trim_recycled_memory();
+}
+
+TEST(recycling_allocator_test, rebound_allocators_share_size_classes) {
+  struct same_size {
+    char bytes[sizeof(big)];
+  };
+
+  unifex::recycling_allocator<big> alloc;
+  unifex::recycling_allocator<same_size> other{alloc};
+
+  big* first = alloc.allocate(1);
+  alloc.deallocate(first, 1);
+
+  same_size* second = other.allocate(1);
+  EXPECT_EQ(static_cast<void*>(first), static_cast<void*>(second));
+  other.deallocate(second, 1);
+
+  EXPECT_TRUE(alloc == other);
+  EXPECT_FALSE(alloc != other);
+
+  unifex::trim_recycled_memory();
+}
+
+TEST(recycling_allocator_test, array_allocations_bypass_the_cache) {
+  unifex::recycling_allocator<int> alloc;
+
+  int* p = alloc.allocate(100);
+  for (int i = 0; i < 100; ++i) {
+    p[i] = i;
+  }
+  alloc.deallocate(p, 100);
+}
+
+TEST(recycling_allocator_test, trim_releases_cached_blocks) {
+  unifex::recycling_allocator<big> alloc;
+
+  std::vector<big*> blocks;
+  for (int i = 0; i < 10; ++i) {
+    blocks.push_back(alloc.allocate(1));
+  }
+  for (auto* b : blocks) {
+    alloc.deallocate(b, 1);
+  }
+
+  unifex::trim_recycled_memory();
+
+  // the cache is empty so this has to be a fresh allocation, but we can't
+  // observe that portably; just check that allocation still works
+  big* p = alloc.allocate(1);
+  EXPECT_NE(nullptr, p);
+  alloc.deallocate(p, 1);
+
+  unifex::trim_recycled_memory();
+}
+
+TEST(recycling_allocator_test, spawn_detached_recycles_operation_states) {
+  unifex::v2::async_scope scope;
+
+  int count = 0;
+  auto spawn = [&] {
+    unifex::spawn_detached(
+        unifex::just_from([&]() noexcept { ++count; }),
+        scope,
+        unifex::recycling_allocator<std::byte>{});
+  };
+
+  // the first operation state comes from the global heap and is cached
+  // when it completes; every later one reuses it
+  spawn();
+  unifex_test::allocation_scope allocations;
+  for (int i = 1; i < 1000; ++i) {
+    spawn();
+  }
+  EXPECT_EQ(0u, allocations.allocations());
+  EXPECT_EQ(0u, allocations.deallocations());
+
+  unifex::sync_wait(scope.join());
+
+  EXPECT_EQ(1000, count);
+
+  unifex::trim_recycled_memory();
+}
+
+TEST(recycling_allocator_test, spawn_future_recycles_operation_states) {
+  unifex::v2::async_scope scope;
+
+  int sum = 0;
+  auto spawnAndWait = [&](int i) {
+    auto fut = unifex::spawn_future(
+        unifex::just(i), scope, unifex::recycling_allocator<std::byte>{});
+
+    auto result = unifex::sync_wait(std::move(fut));
+    ASSERT_TRUE(result.has_value());
+    sum += *result;
+  };
+
+  // as above, only the first operation state touches the global heap
+  spawnAndWait(0);
+  unifex_test::allocation_scope allocations;
+  for (int i = 1; i < 100; ++i) {
+    spawnAndWait(i);
+  }
+  EXPECT_EQ(0u, allocations.allocations());
+  EXPECT_EQ(0u, allocations.deallocations());
+
+  unifex::sync_wait(scope.join());
+
+  EXPECT_EQ(4950, sum);
+
+  unifex::trim_recycled_memory();
+}
+
+TEST(recycling_allocator_test, blocks_may_be_freed_on_other_threads) {
+  unifex::static_thread_pool pool{2};
+  unifex::v2::async_scope scope;
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 1000; ++i) {
+    unifex::spawn_detached(
+        unifex::schedule(pool.get_scheduler()) |
+            unifex::then([&]() noexcept { ++count; }),
+        scope,
+        unifex::recycling_allocator<std::byte>{});
+  }
+
+  unifex::sync_wait(scope.join());
+
+  // the pool's threads drain their caches when they exit
+  EXPECT_EQ(1000, count.load());
+}
+
+// Constructed before the thread's recycling cache, so it's destroyed after
+// the cache has been drained and can count what the thread freed on exit.
+struct exit_probe {
+  ~exit_probe() { freedOnExit = scope_.deallocations(); }
+
+  void reset() noexcept { scope_ = {}; }
+
+  static inline std::size_t freedOnExit = 0;
+  unifex_test::allocation_scope scope_;
+};
+
+// Returns how many blocks a thread frees on exit after allocating and
+// deallocating a single block with Allocator.
+template <typename Allocator>
+std::size_t freed_on_exit() {
+  std::thread t{[] {
+    static thread_local exit_probe probe;
+    Allocator alloc;
+    alloc.deallocate(alloc.allocate(1), 1);
+    probe.reset();
+  }};
+  t.join();
+  return exit_probe::freedOnExit;
+}
+
+TEST(recycling_allocator_test, threads_drain_their_caches_on_exit) {
+  // the thread's own bookkeeping is freed on exit either way; the recycled
+  // block is cached rather than freed until the thread exits
+  EXPECT_EQ(
+      freed_on_exit<std::allocator<big>>() + 1,
+      freed_on_exit<unifex::recycling_allocator<big>>());
+}
+
+}  // namespace
@@ -15,12 +15,21 @@
  */
 #include <unifex/reduce_stream.hpp>
 
+#include <unifex/batch_stream.hpp>
+#include <unifex/execution_policy.hpp>
+#include <unifex/static_thread_pool.hpp>
 #include <unifex/sync_wait.hpp>
 #include <unifex/transform_stream.hpp>
 #include <unifex/then.hpp>
 #include <unifex/range_stream.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <stdexcept>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -57,3 +66,123 @@ TEST(reduce_stream, Pipeable) {
   EXPECT_EQ(finalResult, 285);
   std::printf("result = %i\n", finalResult);
 }
+
+TEST(reduce_stream, ParallelRangeUsesEveryWorker) {
+  static_thread_pool pool{4};
+
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  auto result = range_stream{0, 1 << 20}
+    | reduce_stream(
+        std::int64_t{7},
+        [&](std::int64_t state, std::int64_t value) {
+          if ((value & 0xffff) == 1) {
+            {
+              std::lock_guard lock{mutex};
+              threads.insert(std::this_thread::get_id());
+            }
+            // Give the other workers a chance to claim some chunks.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+          return state + value;
+        },
+        par,
+        pool.get_scheduler())
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(7 + (std::int64_t{1} << 20) * ((1 << 20) - 1) / 2, *result);
+  EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(reduce_stream, ParallelEmptyRangeSendsInitialState) {
+  static_thread_pool pool{2};
+
+  auto result = sync_wait(reduce_stream(
+      range_stream{5, 5},
+      42,
+      [](int state, int value) { return state + value; },
+      par,
+      pool.get_scheduler()));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(42, *result);
+}
+
+TEST(reduce_stream, ParallelFoldsEachBatch) {
+  static_thread_pool pool{4};
+
+  auto result = range_stream{0, 100000}
+    | transform_stream([](int value) { return double(value); })
+    | batch_stream(10000)
+    | reduce_stream(
+        0.0,
+        [](double state, double value) { return state + value; },
+        par_unseq,
+        pool.get_scheduler())
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(4999950000.0, *result);
+}
+
+TEST(reduce_stream, ParallelFallsBackToSequentialForScalarStreams) {
+  static_thread_pool pool{2};
+
+  auto result = range_stream{0, 10}
+    | transform_stream([](int value) { return value * value; })
+    | reduce_stream(
+        0,
+        [](int state, int value) { return state + value; },
+        par,
+        pool.get_scheduler())
+    | sync_wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(285, *result);
+}
+
+namespace {
+// Looks like an indexed stream but hasn't opted in, so its values must be
+// pulled with next().
+struct lookalike_stream : range_stream {
+  using range_stream::range_stream;
+
+  std::size_t remaining() const noexcept { return 1; }
+  int value_at(std::size_t) const noexcept { return -1; }
+};
+} // namespace
+
+TEST(reduce_stream, ParallelOnlyReducesOptedInStreamsByIndex) {
+  static_assert(enable_indexed_stream<range_stream>);
+  static_assert(!enable_indexed_stream<lookalike_stream>);
+  static_thread_pool pool{2};
+
+  auto result = sync_wait(reduce_stream(
+      lookalike_stream{0, 1000},
+      0,
+      [](int state, int value) { return state + value; },
+      par,
+      pool.get_scheduler()));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(499500, *result);
+}
+
+TEST(reduce_stream, ParallelErrorsPropagate) {
+  static_thread_pool pool{4};
+
+  EXPECT_THROW(
+      sync_wait(reduce_stream(
+          range_stream{0, 100000},
+          0L,
+          [](long state, long value) {
+            if (value == 54321) {
+              throw std::runtime_error("boom");
+            }
+            return state + value;
+          },
+          par,
+          pool.get_scheduler())),
+      std::runtime_error);
+}
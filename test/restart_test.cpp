@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/restart.hpp>
+
+#include <unifex/just.hpp>
+#include <unifex/repeat_effect_until.hpp>
+#include <unifex/retry_when.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <exception>
+#include <string>
+#include <type_traits>
+
+using namespace unifex;
+
+namespace {
+
+struct sink {
+  void set_value(...) noexcept {}
+  void set_error(std::exception_ptr) noexcept {}
+  void set_done() noexcept {}
+};
+
+static_assert(is_restartable_v<connect_result_t<decltype(just()), sink>>);
+static_assert(is_restartable_v<connect_result_t<decltype(just(42)), sink>>);
+static_assert(
+    !is_restartable_v<connect_result_t<decltype(just(std::string{})), sink>>);
+static_assert(is_restartable_v<connect_result_t<
+                  schedule_result_t<static_thread_pool::scheduler>,
+                  sink>>);
+
+struct counters {
+  int connects = 0;
+  int starts = 0;
+  int restarts = 0;
+};
+
+// A sender that completes inline with set_value(), or with set_error() for
+// its first `failures` starts, and that records connect/start/restart calls.
+template <bool Restartable>
+struct counting_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  static constexpr bool sends_done = false;
+
+  template <typename Receiver>
+  struct operation {
+    void start() noexcept {
+      if (counters_->starts++ < failures_) {
+        unifex::set_error(
+            static_cast<Receiver&&>(receiver_),
+            std::make_exception_ptr(42));
+      } else {
+        unifex::set_value(static_cast<Receiver&&>(receiver_));
+      }
+    }
+
+    template <bool R = Restartable, std::enable_if_t<R, int> = 0>
+    void restart() noexcept {
+      ++counters_->restarts;
+    }
+
+    counters* counters_;
+    int failures_;
+    Receiver receiver_;
+  };
+
+  template <typename Receiver>
+  operation<remove_cvref_t<Receiver>> connect(Receiver&& r) {
+    ++counters_->connects;
+    return {counters_, failures_, static_cast<Receiver&&>(r)};
+  }
+
+  counters* counters_;
+  int failures_ = 0;
+};
+
+template <bool Restartable>
+auto repeat_n(counters& c, int n) {
+  return repeat_effect_until(
+      counting_sender<Restartable>{&c}, [&c, n]() noexcept {
+        return c.starts == n;
+      });
+}
+
+template <bool Restartable>
+auto retry_n(counters& c, int failures) {
+  return retry_when(
+      counting_sender<Restartable>{&c, failures},
+      [](std::exception_ptr) noexcept { return just(); });
+}
+
+}  // namespace
+
+TEST(restart, repeat_effect_until_restarts_restartable_operations) {
+  counters c;
+  sync_wait(repeat_n<true>(c, 10));
+
+  EXPECT_EQ(1, c.connects);
+  EXPECT_EQ(10, c.starts);
+  EXPECT_EQ(9, c.restarts);
+}
+
+TEST(restart, repeat_effect_until_reconnects_other_operations) {
+  counters c;
+  sync_wait(repeat_n<false>(c, 10));
+
+  EXPECT_EQ(10, c.connects);
+  EXPECT_EQ(10, c.starts);
+  EXPECT_EQ(0, c.restarts);
+}
+
+TEST(restart, retry_when_restarts_restartable_operations) {
+  counters c;
+  sync_wait(retry_n<true>(c, 5));
+
+  EXPECT_EQ(1, c.connects);
+  EXPECT_EQ(6, c.starts);
+  EXPECT_EQ(5, c.restarts);
+}
+
+TEST(restart, retry_when_reconnects_other_operations) {
+  counters c;
+  sync_wait(retry_n<false>(c, 5));
+
+  EXPECT_EQ(6, c.connects);
+  EXPECT_EQ(6, c.starts);
+  EXPECT_EQ(0, c.restarts);
+}
+
+TEST(restart, repeat_effect_until_restarts_just) {
+  int count = 0;
+  sync_wait(repeat_effect_until(just(), [&]() noexcept { return ++count == 100; }));
+
+  EXPECT_EQ(100, count);
+}
+
+TEST(restart, repeat_effect_until_restarts_thread_pool_schedule) {
+  static_thread_pool pool{2};
+  std::atomic<int> count{0};
+
+  sync_wait(repeat_effect_until(
+      schedule(pool.get_scheduler()), [&]() noexcept { return ++count == 100; }));
+
+  EXPECT_EQ(100, count.load());
+}
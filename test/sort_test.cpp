@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/sort.hpp>
+
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+std::vector<int> shuffled(std::size_t size) {
+  std::vector<int> values(size);
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<int> dist{0, 1000};
+  for (auto& value : values) {
+    value = dist(rng);
+  }
+  return values;
+}
+} // namespace
+
+TEST(sort, Parallel) {
+  static_thread_pool pool{4};
+  // Not a power of two chunks, so that some runs have no sibling.
+  for (std::size_t size : {0, 1, 100, 2048 * 5 + 7, 100'000}) {
+    auto values = shuffled(size);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    auto result = sync_wait(unifex::sort(
+        pool.get_scheduler(), par, values.begin(), values.end()));
+
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(expected, values);
+  }
+}
+
+TEST(sort, SequencedWithComparator) {
+  auto values = shuffled(10'000);
+  auto expected = values;
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+
+  auto result = sync_wait(unifex::sort(
+      inline_scheduler{}, seq, values.begin(), values.end(), std::greater<>{}));
+
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ(expected, values);
+}
+
+TEST(sort, ComparatorExceptionIsSent) {
+  static_thread_pool pool{4};
+  auto values = shuffled(100'000);
+
+  EXPECT_THROW(
+      sync_wait(unifex::sort(
+          pool.get_scheduler(),
+          par,
+          values.begin(),
+          values.end(),
+          [](int a, int b) {
+            if (a == 500 || b == 500) {
+              throw std::runtime_error("boom");
+            }
+            return a < b;
+          })),
+      std::runtime_error);
+}
+
+TEST(sort, Cancellation) {
+  static_thread_pool pool{4};
+  auto values = shuffled(100'000);
+
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return unifex::sort(
+            pool.get_scheduler(), par, values.begin(), values.end());
+      }));
+
+  EXPECT_FALSE(result.has_value());
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/config.hpp>
+
+#if defined(__linux__)
+
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/copy_file_range.hpp>
+#include <unifex/linux/io_epoll_context.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/linux/sendfile_stream.hpp>
+#include <unifex/reduce_stream.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/splice_concepts.hpp>
+#include <unifex/stop_when.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace unifex;
+using namespace unifex::linuxos;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct temp_file {
+  temp_file() {
+    fd_ = mkstemp(path_);
+    EXPECT_NE(-1, fd_);
+  }
+
+  ~temp_file() {
+    close(fd_);
+    unlink(path_);
+  }
+
+  std::string contents() const {
+    std::string text(static_cast<std::size_t>(lseek(fd_, 0, SEEK_END)), '\0');
+    EXPECT_EQ(
+        static_cast<ssize_t>(text.size()),
+        pread(fd_, text.data(), text.size(), 0));
+    return text;
+  }
+
+  char path_[32] = "/tmp/unifex_splice_XXXXXX";
+  int fd_;
+};
+
+struct pipe_fds {
+  pipe_fds() { EXPECT_EQ(0, pipe2(fds_, O_CLOEXEC | O_NONBLOCK)); }
+
+  ~pipe_fds() {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  int read_end() const { return fds_[0]; }
+  int write_end() const { return fds_[1]; }
+
+  void write(const std::string& text) const {
+    ASSERT_EQ(
+        static_cast<ssize_t>(text.size()),
+        ::write(write_end(), text.data(), text.size()));
+  }
+
+  std::string read(std::size_t size) const {
+    std::string text(size, '\0');
+    const ssize_t result = ::read(read_end(), text.data(), size);
+    text.resize(result < 0 ? 0 : static_cast<std::size_t>(result));
+    return text;
+  }
+
+  int fds_[2];
+};
+
+std::string make_text(std::size_t size) {
+  std::string text(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    text[i] = static_cast<char>('a' + i % 26);
+  }
+  return text;
+}
+
+template <typename Context>
+struct SpliceTest : testing::Test {
+  ~SpliceTest() {
+    stopSource_.request_stop();
+    io_.join();
+  }
+
+  Context ctx_;
+  inplace_stop_source stopSource_;
+  std::thread io_{[this] { ctx_.run(stopSource_.get_token()); }};
+};
+
+#if !UNIFEX_NO_LIBURING && !UNIFEX_NO_EPOLL
+using Contexts = testing::Types<io_uring_context, io_epoll_context>;
+#elif !UNIFEX_NO_LIBURING
+using Contexts = testing::Types<io_uring_context>;
+#else
+using Contexts = testing::Types<io_epoll_context>;
+#endif
+
+} // namespace
+
+TYPED_TEST_SUITE(SpliceTest, Contexts);
+
+TYPED_TEST(SpliceTest, TeesThenSplicesBetweenPipes) {
+  auto sched = this->ctx_.get_scheduler();
+  pipe_fds in;
+  pipe_fds copy;
+  pipe_fds out;
+  in.write("hello");
+
+  auto teed = sync_wait(
+      async_tee(sched, in.read_end(), copy.write_end(), std::size_t(16)));
+  ASSERT_TRUE(teed.has_value());
+  EXPECT_EQ(5, *teed);
+
+  auto spliced = sync_wait(
+      async_splice(sched, in.read_end(), out.write_end(), std::size_t(16)));
+  ASSERT_TRUE(spliced.has_value());
+  EXPECT_EQ(5, *spliced);
+
+  EXPECT_EQ("hello", copy.read(16));
+  EXPECT_EQ("hello", out.read(16));
+}
+
+TYPED_TEST(SpliceTest, SpliceAllWaitsForTheRest) {
+  auto sched = this->ctx_.get_scheduler();
+  pipe_fds in;
+  pipe_fds out;
+  std::thread writer{[&] {
+    in.write("hello");
+    std::this_thread::sleep_for(20ms);
+    in.write(", world");
+  }};
+
+  auto spliced = sync_wait(async_splice_all(
+      sched, in.read_end(), out.write_end(), std::size_t(12)));
+  writer.join();
+
+  ASSERT_TRUE(spliced.has_value());
+  EXPECT_EQ(12, *spliced);
+  EXPECT_EQ("hello, world", out.read(16));
+}
+
+TYPED_TEST(SpliceTest, StopsWhileWaitingForInput) {
+  auto sched = this->ctx_.get_scheduler();
+  pipe_fds in;
+  pipe_fds out;
+
+  auto spliced = sync_wait(stop_when(
+      async_splice(sched, in.read_end(), out.write_end(), std::size_t(16)),
+      schedule_at(sched, now(sched) + 20ms)));
+
+  EXPECT_FALSE(spliced.has_value());
+}
+
+TYPED_TEST(SpliceTest, SendsAFileInChunks) {
+  temp_file from;
+  temp_file to;
+  const std::string text = make_text(200 * 1000);
+  ASSERT_EQ(
+      static_cast<ssize_t>(text.size()),
+      pwrite(from.fd_, text.data(), text.size(), 0));
+  lseek(from.fd_, 1000, SEEK_SET);
+
+  auto chunks = sync_wait(reduce_stream(
+      async_sendfile(
+          this->ctx_.get_scheduler(), from.fd_, to.fd_, 150 * 1000, 64 * 1024),
+      std::size_t(0),
+      [](std::size_t count, ssize_t size) {
+        EXPECT_GT(size, 0);
+        EXPECT_LE(size, 64 * 1024);
+        return count + 1;
+      }));
+
+  ASSERT_TRUE(chunks.has_value());
+  EXPECT_GE(*chunks, 3u);
+  EXPECT_EQ(text.substr(1000, 150 * 1000), to.contents());
+}
+
+TYPED_TEST(SpliceTest, SendFileSendsTheRestOfAChunkThatDidNotDrain) {
+  auto sched = this->ctx_.get_scheduler();
+  temp_file from;
+  const std::string text = make_text(3000);
+  ASSERT_EQ(
+      static_cast<ssize_t>(text.size()),
+      pwrite(from.fd_, text.data(), text.size(), 0));
+  pipe_fds out;
+  // Fill `out` so that the first chunk can't drain until it is read.
+  const auto filler = static_cast<std::size_t>(
+      fcntl(out.write_end(), F_GETPIPE_SZ));
+  out.write(std::string(filler, '-'));
+
+  auto stream = async_sendfile(sched, from.fd_, out.write_end());
+  auto first = sync_wait(
+      stop_when(stream.next(), schedule_at(sched, now(sched) + 20ms)));
+  EXPECT_FALSE(first.has_value());
+
+  std::string sent = out.read(filler + text.size()).substr(filler);
+  while (auto size = sync_wait(stream.next())) {
+    EXPECT_GT(*size, 0);
+    sent += out.read(static_cast<std::size_t>(*size));
+  }
+  EXPECT_EQ(text, sent);
+}
+
+TEST(CopyFileRange, CopiesARangeOnTheScheduler) {
+  temp_file from;
+  temp_file to;
+  const std::string text = make_text(10000);
+  ASSERT_EQ(
+      static_cast<ssize_t>(text.size()),
+      pwrite(from.fd_, text.data(), text.size(), 0));
+
+  single_thread_context thread;
+  auto copied = sync_wait(async_copy_file_range(
+      thread.get_scheduler(), from.fd_, 100, to.fd_, 0, 20000));
+
+  ASSERT_TRUE(copied.has_value());
+  EXPECT_EQ(9900u, *copied);
+  EXPECT_EQ(text.substr(100), to.contents());
+}
+
+TEST(CopyFileRange, ReportsErrors) {
+  single_thread_context thread;
+  EXPECT_THROW(
+      sync_wait(async_copy_file_range(thread.get_scheduler(), -1, 0, -1, 0, 1)),
+      std::system_error);
+}
+
+#endif // defined(__linux__)
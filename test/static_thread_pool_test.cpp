@@ -18,11 +18,17 @@
 #include <unifex/just.hpp>
 #include <unifex/on.hpp>
 #include <unifex/scheduler_concepts.hpp>
+#include <unifex/submission_batch.hpp>
 #include <unifex/sync_wait.hpp>
 #include <unifex/then.hpp>
 #include <unifex/when_all.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -62,3 +68,68 @@ TEST(StaticThreadPool, Smoke) {
 
   EXPECT_EQ(x, 3);
 }
+
+namespace {
+struct count_receiver {
+  std::atomic<int>* count;
+
+  void set_value() noexcept { ++*count; }
+  void set_error(std::exception_ptr) noexcept { std::terminate(); }
+  void set_done() noexcept { std::terminate(); }
+};
+} // anonymous namespace
+
+TEST(StaticThreadPool, SubmissionBatchDefersEnqueuesUntilDestroyed) {
+  static_thread_pool tpContext{2};
+  auto tp = tpContext.get_scheduler();
+  std::atomic<int> x = 0;
+
+  using op_t = connect_result_t<schedule_result_t<decltype(tp)>, count_receiver>;
+  std::vector<std::unique_ptr<op_t>> ops;
+
+  {
+    submission_batch batch;
+    for (int i = 0; i < 100; ++i) {
+      ops.emplace_back(new op_t(connect(schedule(tp), count_receiver{&x})));
+      start(*ops.back());
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(x, 0);
+  }
+
+  while (x.load() != 100) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(x, 100);
+}
+
+TEST(StaticThreadPool, NestedSubmissionBatchesSubmitWithTheOutermost) {
+  static_thread_pool tpContext{2};
+  auto tp = tpContext.get_scheduler();
+  std::atomic<int> x = 0;
+
+  using op_t = connect_result_t<schedule_result_t<decltype(tp)>, count_receiver>;
+  std::vector<std::unique_ptr<op_t>> ops;
+
+  {
+    submission_batch outer;
+    {
+      submission_batch inner;
+      for (int i = 0; i < 10; ++i) {
+        ops.emplace_back(new op_t(connect(schedule(tp), count_receiver{&x})));
+        start(*ops.back());
+      }
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(x, 0);
+  }
+
+  while (x.load() != 10) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(x, 10);
+}
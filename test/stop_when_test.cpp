@@ -23,6 +23,7 @@
 #include <unifex/sync_wait.hpp>
 #include <unifex/then.hpp>
 #include <unifex/timed_single_thread_context.hpp>
+#include <unifex/unstoppable.hpp>
 #include <unifex/when_all.hpp>
 
 #if !UNIFEX_NO_COROUTINES
@@ -86,6 +87,34 @@ TEST(StopWhen, TriggerCompletesFirst) {
   EXPECT_TRUE(triggerExecuted);
 }
 
+TEST(StopWhen, TriggerStopsSourceUnderUnstoppableReceiver) {
+  using namespace std::chrono_literals;
+
+  unifex::timed_single_thread_context ctx;
+
+  bool sourceExecuted = false;
+  bool triggerExecuted = false;
+
+  // The receiver can't ask to stop, so no callback is registered with it,
+  // but the trigger still has to stop the source.
+  std::optional<int> result = unifex::sync_wait(unifex::unstoppable(unifex::on(
+      ctx.get_scheduler(),
+      unifex::stop_when(
+          unifex::then(
+              unifex::schedule_after(1s),
+              [&] {
+                sourceExecuted = true;
+                return 42;
+              }),
+          unifex::then(unifex::schedule_after(10ms), [&] {
+            triggerExecuted = true;
+          })))));
+
+  EXPECT_FALSE(result.has_value());
+  EXPECT_FALSE(sourceExecuted);
+  EXPECT_TRUE(triggerExecuted);
+}
+
 TEST(StopWhen, CancelledFromParent) {
   using namespace std::chrono_literals;
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unifex/coroutine.hpp>
+
+#if !UNIFEX_NO_COROUTINES
+
+#include <unifex/just.hpp>
+#include <unifex/recycling_allocator.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/task.hpp>
+#include <unifex/when_all.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+using namespace unifex;
+
+namespace {
+
+struct alloc_stats {
+  int allocations = 0;
+  int deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(alloc_stats& stats) noexcept : stats_(&stats) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other) noexcept
+    : stats_(other.stats_) {}
+
+  T* allocate(std::size_t n) {
+    ++stats_->allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    ++stats_->deallocations;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool
+  operator==(const counting_allocator& a, const counting_allocator& b) noexcept {
+    return a.stats_ == b.stats_;
+  }
+
+  friend bool
+  operator!=(const counting_allocator& a, const counting_allocator& b) noexcept {
+    return !(a == b);
+  }
+
+  alloc_stats* stats_;
+};
+
+task<int> add(std::allocator_arg_t, counting_allocator<std::byte>, int a, int b) {
+  co_return a + b;
+}
+
+task<int> add_twice(alloc_stats& stats, int a, int b) {
+  counting_allocator<std::byte> alloc{stats};
+  int x = co_await add(std::allocator_arg, alloc, a, b);
+  int y = co_await add(std::allocator_arg, alloc, x, b);
+  co_return y;
+}
+
+struct adder {
+  task<int>
+  add(std::allocator_arg_t, counting_allocator<std::byte>, int a) const {
+    co_return base_ + a;
+  }
+
+  int base_;
+};
+
+recycling_task<int>
+recycled_add(std::allocator_arg_t, counting_allocator<std::byte>, int a) {
+  co_return a;
+}
+
+recycling_task<int> leaf(int depth) {
+  co_return co_await just(depth);
+}
+
+recycling_task<int> tree(int depth) {
+  if (depth == 0) {
+    co_return co_await leaf(depth);
+  }
+  int left = co_await tree(depth - 1);
+  int right = co_await tree(depth - 1);
+  co_return left + right + 1;
+}
+
+recycling_task<void> child(static_thread_pool::scheduler s, std::atomic<int>& x) {
+  co_await schedule(s);
+  ++x;
+}
+
+recycling_task<void>
+parent(static_thread_pool::scheduler s, std::atomic<int>& x) {
+  co_await when_all(child(s, x), child(s, x));
+}
+
+}  // namespace
+
+TEST(TaskFrameAllocation, LeadingAllocatorArgIsUsedForFrame) {
+  alloc_stats stats;
+  auto result = sync_wait(add_twice(stats, 1, 2));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(5, *result);
+  EXPECT_EQ(2, stats.allocations);
+  EXPECT_EQ(2, stats.deallocations);
+}
+
+TEST(TaskFrameAllocation, MemberCoroutinesHonourAllocatorArg) {
+  alloc_stats stats;
+  adder a{10};
+  auto result = sync_wait(
+      a.add(std::allocator_arg, counting_allocator<std::byte>{stats}, 5));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(15, *result);
+  EXPECT_EQ(1, stats.allocations);
+  EXPECT_EQ(1, stats.deallocations);
+}
+
+TEST(TaskFrameAllocation, UnstartedTaskFreesFrameWithAllocator) {
+  alloc_stats stats;
+  {
+    auto t = add(std::allocator_arg, counting_allocator<std::byte>{stats}, 1, 2);
+    EXPECT_EQ(1, stats.allocations);
+  }
+  EXPECT_EQ(1, stats.deallocations);
+}
+
+TEST(TaskFrameAllocation, AllocatorArgTakesPrecedenceOverRecycling) {
+  alloc_stats stats;
+  auto result = sync_wait(
+      recycled_add(std::allocator_arg, counting_allocator<std::byte>{stats}, 3));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(3, *result);
+  EXPECT_EQ(1, stats.allocations);
+  EXPECT_EQ(1, stats.deallocations);
+}
+
+TEST(TaskFrameAllocation, RecyclingTaskRunsDeepCallTrees) {
+  auto result = sync_wait(tree(6));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(63, *result);
+
+  trim_recycled_memory();
+}
+
+TEST(TaskFrameAllocation, RecyclingTaskFramesMayMoveBetweenThreads) {
+  std::atomic<int> x{0};
+  static_thread_pool context(2);
+
+  for (int i = 0; i < 100; ++i) {
+    sync_wait(parent(context.get_scheduler(), x));
+  }
+
+  EXPECT_EQ(200, x.load());
+
+  trim_recycled_memory();
+}
+
+#endif  // !UNIFEX_NO_COROUTINES
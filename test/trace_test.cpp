@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/trace.hpp>
+
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+const void* as_id(std::uintptr_t i) {
+  return reinterpret_cast<const void*>(i);
+}
+
+// The events recorded with the given name, oldest first on each thread.
+std::vector<trace_event> events_named(
+    const std::vector<thread_trace_events>& threads, const char* name) {
+  std::vector<trace_event> result;
+  for (auto& thread : threads) {
+    for (auto& e : thread.events) {
+      if (std::strcmp(e.name, name) == 0) {
+        result.push_back(e);
+      }
+    }
+  }
+  return result;
+}
+
+constexpr const char* test_name = "trace_test";
+} // namespace
+
+TEST(trace, RecordsEventsOnEachThread) {
+  clear_trace_events();
+  record_trace_event(trace_event_kind::enqueue, test_name, as_id(1));
+  std::thread worker{[] {
+    record_trace_event(trace_event_kind::dequeue, test_name, as_id(1));
+    record_trace_event(trace_event_kind::start, test_name, as_id(1));
+    record_trace_event(trace_event_kind::complete, test_name, as_id(1));
+  }};
+  worker.join();
+
+  auto threads = collect_trace_events();
+  std::vector<std::uint32_t> threadIds;
+  for (auto& thread : threads) {
+    if (!events_named({thread}, test_name).empty()) {
+      threadIds.push_back(thread.threadId);
+    }
+  }
+  EXPECT_EQ(2u, threadIds.size());
+
+  auto events = events_named(threads, test_name);
+  ASSERT_EQ(4u, events.size());
+  std::sort(events.begin(), events.end(), [](auto& a, auto& b) {
+    return a.timestamp < b.timestamp;
+  });
+  EXPECT_EQ(trace_event_kind::enqueue, events[0].kind);
+  EXPECT_EQ(trace_event_kind::dequeue, events[1].kind);
+  EXPECT_EQ(trace_event_kind::start, events[2].kind);
+  EXPECT_EQ(trace_event_kind::complete, events[3].kind);
+  for (auto& e : events) {
+    EXPECT_EQ(as_id(1), e.id);
+  }
+}
+
+TEST(trace, KeepsTheMostRecentEvents) {
+  clear_trace_events();
+  const std::size_t capacity = trace_buffer_capacity();
+  const std::size_t overflow = 10;
+  for (std::size_t i = 0; i < capacity + overflow; ++i) {
+    record_trace_event(trace_event_kind::start, test_name, as_id(i));
+  }
+
+  auto events = events_named(collect_trace_events(), test_name);
+  ASSERT_EQ(capacity, events.size());
+  EXPECT_EQ(as_id(overflow), events.front().id);
+  EXPECT_EQ(as_id(capacity + overflow - 1), events.back().id);
+  EXPECT_TRUE(std::is_sorted(
+      events.begin(), events.end(), [](auto& a, auto& b) {
+        return a.timestamp < b.timestamp;
+      }));
+
+  clear_trace_events();
+  EXPECT_TRUE(events_named(collect_trace_events(), test_name).empty());
+}
+
+TEST(trace, ReusesTheBuffersOfExitedThreads) {
+  clear_trace_events();
+  // Make sure that at least one buffer is free.
+  std::thread{[] {
+    record_trace_event(trace_event_kind::start, test_name, as_id(1));
+  }}.join();
+  const auto buffers = collect_trace_events().size();
+
+  for (std::uintptr_t i = 2; i != 10; ++i) {
+    std::thread{[i] {
+      record_trace_event(trace_event_kind::start, test_name, as_id(i));
+    }}.join();
+  }
+
+  auto threads = collect_trace_events();
+  EXPECT_EQ(buffers, threads.size());
+  // Only the last thread's event is left in the reused buffer.
+  auto events = events_named(threads, test_name);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(as_id(9), events[0].id);
+}
+
+TEST(trace, SkipsEventsThatAreBeingOverwritten) {
+  clear_trace_events();
+  std::atomic<bool> stop{false};
+  std::thread writer{[&] {
+    for (std::uintptr_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+      record_trace_event(trace_event_kind::start, test_name, as_id(i));
+    }
+  }};
+
+  for (int n = 0; n != 100; ++n) {
+    // Events from one thread have increasing ids; a torn slot would show up
+    // as an event that's out of order.
+    auto events = events_named(collect_trace_events(), test_name);
+    EXPECT_LE(events.size(), trace_buffer_capacity());
+    auto outOfOrder = [](auto& a, auto& b) {
+      return reinterpret_cast<std::uintptr_t>(b.id) <=
+          reinterpret_cast<std::uintptr_t>(a.id) ||
+          b.timestamp < a.timestamp;
+    };
+    EXPECT_EQ(
+        events.end(),
+        std::adjacent_find(events.begin(), events.end(), outOfOrder));
+  }
+  stop = true;
+  writer.join();
+}
+
+TEST(trace, WritesChromeTraceEvents) {
+  static constexpr const char* name = "trace_test \"chrome\"";
+  clear_trace_events();
+  record_trace_event(trace_event_kind::enqueue, name, as_id(0x2a));
+  record_trace_event(trace_event_kind::dequeue, name, as_id(0x2a));
+  record_trace_event(trace_event_kind::start, name, as_id(0x2a));
+  record_trace_event(trace_event_kind::complete, name, as_id(0x2a));
+  record_trace_event(trace_event_kind::cancel, name, as_id(0x2a));
+
+  std::ostringstream out;
+  write_chrome_trace(out);
+  const std::string json = out.str();
+
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(
+      std::string::npos,
+      json.find("\"name\":\"trace_test \\\"chrome\\\"\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"queue\",\"ph\":\"b\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"queue\",\"ph\":\"e\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"run\",\"ph\":\"b\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"run\",\"ph\":\"e\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"queue\",\"ph\":\"n\""));
+  EXPECT_NE(std::string::npos, json.find("\"id\":\"0x2a\""));
+  EXPECT_NE(std::string::npos, json.find("\"pid\":1,\"tid\":"));
+  EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+}
+
+#if UNIFEX_ENABLE_TRACING
+TEST(trace, StaticThreadPoolRecordsTasks) {
+  clear_trace_events();
+  {
+    static_thread_pool pool{1};
+    sync_wait(schedule(pool.get_scheduler()));
+  }
+
+  auto events = events_named(collect_trace_events(), "static_thread_pool");
+  auto count = [&](trace_event_kind kind) {
+    return std::count_if(events.begin(), events.end(), [&](auto& e) {
+      return e.kind == kind;
+    });
+  };
+  EXPECT_EQ(1, count(trace_event_kind::enqueue));
+  EXPECT_EQ(1, count(trace_event_kind::dequeue));
+  EXPECT_EQ(1, count(trace_event_kind::start));
+  EXPECT_EQ(1, count(trace_event_kind::complete));
+}
+#endif
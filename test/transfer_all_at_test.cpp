@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/io_concepts.hpp>
+
+#include <unifex/just.hpp>
+#include <unifex/span.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace unifex;
+
+namespace {
+
+// A file that reads and writes at most `maxChunk_` bytes at a time, and
+// only customises async_read_some_at and async_write_some_at.
+struct chunked_file {
+  using offset_t = std::int64_t;
+
+  std::string contents_;
+  std::size_t maxChunk_ = 5;
+  int calls_ = 0;
+  // The call that throws, if any.
+  int failingCall_ = -1;
+
+  std::size_t next_chunk(offset_t offset, std::size_t size) {
+    if (++calls_ == failingCall_) {
+      throw std::runtime_error("boom");
+    }
+    const auto available =
+        contents_.size() - std::min<std::size_t>(offset, contents_.size());
+    return std::min({size, maxChunk_, available});
+  }
+
+  friend auto tag_invoke(
+      tag_t<async_read_some_at>,
+      chunked_file& file,
+      offset_t offset,
+      span<std::byte> buffer) {
+    return then(just(), [&file, offset, buffer]() -> std::ptrdiff_t {
+      const auto count = file.next_chunk(offset, buffer.size());
+      std::memcpy(buffer.data(), file.contents_.data() + offset, count);
+      return static_cast<std::ptrdiff_t>(count);
+    });
+  }
+
+  friend auto tag_invoke(
+      tag_t<async_write_some_at>,
+      chunked_file& file,
+      offset_t offset,
+      span<const std::byte> buffer) {
+    return then(just(), [&file, offset, buffer]() -> std::ptrdiff_t {
+      file.contents_.resize(
+          std::max<std::size_t>(file.contents_.size(), offset + buffer.size()));
+      const auto count = file.next_chunk(offset, buffer.size());
+      std::memcpy(file.contents_.data() + offset, buffer.data(), count);
+      return static_cast<std::ptrdiff_t>(count);
+    });
+  }
+};
+
+} // namespace
+
+TEST(TransferAllAt, FallbackReadsExactlyAcrossShortReads) {
+  chunked_file file{"hello, world"};
+  char buffer[12] = {};
+
+  auto read = sync_wait(async_read_exactly_at(
+      file, 0, as_writable_bytes(span{buffer, sizeof(buffer)})));
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(12, *read);
+  EXPECT_EQ(3, file.calls_);
+  EXPECT_EQ("hello, world", std::string(buffer, sizeof(buffer)));
+}
+
+TEST(TransferAllAt, FallbackReadIsShortOnlyAtTheEndOfTheFile) {
+  chunked_file file{"hello, world"};
+  char buffer[16] = {};
+
+  auto read = sync_wait(async_read_exactly_at(
+      file, 7, as_writable_bytes(span{buffer, sizeof(buffer)})));
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(5, *read);
+  EXPECT_EQ("world", std::string(buffer, 5));
+}
+
+TEST(TransferAllAt, FallbackWritesAllAcrossShortWrites) {
+  chunked_file file{"ab"};
+  const std::string text = "0123456789abc";
+
+  auto written = sync_wait(
+      async_write_all_at(file, 2, as_bytes(span{text.data(), text.size()})));
+
+  ASSERT_TRUE(written.has_value());
+  EXPECT_EQ(13, *written);
+  EXPECT_EQ(3, file.calls_);
+  EXPECT_EQ("ab0123456789abc", file.contents_);
+}
+
+TEST(TransferAllAt, FallbackErrorAfterProgressIsSent) {
+  chunked_file file{"hello, world"};
+  file.failingCall_ = 2;
+  char buffer[12] = {};
+
+  EXPECT_THROW(
+      sync_wait(async_read_exactly_at(
+          file, 0, as_writable_bytes(span{buffer, sizeof(buffer)}))),
+      std::runtime_error);
+  EXPECT_EQ("hello", std::string(buffer, 5));
+}
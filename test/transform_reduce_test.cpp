@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/transform_reduce.hpp>
+
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace unifex;
+
+TEST(transform_reduce, Parallel) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000);
+  std::iota(values.begin(), values.end(), 0);
+
+  auto result = sync_wait(unifex::transform_reduce(
+      pool.get_scheduler(),
+      par,
+      values.begin(),
+      values.end(),
+      std::int64_t{10},
+      std::plus<>{},
+      [](int value) { return std::int64_t{value} * 2; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(10 + 99'999ll * 100'000ll, *result);
+}
+
+TEST(transform_reduce, EmptyRangeSendsInit) {
+  static_thread_pool pool{2};
+  std::vector<int> values;
+
+  auto result = sync_wait(unifex::transform_reduce(
+      pool.get_scheduler(),
+      par,
+      values.begin(),
+      values.end(),
+      7,
+      std::plus<>{},
+      [](int value) { return value; }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(7, *result);
+}
+
+TEST(transform_reduce, SequencedKeepsOrder) {
+  std::vector<int> values{1, 2, 3, 4};
+
+  // Not commutative, so only a sequenced fold gives this result.
+  auto result = sync_wait(unifex::transform_reduce(
+      inline_scheduler{},
+      seq,
+      values.begin(),
+      values.end(),
+      std::string{">"},
+      std::plus<>{},
+      [](int value) { return std::to_string(value); }));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(">1234", *result);
+}
+
+TEST(transform_reduce, ExceptionIsSent) {
+  static_thread_pool pool{4};
+  std::vector<int> values(10'000, 1);
+  values[5'000] = 0;
+
+  EXPECT_THROW(
+      sync_wait(unifex::transform_reduce(
+          pool.get_scheduler(),
+          par,
+          values.begin(),
+          values.end(),
+          0,
+          std::plus<>{},
+          [](int value) {
+            if (value == 0) {
+              throw std::runtime_error("boom");
+            }
+            return value;
+          })),
+      std::runtime_error);
+}
+
+TEST(transform_reduce, Cancellation) {
+  static_thread_pool pool{4};
+  std::vector<int> values(100'000, 1);
+
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return unifex::transform_reduce(
+            pool.get_scheduler(),
+            par,
+            values.begin(),
+            values.end(),
+            0,
+            std::plus<>{},
+            [](int value) { return value; });
+      }));
+
+  EXPECT_FALSE(result.has_value());
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/transform_stream_async.hpp>
+
+#include <unifex/for_each.hpp>
+#include <unifex/just.hpp>
+#include <unifex/let_value.hpp>
+#include <unifex/range_stream.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+struct concurrency_counter {
+  std::atomic<int> current{0};
+  std::atomic<int> max{0};
+
+  void enter() {
+    int now = ++current;
+    int seen = max.load();
+    while (now > seen && !max.compare_exchange_weak(seen, now)) {
+    }
+  }
+
+  void exit() { --current; }
+};
+} // namespace
+
+TEST(transform_stream_async, PreservesSourceOrder) {
+  static_thread_pool pool{4};
+  auto sched = pool.get_scheduler();
+
+  std::vector<int> values;
+  range_stream{0, 20}
+    | transform_stream_async(
+        [](int value) {
+          return just(value) | then([](int value) {
+                   // Later values finish first.
+                   std::this_thread::sleep_for(
+                       std::chrono::microseconds((20 - value) * 100));
+                   return value * 2;
+                 });
+        },
+        4,
+        sched)
+    | for_each([&](int value) { values.push_back(value); })
+    | sync_wait();
+
+  std::vector<int> expected;
+  for (int i = 0; i < 20; ++i) {
+    expected.push_back(i * 2);
+  }
+  EXPECT_EQ(expected, values);
+}
+
+TEST(transform_stream_async, BoundsConcurrency) {
+  static_thread_pool pool{8};
+  auto sched = pool.get_scheduler();
+
+  concurrency_counter counter;
+  int count = 0;
+  range_stream{0, 50}
+    | transform_stream_async(
+        [&](int value) {
+          return just(value) | then([&](int value) {
+                   counter.enter();
+                   std::this_thread::sleep_for(200us);
+                   counter.exit();
+                   return value;
+                 });
+        },
+        3,
+        sched)
+    | for_each([&](int) { ++count; })
+    | sync_wait();
+
+  EXPECT_EQ(50, count);
+  EXPECT_LE(counter.max.load(), 3);
+  EXPECT_GE(counter.max.load(), 1);
+}
+
+TEST(transform_stream_async, UnorderedSendsEveryResult) {
+  static_thread_pool pool{4};
+  auto sched = pool.get_scheduler();
+
+  std::vector<int> values;
+  range_stream{0, 30}
+    | transform_stream_async_unordered(
+        [](int value) {
+          return just(value) | then([](int value) {
+                   std::this_thread::sleep_for(
+                       std::chrono::microseconds((value % 3) * 100));
+                   return value;
+                 });
+        },
+        5,
+        sched)
+    | for_each([&](int value) { values.push_back(value); })
+    | sync_wait();
+
+  std::sort(values.begin(), values.end());
+  std::vector<int> expected;
+  for (int i = 0; i < 30; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(expected, values);
+}
+
+TEST(transform_stream_async, ErrorsAreSentInOrder) {
+  static_thread_pool pool{4};
+  auto sched = pool.get_scheduler();
+
+  std::vector<int> values;
+  EXPECT_THROW(
+      sync_wait(for_each(
+          transform_stream_async(
+              range_stream{0, 10},
+              [](int value) {
+                return just(value) | then([](int value) {
+                         if (value == 5) {
+                           throw std::runtime_error("boom");
+                         }
+                         return value;
+                       });
+              },
+              3,
+              sched),
+          [&](int value) { values.push_back(value); })),
+      std::runtime_error);
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), values);
+}
+
+TEST(transform_stream_async, CancellingNextCancelsInFlightWork) {
+  timed_single_thread_context ctx;
+  auto timer = ctx.get_scheduler();
+  static_thread_pool pool{2};
+  auto sched = pool.get_scheduler();
+
+  int count = 0;
+  auto result = sync_wait(for_each(
+      take_until(
+          transform_stream_async(
+              range_stream{0, 1000},
+              [&](int value) {
+                return schedule_after(timer, 10ms)
+                    | then([value] { return value; });
+              },
+              2,
+              sched),
+          single(schedule_after(timer, 50ms))),
+      [&](int) { ++count; }));
+
+  EXPECT_TRUE(result.has_value());
+  EXPECT_LT(count, 1000);
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/config.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/io_concepts.hpp>
+#include <unifex/just.hpp>
+#include <unifex/span.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <unifex/linux/io_epoll_context.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#if !UNIFEX_NO_LIBURING
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+using namespace unifex;
+
+namespace {
+
+span<const std::byte> bytes_of(const char* text) noexcept {
+  return as_bytes(span{text, std::strlen(text)});
+}
+
+span<std::byte> bytes_of(char* text, std::size_t size) noexcept {
+  return as_writable_bytes(span{text, size});
+}
+
+// A file that only knows how to read a single buffer.
+struct single_buffer_file {
+  using offset_t = std::int64_t;
+
+  offset_t lastOffset_ = -1;
+  std::byte* lastData_ = nullptr;
+  std::size_t lastSize_ = 0;
+
+  friend auto tag_invoke(
+      tag_t<async_read_some_at>,
+      single_buffer_file& file,
+      offset_t offset,
+      span<std::byte> buffer) noexcept {
+    file.lastOffset_ = offset;
+    file.lastData_ = buffer.data();
+    file.lastSize_ = buffer.size();
+    return just(static_cast<std::ptrdiff_t>(buffer.size()));
+  }
+};
+
+} // namespace
+
+TEST(VectoredIO, FallsBackToTheFirstBufferThatIsNotEmpty) {
+  single_buffer_file file;
+  char storage[8];
+  const span<std::byte> buffers[] = {
+      bytes_of(storage, 0), bytes_of(storage + 2, 3), bytes_of(storage, 8)};
+
+  auto read = sync_wait(async_read_some_at_v(file, 42, buffers));
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(3, *read);
+  EXPECT_EQ(42, file.lastOffset_);
+  EXPECT_EQ(reinterpret_cast<std::byte*>(storage + 2), file.lastData_);
+  EXPECT_EQ(3u, file.lastSize_);
+}
+
+TEST(VectoredIO, FallsBackToAnEmptyBufferWhenThereIsNothingToRead) {
+  single_buffer_file file;
+
+  auto read = sync_wait(
+      async_read_some_at_v(file, 0, span<const span<std::byte>>{}));
+
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(0, *read);
+  EXPECT_EQ(0u, file.lastSize_);
+}
+
+#if !UNIFEX_NO_LIBURING
+TEST(VectoredIO, IOUringScattersAndGathersAtAnOffset) {
+  char path[] = "/tmp/unifex_vectored_io_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+
+  linuxos::io_uring_context ctx;
+  inplace_stop_source stopSource;
+  std::thread io{[&] { ctx.run(stopSource.get_token()); }};
+  auto sched = ctx.get_scheduler();
+
+  {
+    auto file = open_file_read_write(sched, path);
+
+    const span<const std::byte> header[] = {
+        bytes_of("HTTP/1.1 200 OK\r\n"), bytes_of("\r\n"), bytes_of("body")};
+    auto written = sync_wait(async_write_some_at_v(file, 4, header));
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(23, *written);
+
+    // More buffers than the operation stores inline.
+    char parts[6][4] = {};
+    span<std::byte> buffers[6];
+    for (int i = 0; i < 6; ++i) {
+      buffers[i] = bytes_of(parts[i], 4);
+    }
+    auto read = sync_wait(async_read_some_at_v(file, 4, buffers));
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(23, *read);
+    EXPECT_EQ(
+        std::string("HTTP/1.1 200 OK\r\n\r\nbody"),
+        std::string(&parts[0][0], 23));
+
+    // The span of buffers only has to live until the sender is constructed.
+    char name[4] = {};
+    char version[16] = {};
+    auto readSender = [&] {
+      const span<std::byte> scratch[] = {
+          bytes_of(name, 4), bytes_of(version, sizeof(version))};
+      return async_read_some_at_v(file, 4, scratch);
+    }();
+    auto reread = sync_wait(std::move(readSender));
+    ASSERT_TRUE(reread.has_value());
+    EXPECT_EQ(20, *reread);
+    EXPECT_EQ("HTTP", std::string(name, 4));
+    EXPECT_EQ("/1.1 200 OK\r\n\r\nb", std::string(version, 16));
+  }
+
+  stopSource.request_stop();
+  io.join();
+  unlink(path);
+}
+#endif // !UNIFEX_NO_LIBURING
+
+#if !UNIFEX_NO_EPOLL
+TEST(VectoredIO, EpollScattersAndGathersThroughAPipe) {
+  linuxos::io_epoll_context ctx;
+  inplace_stop_source stopSource;
+  std::thread io{[&] { ctx.run(stopSource.get_token()); }};
+
+  {
+    auto [reader, writer] = open_pipe(ctx.get_scheduler());
+
+    const span<const std::byte> message[] = {
+        bytes_of("scatter"), bytes_of(""), bytes_of("/gather")};
+    auto written = sync_wait(async_write_some_v(writer, message));
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(14, *written);
+
+    char first[3] = {};
+    char second[16] = {};
+    const span<std::byte> buffers[] = {
+        bytes_of(first, sizeof(first)), bytes_of(second, sizeof(second))};
+    auto read = sync_wait(async_read_some_v(reader, buffers));
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(14, *read);
+    EXPECT_EQ("sca", std::string(first, 3));
+    EXPECT_EQ("tter/gather", std::string(second, 11));
+  }
+
+  stopSource.request_stop();
+  io.join();
+}
+#endif // !UNIFEX_NO_EPOLL
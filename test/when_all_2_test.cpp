@@ -28,8 +28,13 @@
 #include <unifex/timed_single_thread_context.hpp>
 
 #include <chrono>
+#include <cstddef>
+#include <exception>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <tuple>
+#include <variant>
 
 #include <gtest/gtest.h>
 
@@ -217,3 +222,48 @@ TEST(WhenAll2, SenderIsLvalueConnectable) {
 
   unifex::sync_wait(test);
 }
+
+namespace {
+struct pointer_receiver {
+  void* context_;
+
+  template <typename... Values>
+  void set_value(Values&&...) noexcept {}
+  template <typename Error>
+  void set_error(Error&&) noexcept {}
+  void set_done() noexcept {}
+};
+}  // namespace
+
+TEST(WhenAll2, OperationStateHasNoPerChildOverhead) {
+  using just_int = decltype(just(0));
+  using op_t = connect_result_t<
+      decltype(when_all(
+          just(0), just(1), just(2), just(3),
+          just(4), just(5), just(6), just(7))),
+      pointer_receiver>;
+
+  // Each child costs its operation state and its values. Beyond that
+  // there is one error, one stop source, the reference count and the
+  // completion bits, the receiver's stop callback (empty here, but it can
+  // still take a word without [[no_unique_address]]) and the receiver.
+  constexpr std::size_t budget =
+      8 * (sizeof(connect_result_t<just_int, pointer_receiver>) +
+           sizeof(std::variant<std::tuple<int>>)) +
+      sizeof(std::variant<std::exception_ptr>) +
+      sizeof(inplace_stop_source) + 3 * sizeof(std::size_t) +
+      sizeof(pointer_receiver);
+  static_assert(sizeof(op_t) <= budget);
+}
+
+#if !UNIFEX_NO_EXCEPTIONS
+TEST(WhenAll2, StoredValuesAreDestroyedOnError) {
+  auto value = std::make_shared<int>(42);
+
+  EXPECT_THROW(
+      sync_wait(when_all(
+          just(value), then(just(), []() -> int { throw my_error{}; }))),
+      my_error);
+  EXPECT_EQ(1, value.use_count());
+}
+#endif  // !UNIFEX_NO_EXCEPTIONS
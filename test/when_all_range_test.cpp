@@ -14,8 +14,12 @@
 #include <unifex/then.hpp>
 
 #include <unifex/never.hpp>
+#include <unifex/span.hpp>
 #include <unifex/when_all_range.hpp>
 
+#include <array>
+#include <stdexcept>
+
 using namespace unifex;
 
 class WhenAllRangeTests : public ::testing::Test {};
@@ -104,6 +108,101 @@ TEST_F(WhenAllRangeTests, noCopy) {
   }
 }
 
+TEST_F(WhenAllRangeTests, arrayOfSendersSendsArray) {
+  std::array<decltype(times_three(0)), 4> works{
+      times_three(0), times_three(1), times_three(2), times_three(3)};
+
+  auto result = sync_wait(when_all_range(std::move(works)));
+
+  static_assert(std::is_same_v<
+                decltype(result),
+                std::optional<std::array<int, 4>>>);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((std::array<int, 4>{0, 3, 6, 9}), *result);
+}
+
+TEST_F(WhenAllRangeTests, staticSpanOfSendersSendsArray) {
+  using work_t = decltype(times_three(0));
+  work_t works[3]{times_three(1), times_three(2), times_three(3)};
+
+  auto result = sync_wait(when_all_range(span<work_t, 3>{works}));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((std::array<int, 3>{3, 6, 9}), *result);
+}
+
+TEST_F(WhenAllRangeTests, spanOfSendersSendsVector) {
+  std::vector<decltype(times_three(0))> works;
+  for (int i = 0; i < 5; i++) {
+    works.push_back(times_three(i));
+  }
+
+  using work_t = decltype(times_three(0));
+  auto result =
+      sync_wait(when_all_range(span<work_t>{works.data(), works.size()}));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((std::vector<int>{0, 3, 6, 9, 12}), *result);
+}
+
+TEST_F(WhenAllRangeTests, resultsAreWrittenToCallerStorage) {
+  // More senders than fit inline, so some are stored on the heap.
+  std::vector<decltype(times_three(0))> works;
+  for (int i = 0; i < 20; i++) {
+    works.push_back(times_three(i));
+  }
+  std::array<int, 32> results{};
+
+  auto result = sync_wait(when_all_range(
+      span<decltype(times_three(0))>{works.data(), works.size()},
+      span<int>{results}));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(results.data(), result->data());
+  ASSERT_EQ(20u, result->size());
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(i * 3, (*result)[i]);
+  }
+  EXPECT_EQ(0, results[20]);
+}
+
+TEST_F(WhenAllRangeTests, callerStorageThatIsTooShortThrows) {
+  std::array<decltype(times_three(0)), 3> works{
+      times_three(0), times_three(1), times_three(2)};
+  std::array<int, 2> results{};
+
+  EXPECT_THROW(
+      when_all_range(
+          span<decltype(times_three(0))>{works.data(), works.size()},
+          span<int>{results}),
+      std::length_error);
+}
+
+TEST_F(WhenAllRangeTests, arrayOfSendersSendsError) {
+  auto make_work = [](int x) {
+    return then(just(x), [](int val) {
+      if (val == 1) {
+        throw std::exception{};
+      }
+      return val;
+    });
+  };
+  std::array<decltype(make_work(0)), 3> works{
+      make_work(0), make_work(1), make_work(2)};
+
+  EXPECT_THROW(sync_wait(when_all_range(std::move(works))), std::exception);
+}
+
+TEST_F(WhenAllRangeTests, emptySpanWritesNothing) {
+  std::array<int, 1> results{};
+
+  auto result = sync_wait(when_all_range(
+      span<decltype(times_three(0))>{}, span<int>{results}));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->empty());
+}
+
 // TODO: Fix MSVC compilation error with any_unique
 #ifndef _MSC_VER
 TEST_F(WhenAllRangeTests, ErrorCancelsRest) {
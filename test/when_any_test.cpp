@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/when_any.hpp>
+
+#include <unifex/just.hpp>
+#include <unifex/just_done.hpp>
+#include <unifex/just_error.hpp>
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/unstoppable.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <variant>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+TEST(when_any, FirstValueWinsAndStopsTheRest) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+  bool slowRan = false;
+
+  const auto start = std::chrono::steady_clock::now();
+  auto result = sync_wait(when_any(
+      then(schedule_after(sched, 10s), [&] { slowRan = true; return 1; }),
+      then(schedule_after(sched, 10ms), [] { return std::string{"fast"}; })));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(1u, result->index());
+  EXPECT_EQ("fast", std::get<0>(std::get<1>(*result)));
+  EXPECT_FALSE(slowRan);
+}
+
+TEST(when_any, WinnerStopsTheRestUnderUnstoppableReceiver) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+  bool slowRan = false;
+
+  const auto start = std::chrono::steady_clock::now();
+  auto result = sync_wait(unstoppable(when_any(
+      then(schedule_after(sched, 10s), [&] { slowRan = true; return 1; }),
+      then(schedule_after(sched, 10ms), [] { return 2; }))));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(1u, result->index());
+  EXPECT_FALSE(slowRan);
+}
+
+TEST(when_any, SameTypedSendersReportTheWinner) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+  auto replica = [&](std::chrono::milliseconds delay, int value) {
+    return then(schedule_after(sched, delay), [value] { return value; });
+  };
+
+  auto result =
+      sync_wait(when_any(replica(50ms, 1), replica(10ms, 2), replica(10s, 3)));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(1u, result->index());
+  EXPECT_EQ(std::make_tuple(2), std::get<1>(*result));
+}
+
+TEST(when_any, ErrorsAreIgnoredWhileAValueIsPossible) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+
+  auto result = sync_wait(when_any(
+      just_error(std::make_exception_ptr(std::runtime_error{"boom"})),
+      then(schedule_after(sched, 10ms), [] { return 42; })));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(1u, result->index());
+}
+
+TEST(when_any, SendsTheFirstErrorWhenEverySenderFails) {
+  EXPECT_THROW(
+      sync_wait(when_any(
+          just_done(),
+          just_error(std::make_exception_ptr(std::runtime_error{"boom"})))),
+      std::runtime_error);
+}
+
+namespace {
+struct copy_throws {
+  copy_throws() = default;
+  copy_throws(copy_throws&&) = default;
+  copy_throws(const copy_throws&) { throw std::runtime_error{"copy"}; }
+};
+} // namespace
+
+TEST(when_any, SendsTheWinnersExceptionWhenItsValuesCantBeStored) {
+  // The first sender wins, but copying its value into the result throws.
+  // The second one's value has already been dropped by then, so the
+  // exception is sent rather than letting it win.
+  copy_throws shared;
+
+  EXPECT_THROW(
+      sync_wait(when_any(
+          then(just(), [&]() -> copy_throws& { return shared; }),
+          just(copy_throws{}))),
+      std::runtime_error);
+}
+
+TEST(when_any, SendsDoneWhenEverySenderIsDone) {
+  auto result = sync_wait(when_any(just_done(), just_done()));
+
+  EXPECT_FALSE(result.has_value());
+}
+
+TEST(when_any, CancellationStopsEverySender) {
+  timed_single_thread_context ctx;
+  auto sched = ctx.get_scheduler();
+
+  const auto start = std::chrono::steady_clock::now();
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return when_any(schedule_after(sched, 10s), schedule_after(sched, 10s));
+      }));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_FALSE(result.has_value());
+}
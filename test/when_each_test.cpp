@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/when_each.hpp>
+
+#include <unifex/for_each.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/take_until.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+auto delayed(
+    timed_single_thread_context& ctx,
+    std::chrono::milliseconds delay,
+    int value) {
+  return then(schedule_after(ctx.get_scheduler(), delay), [value] {
+    if (value < 0) {
+      throw std::runtime_error("boom");
+    }
+    return value;
+  });
+}
+} // namespace
+
+TEST(when_each, SendsResultsInCompletionOrder) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 30ms, 10));
+  senders.push_back(delayed(ctx, 10ms, 11));
+  senders.push_back(delayed(ctx, 20ms, 12));
+
+  std::vector<std::pair<std::size_t, int>> results;
+  auto done = sync_wait(for_each(
+      when_each(std::move(senders)), [&](std::size_t index, int value) {
+        results.emplace_back(index, value);
+      }));
+
+  EXPECT_TRUE(done.has_value());
+  EXPECT_EQ(
+      (std::vector<std::pair<std::size_t, int>>{{1, 11}, {2, 12}, {0, 10}}),
+      results);
+}
+
+TEST(when_each, EmptyRangeEndsImmediately) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+
+  int count = 0;
+  auto done = sync_wait(
+      for_each(when_each(std::move(senders)), [&](std::size_t, int) {
+        ++count;
+      }));
+
+  EXPECT_TRUE(done.has_value());
+  EXPECT_EQ(0, count);
+}
+
+TEST(when_each, ErrorEndsTheStreamAndStopsTheRest) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10ms, 1));
+  senders.push_back(delayed(ctx, 20ms, -1));
+  senders.push_back(delayed(ctx, 10s, 3));
+
+  std::vector<int> values;
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(
+      sync_wait(for_each(
+          when_each(std::move(senders)),
+          [&](std::size_t, int value) { values.push_back(value); })),
+      std::runtime_error);
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_EQ(std::vector<int>{1}, values);
+}
+
+TEST(when_each, ConsumerStoppingCancelsTheRest) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10ms, 1));
+  senders.push_back(delayed(ctx, 10s, 2));
+  senders.push_back(delayed(ctx, 10s, 3));
+
+  std::vector<int> values;
+  const auto start = std::chrono::steady_clock::now();
+  auto done = sync_wait(for_each(
+      take_until(
+          when_each(std::move(senders)),
+          single(schedule_after(ctx.get_scheduler(), 50ms))),
+      [&](std::size_t, int value) { values.push_back(value); }));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_TRUE(done.has_value());
+  EXPECT_EQ(std::vector<int>{1}, values);
+}
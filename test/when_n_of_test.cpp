@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/when_n_of.hpp>
+
+#include <unifex/let_value_with_stop_source.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+auto delayed(
+    timed_single_thread_context& ctx,
+    std::chrono::milliseconds delay,
+    int value) {
+  return then(schedule_after(ctx.get_scheduler(), delay), [value] {
+    if (value < 0) {
+      throw std::runtime_error("boom");
+    }
+    return value;
+  });
+}
+
+using result_t = std::vector<std::pair<std::size_t, int>>;
+} // namespace
+
+TEST(when_n_of, CompletesAfterKValuesAndStopsTheRest) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 30ms, 10));
+  senders.push_back(delayed(ctx, 10s, 11));
+  senders.push_back(delayed(ctx, 10ms, 12));
+  senders.push_back(delayed(ctx, 10s, 13));
+
+  const auto start = std::chrono::steady_clock::now();
+  auto result = sync_wait(when_n_of(std::move(senders), 2));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((result_t{{2, 12}, {0, 10}}), *result);
+}
+
+TEST(when_n_of, FailuresDontCountWhileKIsReachable) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10ms, -1));
+  senders.push_back(delayed(ctx, 20ms, 1));
+  senders.push_back(delayed(ctx, 30ms, 2));
+
+  auto result = sync_wait(when_n_of(std::move(senders), 2));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((result_t{{1, 1}, {2, 2}}), *result);
+}
+
+TEST(when_n_of, SendsTheFirstErrorOnceKIsUnreachable) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10ms, -1));
+  senders.push_back(delayed(ctx, 20ms, -1));
+  senders.push_back(delayed(ctx, 10s, 2));
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(
+      sync_wait(when_n_of(std::move(senders), 2)), std::runtime_error);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST(when_n_of, ZeroCompletesImmediately) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10s, 1));
+
+  auto result = sync_wait(when_n_of(std::move(senders), 0));
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->empty());
+}
+
+TEST(when_n_of, CancellationStopsEverySender) {
+  timed_single_thread_context ctx;
+  std::vector<decltype(delayed(ctx, 0ms, 0))> senders;
+  senders.push_back(delayed(ctx, 10s, 1));
+  senders.push_back(delayed(ctx, 10s, 2));
+
+  const auto start = std::chrono::steady_clock::now();
+  auto result = sync_wait(
+      let_value_with_stop_source([&](inplace_stop_source& stopSource) {
+        stopSource.request_stop();
+        return when_n_of(std::move(senders), 1);
+      }));
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_FALSE(result.has_value());
+}